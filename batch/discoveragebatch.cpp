@@ -0,0 +1,445 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+// Runs the batch experiments of the Statistics dock without main window:
+// nothing is shown, the map is not rendered and no events are processed
+// between iterations. The statistics are exported as by "Auto Export",
+// next to the scene file.
+//
+// Usage: discoverage-batch [options] file.scene
+//   --strategies 5,6,7   strategy indices as in the tool combo box, default:
+//                        the tool saved in the scene
+//   --ranges 1,2,3       sensing ranges [m], default: as saved in the scene
+//   --robots N           number of robots, default: as saved in the scene
+//   --runs N             test runs per strategy and range, default: 100
+//   --jobs N             test runs in parallel, default: one per core
+//
+// Each test run has its own SimulationContext, so test runs of one batch
+// run in parallel. Run i always starts with qsrand(1 + i), so the results
+// do not depend on the number of jobs.
+
+#include "simulationcontext.h"
+#include "config.h"
+#include "robotmanager.h"
+#include "robot.h"
+#include "robottask.h"
+#include "batchstatistics.h"
+#include "bullostrategy.h"
+#include "discoveragestrategy.h"
+#include "mindiststrategy.h"
+#include "randomstrategy.h"
+#include "maxareastrategy.h"
+#include "ruffinsstrategy.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QSettings>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTime>
+
+#include <stdio.h>
+
+static void printUsage()
+{
+    fprintf(stderr,
+            "Usage: discoverage-batch [options] file.scene\n"
+            "  --strategies 5,6,7   strategy indices, default: the tool saved in the scene\n"
+            "                         5: DisCoverage (Orientation-based)\n"
+            "                         6: MinDist\n"
+            "                         7: DisCoverage (Frontier Weights)\n"
+            "                         8: Random\n"
+            "                         9: MaxArea\n"
+            "                        10: Ruffins\n"
+            "  --ranges 1,2,3       sensing ranges [m], default: as saved in the scene\n"
+            "  --robots N           number of robots, default: as saved in the scene\n"
+            "  --runs N             test runs per strategy and range, default: 100\n"
+            "  --jobs N             test runs in parallel, default: one per core\n");
+}
+
+struct BatchOptions
+{
+    BatchOptions()
+        : robotCount(0)
+        , runs(100)
+        , jobs(QThread::idealThreadCount())
+    {}
+
+    QString fileName;
+    QVector<int> strategies;
+    QVector<qreal> ranges;
+    int robotCount;     // 0: as saved in the scene
+    int runs;
+    int jobs;
+};
+
+// comma separated list of numbers, false if an item is no number
+static bool parseList(const QString& text, QVector<qreal>& values)
+{
+    foreach (const QString& item, text.split(',', QString::SkipEmptyParts)) {
+        bool ok;
+        const qreal value = item.toDouble(&ok);
+        if (!ok) {
+            return false;
+        }
+        values.append(value);
+    }
+    return true;
+}
+
+static bool parseList(const QString& text, QVector<int>& values)
+{
+    foreach (const QString& item, text.split(',', QString::SkipEmptyParts)) {
+        bool ok;
+        const int value = item.toInt(&ok);
+        if (!ok) {
+            return false;
+        }
+        values.append(value);
+    }
+    return true;
+}
+
+static bool parseArguments(const QStringList& args, BatchOptions& options)
+{
+    for (int i = 1; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        bool ok = true;
+        if (arg == "--strategies" && hasValue) {
+            ok = parseList(args[++i], options.strategies);
+        } else if (arg == "--ranges" && hasValue) {
+            ok = parseList(args[++i], options.ranges);
+        } else if (arg == "--robots" && hasValue) {
+            options.robotCount = args[++i].toInt(&ok);
+            ok = ok && options.robotCount > 0;
+        } else if (arg == "--runs" && hasValue) {
+            options.runs = args[++i].toInt(&ok);
+            ok = ok && options.runs > 0;
+        } else if (arg == "--jobs" && hasValue) {
+            options.jobs = args[++i].toInt(&ok);
+            ok = ok && options.jobs > 0;
+        } else if (!arg.startsWith("--") && options.fileName.isEmpty()) {
+            options.fileName = arg;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return !options.fileName.isEmpty();
+}
+
+//BEGIN Simulation
+// One test run: a context with the strategies of the Scene.
+class Simulation
+{
+    public:
+        Simulation()
+            : m_context()
+            , m_bulloStrategy(&m_context)
+            , m_discoverageStrategy(&m_context, &m_bulloStrategy)
+            , m_minDistStrategy(&m_context, &m_bulloStrategy)
+            , m_randomStrategy(&m_context)
+            , m_maxAreaStrategy(&m_context)
+            , m_ruffinsStrategy(&m_context)
+        {
+            // nothing is displayed
+            m_context.config().setRenderingEnabled(false);
+        }
+
+        SimulationContext& context()
+        { return m_context; }
+
+        // same as MainWindow::loadScene(), returns the tool saved in the scene or -1
+        int load(const QString& fileName);
+
+        // strategy for the index of the tool combo box, 0 if it is no strategy
+        Strategy* strategy(int toolIndex);
+
+        // load the scene and prepare the robots for a test run
+        bool prepare(const BatchOptions& options, int strategy, const qreal* range);
+
+    private:
+        SimulationContext m_context;
+        DisCoverageBulloStrategy m_bulloStrategy;
+        DisCoverageStrategy m_discoverageStrategy;
+        MinDistStrategy m_minDistStrategy;
+        RandomStrategy m_randomStrategy;
+        MaxAreaStrategy m_maxAreaStrategy;
+        RuffinsStrategy m_ruffinsStrategy;
+};
+
+int Simulation::load(const QString& fileName)
+{
+    QSettings config(fileName, QSettings::IniFormat);
+    QSettings::Status status = config.status();
+    if (status != QSettings::NoError) {
+        fprintf(stderr, "Cannot read scene: %s\n", qPrintable(fileName));
+        return -1;
+    }
+
+    const int version = config.value("general/version", -1).toInt();
+    if (version != 1) {
+        fprintf(stderr, "Unknown version in file, aborting: %s\n", qPrintable(fileName));
+        return -1;
+    }
+
+    // one configChanged() for the whole scene. The vector field is only
+    // displayed, so it is not computed.
+    Config& c = m_context.config();
+    c.begin();
+    m_context.load(config);
+    m_minDistStrategy.load(config);
+    m_discoverageStrategy.load(config);
+    m_bulloStrategy.load(config);
+    c.load(config);
+    c.setShowVectorField(false);
+    c.end();
+
+    return config.value("tool-handler/tool", 0).toInt();
+}
+
+Strategy* Simulation::strategy(int toolIndex)
+{
+    switch (toolIndex) {
+        case 5: return &m_discoverageStrategy;
+        case 6: return &m_minDistStrategy;
+        case 7: return &m_bulloStrategy;
+        case 8: return &m_randomStrategy;
+        case 9: return &m_maxAreaStrategy;
+        case 10: return &m_ruffinsStrategy;
+        default: return 0;
+    }
+}
+
+static void setRobotCount(RobotManager& manager, int count)
+{
+    while (manager.count() > count) {
+        manager.removeRobot();
+    }
+
+    // new robots have the dynamics and sensing range of the first one
+    while (manager.count() < count) {
+        const Robot::Dynamics dynamics = manager.count() ? manager.robot(0)->type() : Robot::Unicycle;
+        manager.addRobot(dynamics);
+        if (manager.count() > 1) {
+            manager.robot(manager.count() - 1)->setSensingRange(manager.robot(0)->sensingRange());
+        }
+    }
+}
+
+bool Simulation::prepare(const BatchOptions& options, int strategy, const qreal* range)
+{
+    if (load(options.fileName) < 0) {
+        return false;
+    }
+
+    if (options.robotCount > 0) {
+        setRobotCount(m_context.robotManager(), options.robotCount);
+    }
+
+    RobotManager& manager = m_context.robotManager();
+    for (int i = 0; i < manager.count(); ++i) {
+        if (range) manager.robot(i)->setSensingRange(*range);
+    }
+
+    m_context.setStrategy(this->strategy(strategy));
+    return m_context.strategy() != 0;
+}
+//END Simulation
+
+//BEGIN TestRunTask
+// Status line of a batch, shared by the test runs of all threads
+class BatchProgress
+{
+    public:
+        BatchProgress(int runs)
+            : m_runs(runs)
+            , m_completed(0)
+        {
+            m_start.start();
+        }
+
+        void runCompleted()
+        {
+            QMutexLocker lock(&m_mutex);
+            ++m_completed;
+
+            QTime tAll = m_start.addMSecs((m_runs * m_start.elapsed()) / m_completed);
+            fprintf(stdout, "\r[INFO] completed run %d of %d, completion at: %s   ",
+                    m_completed, m_runs, qPrintable(tAll.toString("hh:mm")));
+            fflush(stdout);
+        }
+
+    private:
+        QMutex m_mutex;
+        QTime m_start;
+        int m_runs;
+        int m_completed;
+};
+
+// same as one iteration of Statistics::oneBatchRun()
+class TestRunTask : public QRunnable
+{
+    public:
+        TestRunTask(const BatchOptions& options, int strategy, const qreal* range,
+                    int run, BatchStatistics* statistics, BatchProgress* progress)
+            : m_options(options)
+            , m_strategy(strategy)
+            , m_range(range)
+            , m_run(run)
+            , m_statistics(statistics)
+            , m_progress(progress)
+        {}
+
+        virtual void run()
+        {
+            Simulation simulation;
+            if (!simulation.prepare(m_options, m_strategy, m_range)) {
+                return;
+            }
+
+            SimulationContext& context = simulation.context();
+            GridMap& map = context.map();
+
+            // reproducible random numbers, depending on the run only
+            qsrand(1 + m_run);
+
+            m_statistics->beginRun();
+
+            // all robots start at the same random position
+            const QPointF commonPoint = BatchStatistics::randomRobotPos(map, 0);
+            RobotManager& manager = context.robotManager();
+            for (int i = 0; i < manager.count(); ++i) {
+                manager.robot(i)->setPosition(commonPoint);
+            }
+
+            // caches for the start positions, as after Scene::selectTool()
+            context.postProcess();
+
+            // do one run
+            while (map.explorationProgress() < 1.0) {
+                context.tick();
+                m_statistics->recordIteration(map.robots(), map.explorationProgress());
+            }
+
+            m_progress->runCompleted();
+        }
+
+    private:
+        const BatchOptions& m_options;
+        int m_strategy;
+        const qreal* m_range;
+        int m_run;
+        BatchStatistics* m_statistics;
+        BatchProgress* m_progress;
+};
+//END TestRunTask
+
+// same as Statistics::oneBatchRun()
+static void batchRun(QThreadPool& pool, const BatchOptions& options, int strategy, const qreal* range)
+{
+    // one statistics per run, merged in the order of the runs
+    QVector<BatchStatistics> runStatistics(options.runs);
+    BatchProgress progress(options.runs);
+
+    for (int run = 0; run < options.runs; ++run) {
+        pool.start(new TestRunTask(options, strategy, range, run, &runStatistics[run], &progress));
+    }
+    pool.waitForDone();
+    fprintf(stdout, "\n");
+
+    BatchStatistics statistics;
+    foreach (const BatchStatistics& s, runStatistics) {
+        statistics.addRuns(s);
+    }
+    statistics.finish();
+
+    // the export needs the robots and the map of the batch
+    Simulation simulation;
+    if (!simulation.prepare(options, strategy, range)) {
+        fprintf(stderr, "Strategy %d is no exploration strategy, skipped\n", strategy);
+        return;
+    }
+
+    QString baseName = options.fileName;
+    if (baseName.endsWith(".scene")) {
+        baseName.chop(6);
+    }
+    statistics.exportStatistics(baseName, simulation.context().strategy()->name(), simulation.context().map());
+}
+
+// same as Statistics::startStopBatchProcess()
+static int runBatches(BatchOptions options)
+{
+    int sceneTool = -1;
+    {
+        Simulation simulation;
+        sceneTool = simulation.load(options.fileName);
+    }
+    if (sceneTool < 0) {
+        return 1;
+    }
+
+    if (options.strategies.isEmpty()) {
+        options.strategies.append(sceneTool);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(options.jobs);
+
+    // the test runs already use all cores, so the robots of a run do not
+    // share the global thread pool
+    RobotTask::setParallel(options.jobs == 1);
+
+    foreach (int strategy, options.strategies) {
+        if (options.ranges.isEmpty()) {
+            // no range specified -> do not touch
+            batchRun(pool, options, strategy, 0);
+        } else {
+            foreach (qreal range, options.ranges) {
+                batchRun(pool, options, strategy, &range);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    BatchOptions options;
+    if (!parseArguments(app.arguments(), options)) {
+        printUsage();
+        return 1;
+    }
+
+    return runBatches(options);
+}
+
+// kate: replace-tabs on; indent-width 4;
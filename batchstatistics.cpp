@@ -0,0 +1,477 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "batchstatistics.h"
+#include "gridmap.h"
+#include "robot.h"
+#include "tikzexport.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QtAlgorithms>
+
+//BEGIN Stats, TestRun, BoxPlotItem
+Stats::Stats()
+    : iteration(0)
+    , percentExplored(0.0)
+    , percentUnemployed(0.0)
+{
+}
+
+TestRun::TestRun()
+    : testRun(0)
+    , stats()
+{
+}
+
+int TestRun::iterationForPercentExplored(qreal percent) const
+{
+    for (int i = 0; i < stats.size(); ++i) {
+        if (stats[i].percentExplored >= percent)
+            return i;
+    }
+
+    return stats.size();
+}
+
+BoxPlotItem::BoxPlotItem()
+{
+    minimum = 0;
+    lowerQuartile = 0;
+    median = 0;
+    upperQuartile = 0;
+    maximum = 0;
+}
+//END
+
+//BEGIN BatchStatistics
+BatchStatistics::BatchStatistics()
+{
+}
+
+void BatchStatistics::clear()
+{
+    m_testRuns.clear();
+    m_boxPlot.clear();
+}
+
+void BatchStatistics::beginRun()
+{
+    m_testRuns.append(TestRun());
+    m_testRuns.last().testRun = m_testRuns.size();
+}
+
+void BatchStatistics::recordIteration(const QVector<Robot*>& robots, qreal progress)
+{
+    if (m_testRuns.isEmpty()) {
+        return;
+    }
+
+    qreal unemployed = 0.0;
+    const int count = robots.size();
+    if (progress < 1.0) { // only count as unemployed, if exploration is not finished
+        for (int i = 0; i < count; ++i) {
+            if (robots[i]->stats().isUnemployed())
+                unemployed += 1;
+        }
+        unemployed /= count;
+    }
+
+    QVector<Stats>& stats = m_testRuns.last().stats;
+    stats.append(Stats());
+    stats.last().iteration = stats.size();
+    stats.last().percentExplored = progress;
+    stats.last().percentUnemployed = unemployed;
+}
+
+void BatchStatistics::addRuns(const BatchStatistics& other)
+{
+    foreach (const TestRun& run, other.m_testRuns) {
+        m_testRuns.append(run);
+        m_testRuns.last().testRun = m_testRuns.size();
+    }
+}
+
+int BatchStatistics::runCount() const
+{
+    return m_testRuns.size();
+}
+
+void BatchStatistics::finish()
+{
+    int maxIterations = 0;
+    for (int run = 0; run < m_testRuns.size(); ++run) {
+        maxIterations = qMax(maxIterations, m_testRuns[run].stats.size());
+    }
+
+    m_boxPlot.resize(maxIterations);
+    for (int it = 0; it < maxIterations; ++it) {
+        QVector<qreal> percentExploredList = percentList(it);
+        const int count = percentExploredList.size();
+        Q_ASSERT(count > 0);
+
+        m_boxPlot[it].minimum = percentExploredList.first();
+        m_boxPlot[it].maximum = percentExploredList.last();
+        m_boxPlot[it].median = percentExploredList[count * 0.5];
+        m_boxPlot[it].lowerQuartile = percentExploredList[count * 0.25];
+        m_boxPlot[it].upperQuartile = percentExploredList[count * 0.75];
+    }
+}
+
+const QVector<BoxPlotItem>& BatchStatistics::boxPlot() const
+{
+    return m_boxPlot;
+}
+
+qreal BatchStatistics::meanProgress(int iteration) const
+{
+    const int N = m_testRuns.size();
+    qreal meanExplored = 0.0;
+    for (int i = 0; i < N; ++i) {
+        qreal explored = 1.0;
+        if (iteration < m_testRuns[i].stats.size()) {
+            explored = m_testRuns[i].stats[iteration].percentExplored;
+        }
+        meanExplored += explored;
+    }
+    return meanExplored / N;
+}
+
+qreal BatchStatistics::varianceProgress(int iteration) const
+{
+    const qreal mean = meanProgress(iteration);
+
+    const int N = m_testRuns.size();
+    qreal variance = 0.0;
+    for (int i = 0; i < N; ++i) {
+        qreal explored = 1.0;
+        if (iteration < m_testRuns[i].stats.size()) {
+            explored = m_testRuns[i].stats[iteration].percentExplored;
+        }
+        variance += (explored - mean) * (explored - mean);
+    }
+    return variance / N;
+}
+
+qreal BatchStatistics::meanUnemployed(int iteration) const
+{
+    const int N = m_testRuns.size();
+    qreal meanUnemployed = 0.0;
+    for (int i = 0; i < N; ++i) {
+        qreal unemployed = 0.0;
+        if (iteration < m_testRuns[i].stats.size()) {
+            unemployed = m_testRuns[i].stats[iteration].percentUnemployed;
+        }
+        meanUnemployed += unemployed;
+    }
+    return meanUnemployed / N;
+}
+
+qreal BatchStatistics::varianceUnemployed(int iteration) const
+{
+    const qreal mean = meanUnemployed(iteration);
+
+    const int N = m_testRuns.size();
+    qreal variance = 0.0;
+    for (int i = 0; i < N; ++i) {
+        qreal unemployed = 1.0;
+        if (iteration < m_testRuns[i].stats.size()) {
+            unemployed = m_testRuns[i].stats[iteration].percentUnemployed;
+        }
+        variance += (unemployed - mean) * (unemployed - mean);
+    }
+    return variance / N;
+}
+
+void BatchStatistics::statsForPercentExplored(qreal percent, qreal & meanIteration, qreal & stdDeviation) const
+{
+    meanIteration = 0;
+    stdDeviation = 0;
+
+    const int N = m_testRuns.size();
+
+    if (N < 2) return;
+
+    // calculate mean
+    for (int i = 0; i < N; ++i) {
+        meanIteration += m_testRuns[i].iterationForPercentExplored(percent);
+    }
+    meanIteration /= N;
+
+    // calculate variance
+    for (int i = 0; i < N; ++i) {
+        qreal it = m_testRuns[i].iterationForPercentExplored(percent);
+        stdDeviation += (it - meanIteration) * (it - meanIteration);
+    }
+
+    // empirical standard deviation
+    stdDeviation =  sqrt(stdDeviation / (N - 1));
+}
+
+QVector<qreal> BatchStatistics::percentList(int iteration) const
+{
+    QVector<qreal> vec;
+    for (int run = 0; run < m_testRuns.size(); ++run) {
+        if (iteration < m_testRuns[run].stats.size()) {
+            vec.append(m_testRuns[run].stats[iteration].percentExplored);
+        } else {
+            vec.append(1.0);
+        }
+    }
+    qSort(vec.begin(), vec.end());
+    return vec;
+}
+
+QPointF BatchStatistics::randomRobotPos(GridMap& map, int robot)
+{
+    const QSizeF worldSize = map.worldSize();
+    while (true) {
+        const QPointF worldPos((qrand() * worldSize.width()) / RAND_MAX,
+                               (qrand() * worldSize.height()) / RAND_MAX);
+        const QPoint cellIndex = map.worldToIndex(worldPos);
+
+        // make sure cell is valid and no obstacle
+        if (!map.isValidField(cellIndex) ||
+            map.cell(cellIndex).isObstacle())
+        {
+            continue;
+        }
+
+        // Ruffin's Bookmark
+        // make sure no other robots is in the same cell
+        for (int i = 0; i < robot; ++i) {
+            const QPoint robotIndex = map.worldToIndex(
+                    map.robots()[i]->position());
+            if (robotIndex == cellIndex)
+                continue;
+        }
+
+        return worldPos;
+    }
+}
+
+inline static bool inCircle(qreal cellX, qreal cellY, qreal radius)
+{
+    return (cellX * cellX + cellY * cellY) <= radius*radius;
+}
+
+static int cellCountInCircle(qreal radius, qreal resolution)
+{
+    // compute amount of cells in one quadrant of the circle centered at (0, 0)
+    int cellCount = 0;
+    const int maxCellCount = ceil(radius / resolution);
+    for (int a = -maxCellCount; a < maxCellCount; ++a) {
+            const qreal startX = a * resolution - resolution / 2.0;
+            const qreal endX = (a + 1) * resolution - resolution / 2.0;
+        for (int b = -maxCellCount; b < maxCellCount; ++b) {
+            const qreal startY = b * resolution - resolution / 2.0;
+            const qreal endY = (b + 1) * resolution - resolution / 2.0;
+
+            // cell contained in circle?
+            if (inCircle(startX, startY, radius) &&
+                inCircle(startX, endY, radius) &&
+                inCircle(endX, startY, radius) &&
+                inCircle(endX, endY, radius))
+                ++cellCount;
+        }
+    }
+    return cellCount;
+}
+
+void BatchStatistics::exportStatistics(const QString& sceneBaseName, const QString& strategyName, GridMap& map)
+{
+    if (!m_boxPlot.size()) return;
+
+    // create paths to export
+    QVector<QPointF> minPath;
+    QVector<QPointF> maxPath;
+    QVector<QPointF> medianPath;
+    QVector<QPointF> lowerPath;
+    QVector<QPointF> upperPath;
+    QVector<QPointF> unemployedPath;
+    for (int i = 0; i < m_boxPlot.size(); ++i) {
+        minPath.append(QPointF(i, 100*m_boxPlot[i].minimum));
+        maxPath.append(QPointF(i, 100*m_boxPlot[i].maximum));
+        medianPath.append(QPointF(i, 100*m_boxPlot[i].median));
+        lowerPath.append(QPointF(i, 100*m_boxPlot[i].lowerQuartile));
+        upperPath.append(QPointF(i, 100*m_boxPlot[i].upperQuartile));
+        unemployedPath.append(QPointF(i, meanUnemployed(i) * 100.0));
+    }
+
+    // create paths to fill
+    QVector<QPointF> minMaxPath = maxPath;
+    std::reverse(minMaxPath.begin(), minMaxPath.end());
+    minMaxPath = minPath + minMaxPath;
+
+    QVector<QPointF> lowUpPath = upperPath;
+    std::reverse(lowUpPath.begin(), lowUpPath.end());
+    lowUpPath = lowerPath + lowUpPath;
+
+    // compute time-optimal-case
+    const qreal res = map.resolution();
+    const qreal range = map.robots()[0]->sensingRange();
+    const int robotCount = map.robots().size();
+    const int totalCells = map.freeCellCount();
+    const int startCells = robotCount * cellCountInCircle(range, res);
+    const qreal cellsPerIteration = robotCount * 2.0 * floor(range / res);
+    const qreal percentPerIteration = cellsPerIteration / (totalCells - startCells);
+    const QPointF tocStart(0, (100.0 * startCells) / totalCells);
+    const QPointF tocEnd((1.0 - tocStart.y() / 100.0) / percentPerIteration, 100);
+
+    // export file name
+    QString fileName = sceneBaseName
+        + "-" + strategyName
+        + "-robots-" + QString::number(robotCount)
+        + "-range-" + QString::number(range)
+        + "-runs-" + QString::number(m_testRuns.size())
+        + "-statistics";
+
+    QString fileNametxt = fileName + ".txt";
+    fileName = fileName + ".tikz";
+
+    QFile file(fileNametxt);
+    if (file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QTextStream ts(&file);
+        qreal mean, sigma;
+        statsForPercentExplored(0.90, mean, sigma);
+        ts << "mean and variance of 90% :" << "\n";
+        ts << mean << " " << sigma << "\n";
+        statsForPercentExplored(0.95, mean, sigma);
+        ts << "mean and variance of 95% :" << "\n";
+        ts << mean << " " << sigma << "\n";
+        statsForPercentExplored(0.98, mean, sigma);
+        ts << "mean and variance of 98% :" << "\n";
+        ts << mean << " " << sigma << "\n";
+        statsForPercentExplored(1.00, mean, sigma);
+        ts << "mean and variance of 100% :" << "\n";
+        ts << mean << " " << sigma << "\n";
+    }
+    file.close();
+
+    file.setFileName(fileName);
+    if (file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QTextStream ts(&file);
+        QTikzPicture tikzPicture;
+        tikzPicture.setStream(&ts);
+
+        tikzPicture.begin("thick");
+
+        // plot data, scaled to 8cm
+        tikzPicture.newline(2);
+        tikzPicture.comment("plot data, scaled to 8cm");
+        tikzPicture.beginScope(QString("yscale=0.05, xscale=%1").arg(8.0 / m_boxPlot.size()));
+
+            tikzPicture.line(minMaxPath, "draw=orange, fill=orange!50");
+            tikzPicture.line(lowUpPath, "gray, densely dashed, fill=green!20");
+            tikzPicture.line(medianPath, "blue");
+            tikzPicture.line(unemployedPath, "densely dotted, magenta");
+
+            // time-optimal case
+            tikzPicture.line(tocStart, tocEnd, "black");
+
+            // draw grid
+            tikzPicture << QString("\\draw[densely dashed, thin, black, ystep=20, xstep=10, opacity=0.3] (0, 0) grid (%1, 100);").arg(m_boxPlot.size());
+
+            // axes
+            tikzPicture.newline();
+            tikzPicture.comment("axis lables");
+            for (int i = 0; i <= m_boxPlot.size(); i += m_boxPlot.size() >= 100 ? 20 : 10) {
+                tikzPicture << QString("\\node[below] at (%1, 0) {%1};\n").arg(i);
+            }
+
+            // mean and variance of 90%, 95% and 98% explored
+            qreal mean, sigma;
+            statsForPercentExplored(0.9, mean, sigma);
+            tikzPicture << QString("\\draw[|-|] (%1, 90) -- (%2, 90);\n").arg(mean - sigma).arg(mean + sigma);
+            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 90) {};\n").arg(mean);
+            tikzPicture.comment(QString("90: %1  +-  %2").arg(mean).arg(sigma));
+            statsForPercentExplored(0.95, mean, sigma);
+            tikzPicture << QString("\\draw[|-|] (%1, 95) -- (%2, 95);\n").arg(mean - sigma).arg(mean + sigma);
+            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 95) {};\n").arg(mean);
+            tikzPicture.comment(QString("95: %1  +-  %2").arg(mean).arg(sigma));
+            statsForPercentExplored(0.98, mean, sigma);
+            tikzPicture << QString("\\draw[|-|] (%1, 98) -- (%2, 98);\n").arg(mean - sigma).arg(mean + sigma);
+            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 98) {};\n").arg(mean);
+            tikzPicture.comment(QString("98: %1  +-  %2").arg(mean).arg(sigma));
+            statsForPercentExplored(1.0, mean, sigma);
+            tikzPicture << QString("\\draw[|-|] (%1, 100) -- (%2, 100);\n").arg(mean - sigma).arg(mean + sigma);
+            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 100) {};\n").arg(mean);
+            tikzPicture.comment(QString("100: %1  +-  %2").arg(mean).arg(sigma));
+
+        tikzPicture.endScope();
+
+        // axes lables
+        tikzPicture.newline(2);
+        tikzPicture.comment("axes lables");
+        tikzPicture.beginScope("yscale=0.05");
+
+            // y axis lables
+            tikzPicture.line(QPointF(0, 0), QPointF(0, 100));
+            tikzPicture << "\\node[left] at (0, 20) {20};\n";
+            tikzPicture << "\\node[left] at (0, 40) {40};\n";
+            tikzPicture << "\\node[left] at (0, 60) {60};\n";
+            tikzPicture << "\\node[left] at (0, 80) {80};\n";
+            tikzPicture << "\\node[left] at (0, 100) {100};\n";
+
+            tikzPicture << "\\node[rotate=90] at (-0.8, 50) {exploration progress in \\%};\n";
+
+            // x axis lables
+            tikzPicture.line(QPointF(0, 0), QPointF(8.5, 0), "->, >=stealth'");
+            tikzPicture << "\\node[below] at (8.5, 0) {it};\n";
+
+        tikzPicture.endScope();
+
+        // legend
+        tikzPicture.newline(2);
+        tikzPicture.comment("legend");
+        tikzPicture.beginScope("xshift=6cm, yshift=2.5cm");
+
+            tikzPicture << "\\draw[semithick, fill=white, fill opacity=0.8] (0, -0.65) rectangle +(2.5, 2.6);\n";
+            tikzPicture << "\\scriptsize\n";
+
+            tikzPicture << "\\draw[semithick,|-|] (0.2, -.4) -- +(0.28, 0) node[right, black] {$\\text{mean} \\pm \\sqrt{\\text{var}}$};\n";
+            tikzPicture << "\\node[semithick,draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (0.34, -0.4) {};\n";
+            tikzPicture << "\\draw (0.2, -.1) -- +(0.28, 0) node[right, black] {time-opt. case};\n";
+            tikzPicture << "\\draw[magenta, densely dotted] (0.2, 0.2) -- +(0.28, 0) node[right, black] {unemployed};\n";
+
+            tikzPicture << "\\fill[orange!50] (0.2, 0.5) rectangle +(0.28, 1.2);\n";
+            tikzPicture << "\\fill[green!20] (0.2, 0.8) rectangle +(0.28, 0.6);\n";
+
+            tikzPicture << "\\draw[orange] (0.2, 1.7) -- +(0.28, 0) node[right, black] {best case};\n";
+            tikzPicture << "\\draw[gray, densely dashed] (0.2, 1.4) -- +(0.28, 0) node[right, black] {median $+25\\%$};\n";
+            tikzPicture << "\\draw[blue] (0.2, 1.1) -- +(0.28, 0) node[right, black] {median};\n";
+            tikzPicture << "\\draw[gray, densely dashed] (0.2, 0.8) -- +(0.28, 0) node[right, black] {median $-25\\%$};\n";
+            tikzPicture << "\\draw[orange] (0.2, 0.5) -- +(0.28, 0) node[right, black] {worst case};\n";
+
+        tikzPicture.endScope();
+
+        tikzPicture.end();
+
+        file.close();
+    }
+}
+//END
+
+// kate: replace-tabs on; indent-width 4;
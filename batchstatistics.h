@@ -0,0 +1,121 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_BATCH_STATISTICS_H
+#define DISCOVERAGE_BATCH_STATISTICS_H
+
+#include <QtCore/QVector>
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+
+class GridMap;
+class Robot;
+
+class Stats
+{
+    public:
+        Stats();
+
+        int iteration;
+        qreal percentExplored; // [0; 1]
+        qreal percentUnemployed; // [0; 1]
+};
+
+class TestRun
+{
+    public:
+        TestRun();
+        int iterationForPercentExplored(qreal percent) const; // [0; 1]
+        int testRun;
+        QVector<Stats> stats;
+};
+
+class BoxPlotItem
+{
+    public:
+        BoxPlotItem();
+        qreal minimum;
+        qreal lowerQuartile;
+        qreal median;
+        qreal upperQuartile;
+        qreal maximum;
+};
+
+/**
+ * Exploration progress of a series of test runs with the same strategy and
+ * sensing range, and its TikZ export. Shared by the Statistics widget and
+ * the discoverage-batch tool, it neither paints nor uses widgets.
+ */
+class BatchStatistics
+{
+    public:
+        BatchStatistics();
+
+        // forget all test runs
+        void clear();
+
+        // start the next test run
+        void beginRun();
+
+        // record the state of robots after one iteration of the current test run
+        void recordIteration(const QVector<Robot*>& robots, qreal progress);
+
+        // append the test runs of other, e.g. of a batch run in another thread
+        void addRuns(const BatchStatistics& other);
+
+        int runCount() const;
+
+        // compute the box plots over all test runs
+        void finish();
+        const QVector<BoxPlotItem>& boxPlot() const;
+
+        qreal meanProgress(int iteration) const;
+        qreal varianceProgress(int iteration) const;
+        qreal meanUnemployed(int iteration) const;
+        qreal varianceUnemployed(int iteration) const;
+
+        /**
+         * Get the iteration (mean and variance) for which @p percent are explored.
+         * @param percent percent explored in inverval [0; 1]
+         */
+        void statsForPercentExplored(qreal percent, qreal & meanIteration, qreal & stdDeviation) const;
+
+        // sorted progress of all test runs in the given iteration
+        QVector<qreal> percentList(int iteration) const;
+
+        /**
+         * Write the box plots to sceneBaseName-strategy-robots-N-range-R-runs-M-statistics.tikz
+         * and the iterations for 90%, 95%, 98% and 100% progress to the .txt file
+         * of the same name. Uses the robots of map for the time-optimal case.
+         */
+        void exportStatistics(const QString& sceneBaseName, const QString& strategyName, GridMap& map);
+
+        // Random start position of robot, which is on a free cell. Uses
+        // qrand(), so each thread draws its own sequence, see qsrand().
+        static QPointF randomRobotPos(GridMap& map, int robot);
+
+    private:
+        QVector<TestRun> m_testRuns;
+        QVector<BoxPlotItem> m_boxPlot;
+};
+
+#endif // DISCOVERAGE_BATCH_STATISTICS_H
+
+// kate: replace-tabs on; indent-width 4;
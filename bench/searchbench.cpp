@@ -0,0 +1,501 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+// Benchmark of the open list implementations used by GridMap::frontierPaths()
+// and GridMap::aStar(), of the any-angle searches compared to a grid search
+// followed by Path::beautify(), of the HierarchicalPlanner compared to
+// GridMap::frontierPaths(), of the EikonalField distances compared to the
+// any-angle searches, and of the IncrementalPlanner compared to a full
+// GridMap::computeFrontierField() after each exploration step.
+// Before the scenes, the FastMath functions are compared to libm, with
+// their maximum error and timings.
+//
+// Usage: searchbench [file.scene ...]
+// Without arguments, all scenes in the save/ folder of the source tree are used.
+
+#include "gridmap.h"
+#include "config.h"
+#include "searchworkspace.h"
+#include "priorityqueue.h"
+#include "frontierfield.h"
+#include "eikonalfield.h"
+#include "frontiersegmentation.h"
+#include "incrementalplanner.h"
+#include "hierarchicalplanner.h"
+#include "fastmath.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtCore/QStringList>
+#include <QtCore/QTime>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static const int s_frontierRuns = 20;
+static const int s_aStarRuns = 200;
+static const int s_sampledFrontiers = 16;
+static const int s_explorationSteps = 20;
+static const double s_sensingRange = 1.0;
+static const int s_tileSize = 16;
+static const int s_mathValues = 1 << 20;
+static const int s_mathRuns = 20;
+
+static QList<QPoint> freeCells(GridMap& map)
+{
+    QList<QPoint> cells;
+    const QSize size = map.size();
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            if (map.cell(x, y).state() & Cell::Free)
+                cells.append(QPoint(x, y));
+        }
+    }
+    return cells;
+}
+
+// same random sequence for every queue type
+static QList<QPoint> sample(const QList<QPoint>& cells, int count, uint seed)
+{
+    QList<QPoint> result;
+    if (cells.isEmpty())
+        return result;
+
+    srand(seed);
+    for (int i = 0; i < count; ++i) {
+        result.append(cells[rand() % cells.size()]);
+    }
+    return result;
+}
+
+static void benchAnyAngle(GridMap& map, const QList<QPoint>& starts, const QList<Cell>& frontiers,
+                          const QList<QPoint>& goals)
+{
+    SearchWorkspace ws;
+    QTime time;
+
+    time.start();
+    double gridLength = 0.0;
+    foreach (const QPoint& start, starts) {
+        QList<Path> paths = map.frontierPaths(start, frontiers, &ws);
+        for (int i = 0; i < paths.size(); ++i) {
+            paths[i].beautify(map);
+            gridLength += paths[i].m_length;
+        }
+    }
+    const int gridTime = time.elapsed();
+
+    time.start();
+    double anyAngleLength = 0.0;
+    foreach (const QPoint& start, starts) {
+        foreach (const Path& path, map.anyAngleFrontierPaths(start, frontiers, -1.0f, &ws)) {
+            anyAngleLength += path.m_length;
+        }
+    }
+    const int anyAngleTime = time.elapsed();
+
+    printf("  %-14s frontierPaths+beautify %6d ms (length %.1f)   anyAngleFrontierPaths %6d ms (length %.1f)\n",
+           "any-angle", gridTime, gridLength, anyAngleTime, anyAngleLength);
+
+    time.start();
+    gridLength = 0.0;
+    for (int i = 0; i < s_aStarRuns; ++i) {
+        Path path = map.aStar(goals[2 * i], goals[2 * i + 1], &ws);
+        path.beautify(map);
+        gridLength += path.m_length;
+    }
+    const int aStarTime = time.elapsed();
+
+    time.start();
+    anyAngleLength = 0.0;
+    for (int i = 0; i < s_aStarRuns; ++i) {
+        anyAngleLength += map.thetaStar(goals[2 * i], goals[2 * i + 1], &ws).m_length;
+    }
+    const int thetaStarTime = time.elapsed();
+
+    printf("  %-14s aStar+beautify         %6d ms (length %.1f)   thetaStar             %6d ms (length %.1f)\n",
+           "", aStarTime, gridLength, thetaStarTime, anyAngleLength);
+}
+
+static void benchEikonal(GridMap& map, const QList<QPoint>& starts, const QList<Cell>& frontiers)
+{
+    // one seed set per frontier segment, or per frontier if the map has none
+    QList<QList<Cell> > seeds;
+    QList<Cell> targets;
+    foreach (const FrontierSegment& segment, map.frontierSegments()) {
+        seeds.append(segment.m_cells);
+        targets.append(segment.m_representative);
+    }
+    if (seeds.isEmpty()) {
+        foreach (const Cell& frontier, frontiers) {
+            seeds.append(QList<Cell>() << frontier);
+            targets.append(frontier);
+        }
+    }
+
+    SearchWorkspace ws;
+    QTime time;
+
+    time.start();
+    QList<EikonalField> fields;
+    foreach (const QList<Cell>& seedCells, seeds) {
+        fields.append(EikonalField());
+        map.computeEikonalField(fields.last(), seedCells);
+    }
+    const int buildTime = time.elapsed();
+
+    int anyAngleTime = 0;
+    int fieldTime = 0;
+    double ratio = 0.0;
+    int count = 0;
+
+    foreach (const QPoint& start, starts) {
+        time.start();
+        const QVector<PathSummary> summaries = map.anyAngleFrontierSummaries(start, targets, -1.0f, &ws);
+        anyAngleTime += time.elapsed();
+
+        const QPointF pos = map.cell(start).center();
+        time.start();
+        QVector<float> distances(fields.size());
+        for (int i = 0; i < fields.size(); ++i) {
+            distances[i] = fields[i].distance(pos);
+            fields[i].descent(pos);
+        }
+        fieldTime += time.elapsed();
+
+        // the field measures the distance to the nearest segment cell, the
+        // search the one to the representative, so the ratio is <= 1
+        for (int i = 0; i < fields.size(); ++i) {
+            if (summaries[i].m_reachable && summaries[i].m_cost > 0.0f && distances[i] >= 0.0f) {
+                ratio += distances[i] / summaries[i].m_cost;
+                ++count;
+            }
+        }
+    }
+
+    printf("  %-14s %d fields, build %6d ms   queries %6d ms (anyAngleFrontierSummaries %6d ms)   mean cost ratio %.3f\n",
+           "eikonal", fields.size(), buildTime, fieldTime, anyAngleTime, count ? ratio / count : 1.0);
+}
+
+static void benchHierarchical(GridMap& map, const QList<QPoint>& starts, const QList<Cell>& frontiers)
+{
+    SearchWorkspace ws;
+    QTime time;
+
+    time.start();
+    HierarchicalPlanner planner(&map, s_tileSize);
+    planner.update();
+    const int buildTime = time.elapsed();
+
+    int exactTime = 0;
+    int hierarchicalTime = 0;
+    double ratio = 0.0;
+    int count = 0;
+    int errors = 0;
+
+    foreach (const QPoint& start, starts) {
+        time.start();
+        map.frontierPaths(start, frontiers, &ws);
+        exactTime += time.elapsed();
+
+        time.start();
+        const QVector<float> distances = planner.distances(start, frontiers);
+        hierarchicalTime += time.elapsed();
+
+        // the hierarchical costs are upper bounds of the exact ones
+        for (int i = 0; i < frontiers.size(); ++i) {
+            const float exact = ws.cost(frontiers[i].linearIndex());
+            if (distances[i] < exact - 0.0001f * (1.0f + exact))
+                ++errors;
+            if (exact > 0.0f) {
+                ratio += distances[i] / exact;
+                ++count;
+            }
+        }
+    }
+
+    printf("  %-14s %d entrances, build %6d ms   distances %6d ms (frontierPaths %6d ms)   mean cost ratio %.3f   %d errors\n",
+           "hierarchical", planner.entranceCount(), buildTime, hierarchicalTime, exactTime,
+           count ? ratio / count : 1.0, errors);
+}
+
+static void benchIncremental(GridMap& map, const QList<QPoint>& cells)
+{
+    IncrementalPlanner planner(&map, IncrementalPlanner::ToSources);
+    planner.setSources(map.frontiers());
+    planner.update();
+
+    HierarchicalPlanner hierarchical(&map, s_tileSize);
+    hierarchical.update();
+    int hierarchicalTime = 0;
+    int rebuiltTiles = 0;
+
+    FrontierField field;
+    const QSize size = map.size();
+
+    int incrementalTime = 0;
+    int fullTime = 0;
+    int processed = 0;
+    int mismatches = 0;
+
+    QTime time;
+    foreach (const QPoint& pt, sample(cells, s_explorationSteps, 4)) {
+        map.exploreInRadius(map.cell(pt).center(), s_sensingRange, true);
+
+        time.start();
+        planner.setSources(map.frontiers());
+        planner.update();
+        incrementalTime += time.elapsed();
+        processed += planner.lastUpdateCount();
+
+        time.start();
+        map.computeFrontierField(field, map.frontiers());
+        fullTime += time.elapsed();
+
+        time.start();
+        hierarchical.update();
+        hierarchicalTime += time.elapsed();
+        rebuiltTiles += hierarchical.lastRebuildCount();
+
+        // both must yield the same path costs
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                const float expected = field.distance(QPoint(x, y));
+                if (qAbs(planner.distance(QPoint(x, y)) - expected) > 0.0001f * (1.0f + qAbs(expected)))
+                    ++mismatches;
+            }
+        }
+    }
+
+    printf("  %-14s %d exploration steps: update %6d ms (%d cells processed)   full search %6d ms   %d mismatches\n",
+           "incremental", s_explorationSteps, incrementalTime, processed, fullTime, mismatches);
+    printf("  %-14s %d exploration steps: tile rebuild %6d ms (%d tiles)\n",
+           "hierarchical", s_explorationSteps, hierarchicalTime, rebuiltTiles);
+}
+
+static void benchFastMath()
+{
+    QVector<float> x(s_mathValues);
+    QVector<float> y(s_mathValues);
+    QVector<float> result(s_mathValues);
+    QVector<float> reference(s_mathValues);
+    QTime time;
+
+    printf("FastMath (%s), %d values\n", FastMath::instructionSet(), s_mathValues);
+
+    // exp: relative error over the range that neither under- nor overflows
+    for (int i = 0; i < s_mathValues; ++i) {
+        x[i] = -87.0f + 175.5f * i / s_mathValues;
+    }
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        FastMath::exp(x.constData(), result.data(), s_mathValues);
+    }
+    int fastTime = time.elapsed();
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        for (int i = 0; i < s_mathValues; ++i) {
+            reference[i] = expf(x[i]);
+        }
+    }
+    int libmTime = time.elapsed();
+    double maxError = 0.0;
+    for (int i = 0; i < s_mathValues; ++i) {
+        const double exact = ::exp(static_cast<double>(x[i]));
+        maxError = qMax(maxError, qAbs(result[i] - exact) / exact);
+    }
+    printf("  %-14s %6d ms (libm %6d ms)   max relative error %.2g\n", "exp", fastTime, libmTime, maxError);
+
+    // log: error relative to max(1, |log(x)|), over the normal floats
+    for (int i = 0; i < s_mathValues; ++i) {
+        x[i] = ::exp(-80.0 + 160.0 * i / s_mathValues);
+    }
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        FastMath::log(x.constData(), result.data(), s_mathValues);
+    }
+    fastTime = time.elapsed();
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        for (int i = 0; i < s_mathValues; ++i) {
+            reference[i] = logf(x[i]);
+        }
+    }
+    libmTime = time.elapsed();
+    maxError = 0.0;
+    for (int i = 0; i < s_mathValues; ++i) {
+        const double exact = ::log(static_cast<double>(x[i]));
+        maxError = qMax(maxError, qAbs(result[i] - exact) / qMax(1.0, qAbs(exact)));
+    }
+    printf("  %-14s %6d ms (libm %6d ms)   max error %.2g\n", "log", fastTime, libmTime, maxError);
+
+    // atan2: absolute error for directions in all quadrants
+    srand(1);
+    for (int i = 0; i < s_mathValues; ++i) {
+        x[i] = 100.0f * rand() / RAND_MAX - 50.0f;
+        y[i] = 100.0f * rand() / RAND_MAX - 50.0f;
+    }
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        FastMath::atan2(y.constData(), x.constData(), result.data(), s_mathValues);
+    }
+    fastTime = time.elapsed();
+    time.start();
+    for (int run = 0; run < s_mathRuns; ++run) {
+        for (int i = 0; i < s_mathValues; ++i) {
+            reference[i] = atan2f(y[i], x[i]);
+        }
+    }
+    libmTime = time.elapsed();
+    maxError = 0.0;
+    for (int i = 0; i < s_mathValues; ++i) {
+        const double exact = ::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]));
+        maxError = qMax(maxError, qAbs(result[i] - exact));
+    }
+    printf("  %-14s %6d ms (libm %6d ms)   max absolute error %.2g\n", "atan2", fastTime, libmTime, maxError);
+
+    // the scalar versions must agree with the batch versions
+    int mismatches = 0;
+    for (int i = 0; i < s_mathValues; ++i) {
+        if (qAbs(FastMath::atan2(y[i], x[i]) - result[i]) > 1e-6f) {
+            ++mismatches;
+        }
+    }
+    printf("  %-14s %d mismatches between scalar and batch atan2\n", "", mismatches);
+}
+
+static void benchScene(const QString& fileName)
+{
+    QSettings config(fileName, QSettings::IniFormat);
+    if (config.value("general/version", 0).toInt() != 1) {
+        printf("%s: unsupported file version, skipped\n", qPrintable(fileName));
+        return;
+    }
+
+    GridMap map(0, 1.0, 1.0, 0.2);
+    map.load(config);
+
+    const QList<QPoint> cells = freeCells(map);
+    if (cells.isEmpty()) {
+        printf("%s: no free cells, skipped\n", qPrintable(fileName));
+        return;
+    }
+
+    QList<Cell> frontiers = map.frontiers();
+    if (frontiers.isEmpty()) {
+        foreach (const QPoint& pt, sample(cells, s_sampledFrontiers, 3)) {
+            frontiers.append(map.cell(pt));
+        }
+    }
+
+    const QList<QPoint> starts = sample(cells, s_frontierRuns, 1);
+    const QList<QPoint> goals = sample(cells, 2 * s_aStarRuns, 2);
+
+    printf("%s: %dx%d cells, %d free, %d frontiers\n",
+           qPrintable(QFileInfo(fileName).fileName()),
+           map.size().width(), map.size().height(), cells.size(), frontiers.size());
+
+    const PriorityQueue::Type types[] = {
+        PriorityQueue::Multiset,
+        PriorityQueue::IndexedHeap,
+        PriorityQueue::RadixBucket
+    };
+
+    for (int t = 0; t < 3; ++t) {
+        PriorityQueue::setDefaultType(types[t]);
+        SearchWorkspace ws;
+
+        QTime time;
+        time.start();
+        double frontierChecksum = 0.0;
+        foreach (const QPoint& start, starts) {
+            const QList<Path> paths = map.frontierPaths(start, frontiers, &ws);
+            foreach (const Path& path, paths) {
+                frontierChecksum += path.m_cost;
+            }
+        }
+        const int frontierTime = time.elapsed();
+
+        time.start();
+        double aStarChecksum = 0.0;
+        for (int i = 0; i < s_aStarRuns; ++i) {
+            const Path path = map.aStar(goals[2 * i], goals[2 * i + 1], &ws);
+            aStarChecksum += path.m_cost;
+        }
+        const int aStarTime = time.elapsed();
+
+        time.start();
+        double nearestChecksum = 0.0;
+        foreach (const QPoint& start, starts) {
+            const QList<Path> paths = map.nearestFrontierPaths(start, frontiers, 1, -1.0f, &ws);
+            if (!paths.isEmpty()) {
+                nearestChecksum += paths.first().m_cost;
+            }
+        }
+        const int nearestTime = time.elapsed();
+
+        printf("  %-14s frontierPaths %6d ms (checksum %.1f)   aStar %6d ms (checksum %.1f)   nearest frontier %6d ms (checksum %.1f)\n",
+               PriorityQueue::typeName(types[t]),
+               frontierTime, frontierChecksum, aStarTime, aStarChecksum, nearestTime, nearestChecksum);
+    }
+
+    benchAnyAngle(map, starts, frontiers, goals);
+    benchEikonal(map, starts, frontiers);
+    benchHierarchical(map, starts, frontiers);
+
+    // modifies the map, so it runs last
+    benchIncremental(map, cells);
+}
+
+int main(int argc, char* argv[])
+{
+    // only links the core library, so neither QtGui nor a display is needed
+    QCoreApplication app(argc, argv);
+
+    Config::self();
+
+    QStringList files;
+    for (int i = 1; i < argc; ++i) {
+        files.append(QString::fromLocal8Bit(argv[i]));
+    }
+
+    if (files.isEmpty()) {
+        QDir dir(DISCOVERAGE_SAVE_DIR);
+        foreach (const QString& file, dir.entryList(QStringList() << "*.scene", QDir::Files, QDir::Name)) {
+            files.append(dir.absoluteFilePath(file));
+        }
+    }
+
+    benchFastMath();
+
+    const PriorityQueue::Type defaultType = PriorityQueue::defaultType();
+    foreach (const QString& file, files) {
+        benchScene(file);
+    }
+    PriorityQueue::setDefaultType(defaultType);
+
+    delete Config::self();
+
+    return 0;
+}
+
+// kate: replace-tabs on; indent-width 4;
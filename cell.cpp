@@ -17,153 +17,28 @@
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 
-#define _USE_MATH_DEFINES 
-#include <math.h>
+#include "gridmap.h"
 
-#include "scene.h"
-#include "tikzexport.h"
-
-#include <QtGui/QPainter>
-#include <QtGui/QBrush>
 #include <QtCore/QDataStream>
 
-//BEGIN helpers
-QColor Cell::densityToColor(float density)
-{
-    const float sat = density == 0 ? 0.0 : 0.5;
-    const float val = 1.0;
-    float tmp = sqrt(-logf(density)) / 10;
-    const float hue = tmp;
-
-    return QColor::fromHsvF(hue, sat, val);
-}
-//END
-
-Cell::Cell()
-    : m_pathState(PathNone)
-    , m_pathParent(-1)
-    , m_rect()
-    , m_state(static_cast<State>(Free | Unknown))
-    , m_gradient(0, 0)
-    , m_robot(0)
-    , m_costF(0.0)
-    , m_costG(0.0)
-    , m_density(1.0)
-    , m_frontierDist(0.0)
-    , m_robotDist(0.0)
-{
-}
-
-Cell::Cell(const QRectF& rect)
-    : m_pathState(PathNone)
-    , m_pathParent(-1)
-    , m_rect(rect)
-    , m_state(static_cast<State>(Free | Unknown))
-    , m_gradient(0, 0)
-    , m_robot(0)
-    , m_costF(0.0)
-    , m_costG(0.0)
-    , m_density(1.0)
-    , m_frontierDist(0.0)
-    , m_robotDist(0.0)
-{
-}
-
-void Cell::setRect(const QRectF& rect)
-{
-    m_rect = rect;
-    m_center = rect.center();
-}
-
-void Cell::setIndex(const QPoint& index)
-{
-    m_index = index;
-}
-
-const QPoint& Cell::index() const
-{
-    return m_index;
-}
-
-void Cell::draw(QPainter& p, bool showDensity, bool showGradient)
-{
-    static QBrush sBrushFrontier = QBrush(QColor(255, 127, 0, 255));
-    static QBrush sBrushExplored = QBrush(QColor(255, 255, 255, 0));
-
-    static QBrush sBrushExploredObstacle = QBrush(QColor(127, 127, 127));
-    static QBrush sBrushUnexploredObstacle = QBrush(QColor(Qt::gray));
-    static QBrush sBrushFree = QBrush(QColor(255, 255, 255));
-
-    p.setPen(Qt::NoPen);
-    p.setBrush(Qt::NoBrush);
-    if (m_state & Free) {
-        p.fillRect(m_rect, sBrushFree);
-    } else {
-        p.fillRect(m_rect, (m_state & Explored) ? sBrushExploredObstacle : sBrushUnexploredObstacle);
-    }
-
-    if (m_state & Unknown) {
-        p.setPen(Qt::gray);
-        p.drawRect(m_rect);
-    } else if (m_state & Frontier) {
-        p.setBrush(sBrushFrontier);
-        p.setPen(Qt::gray);
-        p.drawRect(m_rect);
-    } else if (!(m_state & Obstacle)) { // m_state & Explored
-        if (showDensity) {
-            p.fillRect(m_rect, densityToColor(m_density));
-        } else {
-            p.setPen(Qt::white);
-            p.setBrush(sBrushFree);
-            p.drawRect(m_rect);
-        }
-
-        if (showGradient && !m_gradient.isNull()) {
-            // Draw the arrows
-            double angle = ::acos(m_gradient.x() / sqrt(m_gradient.x()*m_gradient.x() + m_gradient.y()*m_gradient.y()));
-            if (m_gradient.y() >= 0)
-                angle = 2 * M_PI - angle;
-
-            qreal arrowSize = m_rect.width() / 2.0;
-            
-            QPointF src = center() - m_gradient * m_rect.width() / 4.0;
-            QPointF dst = center() + m_gradient * m_rect.width() / 4.0;
-
-            QPointF destArrowP1 = dst + QPointF(sin(angle - M_PI / 3) * arrowSize/2,
-                                                     cos(angle - M_PI / 3) * arrowSize/2);
-            QPointF destArrowP2 = dst + QPointF(sin(angle - M_PI + M_PI / 3) * arrowSize/2,
-                                                     cos(angle - M_PI + M_PI / 3) * arrowSize/2);
-
-            p.setRenderHints(QPainter::Antialiasing, true);
-            p.setPen(Qt::black);
-            p.drawLine(src, dst);
-            p.drawPolyline(QPolygonF() << destArrowP1 << dst << destArrowP2);
-            p.setRenderHints(QPainter::Antialiasing, false);
-        }
-    }
-}
-
-const QRectF& Cell::rect() const
-{
-    return m_rect;
-}
-
-void Cell::setState(State newState)
+Cell::State Cell::mergeState(State oldState, State newState)
 {
+    State state = oldState;
     if (newState & 0x3) {
-        m_state = (m_state & 0x1C) | newState; // 1C = 28 = 111|00
-        if ((newState & Obstacle) && (m_state & Frontier)) {
-            m_state = (m_state & 0x3) | Unknown;
+        state = (state & 0x1C) | newState; // 1C = 28 = 111|00
+        if ((newState & Obstacle) && (state & Frontier)) {
+            state = (state & 0x3) | Unknown;
         }
     }
 
     if (newState & 0x1C) {
-        if ((newState & Frontier) && (m_state & Obstacle)) {
-            m_state = (m_state & 0x3) | Explored;
+        if ((newState & Frontier) && (state & Obstacle)) {
+            state = (state & 0x3) | Explored;
         } else {
-            m_state = (m_state & 0x3) | newState;
+            state = (state & 0x3) | newState;
         }
     }
+    return state;
 }
 
 QDataStream& Cell::load(QDataStream& ds)
@@ -172,15 +47,14 @@ QDataStream& Cell::load(QDataStream& ds)
     QRectF r;
 
     ds >> s;
-    ds >> r;
+    ds >> r; // the cell rect is derived from the index, kept for file compatibility
 
-    setState((Cell::State)s);
-    setRect(r);
+    m_map->m_state[m_index] = mergeState(static_cast<State>(Free | Unknown), (Cell::State)s);
 
     return ds;
 }
 
-QDataStream& Cell::save(QDataStream& ds)
+QDataStream& Cell::save(QDataStream& ds) const
 {
     ds << qint32(state());
     ds << rect();
@@ -188,33 +62,4 @@ QDataStream& Cell::save(QDataStream& ds)
     return ds;
 }
 
-void Cell::exportToTikz(QTikzPicture& tp, bool fillDensity, bool exportGradient)
-{
-    if (m_state & Frontier) { // frontiers
-        tp.path(m_rect, "fill=colFrontier, draw=colBorder");
-    } else if (m_state & Obstacle) {
-        if (m_state & Explored) {
-            tp.path(m_rect, "fill=colExploredObstacle, draw=colBorder");
-        } else {
-            tp.path(m_rect, "fill=colUnexploredObstacle, draw=colBorder");
-        }
-    } else {
-        if (m_state & Unknown) {
-            tp.path(m_rect, "draw=colBorder");
-        } else {
-            if (fillDensity) {
-                QColor color = densityToColor(m_density);
-                QString strColor = tp.registerColor(color);
-                tp.path(m_rect, "fill=" + strColor + ", draw=" + strColor);
-            }
-        }
-    }
-
-    if (exportGradient && !m_gradient.isNull()) {
-        QPointF src = center() - m_gradient * m_rect.width() / 3.5;
-        QPointF dst = center() + m_gradient * m_rect.width() / 3.5;
-        tp.line(src, dst, "->");
-    }
-}
-
 // kate: replace-tabs on; indent-width 4;
@@ -21,14 +21,23 @@
 #define CELL_H
 
 #include <QRectF>
-#include <QColor>
 #include <QDebug>
 
 class QDataStream;
-class QPainter;
-class QTikzPicture;
 class Robot;
-
+class GridMap;
+
+/**
+ * A Cell is a lightweight handle into the GridMap. The GridMap stores all
+ * cell data in flat, row-major planes (one entry per cell), and the Cell
+ * only references the owning map and the linear index of the cell.
+ * Geometry (rect, center, index) is computed from the linear index.
+ *
+ * Cells are cheap to copy and are passed around by value. A handle stays
+ * valid as long as the GridMap is not resized (e.g. through GridMap::load()).
+ *
+ * Drawing and TikZ export of cells is done by the GridMapView.
+ */
 class Cell
 {
     friend class GridMap;
@@ -44,144 +53,108 @@ class Cell
             Explored = 1 << 4  // 16
         };
 
-    static QColor densityToColor(float density);
-
     public:
-        Cell();
-        Cell(const QRectF& rect);
-
-        const QPoint& index() const;
+        inline Cell();
+        inline Cell(GridMap* map, int linearIndex);
 
-        void setRect(const QRectF& rect);
+        inline bool isValid() const;
+        inline GridMap* map() const;
+        inline int linearIndex() const;         // row-major index: y * width + x
 
-        void draw(QPainter& p, bool showDensity, bool showGradient);
+        inline QPoint index() const;
 
-        const QRectF& rect() const;
-        inline const QPointF& center() const
-        { return m_center; }
+        inline QRectF rect() const;
+        inline QPointF center() const;
 
-        inline bool isObstacle() const
-        { return m_state & Obstacle; }
+        inline bool isObstacle() const;
 
-        inline State state() const
-        { return m_state; }
+        inline State state() const;
 
         // get density
-        inline float density() const
-        { return m_density; }
+        inline float density() const;
 
         // set density
-        inline void setDensity(float density)
-        { m_density = density; }
+        inline void setDensity(float density);
 
         // get gradient
-        inline QPointF gradient()  const
-        { return m_gradient; }
+        inline QPointF gradient()  const;
 
         // set gradient
-        inline void setGradient(const QPointF& gradient)
-        { m_gradient = gradient; }
+        inline void setGradient(const QPointF& gradient);
 
-        inline float frontierDist() const
-        { return m_frontierDist; }
+        inline float frontierDist() const;
+        inline void setFrontierDist(float dist);
 
-        inline void setFrontierDist(float dist)
-        { m_frontierDist = dist; }
+        inline Robot* robot() const;
 
-        inline Robot* robot() const
-        { return m_robot; }
+        inline float robotDist() const;
+        inline void setRobotDist(float dist);
 
-        inline void setRobot(Robot* robot)
-        { m_robot = robot; }
+        inline bool operator==(const Cell& other) const
+        { return m_index == other.m_index && m_map == other.m_map; }
 
-        inline float robotDist() const
-        { return m_robotDist; }
-
-        inline void setRobotDist(float dist)
-        { m_robotDist = dist; }
+        inline bool operator!=(const Cell& other) const
+        { return !(*this == other); }
 
     //
-    // load & save + export
+    // load & save
     //
     public:
         QDataStream& load(QDataStream& ds);
-        QDataStream& save(QDataStream& ds);
-
-        void exportToTikz(QTikzPicture& tp, bool fillDensity, bool exportGradient);
+        QDataStream& save(QDataStream& ds) const;
 
     //
     // path planning
     //
     public:
-        enum PathState {
-            PathNone = 0,
-            PathOpen,
-            PathClose
-        };
-        inline PathState pathState() const { return m_pathState; }
-        inline void setPathState(PathState state) { m_pathState = state; }
-        inline float cellCost() const {
+        inline float cellCost() const
+        { return cellCost(state()); }
+
+        static inline float cellCost(State state) {
             static int s_pathCost[] = {
-				0,		//  0: 0 0 0 | 0 0 ---
-				0,		//  1: 0 0 0 | 0 1 ---
-				0,		//  2: 0 0 0 | 1 0 ---
-				0,		//  3: 0 0 0 | 1 1 ---
-				0,		//  4: 0 0 1 | 0 0 ---
-				1000,	//  5: 0 0 1 | 0 1 unknown | obstacle
-				100,	//  6: 0 0 1 | 1 0 unknown | free
-				0,		//  7: 0 0 1 | 1 1 ---
-				0,		//  8: 0 1 0 | 0 0 ---
-				1,		//  9: 0 1 0 | 0 1 frontier | obstacle
-				1,		// 10: 0 1 0 | 1 0 frontier | free
-				0,		// 11: 0 1 0 | 1 1 ---
-				0,		// 12: 0 1 1 | 0 0 ---
-				0,		// 13: 0 1 1 | 0 1 ---
-				0,		// 14: 0 1 1 | 1 0 ---
-				0,		// 15: 0 1 1 | 1 1 ---
-				0,		// 16: 1 0 0 | 0 0 ---
-				1000000,// 17: 1 0 0 | 0 1 explored | obstacle
-				2,		// 18: 1 0 0 | 1 0 explored | free
-				0,		// 19: 1 0 0 | 1 1 ---
-				0,		// 20: 1 0 1 | 0 0 ---
-				0,		// 21: 1 0 1 | 0 1 ---
-				0,		// 22: 1 0 1 | 1 0 ---
-				0,		// 23: 1 0 1 | 1 1 ---
-				0,		// 24: 1 1 0 | 0 0 ---
-				0,		// 25: 1 1 0 | 0 1 ---
-				0,		// 26: 1 1 0 | 1 0 ---
-				0,		// 27: 1 1 0 | 1 1 ---
-				0,		// 28: 1 1 1 | 0 0 ---
-				0,		// 29: 1 1 1 | 0 1 ---
-				0,		// 30: 1 1 1 | 1 0 ---
-				0		// 31: 1 1 1 | 1 1 ---
+                0,      //  0: 0 0 0 | 0 0 ---
+                0,      //  1: 0 0 0 | 0 1 ---
+                0,      //  2: 0 0 0 | 1 0 ---
+                0,      //  3: 0 0 0 | 1 1 ---
+                0,      //  4: 0 0 1 | 0 0 ---
+                1000,   //  5: 0 0 1 | 0 1 unknown | obstacle
+                100,    //  6: 0 0 1 | 1 0 unknown | free
+                0,      //  7: 0 0 1 | 1 1 ---
+                0,      //  8: 0 1 0 | 0 0 ---
+                1,      //  9: 0 1 0 | 0 1 frontier | obstacle
+                1,      // 10: 0 1 0 | 1 0 frontier | free
+                0,      // 11: 0 1 0 | 1 1 ---
+                0,      // 12: 0 1 1 | 0 0 ---
+                0,      // 13: 0 1 1 | 0 1 ---
+                0,      // 14: 0 1 1 | 1 0 ---
+                0,      // 15: 0 1 1 | 1 1 ---
+                0,      // 16: 1 0 0 | 0 0 ---
+                1000000,// 17: 1 0 0 | 0 1 explored | obstacle
+                2,      // 18: 1 0 0 | 1 0 explored | free
+                0,      // 19: 1 0 0 | 1 1 ---
+                0,      // 20: 1 0 1 | 0 0 ---
+                0,      // 21: 1 0 1 | 0 1 ---
+                0,      // 22: 1 0 1 | 1 0 ---
+                0,      // 23: 1 0 1 | 1 1 ---
+                0,      // 24: 1 1 0 | 0 0 ---
+                0,      // 25: 1 1 0 | 0 1 ---
+                0,      // 26: 1 1 0 | 1 0 ---
+                0,      // 27: 1 1 0 | 1 1 ---
+                0,      // 28: 1 1 1 | 0 0 ---
+                0,      // 29: 1 1 1 | 0 1 ---
+                0,      // 30: 1 1 1 | 1 0 ---
+                0       // 31: 1 1 1 | 1 1 ---
             };
-//             qDebug() << m_state << s_pathCost[qint8(m_state)];
-            return s_pathCost[qint8(m_state)];
+            return s_pathCost[qint8(state)];
         }
 
     private:
-        PathState m_pathState;
-        int m_pathParent;
-
-    private:
-        void setState(State newState);
-        void setIndex(const QPoint& index);
+        // merge newState into oldState, see GridMap::setState()
+        static State mergeState(State oldState, State newState);
 
     private:
-        QRectF m_rect;
-        QPointF m_center;
-
-        State m_state;
-        QPoint m_index;
-        QPointF m_gradient;
-        Robot* m_robot;
-
-    public:
-        float m_costF;
-        float m_costG;
-        float m_density;
-        float m_frontierDist;
-        float m_robotDist;
+        GridMap* m_map;
+        int m_index;
 };
 
 inline Cell::State operator|(Cell::State state, int value)
@@ -0,0 +1,138 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "chamferpropagation.h"
+
+#include <limits>
+
+// neighbors visited before a cell in a forward sweep (top left to bottom
+// right); the backward sweep uses the negated offsets
+static const int s_causalMask[8][3] = {
+    // dx, dy, weight index
+    { -1,  0, 0 },
+    {  0, -1, 0 },
+    { -1, -1, 1 },
+    {  1, -1, 1 },
+    { -2, -1, 2 },
+    {  2, -1, 2 },
+    { -1, -2, 2 },
+    {  1, -2, 2 }
+};
+
+static inline int sgn(int val)
+{
+    return (0 < val) - (val < 0);
+}
+
+//BEGIN ChamferPropagation
+ChamferPropagation::ChamferPropagation(int width, int height, float step)
+    : m_width(width)
+    , m_height(height)
+    , m_infinity(std::numeric_limits<float>::infinity())
+    , m_flags(width * height, 0)
+    , m_distance(width * height, std::numeric_limits<float>::infinity())
+    , m_label(width * height, 0)
+{
+    // same rounding as the flood fills used before
+    m_weight[0] = step * 1.0;
+    m_weight[1] = step * 1.4142136;
+    m_weight[2] = step * 2.236068;
+}
+
+void ChamferPropagation::addSeed(int index, quint8 label)
+{
+    m_distance[index] = 0.0f;
+    m_label[index] = label;
+}
+
+int ChamferPropagation::propagate(bool withLabels, quint8 favoredLabel)
+{
+    int sweeps = 0;
+    bool changed = true;
+    while (changed) {
+        changed = sweep(1, withLabels, favoredLabel);
+        changed = sweep(-1, withLabels, favoredLabel) || changed;
+        sweeps += 2;
+    }
+    return sweeps;
+}
+
+bool ChamferPropagation::sweep(int direction, bool withLabels, quint8 favoredLabel)
+{
+    const int cellCount = m_width * m_height;
+    const int first = direction > 0 ? 0 : cellCount - 1;
+    const int end = direction > 0 ? cellCount : -1;
+
+    const quint8* flags = m_flags.constData();
+    float* distance = m_distance.data();
+    quint8* labels = m_label.data();
+
+    bool changed = false;
+    for (int index = first; index != end; index += direction) {
+        const quint8 flag = flags[index];
+        if (!(flag & (Passable | PassableForFavored)))
+            continue;
+
+        const int x = index % m_width;
+        const int y = index / m_width;
+
+        for (int i = 0; i < 8; ++i) {
+            const int dx = direction * s_causalMask[i][0];
+            const int dy = direction * s_causalMask[i][1];
+            const int ux = x + dx;
+            const int uy = y + dy;
+            if (ux < 0 || uy < 0 || ux >= m_width || uy >= m_height)
+                continue;
+
+            const int u = uy * m_width + ux;
+            const float candidate = distance[u] + m_weight[s_causalMask[i][2]];
+            if (!(candidate < distance[index]))
+                continue;
+
+            if (!(flag & Passable) && !(withLabels && labels[u] == favoredLabel))
+                continue;
+
+            // knight move from u: the two cells it passes must be transparent
+            if (s_causalMask[i][2] == 2) {
+                const int sx = -dx;
+                const int sy = -dy;
+                int ax, ay, bx, by;
+                if (qAbs(sx) == 2) {
+                    ax = ux + sgn(sx); ay = uy;
+                    bx = ax;           by = uy + sy;
+                } else {
+                    ax = ux;           ay = uy + sgn(sy);
+                    bx = ux + sx;      by = ay;
+                }
+                if (!(flags[ay * m_width + ax] & Transparent) || !(flags[by * m_width + bx] & Transparent))
+                    continue;
+            }
+
+            distance[index] = candidate;
+            if (withLabels) {
+                labels[index] = labels[u];
+            }
+            changed = true;
+        }
+    }
+    return changed;
+}
+//END ChamferPropagation
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,80 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_CHAMFER_PROPAGATION_H
+#define DISCOVERAGE_CHAMFER_PROPAGATION_H
+
+#include <QtCore/QVector>
+
+/**
+ * Geodesic distance propagation over a grid with forward/backward raster
+ * sweeps (chamfer distance transform).
+ *
+ * The 16-neighborhood of the GridMap is used, with the step lengths 1,
+ * sqrt(2) and sqrt(5) times the orthogonal step. A knight move is only
+ * possible if both cells it passes are Transparent. Each sweep only reads
+ * the neighbors already visited in the sweep direction, and sweeps repeat
+ * until no distance changes, so distances around obstacles converge to
+ * the same values a flood fill from the seeds yields.
+ *
+ * Optionally, labels are propagated along with the distances: each cell
+ * takes the label of the neighbor its distance comes from (e.g. the
+ * robot of a Voronoi partition).
+ */
+class ChamferPropagation
+{
+    public:
+        enum CellFlag {
+            Passable = 1,           // can be reached
+            PassableForFavored = 2, // can only be reached from cells with the favored label
+            Transparent = 4         // knight moves may pass this cell
+        };
+
+        ChamferPropagation(int width, int height, float step);
+
+        // flags of all cells, row-major, combination of CellFlag
+        inline QVector<quint8>& flags() { return m_flags; }
+
+        // mark index as a seed with distance 0
+        void addSeed(int index, quint8 label = 0);
+
+        // propagate the distances from the seeds, returns the number of sweeps
+        int propagate(bool withLabels = false, quint8 favoredLabel = 0);
+
+        // results, infinite distance for cells that cannot be reached
+        inline bool isReached(int index) const { return m_distance[index] != m_infinity; }
+        inline float distance(int index) const { return m_distance[index]; }
+        inline quint8 label(int index) const { return m_label[index]; }
+
+    private:
+        bool sweep(int direction, bool withLabels, quint8 favoredLabel);
+
+    private:
+        int m_width;
+        int m_height;
+        float m_infinity;
+        float m_weight[3];          // orthogonal, diagonal, knight
+        QVector<quint8> m_flags;
+        QVector<float> m_distance;
+        QVector<quint8> m_label;
+};
+
+#endif // DISCOVERAGE_CHAMFER_PROPAGATION_H
+
+// kate: replace-tabs on; indent-width 4;
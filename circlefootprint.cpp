@@ -0,0 +1,94 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "circlefootprint.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include <math.h>
+
+// Radii are quantized to 1/8 cell, so slightly different ranges (e.g. after
+// a division by the resolution) share one footprint. Half and quarter cells
+// are represented exactly.
+static const int s_radiusSteps = 8;
+
+// The footprints live until the end of the process. Callers clamp the
+// radius to the map (GridMap::mapFootprint()), so the number of distinct
+// keys is bounded by the map size times s_radiusSteps.
+struct FootprintCache
+{
+    ~FootprintCache()
+    { qDeleteAll(footprints); }
+
+    QReadWriteLock lock;
+    QHash<int, CircleFootprint*> footprints;
+};
+
+static FootprintCache s_cache;
+
+const CircleFootprint& CircleFootprint::footprint(double cellRadius)
+{
+    const int key = qMax(0, qRound(cellRadius * s_radiusSteps));
+
+    // lookups of existing footprints do not block each other
+    {
+        QReadLocker locker(&s_cache.lock);
+        CircleFootprint* footprint = s_cache.footprints.value(key, 0);
+        if (footprint) {
+            return *footprint;
+        }
+    }
+
+    QWriteLocker locker(&s_cache.lock);
+    CircleFootprint* footprint = s_cache.footprints.value(key, 0);
+    if (!footprint) {
+        footprint = new CircleFootprint(double(key) / s_radiusSteps);
+        s_cache.footprints.insert(key, footprint);
+    }
+    return *footprint;
+}
+
+CircleFootprint::CircleFootprint(double cellRadius)
+{
+    // a cell is touched as long as its nearest corner is inside the circle
+    m_radius = qMax(0, static_cast<int>(floor(cellRadius + 0.5)));
+
+    const int size = 2 * m_radius + 1;
+    const double r2 = cellRadius * cellRadius;
+    m_coverage.fill(0, size * size);
+    m_rowRadius.fill(-1, size);
+
+    for (int dy = -m_radius; dy <= m_radius; ++dy) {
+        for (int dx = -m_radius; dx <= m_radius; ++dx) {
+            int count = 0;
+            for (int corner = 0; corner < 4; ++corner) {
+                const double x = dx + ((corner & 1) ? 0.5 : -0.5);
+                const double y = dy + ((corner & 2) ? 0.5 : -0.5);
+                if (x * x + y * y <= r2)
+                    ++count;
+            }
+            m_coverage[(dy + m_radius) * size + dx + m_radius] = count;
+            if (count > 0)
+                m_rowRadius[dy + m_radius] = qMax(m_rowRadius[dy + m_radius], qAbs(dx));
+        }
+    }
+}
+
+// kate: replace-tabs on; indent-width 4;
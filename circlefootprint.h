@@ -0,0 +1,70 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_CIRCLE_FOOTPRINT_H
+#define DISCOVERAGE_CIRCLE_FOOTPRINT_H
+
+#include <QtCore/QVector>
+
+/**
+ * Rasterized disk around the center of a grid cell. For each cell offset
+ * (dx, dy), coverage() is the number of cell corners inside the circle:
+ * 0 means outside, 4 means completely inside, everything in between is
+ * intersected by the circle.
+ *
+ * Footprints are cached, footprint() returns the same object for radii
+ * that agree up to 1/8 cell.
+ */
+class CircleFootprint
+{
+    public:
+        // footprint for a circle radius given in cells (i.e. radius / resolution)
+        static const CircleFootprint& footprint(double cellRadius);
+
+        // largest |dx| or |dy| with coverage > 0
+        inline int radius() const
+        { return m_radius; }
+
+        inline int coverage(int dx, int dy) const
+        {
+            if (dx < -m_radius || dx > m_radius || dy < -m_radius || dy > m_radius)
+                return 0;
+            return m_coverage[(dy + m_radius) * (2 * m_radius + 1) + dx + m_radius];
+        }
+
+        // largest |dx| with coverage(dx, dy) > 0, -1 if the row is empty.
+        // The touched cells of a row are contiguous.
+        inline int rowRadius(int dy) const
+        {
+            if (dy < -m_radius || dy > m_radius)
+                return -1;
+            return m_rowRadius[dy + m_radius];
+        }
+
+    private:
+        explicit CircleFootprint(double cellRadius);
+
+        int m_radius;
+        QVector<quint8> m_coverage;     // (2 * radius + 1)^2 entries, row-major
+        QVector<int> m_rowRadius;       // 2 * radius + 1 entries
+};
+
+#endif // DISCOVERAGE_CIRCLE_FOOTPRINT_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -26,7 +26,7 @@ Config* Config::s_self = 0;
 Config* Config::self()
 {
     if (!s_self) {
-        new Config();
+        s_self = new Config();
     }
 
     return s_self;
@@ -40,13 +40,15 @@ Config::Config()
     , m_showVectorField(false)
     , m_showPreviewTrajectory(false)
     , m_zoomFactor(8.0)
+    , m_renderingEnabled(true)
 {
-    s_self = this;
 }
 
 Config::~Config()
 {
-    s_self = 0;
+    if (s_self == this) {
+        s_self = 0;
+    }
 }
 
 void Config::begin()
@@ -178,4 +180,14 @@ double Config::zoom()
     return m_zoomFactor;
 }
 
+bool Config::renderingEnabled() const
+{
+    return m_renderingEnabled;
+}
+
+void Config::setRenderingEnabled(bool enabled)
+{
+    m_renderingEnabled = enabled;
+}
+
 // kate: replace-tabs on; indent-width 4;
@@ -34,6 +34,7 @@ class Config : public QObject
         Config();
         virtual ~Config();
 
+        // config of the main window. Each SimulationContext may use its own.
         static Config* self();
 
         void load(QSettings& config);
@@ -66,6 +67,11 @@ class Config : public QObject
         bool zoomOut();
         double zoom();
 
+        // if false, the pixmap cache of the map is not updated. Not saved,
+        // used by the batch runner where nothing is displayed.
+        bool renderingEnabled() const;
+        void setRenderingEnabled(bool enabled);
+
     private:
         int m_refCount;
 
@@ -74,6 +80,7 @@ class Config : public QObject
         bool m_showVectorField;
         bool m_showPreviewTrajectory;
         double m_zoomFactor;
+        bool m_renderingEnabled;
 };
 
 #endif // DISCOVERAGE_CONFIG_H
@@ -0,0 +1,361 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "dynamicvoronoi.h"
+#include "chamferpropagation.h"
+#include "gridmap.h"
+#include "priorityqueue.h"
+
+#include <limits>
+
+// same order as the direction map of the GridMap: 4 orthogonal neighbors,
+// 4 diagonal neighbors, 8 knight moves
+static const int s_neighbors[16][2] = {
+    {  0, -1}, {  1,  0}, {  0,  1}, { -1,  0},
+    {  1, -1}, {  1,  1}, { -1,  1}, { -1, -1},
+    {  2, -1}, {  2,  1}, { -2,  1}, { -2, -1},
+    {  1, -2}, {  1,  2}, { -1,  2}, { -1, -2}
+};
+
+static inline int sgn(int val)
+{
+    return (0 < val) - (val < 0);
+}
+
+//BEGIN DynamicVoronoi
+DynamicVoronoi::DynamicVoronoi(GridMap* map)
+    : m_map(map)
+    , m_queue(PriorityQueue::create(PriorityQueue::IndexedHeap)) // keys are not monotone across updates
+    , m_width(0)
+    , m_height(0)
+    , m_resetPending(true)
+    , m_infinity(std::numeric_limits<float>::infinity())
+{
+    m_weight[0] = m_weight[1] = m_weight[2] = 0.0f;
+    m_map->addObserver(this);
+}
+
+DynamicVoronoi::~DynamicVoronoi()
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+    delete m_queue;
+}
+
+bool DynamicVoronoi::needsReset() const
+{
+    return m_resetPending;
+}
+
+void DynamicVoronoi::reset()
+{
+    Q_ASSERT(m_map);
+
+    m_width = m_map->size().width();
+    m_height = m_map->size().height();
+    const int cellCount = m_width * m_height;
+
+    // same rounding as ChamferPropagation
+    const float step = m_map->resolution();
+    m_weight[0] = step * 1.0;
+    m_weight[1] = step * 1.4142136;
+    m_weight[2] = step * 2.236068;
+
+    m_flags.fill(0, cellCount);
+    m_g.fill(m_infinity, cellCount);
+    m_rhs.fill(m_infinity, cellCount);
+    m_label.fill(0, cellCount);
+    m_rhsLabel.fill(0, cellCount);
+    m_parent.fill(-1, cellCount);
+    m_isSeed.fill(false, cellCount);
+    m_isDirty.fill(false, cellCount);
+    m_isChanged.fill(false, cellCount);
+    m_isUpdated.fill(false, cellCount);
+    m_queue->reset(cellCount);
+
+    m_seeds.clear();
+    m_dirty.clear();
+    m_changed.clear();
+    m_updated.clear();
+
+    m_resetPending = false;
+}
+
+void DynamicVoronoi::setFlags(int index, quint8 flags)
+{
+    const quint8 oldFlags = m_flags[index];
+    if (oldFlags == flags)
+        return;
+
+    m_flags[index] = flags;
+    markDirty(index);
+
+    // knight moves passing this cell start and end in the 3x3 block around it
+    if ((oldFlags ^ flags) & ChamferPropagation::Transparent) {
+        const int x = index % m_width;
+        const int y = index / m_width;
+        for (int i = 0; i < 8; ++i) {
+            const int ax = x + s_neighbors[i][0];
+            const int ay = y + s_neighbors[i][1];
+            if (m_map->isValidField(ax, ay)) {
+                markDirty(m_map->linearIndex(ax, ay));
+            }
+        }
+    }
+}
+
+void DynamicVoronoi::setSeeds(const QMap<int, quint8>& seeds)
+{
+    if (seeds == m_seeds)
+        return;
+
+    // old and new seeds need a new rhs value
+    QMapIterator<int, quint8> it(m_seeds);
+    while (it.hasNext()) {
+        it.next();
+        m_isSeed[it.key()] = false;
+        markDirty(it.key());
+    }
+
+    m_seeds = seeds;
+    QMapIterator<int, quint8> jt(m_seeds);
+    while (jt.hasNext()) {
+        jt.next();
+        m_isSeed[jt.key()] = true;
+        markDirty(jt.key());
+    }
+}
+
+QList<int> DynamicVoronoi::takeChangedCells()
+{
+    foreach (int index, m_changed) {
+        m_isChanged[index] = false;
+    }
+
+    QList<int> changed = m_changed;
+    m_changed.clear();
+    return changed;
+}
+
+const QList<int>& DynamicVoronoi::lastUpdatedCells() const
+{
+    return m_updated;
+}
+
+void DynamicVoronoi::update()
+{
+    Q_ASSERT(!m_resetPending);
+
+    foreach (int index, m_updated) {
+        m_isUpdated[index] = false;
+    }
+    m_updated.clear();
+
+    foreach (int index, m_dirty) {
+        m_isDirty[index] = false;
+        updateRhs(index);
+        updateQueue(index);
+    }
+    m_dirty.clear();
+
+    computeDistances();
+}
+
+void DynamicVoronoi::markDirty(int index)
+{
+    if (!m_isDirty[index]) {
+        m_isDirty[index] = true;
+        m_dirty.append(index);
+    }
+}
+
+void DynamicVoronoi::markUpdated(int index)
+{
+    if (!m_isUpdated[index]) {
+        m_isUpdated[index] = true;
+        m_updated.append(index);
+    }
+}
+
+bool DynamicVoronoi::isEdgeFree(int to, int direction) const
+{
+    if (!(m_flags[to] & ChamferPropagation::Passable))
+        return false;
+
+    if (direction < 8)
+        return true;
+
+    // knight move: the two cells it passes must be transparent
+    const int dx = s_neighbors[direction][0];
+    const int dy = s_neighbors[direction][1];
+    const int ux = to % m_width - dx;
+    const int uy = to / m_width - dy;
+
+    int ax, ay, bx, by;
+    if (qAbs(dx) == 2) {
+        ax = ux + sgn(dx); ay = uy;
+        bx = ax;           by = uy + dy;
+    } else {
+        ax = ux;           ay = uy + sgn(dy);
+        bx = ux + dx;      by = ay;
+    }
+
+    return (m_flags[ay * m_width + ax] & ChamferPropagation::Transparent)
+        && (m_flags[by * m_width + bx] & ChamferPropagation::Transparent);
+}
+
+void DynamicVoronoi::updateRhs(int index)
+{
+    if (m_isSeed[index]) {
+        m_rhs[index] = 0;
+        m_rhsLabel[index] = m_seeds.value(index);
+        m_parent[index] = -1;
+        return;
+    }
+
+    const int x = index % m_width;
+    const int y = index / m_width;
+
+    float rhs = m_infinity;
+    int parent = -1;
+    for (int i = 0; i < 16; ++i) {
+        // previous cell on the path
+        const int px = x - s_neighbors[i][0];
+        const int py = y - s_neighbors[i][1];
+        if (!m_map->isValidField(px, py))
+            continue;
+
+        const int prev = m_map->linearIndex(px, py);
+        if (m_g[prev] == m_infinity || !isEdgeFree(index, i))
+            continue;
+
+        const float cost = m_g[prev] + m_weight[i < 4 ? 0 : (i < 8 ? 1 : 2)];
+        if (cost < rhs) {
+            rhs = cost;
+            parent = i;
+        }
+    }
+
+    m_rhs[index] = rhs;
+    m_parent[index] = parent;
+    m_rhsLabel[index] = parent < 0 ? 0
+        : m_label[m_map->linearIndex(x - s_neighbors[parent][0], y - s_neighbors[parent][1])];
+}
+
+void DynamicVoronoi::updateQueue(int index)
+{
+    if (m_g[index] != m_rhs[index]
+        || (m_rhs[index] != m_infinity && m_label[index] != m_rhsLabel[index]))
+    {
+        m_queue->push(index, qMin(m_g[index], m_rhs[index]));
+    } else {
+        m_queue->remove(index);
+    }
+}
+
+void DynamicVoronoi::computeDistances()
+{
+    while (!m_queue->isEmpty()) {
+        const int index = m_queue->pop();
+        markUpdated(index);
+
+        const int x = index % m_width;
+        const int y = index / m_width;
+
+        if (m_g[index] >= m_rhs[index]) {
+            // overconsistent or relabeled: the distance decreased or the
+            // nearest seed changed, propagate to the neighbors
+            const bool lowered = m_g[index] > m_rhs[index];
+            m_g[index] = m_rhs[index];
+            m_label[index] = m_rhsLabel[index];
+
+            for (int i = 0; i < 16; ++i) {
+                const int ax = x + s_neighbors[i][0];
+                const int ay = y + s_neighbors[i][1];
+                if (!m_map->isValidField(ax, ay))
+                    continue;
+
+                const int neighbor = m_map->linearIndex(ax, ay);
+                if (m_isSeed[neighbor] || !isEdgeFree(neighbor, i))
+                    continue;
+
+                const float cost = m_g[index] + m_weight[i < 4 ? 0 : (i < 8 ? 1 : 2)];
+                if (lowered && cost < m_rhs[neighbor]) {
+                    m_rhs[neighbor] = cost;
+                    m_rhsLabel[neighbor] = m_label[index];
+                    m_parent[neighbor] = i;
+                    updateQueue(neighbor);
+                } else if (m_parent[neighbor] == i) {
+                    m_rhsLabel[neighbor] = m_label[index];
+                    updateQueue(neighbor);
+                }
+            }
+        } else {
+            // underconsistent: the distance increased, all cells whose path
+            // runs through this cell need a new rhs value
+            m_g[index] = m_infinity;
+            updateRhs(index);
+            updateQueue(index);
+
+            for (int i = 0; i < 16; ++i) {
+                const int ax = x + s_neighbors[i][0];
+                const int ay = y + s_neighbors[i][1];
+                if (!m_map->isValidField(ax, ay))
+                    continue;
+
+                const int neighbor = m_map->linearIndex(ax, ay);
+                if (m_parent[neighbor] == i) {
+                    updateRhs(neighbor);
+                    updateQueue(neighbor);
+                }
+            }
+        }
+    }
+}
+
+void DynamicVoronoi::cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState)
+{
+    Q_UNUSED(oldState)
+    Q_UNUSED(newState)
+
+    if (m_resetPending)
+        return;
+
+    const int index = cell.linearIndex();
+    if (!m_isChanged[index]) {
+        m_isChanged[index] = true;
+        m_changed.append(index);
+    }
+}
+
+void DynamicVoronoi::mapReset()
+{
+    m_resetPending = true;
+}
+
+void DynamicVoronoi::mapDestroyed()
+{
+    m_map->removeObserver(this);
+    m_map = 0;
+    m_resetPending = true;
+}
+//END DynamicVoronoi
+
+// kate: replace-tabs on; indent-width 4;
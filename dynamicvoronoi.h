@@ -0,0 +1,134 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_DYNAMIC_VORONOI_H
+#define DISCOVERAGE_DYNAMIC_VORONOI_H
+
+#include "gridmapobserver.h"
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+
+class GridMap;
+class PriorityQueue;
+
+/**
+ * Geodesic Voronoi partition of the GridMap that is kept across ticks.
+ *
+ * Each seed cell carries a label (e.g. the robot id). Every reachable cell
+ * gets the distance to its nearest seed and the label of that seed, with
+ * the 16-neighborhood and the step lengths of ChamferPropagation. Cells are
+ * reachable according to their ChamferPropagation flags (Passable and
+ * Transparent, PassableForFavored is not supported).
+ *
+ * Changes of the flags and of the seeds are repaired in update() like in
+ * the IncrementalPlanner (lower and raise wavefronts of LPA*). In addition,
+ * a cell whose distance stays the same but whose nearest seed changes is
+ * relabeled, and the new label is passed on to the cells behind it. Only
+ * cells whose distance or label actually changes are touched.
+ *
+ * The partition observes the map: cells whose state changed are collected
+ * for the owner, which decides about the new flags, see takeChangedCells().
+ * After the map was reset, reset() has to be called before the next update.
+ */
+class DynamicVoronoi : public GridMapObserver
+{
+    public:
+        DynamicVoronoi(GridMap* map);
+        virtual ~DynamicVoronoi();
+
+        // true, if the map was reset since the last reset()
+        bool needsReset() const;
+
+        // forget all distances, flags and seeds, and adapt to the map size
+        void reset();
+
+        // flags of a cell, combination of ChamferPropagation::CellFlag
+        void setFlags(int index, quint8 flags);
+        inline quint8 flags(int index) const { return m_flags[index]; }
+
+        // seed cells with their labels
+        void setSeeds(const QMap<int, quint8>& seeds);
+
+        // cells whose state changed since the last call
+        QList<int> takeChangedCells();
+
+        // repair distances and labels for all changes since the last call
+        void update();
+
+        // cells whose distance or label changed in the last update()
+        const QList<int>& lastUpdatedCells() const;
+
+    //
+    // queries, only valid after update()
+    //
+    public:
+        inline bool isReached(int index) const { return m_g[index] != m_infinity; }
+        inline float distance(int index) const { return m_g[index]; }
+        inline quint8 label(int index) const { return m_label[index]; }
+
+    //
+    // GridMapObserver
+    //
+    public:
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState);
+        virtual void mapReset();
+        virtual void mapDestroyed();
+
+    private:
+        void markDirty(int index);
+        void markUpdated(int index);
+        bool isEdgeFree(int to, int direction) const;
+        void updateRhs(int index);
+        void updateQueue(int index);
+        void computeDistances();
+
+    private:
+        Q_DISABLE_COPY(DynamicVoronoi)
+
+        GridMap* m_map;
+        PriorityQueue* m_queue;
+
+        int m_width;
+        int m_height;
+        bool m_resetPending;
+        float m_infinity;
+        float m_weight[3];              // orthogonal, diagonal, knight
+
+        QMap<int, quint8> m_seeds;
+        QList<int> m_dirty;
+        QList<int> m_changed;
+        QList<int> m_updated;
+
+        QVector<quint8> m_flags;
+        QVector<float> m_g;
+        QVector<float> m_rhs;
+        QVector<quint8> m_label;        // label of the committed distance g
+        QVector<quint8> m_rhsLabel;     // label of the rhs value
+        QVector<qint8> m_parent;        // direction from the previous cell, -1 for none
+        QVector<bool> m_isSeed;
+        QVector<bool> m_isDirty;
+        QVector<bool> m_isChanged;
+        QVector<bool> m_isUpdated;
+};
+
+#endif // DISCOVERAGE_DYNAMIC_VORONOI_H
+
+// kate: replace-tabs on; indent-width 4;
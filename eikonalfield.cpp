@@ -0,0 +1,132 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "eikonalfield.h"
+#include "gridmap.h"
+
+#include <math.h>
+
+EikonalField::EikonalField()
+    : m_map(0)
+    , m_revision(0)
+    , m_maxCost(-1.0f)
+    , m_width(0)
+    , m_height(0)
+    , m_resolution(1.0)
+{
+}
+
+bool EikonalField::isUpToDate(const GridMap& map, const QList<Cell>& seeds, float maxCost) const
+{
+    // a field computed up to a larger cost also answers smaller bounds
+    const bool coversCost = m_maxCost < 0.0f || (maxCost >= 0.0f && maxCost <= m_maxCost);
+
+    return m_map == &map
+        && m_revision == map.revision()
+        && coversCost
+        && m_seeds == seeds;
+}
+
+float EikonalField::distance(const QPointF& worldPos) const
+{
+    // cell centers are at (x + 0.5) * resolution
+    const double fx = worldPos.x() / m_resolution - 0.5;
+    const double fy = worldPos.y() / m_resolution - 0.5;
+    const int x0 = static_cast<int>(floor(fx));
+    const int y0 = static_cast<int>(floor(fy));
+    const double tx = fx - x0;
+    const double ty = fy - y0;
+
+    // weight the reached cell centers around the position, skip the others
+    double sum = 0.0;
+    double weight = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const int x = x0 + (i & 1);
+        const int y = y0 + (i >> 1);
+        if (!isReached(x, y))
+            continue;
+
+        const double w = ((i & 1) ? tx : 1.0 - tx) * ((i >> 1) ? ty : 1.0 - ty);
+        sum += w * m_distance[y * m_width + x];
+        weight += w;
+    }
+
+    if (weight > 0.0) {
+        return sum / weight;
+    }
+
+    // position close to an unreached cell center: use the cell itself
+    const int x = static_cast<int>(worldPos.x() / m_resolution);
+    const int y = static_cast<int>(worldPos.y() / m_resolution);
+    return isReached(x, y) ? m_distance[y * m_width + x] : -1.0f;
+}
+
+QPointF EikonalField::descent(const QPointF& worldPos) const
+{
+    const double fx = worldPos.x() / m_resolution - 0.5;
+    const double fy = worldPos.y() / m_resolution - 0.5;
+    const int x0 = static_cast<int>(floor(fx));
+    const int y0 = static_cast<int>(floor(fy));
+    const double tx = fx - x0;
+    const double ty = fy - y0;
+
+    QPointF gradient;
+    for (int i = 0; i < 4; ++i) {
+        const int x = x0 + (i & 1);
+        const int y = y0 + (i >> 1);
+        const double w = ((i & 1) ? tx : 1.0 - tx) * ((i >> 1) ? ty : 1.0 - ty);
+        gradient += w * cellGradient(x, y);
+    }
+
+    const double length = sqrt(gradient.x() * gradient.x() + gradient.y() * gradient.y());
+    if (length < 1e-6) {
+        return QPointF();
+    }
+
+    return -gradient / length;
+}
+
+QPointF EikonalField::cellGradient(int x, int y) const
+{
+    if (!isReached(x, y)) {
+        return QPointF();
+    }
+
+    // upwind differences: only neighbors closer to the seeds are used,
+    // as in the update of the Fast Marching Method
+    const float center = m_distance[y * m_width + x];
+    double g[2] = { 0.0, 0.0 };
+    for (int axis = 0; axis < 2; ++axis) {
+        const int dx = axis == 0 ? 1 : 0;
+        const int dy = axis == 1 ? 1 : 0;
+
+        const float prev = isReached(x - dx, y - dy) ? m_distance[(y - dy) * m_width + x - dx] : center;
+        const float next = isReached(x + dx, y + dy) ? m_distance[(y + dy) * m_width + x + dx] : center;
+
+        if (prev < center && prev <= next) {
+            g[axis] = center - prev;
+        } else if (next < center) {
+            g[axis] = next - center;
+        }
+    }
+
+    return QPointF(g[0], g[1]);
+}
+
+// kate: replace-tabs on; indent-width 4;
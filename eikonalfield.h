@@ -0,0 +1,96 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_EIKONAL_FIELD_H
+#define DISCOVERAGE_EIKONAL_FIELD_H
+
+#include "cell.h"
+
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+#include <QtCore/QPointF>
+#include <QtCore/QVector>
+
+class GridMap;
+
+/**
+ * Geodesic distance from every cell of the GridMap to a set of seed cells
+ * (e.g. the cells of a frontier segment), computed with the Fast Marching
+ * Method by GridMap::computeEikonalField().
+ *
+ * The field solves |grad T| = cellCost with a first-order upwind scheme, so
+ * unlike the grid searches the distances are not bound to the 8 directions
+ * of the grid. Obstacles are not passed. Distances are path costs, not
+ * lengths: through explored free cells the distance is the Euclidean path
+ * length in cells times Cell::cellCost(Explored | Free).
+ *
+ * Queries at world positions interpolate between the adjacent cell centers,
+ * so that a field can be reused for any position of a robot.
+ *
+ * A field only stays valid as long as the map and the seeds do not change,
+ * see isUpToDate().
+ */
+class EikonalField
+{
+    friend class GridMap;
+
+    public:
+        EikonalField();
+
+        // true, if computed for the current state of map with these seeds and
+        // at least up to maxCost (-1 for the complete map)
+        bool isUpToDate(const GridMap& map, const QList<Cell>& seeds, float maxCost = -1.0f) const;
+
+        // distance of the cell to the nearest seed, -1 if not reached
+        inline float distance(const QPoint& cellIndex) const;
+
+        // bilinearly interpolated distance at a world position, -1 if not reached
+        float distance(const QPointF& worldPos) const;
+
+        // unit vector of steepest descent of the distance at a world position,
+        // i.e. the direction of the shortest path to the seeds. Null on seeds
+        // and on cells that were not reached.
+        QPointF descent(const QPointF& worldPos) const;
+
+    private:
+        inline bool isReached(int x, int y) const
+        { return x >= 0 && y >= 0 && x < m_width && y < m_height && m_distance[y * m_width + x] >= 0.0f; }
+
+        QPointF cellGradient(int x, int y) const;
+
+    private:
+        const GridMap* m_map;
+        quint32 m_revision;
+        QList<Cell> m_seeds;
+        float m_maxCost;
+        int m_width;
+        int m_height;
+        double m_resolution;
+
+        QVector<float> m_distance;  // -1 for cells not reached
+};
+
+float EikonalField::distance(const QPoint& cellIndex) const
+{
+    return m_distance[cellIndex.y() * m_width + cellIndex.x()];
+}
+
+#endif // DISCOVERAGE_EIKONAL_FIELD_H
+
+// kate: replace-tabs on; indent-width 4;
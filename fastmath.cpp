@@ -0,0 +1,362 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "fastmath.h"
+
+#include <QtCore/QtGlobal>
+
+#include <string.h>
+
+#if defined(DISCOVERAGE_AVX2) && defined(__AVX2__)
+#  include <immintrin.h>
+#  define FASTMATH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define FASTMATH_SSE2
+#endif
+
+//BEGIN constants
+// exp: x = n * ln2 + r, |r| <= ln2 / 2, ln2 split for an exact n * ln2
+static const float s_expMin = -87.33f;
+static const float s_expMax = 88.72f;
+static const float s_log2e = 1.44269504f;
+static const float s_ln2Hi = 0.693359375f;
+static const float s_ln2Lo = -2.12194440e-4f;
+// Taylor polynomial of exp(r), degree 6
+static const float s_exp2 = 1.0f / 2.0f;
+static const float s_exp3 = 1.0f / 6.0f;
+static const float s_exp4 = 1.0f / 24.0f;
+static const float s_exp5 = 1.0f / 120.0f;
+static const float s_exp6 = 1.0f / 720.0f;
+
+// log: x = m * 2^e, m in [sqrt(1/2), sqrt(2)), log(m) = 2 * atanh(s)
+static const float s_sqrt2 = 1.41421356f;
+static const float s_ln2 = 0.693147181f;
+static const float s_log3 = 2.0f / 3.0f;
+static const float s_log5 = 2.0f / 5.0f;
+static const float s_log7 = 2.0f / 7.0f;
+static const float s_log9 = 2.0f / 9.0f;
+
+// atan: polynomial for |t| <= tan(pi / 8) (Cephes atanf)
+static const float s_tanPi8 = 0.414213562f;
+static const float s_atan0 = 8.05374449538e-2f;
+static const float s_atan1 = -1.38776856032e-1f;
+static const float s_atan2 = 1.99777106478e-1f;
+static const float s_atan3 = -3.33329491539e-1f;
+static const float s_pi = 3.14159265f;
+static const float s_pi2 = 1.57079633f;
+static const float s_pi4 = 0.785398163f;
+//END constants
+
+//BEGIN scalar
+static inline float fromBits(quint32 bits)
+{
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline quint32 toBits(float f)
+{
+    quint32 bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float FastMath::exp(float x)
+{
+    if (x < s_expMin)
+        return 0.0f;
+    if (x > s_expMax)
+        return fromBits(0x7f800000);
+    if (x != x)
+        return x;
+
+    const int n = static_cast<int>(x * s_log2e + (x < 0.0f ? -0.5f : 0.5f));
+    const float r = (x - n * s_ln2Hi) - n * s_ln2Lo;
+    const float p = 1.0f + r * (1.0f + r * (s_exp2 + r * (s_exp3 + r * (s_exp4 + r * (s_exp5 + r * s_exp6)))));
+
+    // 2^n in two steps, so that neither factor leaves the normal range
+    const int n1 = n >> 1;
+    const int n2 = n - n1;
+    return p * fromBits((n1 + 127) << 23) * fromBits((n2 + 127) << 23);
+}
+
+float FastMath::log(float x)
+{
+    if (x != x || x < 0.0f)
+        return fromBits(0x7fc00000);
+    if (x == 0.0f)
+        return -fromBits(0x7f800000);
+    if (x == fromBits(0x7f800000))
+        return x;
+
+    int e = 0;
+    if (x < fromBits(0x00800000)) {
+        // denormal: scale into the normal range
+        x *= 8388608.0f;
+        e = -23;
+    }
+
+    const quint32 bits = toBits(x);
+    e += static_cast<int>(bits >> 23) - 127;
+    float m = fromBits((bits & 0x007fffff) | 0x3f800000);
+    if (m > s_sqrt2) {
+        m *= 0.5f;
+        ++e;
+    }
+
+    const float f = m - 1.0f;
+    const float s = f / (2.0f + f);
+    const float z = s * s;
+    const float r = z * (s_log3 + z * (s_log5 + z * (s_log7 + z * s_log9)));
+    return e * s_ln2 + (2.0f * s + s * r);
+}
+
+float FastMath::atan2(float y, float x)
+{
+    const float ax = qAbs(x);
+    const float ay = qAbs(y);
+    const float big = qMax(ax, ay);
+    if (big == 0.0f)
+        return 0.0f;
+
+    // atan(t) for t in [0, 1], reduced to |t| <= tan(pi / 8)
+    float t = qMin(ax, ay) / big;
+    float offset = 0.0f;
+    if (t > s_tanPi8) {
+        t = (t - 1.0f) / (t + 1.0f);
+        offset = s_pi4;
+    }
+    const float z = t * t;
+    float a = offset + t + t * z * (((s_atan0 * z + s_atan1) * z + s_atan2) * z + s_atan3);
+
+    if (ay > ax) a = s_pi2 - a;
+    if (x < 0.0f) a = s_pi - a;
+    return y < 0.0f ? -a : a;
+}
+//END scalar
+
+//BEGIN SIMD
+#if defined(FASTMATH_AVX2)
+typedef __m256 Floats;
+typedef __m256i Ints;
+static const int s_width = 8;
+static inline Floats load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void store(float* p, Floats v) { _mm256_storeu_ps(p, v); }
+static inline Floats splat(float f) { return _mm256_set1_ps(f); }
+static inline Floats add(Floats a, Floats b) { return _mm256_add_ps(a, b); }
+static inline Floats sub(Floats a, Floats b) { return _mm256_sub_ps(a, b); }
+static inline Floats mul(Floats a, Floats b) { return _mm256_mul_ps(a, b); }
+static inline Floats div(Floats a, Floats b) { return _mm256_div_ps(a, b); }
+static inline Floats min(Floats a, Floats b) { return _mm256_min_ps(a, b); }
+static inline Floats max(Floats a, Floats b) { return _mm256_max_ps(a, b); }
+static inline Floats bitAnd(Floats a, Floats b) { return _mm256_and_ps(a, b); }
+static inline Floats bitOr(Floats a, Floats b) { return _mm256_or_ps(a, b); }
+static inline Floats bitXor(Floats a, Floats b) { return _mm256_xor_ps(a, b); }
+static inline Floats select(Floats mask, Floats a, Floats b) { return _mm256_blendv_ps(b, a, mask); }
+static inline Floats less(Floats a, Floats b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline Floats greater(Floats a, Floats b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline Floats equal(Floats a, Floats b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline Floats unordered(Floats a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+static inline Ints round(Floats a) { return _mm256_cvtps_epi32(a); }
+static inline Floats toFloats(Ints a) { return _mm256_cvtepi32_ps(a); }
+static inline Ints splatInt(int i) { return _mm256_set1_epi32(i); }
+static inline Ints addInt(Ints a, Ints b) { return _mm256_add_epi32(a, b); }
+static inline Ints subInt(Ints a, Ints b) { return _mm256_sub_epi32(a, b); }
+static inline Ints shiftLeft23(Ints a) { return _mm256_slli_epi32(a, 23); }
+static inline Ints shiftRight23(Ints a) { return _mm256_srli_epi32(a, 23); }
+static inline Ints shiftRightArith1(Ints a) { return _mm256_srai_epi32(a, 1); }
+static inline Floats asFloats(Ints a) { return _mm256_castsi256_ps(a); }
+static inline Ints asInts(Floats a) { return _mm256_castps_si256(a); }
+#elif defined(FASTMATH_SSE2)
+typedef __m128 Floats;
+typedef __m128i Ints;
+static const int s_width = 4;
+static inline Floats load(const float* p) { return _mm_loadu_ps(p); }
+static inline void store(float* p, Floats v) { _mm_storeu_ps(p, v); }
+static inline Floats splat(float f) { return _mm_set1_ps(f); }
+static inline Floats add(Floats a, Floats b) { return _mm_add_ps(a, b); }
+static inline Floats sub(Floats a, Floats b) { return _mm_sub_ps(a, b); }
+static inline Floats mul(Floats a, Floats b) { return _mm_mul_ps(a, b); }
+static inline Floats div(Floats a, Floats b) { return _mm_div_ps(a, b); }
+static inline Floats min(Floats a, Floats b) { return _mm_min_ps(a, b); }
+static inline Floats max(Floats a, Floats b) { return _mm_max_ps(a, b); }
+static inline Floats bitAnd(Floats a, Floats b) { return _mm_and_ps(a, b); }
+static inline Floats bitOr(Floats a, Floats b) { return _mm_or_ps(a, b); }
+static inline Floats bitXor(Floats a, Floats b) { return _mm_xor_ps(a, b); }
+static inline Floats select(Floats mask, Floats a, Floats b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline Floats less(Floats a, Floats b) { return _mm_cmplt_ps(a, b); }
+static inline Floats greater(Floats a, Floats b) { return _mm_cmpgt_ps(a, b); }
+static inline Floats equal(Floats a, Floats b) { return _mm_cmpeq_ps(a, b); }
+static inline Floats unordered(Floats a) { return _mm_cmpunord_ps(a, a); }
+static inline Ints round(Floats a) { return _mm_cvtps_epi32(a); }
+static inline Floats toFloats(Ints a) { return _mm_cvtepi32_ps(a); }
+static inline Ints splatInt(int i) { return _mm_set1_epi32(i); }
+static inline Ints addInt(Ints a, Ints b) { return _mm_add_epi32(a, b); }
+static inline Ints subInt(Ints a, Ints b) { return _mm_sub_epi32(a, b); }
+static inline Ints shiftLeft23(Ints a) { return _mm_slli_epi32(a, 23); }
+static inline Ints shiftRight23(Ints a) { return _mm_srli_epi32(a, 23); }
+static inline Ints shiftRightArith1(Ints a) { return _mm_srai_epi32(a, 1); }
+static inline Floats asFloats(Ints a) { return _mm_castsi128_ps(a); }
+static inline Ints asInts(Floats a) { return _mm_castps_si128(a); }
+#endif
+
+#if defined(FASTMATH_AVX2) || defined(FASTMATH_SSE2)
+static inline Floats expVector(Floats x)
+{
+    const Floats tooSmall = less(x, splat(s_expMin));
+    const Floats tooLarge = greater(x, splat(s_expMax));
+    const Floats nan = unordered(x);
+    const Floats input = x;
+    x = min(max(x, splat(s_expMin)), splat(s_expMax));
+
+    // round to nearest, like the scalar version up to ties
+    const Ints n = round(mul(x, splat(s_log2e)));
+    const Floats fn = toFloats(n);
+    const Floats r = sub(sub(x, mul(fn, splat(s_ln2Hi))), mul(fn, splat(s_ln2Lo)));
+
+    Floats p = add(splat(s_exp5), mul(r, splat(s_exp6)));
+    p = add(splat(s_exp4), mul(r, p));
+    p = add(splat(s_exp3), mul(r, p));
+    p = add(splat(s_exp2), mul(r, p));
+    p = add(splat(1.0f), mul(r, p));
+    p = add(splat(1.0f), mul(r, p));
+
+    const Ints n1 = shiftRightArith1(n);
+    const Ints n2 = subInt(n, n1);
+    const Ints bias = splatInt(127);
+    p = mul(p, asFloats(shiftLeft23(addInt(n1, bias))));
+    p = mul(p, asFloats(shiftLeft23(addInt(n2, bias))));
+
+    p = select(tooSmall, splat(0.0f), p);
+    p = select(tooLarge, asFloats(splatInt(0x7f800000)), p);
+    return select(nan, input, p);
+}
+
+static inline Floats logVector(Floats x)
+{
+    const Floats zero = splat(0.0f);
+    const Floats invalid = bitOr(less(x, zero), unordered(x));
+    const Floats isZero = less(x, asFloats(splatInt(0x00800000)));
+    const Floats isInf = equal(x, asFloats(splatInt(0x7f800000)));
+
+    const Ints bits = asInts(x);
+    Floats e = toFloats(subInt(shiftRight23(bits), splatInt(127)));
+    Floats m = bitOr(bitAnd(x, asFloats(splatInt(0x007fffff))), splat(1.0f));
+
+    const Floats large = greater(m, splat(s_sqrt2));
+    m = select(large, mul(m, splat(0.5f)), m);
+    e = add(e, bitAnd(large, splat(1.0f)));
+
+    const Floats f = sub(m, splat(1.0f));
+    const Floats s = div(f, add(splat(2.0f), f));
+    const Floats z = mul(s, s);
+    Floats r = add(splat(s_log7), mul(z, splat(s_log9)));
+    r = add(splat(s_log5), mul(z, r));
+    r = add(splat(s_log3), mul(z, r));
+    r = mul(z, r);
+
+    Floats result = add(mul(e, splat(s_ln2)), add(mul(splat(2.0f), s), mul(s, r)));
+    result = select(isInf, x, result);
+    result = select(isZero, asFloats(splatInt(0xff800000)), result);
+    return select(invalid, asFloats(splatInt(0x7fc00000)), result);
+}
+
+static inline Floats atan2Vector(Floats y, Floats x)
+{
+    const Floats signMask = asFloats(splatInt(0x80000000));
+    const Floats ax = bitAnd(x, asFloats(splatInt(0x7fffffff)));
+    const Floats ay = bitAnd(y, asFloats(splatInt(0x7fffffff)));
+    const Floats big = max(ax, ay);
+    const Floats isZero = equal(big, splat(0.0f));
+
+    Floats t = div(min(ax, ay), select(isZero, splat(1.0f), big));
+    const Floats reduce = greater(t, splat(s_tanPi8));
+    t = select(reduce, div(sub(t, splat(1.0f)), add(t, splat(1.0f))), t);
+    const Floats offset = bitAnd(reduce, splat(s_pi4));
+
+    const Floats z = mul(t, t);
+    Floats p = add(mul(splat(s_atan0), z), splat(s_atan1));
+    p = add(mul(p, z), splat(s_atan2));
+    p = add(mul(p, z), splat(s_atan3));
+    Floats a = add(offset, add(t, mul(mul(t, z), p)));
+
+    a = select(greater(ay, ax), sub(splat(s_pi2), a), a);
+    a = select(less(x, splat(0.0f)), sub(splat(s_pi), a), a);
+    a = select(less(y, splat(0.0f)), bitXor(a, signMask), a);
+    return select(isZero, splat(0.0f), a);
+}
+#endif
+//END SIMD
+
+//BEGIN batch
+void FastMath::exp(const float* x, float* result, int count)
+{
+    int i = 0;
+#if defined(FASTMATH_AVX2) || defined(FASTMATH_SSE2)
+    for (; i + s_width <= count; i += s_width) {
+        store(result + i, expVector(load(x + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = exp(x[i]);
+    }
+}
+
+void FastMath::log(const float* x, float* result, int count)
+{
+    int i = 0;
+#if defined(FASTMATH_AVX2) || defined(FASTMATH_SSE2)
+    for (; i + s_width <= count; i += s_width) {
+        store(result + i, logVector(load(x + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = log(x[i]);
+    }
+}
+
+void FastMath::atan2(const float* y, const float* x, float* result, int count)
+{
+    int i = 0;
+#if defined(FASTMATH_AVX2) || defined(FASTMATH_SSE2)
+    for (; i + s_width <= count; i += s_width) {
+        store(result + i, atan2Vector(load(y + i), load(x + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = atan2(y[i], x[i]);
+    }
+}
+
+const char* FastMath::instructionSet()
+{
+#if defined(FASTMATH_AVX2)
+    return "AVX2";
+#elif defined(FASTMATH_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+//END batch
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,58 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_FAST_MATH_H
+#define DISCOVERAGE_FAST_MATH_H
+
+/**
+ * Single precision approximations of exp, log and atan2 for the inner loops
+ * (density, density colors, DisCoverage weights), with batch versions that
+ * process whole arrays with SSE2, or AVX2 if the build enables it
+ * (DISCOVERAGE_AVX2), and a scalar fallback otherwise.
+ *
+ * All paths evaluate the same polynomials, so scalar and batch results
+ * agree. Accuracy compared to libm (checked by tests/fastmathtest.cpp):
+ * - exp: relative error below 3e-7 for x in [-87.3, 88.7]. Smaller
+ *   arguments return 0, larger ones infinity.
+ * - log: error below 2e-7, relative to max(1, |log(x)|), for normal
+ *   positive x. log(0) is -infinity, negative arguments give NaN. The
+ *   batch version treats denormals as 0.
+ * - atan2: absolute error below 3e-7 rad. atan2(0, 0) is 0.
+ *
+ * The batch versions allow result == input.
+ */
+class FastMath
+{
+    public:
+        static float exp(float x);
+        static float log(float x);
+        static float atan2(float y, float x);
+
+        static void exp(const float* x, float* result, int count);
+        static void log(const float* x, float* result, int count);
+        static void atan2(const float* y, const float* x, float* result, int count);
+
+        // "AVX2", "SSE2" or "scalar"
+        static const char* instructionSet();
+};
+
+#endif // DISCOVERAGE_FAST_MATH_H
+
+// kate: replace-tabs on; indent-width 4;
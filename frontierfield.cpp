@@ -0,0 +1,71 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "frontierfield.h"
+#include "gridmap.h"
+
+FrontierField::FrontierField()
+    : m_map(0)
+    , m_revision(0)
+    , m_width(0)
+{
+}
+
+bool FrontierField::isUpToDate(const GridMap& map, const QList<Cell>& frontiers) const
+{
+    return m_map == &map
+        && m_revision == map.revision()
+        && m_frontiers == frontiers;
+}
+
+QPoint FrontierField::waypoint(const QPoint& cellIndex)
+{
+    const int index = linearIndex(cellIndex);
+    if (m_waypoint[index] >= 0) {
+        return this->cellIndex(m_waypoint[index]);
+    }
+
+    // follow the shortest path to the frontier
+    QVector<QPoint> path;
+    path.append(cellIndex);
+    for (int next = m_next[index]; next >= 0; next = m_next[next]) {
+        path.append(this->cellIndex(next));
+    }
+
+    // binary search for the furthest visible path cell, like Path::beautify()
+    int visible = qMin(1, path.size() - 1);
+    int end = path.size() - 1;
+    if (end > visible && !m_map->aaPathVisible(path[0], path[end])) {
+        while (end - visible > 1) {
+            const int mid = (visible + end) / 2;
+            if (m_map->aaPathVisible(path[0], path[mid])) {
+                visible = mid;
+            } else {
+                end = mid;
+            }
+        }
+    } else {
+        visible = end;
+    }
+
+    m_waypoint[index] = linearIndex(path[visible]);
+    return path[visible];
+}
+
+// kate: replace-tabs on; indent-width 4;
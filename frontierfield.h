@@ -0,0 +1,93 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_FRONTIER_FIELD_H
+#define DISCOVERAGE_FRONTIER_FIELD_H
+
+#include "cell.h"
+
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+#include <QtCore/QVector>
+
+class GridMap;
+
+/**
+ * Shortest paths from every cell of the GridMap to its nearest frontier,
+ * computed in a single search by GridMap::computeFrontierField().
+ *
+ * Per cell, the field stores the path cost and the next cell on the path.
+ * The first corner of the beautified path (see waypoint()) is computed on
+ * first access and then cached.
+ *
+ * A field only stays valid as long as the map and the frontier list do not
+ * change, see isUpToDate().
+ */
+class FrontierField
+{
+    friend class GridMap;
+
+    public:
+        FrontierField();
+
+        // true, if computed for the current state of map with these frontiers
+        bool isUpToDate(const GridMap& map, const QList<Cell>& frontiers) const;
+
+        // cost of the shortest path to the nearest frontier, -1 if unreachable
+        inline float distance(const QPoint& cellIndex) const;
+
+        // neighbor on the shortest path, cellIndex itself for frontiers and
+        // unreachable cells
+        inline QPoint nextStep(const QPoint& cellIndex) const;
+
+        // furthest cell of the shortest path still visible from cellIndex
+        QPoint waypoint(const QPoint& cellIndex);
+
+    private:
+        inline int linearIndex(const QPoint& cellIndex) const
+        { return cellIndex.y() * m_width + cellIndex.x(); }
+
+        inline QPoint cellIndex(int linearIndex) const
+        { return QPoint(linearIndex % m_width, linearIndex / m_width); }
+
+    private:
+        GridMap* m_map;
+        quint32 m_revision;
+        QList<Cell> m_frontiers;
+        int m_width;
+
+        QVector<float> m_distance;
+        QVector<int> m_next;        // linear index of next cell, -1 for none
+        QVector<int> m_waypoint;    // linear index of waypoint, -1 if not yet computed
+};
+
+float FrontierField::distance(const QPoint& cellIndex) const
+{
+    return m_distance[linearIndex(cellIndex)];
+}
+
+QPoint FrontierField::nextStep(const QPoint& cellIndex) const
+{
+    const int next = m_next[linearIndex(cellIndex)];
+    return next < 0 ? cellIndex : this->cellIndex(next);
+}
+
+#endif // DISCOVERAGE_FRONTIER_FIELD_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,328 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "frontiersegmentation.h"
+#include "gridmap.h"
+
+//BEGIN FrontierSegment
+FrontierSegment FrontierSegment::fromCells(const QList<Cell>& cells)
+{
+    FrontierSegment segment;
+    if (cells.isEmpty())
+        return segment;
+
+    segment.m_cells = cells;
+    segment.m_weight = cells.size();
+
+    qint64 sumX = 0;
+    qint64 sumY = 0;
+    foreach (const Cell& cell, cells) {
+        const QPoint pt = cell.index();
+        sumX += pt.x();
+        sumY += pt.y();
+        segment.m_boundingBox |= QRect(pt.x(), pt.y(), 1, 1);
+    }
+
+    const double cx = double(sumX) / cells.size();
+    const double cy = double(sumY) / cells.size();
+    const qreal res = cells.first().map()->resolution();
+    segment.m_centroid = QPointF((cx + 0.5) * res, (cy + 0.5) * res);
+
+    // the centroid of a curved segment need not be a frontier cell itself
+    double minDist = -1.0;
+    foreach (const Cell& cell, cells) {
+        const QPoint pt = cell.index();
+        const double dist = (pt.x() - cx) * (pt.x() - cx) + (pt.y() - cy) * (pt.y() - cy);
+        if (minDist < 0.0 || dist < minDist) {
+            minDist = dist;
+            segment.m_representative = cell;
+        }
+    }
+
+    return segment;
+}
+//END FrontierSegment
+
+//BEGIN FrontierSegmentation
+FrontierSegmentation::FrontierSegmentation(GridMap* map)
+    : m_map(map)
+    , m_width(0)
+    , m_height(0)
+    , m_rebuildPending(true)
+    , m_segmentsValid(false)
+{
+    m_map->addObserver(this);
+}
+
+FrontierSegmentation::~FrontierSegmentation()
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+}
+
+const QList<FrontierSegment>& FrontierSegmentation::segments()
+{
+    if (!m_map) {
+        m_result.clear();
+        return m_result;
+    }
+
+    if (m_rebuildPending) {
+        rebuild();
+    }
+
+    foreach (int id, m_dirtyIds) {
+        split(id);
+    }
+    m_dirtyIds.clear();
+
+    if (!m_segmentsValid) {
+        m_result.clear();
+        for (int id = 0; id < m_segments.size(); ++id) {
+            const QVector<int>& indices = m_segments[id].cells;
+            if (indices.isEmpty())
+                continue;
+
+            QList<Cell> cells;
+            cells.reserve(indices.size());
+            foreach (int index, indices) {
+                cells.append(Cell(m_map, index));
+            }
+            m_result.append(FrontierSegment::fromCells(cells));
+        }
+        m_segmentsValid = true;
+    }
+
+    return m_result;
+}
+
+int FrontierSegmentation::createSegment()
+{
+    if (!m_freeIds.isEmpty()) {
+        const int id = m_freeIds.last();
+        m_freeIds.pop_back();
+        return id;
+    }
+
+    Segment segment;
+    segment.dirty = false;
+    m_segments.append(segment);
+    return m_segments.size() - 1;
+}
+
+void FrontierSegmentation::freeSegment(int id)
+{
+    m_segments[id].cells.clear();
+    m_segments[id].dirty = false;
+    m_freeIds.append(id);
+}
+
+void FrontierSegmentation::appendCell(int id, int index)
+{
+    QVector<int>& cells = m_segments[id].cells;
+    m_segmentId[index] = id;
+    m_position[index] = cells.size();
+    cells.append(index);
+}
+
+void FrontierSegmentation::mergeSegments(int id, int other)
+{
+    foreach (int index, m_segments[other].cells) {
+        appendCell(id, index);
+    }
+
+    if (m_segments[other].dirty && !m_segments[id].dirty) {
+        m_segments[id].dirty = true;
+        m_dirtyIds.append(id);
+    }
+
+    freeSegment(other);
+}
+
+void FrontierSegmentation::addCell(int index)
+{
+    const int x = index % m_width;
+    const int y = index / m_width;
+
+    // collect the distinct segments of all neighbors, the largest one survives
+    int ids[8];
+    int idCount = 0;
+    int id = -1;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const int ax = x + dx;
+            const int ay = y + dy;
+            if (ax < 0 || ay < 0 || ax >= m_width || ay >= m_height)
+                continue;
+
+            const int neighborId = m_segmentId[ay * m_width + ax];
+            if (neighborId < 0)
+                continue;
+
+            bool known = false;
+            for (int i = 0; i < idCount; ++i) {
+                known = known || ids[i] == neighborId;
+            }
+            if (known)
+                continue;
+
+            ids[idCount++] = neighborId;
+            if (id < 0 || m_segments[neighborId].cells.size() > m_segments[id].cells.size()) {
+                id = neighborId;
+            }
+        }
+    }
+
+    if (id < 0) {
+        id = createSegment();
+    }
+
+    for (int i = 0; i < idCount; ++i) {
+        if (ids[i] != id) {
+            mergeSegments(id, ids[i]);
+        }
+    }
+
+    appendCell(id, index);
+}
+
+void FrontierSegmentation::removeCell(int index)
+{
+    const int id = m_segmentId[index];
+    if (id < 0)
+        return;
+
+    // swap with last cell
+    QVector<int>& cells = m_segments[id].cells;
+    const int pos = m_position[index];
+    const int last = cells.last();
+    cells[pos] = last;
+    m_position[last] = pos;
+    cells.pop_back();
+    m_segmentId[index] = -1;
+
+    if (cells.isEmpty()) {
+        freeSegment(id);
+    } else if (!m_segments[id].dirty) {
+        m_segments[id].dirty = true;
+        m_dirtyIds.append(id);
+    }
+}
+
+void FrontierSegmentation::split(int id)
+{
+    if (!m_segments[id].dirty)
+        return;
+
+    const QVector<int> cells = m_segments[id].cells;
+    freeSegment(id);
+
+    // -2 marks cells that are not yet assigned to a new segment
+    foreach (int index, cells) {
+        m_segmentId[index] = -2;
+    }
+
+    QVector<int> stack;
+    foreach (int seed, cells) {
+        if (m_segmentId[seed] != -2)
+            continue;
+
+        const int newId = createSegment();
+        appendCell(newId, seed);
+        stack.append(seed);
+
+        while (!stack.isEmpty()) {
+            const int index = stack.last();
+            stack.pop_back();
+
+            const int x = index % m_width;
+            const int y = index / m_width;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int ax = x + dx;
+                    const int ay = y + dy;
+                    if (ax < 0 || ay < 0 || ax >= m_width || ay >= m_height)
+                        continue;
+
+                    const int neighbor = ay * m_width + ax;
+                    if (m_segmentId[neighbor] == -2) {
+                        appendCell(newId, neighbor);
+                        stack.append(neighbor);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FrontierSegmentation::rebuild()
+{
+    const QSize size = m_map->size();
+    m_width = size.width();
+    m_height = size.height();
+
+    m_segmentId.fill(-1, m_width * m_height);
+    m_position.fill(0, m_width * m_height);
+    m_segments.clear();
+    m_freeIds.clear();
+    m_dirtyIds.clear();
+
+    foreach (const Cell& cell, m_map->frontiers()) {
+        addCell(cell.linearIndex());
+    }
+
+    m_rebuildPending = false;
+    m_segmentsValid = false;
+}
+
+void FrontierSegmentation::cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState)
+{
+    const bool wasFrontier = oldState & Cell::Frontier;
+    const bool isFrontier = newState & Cell::Frontier;
+    if (wasFrontier == isFrontier)
+        return;
+
+    m_segmentsValid = false;
+    if (m_rebuildPending)
+        return;
+
+    if (isFrontier) {
+        addCell(cell.linearIndex());
+    } else {
+        removeCell(cell.linearIndex());
+    }
+}
+
+void FrontierSegmentation::mapReset()
+{
+    m_rebuildPending = true;
+    m_segmentsValid = false;
+}
+
+void FrontierSegmentation::mapDestroyed()
+{
+    m_map->removeObserver(this);
+    m_map = 0;
+    m_rebuildPending = true;
+    m_segmentsValid = false;
+}
+//END FrontierSegmentation
+
+// kate: replace-tabs on; indent-width 4;
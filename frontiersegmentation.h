@@ -0,0 +1,108 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_FRONTIER_SEGMENTATION_H
+#define DISCOVERAGE_FRONTIER_SEGMENTATION_H
+
+#include "gridmapobserver.h"
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QRect>
+#include <QtCore/QVector>
+
+class GridMap;
+
+/**
+ * Connected set of frontier cells (8-neighborhood).
+ */
+class FrontierSegment
+{
+    public:
+        FrontierSegment() : m_weight(0.0f) { }
+
+        QList<Cell> m_cells;
+        QPointF m_centroid;         // world coordinates
+        QRect m_boundingBox;        // cell indices
+        float m_weight;             // number of cells
+        Cell m_representative;      // cell closest to the centroid
+
+        // compute centroid, bounding box, weight and representative of cells
+        static FrontierSegment fromCells(const QList<Cell>& cells);
+};
+
+/**
+ * Maintains the connected frontier segments of a GridMap.
+ *
+ * New frontier cells are added to (and merge) the segments of their
+ * neighbors right away. Removing a frontier cell may split its segment,
+ * so such segments are marked dirty and split with a flood fill over their
+ * cells the next time segments() is called.
+ */
+class FrontierSegmentation : public GridMapObserver
+{
+    public:
+        FrontierSegmentation(GridMap* map);
+        virtual ~FrontierSegmentation();
+
+        const QList<FrontierSegment>& segments();
+
+    //
+    // GridMapObserver
+    //
+    public:
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState);
+        virtual void mapReset();
+        virtual void mapDestroyed();
+
+    private:
+        struct Segment
+        {
+            QVector<int> cells;     // linear indices
+            bool dirty;             // cells were removed, may be split
+        };
+
+        int createSegment();
+        void freeSegment(int id);
+        void appendCell(int id, int index);
+        void mergeSegments(int id, int other);
+        void addCell(int index);
+        void removeCell(int index);
+        void split(int id);
+        void rebuild();
+
+    private:
+        GridMap* m_map;
+        int m_width;
+        int m_height;
+
+        QVector<int> m_segmentId;   // per cell, -1 if no frontier
+        QVector<int> m_position;    // position of cell in Segment::cells
+        QVector<Segment> m_segments;
+        QVector<int> m_freeIds;
+        QList<int> m_dirtyIds;
+
+        bool m_rebuildPending;
+        bool m_segmentsValid;
+        QList<FrontierSegment> m_result;
+};
+
+#endif // DISCOVERAGE_FRONTIER_SEGMENTATION_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,60 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "gradientcache.h"
+#include "gridmap.h"
+
+GradientCache::GradientCache()
+    : m_map(0)
+    , m_revision(0)
+    , m_partitionRevision(0)
+    , m_key(0)
+    , m_generation(0)
+{
+}
+
+void GradientCache::validate(const GridMap& map, quint32 key)
+{
+    const int cellCount = map.size().width() * map.size().height();
+
+    if (m_map == &map
+        && m_revision == map.revision()
+        && m_partitionRevision == map.partitionRevision()
+        && m_key == key
+        && m_stamp.size() == cellCount)
+    {
+        return;
+    }
+
+    m_map = &map;
+    m_revision = map.revision();
+    m_partitionRevision = map.partitionRevision();
+    m_key = key;
+
+    ++m_generation;
+    if (m_stamp.size() != cellCount || m_generation == 0) {
+        // new map size or wrap around of the generation
+        m_stamp.fill(0, cellCount);
+        m_gradient.fill(0.0f, 2 * cellCount);
+        m_generation = 1;
+    }
+}
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,78 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_GRADIENT_CACHE_H
+#define DISCOVERAGE_GRADIENT_CACHE_H
+
+#include <QtCore/QPointF>
+#include <QtCore/QVector>
+
+class GridMap;
+
+/**
+ * Gradients at the cell centers of the GridMap, filled on demand by a tool
+ * handler, e.g. for the interpolation between the 4 cells around a robot.
+ *
+ * The cache is bound to a version: the map revision, the partition revision
+ * and a key of the handler for all other inputs (e.g. the density revision).
+ * validate() drops all entries in O(1) if any of them changed, using
+ * generation stamps like the SearchWorkspace.
+ *
+ * Different cells may be stored concurrently once the cache is validated.
+ */
+class GradientCache
+{
+    public:
+        GradientCache();
+
+        // drop all entries, unless the cache was filled for the current
+        // version of map and the same key
+        void validate(const GridMap& map, quint32 key = 0);
+
+        // true and the gradient of the cell, if cached
+        inline bool lookup(int index, QPointF& gradient) const
+        {
+            if (m_stamp[index] != m_generation)
+                return false;
+            gradient = QPointF(m_gradient[2 * index], m_gradient[2 * index + 1]);
+            return true;
+        }
+
+        inline void store(int index, const QPointF& gradient)
+        {
+            m_stamp[index] = m_generation;
+            m_gradient[2 * index] = gradient.x();
+            m_gradient[2 * index + 1] = gradient.y();
+        }
+
+    private:
+        const GridMap* m_map;
+        quint32 m_revision;
+        quint32 m_partitionRevision;
+        quint32 m_key;
+
+        quint32 m_generation;
+        QVector<quint32> m_stamp;
+        QVector<float> m_gradient;      // interleaved x, y
+};
+
+#endif // DISCOVERAGE_GRADIENT_CACHE_H
+
+// kate: replace-tabs on; indent-width 4;
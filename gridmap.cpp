@@ -18,23 +18,29 @@
 */
 
 #include "gridmap.h"
-#include "scene.h"
-#include "config.h"
-#include "tikzexport.h"
-#include "robotmanager.h"
-#include "robot.h"
-
-#include <QPainter>
-#include <QPoint>
+#include "searchworkspace.h"
+#include "priorityqueue.h"
+#include "frontierfield.h"
+#include "eikonalfield.h"
+#include "gridmapobserver.h"
+#include "circlefootprint.h"
+#include "frontiersegmentation.h"
+#include "chamferpropagation.h"
+#include "dynamicvoronoi.h"
+#include "robottask.h"
+#include "fastmath.h"
+
 #include <QtCore/QDebug>
+#include <QtCore/QDataStream>
 #include <QtCore/QSettings>
 #include <QtCore/QTime>
 #include <QtCore/QBitArray>
+#include <QtCore/QPair>
+#include <QtCore/QtAlgorithms>
 
 //#include <iostream>
 
 #include <math.h>
-#include <set>
 
 static int directionMap[16][2] = {
     //
@@ -132,29 +138,35 @@ void Path::beautify(GridMap& gridMap, bool computeExactLength)
 
 static const int border = 2;
 
-GridMap::GridMap(Scene* scene, double width, double height, double resolution)
-    : QObject(scene)
-    , m_scene(scene)
+GridMap::GridMap(QObject* parent, double width, double height, double resolution)
+    : QObject(parent)
+    , m_frontierSegmentation(0)
+    , m_width(0)
+    , m_height(0)
+    , m_revision(0)
+    , m_partitionRevision(0)
+    , m_densityRevision(0)
     , m_resolution(resolution)
 {
+    m_frontierSegmentation = new FrontierSegmentation(this);
+    m_dynamicVoronoi = new DynamicVoronoi(this);
+
     const int xCellCount = ceil(width / m_resolution);
     const int yCellCount = ceil(height / m_resolution);
 
-    m_map = QVector<QVector<Cell> >(xCellCount, QVector<Cell>(yCellCount));
+    resize(xCellCount, yCellCount);
 
-    for (int a = 0; a < xCellCount; ++a) {
-        QVector<Cell>& row = m_map[a];
-        for (int b = 0; b < yCellCount; ++b) {
-            row[b].setRect(QRectF(a * m_resolution, b * m_resolution, m_resolution, m_resolution));
-            row[b].setIndex(QPoint(a, b));
+    for (int b = 0; b < yCellCount; ++b) {
+        for (int a = 0; a < xCellCount; ++a) {
+            quint8& state = m_state[linearIndex(a, b)];
 
             if (a == border || a == xCellCount - border - 1||
                 b == border || b == yCellCount - border - 1)
-                row[b].setState(Cell::Unknown | Cell::Obstacle);
+                state = Cell::mergeState(static_cast<Cell::State>(state), Cell::Unknown | Cell::Obstacle);
 
             if (a < border || a > xCellCount - border - 1||
                 b < border || b > yCellCount - border - 1)
-                row[b].setState(Cell::Explored | Cell::Obstacle);
+                state = Cell::mergeState(static_cast<Cell::State>(state), Cell::Explored | Cell::Obstacle);
         }
     }
 
@@ -162,13 +174,77 @@ GridMap::GridMap(Scene* scene, double width, double height, double resolution)
     m_exploredCellCount = 0;
 	m_oldexploredCellCount = 0;
 	m_isunemployed = false;
+    m_voronoiAllPassable = false;
+    m_voronoiConnected = false;
     m_freeCellCount = (xCellCount - 2 * (border+1)) * (yCellCount - 2 * (border+1));
-
-    updateCache();
 }
 
 GridMap::~GridMap()
 {
+    delete m_dynamicVoronoi;
+    delete m_frontierSegmentation;
+
+    foreach (GridMapObserver* observer, m_observers) {
+        observer->mapDestroyed();
+    }
+}
+
+GridMapObserver::~GridMapObserver()
+{
+}
+
+void GridMap::addObserver(GridMapObserver* observer)
+{
+    if (!m_observers.contains(observer)) {
+        m_observers.append(observer);
+    }
+}
+
+void GridMap::removeObserver(GridMapObserver* observer)
+{
+    m_observers.removeAll(observer);
+}
+
+void GridMap::resize(int width, int height)
+{
+    const int cellCount = width * height;
+
+    m_width = width;
+    m_height = height;
+
+    m_state = QVector<quint8>(cellCount, Cell::Free | Cell::Unknown);
+    m_density = QVector<float>(cellCount, 1.0f);
+    m_frontierDist = QVector<float>(cellCount, 0.0f);
+    m_robotDist = QVector<float>(cellCount, 0.0f);
+    m_gradient = QVector<float>(2 * cellCount, 0.0f);
+    m_robotId = QVector<quint8>(cellCount, 0);
+    m_robots = QVector<Robot*>(1, static_cast<Robot*>(0));
+    ++m_revision;
+    ++m_partitionRevision;
+    ++m_densityRevision;
+
+    foreach (GridMapObserver* observer, m_observers) {
+        observer->mapReset();
+    }
+}
+
+int GridMap::findRobotId(Robot* robot) const
+{
+    return m_robots.indexOf(robot);
+}
+
+void GridMap::setRobots(const QVector<Robot*>& robots)
+{
+    m_team = robots;
+    if (m_team.size() > MaxRobots) {
+        qWarning() << "GridMap::setRobots(): ignoring" << m_team.size() - MaxRobots << "robots, at most" << int(MaxRobots) << "are supported";
+        m_team.resize(MaxRobots);
+    }
+}
+
+const QVector<Robot*>& GridMap::robots() const
+{
+    return m_team;
 }
 
 void GridMap::load(QSettings& config)
@@ -180,7 +256,7 @@ void GridMap::load(QSettings& config)
     QByteArray ba = config.value("map", QByteArray()).toByteArray();
     config.endGroup();
 
-    m_map = QVector<QVector<Cell> >(width, QVector<Cell>(height));
+    resize(width, height);
 
     QDataStream ds(&ba, QIODevice::ReadOnly);
 
@@ -188,17 +264,16 @@ void GridMap::load(QSettings& config)
     m_exploredCellCount = 0;
     m_freeCellCount = width * height;
 
+    // the file format stores the map column by column
     for (int a = 0; a < width; ++a) {
-        QVector<Cell>& row = m_map[a];
         for (int b = 0; b < height; ++b) {
-            Cell& cell = row[b];
-            cell.load(ds);
-            cell.setIndex(QPoint(a, b));
-            if (cell.state() & Cell::Frontier) {
-                m_frontierCache.append(&cell);
+            Cell c = cell(a, b);
+            c.load(ds);
+            if (c.state() & Cell::Frontier) {
+                m_frontierCache.append(c);
             }
-            if (cell.state() & Cell::Free) {
-                if (cell.state() & Cell::Explored) {
+            if (c.state() & Cell::Free) {
+                if (c.state() & Cell::Explored) {
                     ++m_exploredCellCount;
                 }
             } else {
@@ -217,9 +292,8 @@ void GridMap::save(QSettings& config)
     // write map size
     const QSize s = size();
     for (int a = 0; a < s.width(); ++a) {
-        QVector<Cell>& row = m_map[a];
         for (int b = 0; b < s.height(); ++b) {
-            row[b].save(ds);
+            cell(a, b).save(ds);
         }
     }
 
@@ -231,15 +305,10 @@ void GridMap::save(QSettings& config)
     config.endGroup();
 }
 
-QSize GridMap::displaySize() const
-{
-    return m_pixmapCache.size();
-}
-
 QSize GridMap::size() const
 {
-    if (m_map.size() && m_map[0].size()) {
-        return QSize(m_map.size(), m_map[0].size());
+    if (m_width && m_height) {
+        return QSize(m_width, m_height);
     }
 
     return QSize(0, 0);
@@ -247,20 +316,14 @@ QSize GridMap::size() const
 
 QSizeF GridMap::worldSize() const
 {
-    const int w = m_map.size();
-    const int h = w > 0 ? m_map[0].size() : 0;
-
-    return QSizeF(m_resolution * w,
-                  m_resolution * h);
+    return QSizeF(m_resolution * m_width,
+                  m_resolution * m_height);
 }
 
 QPointF GridMap::center() const
 {
-    const int w = m_map.size();
-    const int h = w > 0 ? m_map[0].size() : 0;
-
-    return QPointF(m_resolution * w / 2,
-                   m_resolution * h / 2);
+    return QPointF(m_resolution * m_width / 2,
+                   m_resolution * m_height / 2);
 }
 
 double GridMap::convexDiameter() const
@@ -270,146 +333,135 @@ double GridMap::convexDiameter() const
     return m_resolution * sqrt(w * w + h * h);
 }
 
-Cell& GridMap::cell(int xIndex, int yIndex)
-{
-    // assert on index-out-of-range
-    Q_ASSERT(xIndex >= 0 && yIndex >= 0 && xIndex < size().width() && yIndex < size().height());
-    return m_map[xIndex][yIndex];
-}
-
-Cell& GridMap::cell(const QPoint & cellIndex)
-{
-    return cell(cellIndex.x(), cellIndex.y());
-}
-
-qreal GridMap::scaleFactor() const
-{
-    return Config::self()->zoom() / m_resolution;
-}
-
-void GridMap::incScaleFactor()
+void GridMap::updateDensity()
 {
-    Config::self()->zoomIn();
-}
+    Q_ASSERT(m_state.size() > 0);
+
+    const int cellCount = m_state.size();
+    const quint8* state = m_state.constData();
+    const float* frontierDist = m_frontierDist.constData();
+    float* density = m_density.data();
+
+    // store the exponents, then evaluate exp() over the whole plane at once.
+    // exp(0) yields the density 1 of unexplored cells and obstacles.
+    for (int i = 0; i < cellCount; ++i) {
+        if (state[i] & Cell::Explored &&
+            state[i] & Cell::Free)
+        {
+            const float dist = frontierDist[i];
+            density[i] = -0.5f/(2*2)*dist*dist;
+        } else {
+            density[i] = 0.0f;
+        }
+    }
+    FastMath::exp(density, density, cellCount);
+    ++m_densityRevision;
 
-void GridMap::decScaleFactor()
-{
-    Config::self()->zoomOut();
+    updateMomentTable();
 }
 
-void GridMap::updateDensity()
+void GridMap::updateMomentTable()
 {
-    Q_ASSERT(m_map.size() > 0);
-    
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() & Cell::Explored &&
-                c.state() & Cell::Free)
-            {
-                float dist = c.frontierDist();
-                c.setDensity(exp(-0.5/(2*2)*dist*dist));
-            } else {
-                c.setDensity(1.0);
-            }
+    MomentTable& table = m_momentTable;
+    table.m_map = this;
+    table.m_revision = m_revision;
+    table.m_width = m_width;
+    table.m_height = m_height;
+
+    const int stride = m_width + 1;
+    const int entries = stride * (m_height + 1);
+    table.m_mass.fill(0.0, entries);
+    table.m_x.fill(0.0, entries);
+    table.m_y.fill(0.0, entries);
+    table.m_occluders.fill(0, entries);
+
+    // The frame around the map is a wall of obstacles with explored obstacles
+    // behind it. Every frame cell is visible from inside, so the frame only
+    // counts as occluder if it is not intact (e.g. in a loaded map).
+    bool frameIntact = true;
+    for (int i = 0; i < m_state.size() && frameIntact; ++i) {
+        const int a = i % m_width;
+        const int b = i / m_width;
+        const int edge = qMin(qMin(a, b), qMin(m_width - 1 - a, m_height - 1 - b));
+        if (edge < border) {
+            frameIntact = m_state[i] == (Cell::Explored | Cell::Obstacle);
+        } else if (edge == border) {
+            frameIntact = m_state[i] & Cell::Obstacle;
         }
     }
-}
 
-void GridMap::updateCache()
-{
-    const int sizex = m_map.size();
-    const int sizey = sizex > 0 ? m_map[0].size() : 0;
+    const quint8* state = m_state.constData();
+    const float* density = m_density.constData();
 
-    if (sizex == 0 || sizey == 0) {
-        m_pixmapCache = QPixmap();
-        return;
-    }
+    for (int b = 0; b < m_height; ++b) {
+        const double y = (b + 0.5) * m_resolution;
 
-    const qreal w = m_resolution;
-    const qreal scale = scaleFactor();
+        // running sums of the current row
+        double mass = 0.0;
+        double mx = 0.0;
+        double my = 0.0;
+        int occluders = 0;
 
-    // create QPixmap spanning the entire space Q
-    if (m_pixmapCache.width() != scale * sizex * w + 1 ||
-        m_pixmapCache.height() != scale * sizey * w + 1)
-    {
-        m_pixmapCache = QPixmap(scale * sizex * w + 1, scale * sizey * w + 1);
-    }
-    m_pixmapCache.fill();
+        for (int a = 0; a < m_width; ++a) {
+            const int index = linearIndex(a, b);
+            const int edge = qMin(qMin(a, b), qMin(m_width - 1 - a, m_height - 1 - b));
 
-    // finally draw to pixmap cache
-    QPainter p(&m_pixmapCache);
-    p.scale(scaleFactor(), scaleFactor());
-    for (int a = 0; a < m_map.size(); ++a) {
-        QVector<Cell>& row = m_map[a];
-        for (int b = 0; b < row.size(); ++b) {
-            row[b].draw(p, Config::self()->showDensity(), Config::self()->showVectorField());
-        }
-    }
+            if (state[index] & Cell::Obstacle && (edge > border || !frameIntact)) {
+                ++occluders;
+            }
 
-    m_partitionMap.clear();
-    if (Config::self()->showPartition() && RobotManager::self()->count() > 1) {
-        // create a QPainterPath for each robot
-        for (int a = 0; a < m_map.size(); ++a) {
-            QVector<Cell>& row = m_map[a];
-            for (int b = 0; b < row.size(); ++b) {
-                Robot* robot = row[b].robot();
-                if (robot)
-                    m_partitionMap[robot].addRect(row[b].rect());
+            if (state[index] != (Cell::Explored | Cell::Obstacle)) {
+                const double x = (a + 0.5) * m_resolution;
+                const double rho = density[index];
+                mass += rho;
+                mx += rho * x;
+                my += rho * y;
             }
-        }
 
-        // simplify each painter path
-        QMapIterator<Robot*, QPainterPath> it(m_partitionMap);
-        while (it.hasNext()) {
-            it.next();
-            m_partitionMap[it.key()] = it.value().simplified();
+            const int above = b * stride + a + 1;
+            const int entry = above + stride;
+            table.m_mass[entry] = table.m_mass[above] + mass;
+            table.m_x[entry] = table.m_x[above] + mx;
+            table.m_y[entry] = table.m_y[above] + my;
+            table.m_occluders[entry] = table.m_occluders[above] + occluders;
         }
     }
-}
-
-void GridMap::draw(QPainter& p)
-{
-    p.drawPixmap(0, 0, m_pixmapCache);
-
-    p.save();
-    p.scale(scaleFactor(), scaleFactor());
-
-    QMapIterator<Robot*, QPainterPath> it(m_partitionMap);
-    while (it.hasNext()) {
-        it.next();
-        QColor col(it.key()->color());
-        p.setPen(QPen(col, m_resolution * 0.3));
-        col.setAlpha(96);
-        p.setBrush(col);
-        p.drawPath(it.value());
-    }
-
-//     foreach (Cell* c, m_frontierCache) {
-//         p.fillRect(c->rect(), Qt::blue);
-//     }
-//     qDebug() << m_frontierCache.size();
-
-    p.restore();
-}
 
-void GridMap::updateCell(int xIndex, int yIndex)
-{
-    updateCell(m_map[xIndex][yIndex]);
+    updateMomentRegions();
 }
 
-void GridMap::updateCell(Cell& cell)
+void GridMap::updateMomentRegions()
 {
-    QPainter p(&m_pixmapCache);
-    p.scale(scaleFactor(), scaleFactor());
-    cell.draw(p, Config::self()->showDensity(), Config::self()->showVectorField());
+    MomentTable& table = m_momentTable;
+    table.m_partitionRevision = m_partitionRevision;
+    table.m_regions.fill(DensityMoments(), m_robots.size());
+
+    const quint8* state = m_state.constData();
+    const float* density = m_density.constData();
+    const quint8* robotId = m_robotId.constData();
+
+    for (int b = 0; b < m_height; ++b) {
+        const double y = (b + 0.5) * m_resolution;
+        for (int a = 0; a < m_width; ++a) {
+            const int index = linearIndex(a, b);
+            if (state[index] != (Cell::Explored | Cell::Obstacle)) {
+                table.m_regions[robotId[index]].add(QPointF((a + 0.5) * m_resolution, y), density[index]);
+            }
+        }
+    }
 }
 
-bool GridMap::setState(Cell& cell, Cell::State state)
+bool GridMap::setState(Cell cell, Cell::State state)
 {
     const Cell::State oldState = cell.state();
-    cell.setState(state);
-    const Cell::State newState = cell.state();
+    const Cell::State newState = Cell::mergeState(oldState, state);
+    m_state[cell.m_index] = newState;
+    if (newState != oldState) {
+        ++m_revision;
+        foreach (GridMapObserver* observer, m_observers) {
+            observer->cellStateChanged(cell, oldState, newState);
+        }
+    }
 
     const bool wasFrontier = oldState & Cell::Frontier;
     const bool isFrontier  = newState & Cell::Frontier;
@@ -422,9 +474,9 @@ bool GridMap::setState(Cell& cell, Cell::State state)
 
     // update frontier cache
     if (wasFrontier && !isFrontier) {
-        m_frontierCache.removeOne(&cell);
+        m_frontierCache.removeOne(cell);
     } else if (!wasFrontier && isFrontier) {
-        m_frontierCache.append(&cell);
+        m_frontierCache.append(cell);
     }
 
     // update free cell count
@@ -462,55 +514,22 @@ inline static bool inCircle(qreal x, qreal y, qreal radius, qreal px, qreal py)
     return (dx*dx + dy*dy) <= radius*radius;
 }
 
-bool GridMap::exploreCell(const QPoint& center, const QPoint& target, qreal radius, Cell::State targetState)
+bool GridMap::exploreCell(const QPoint& target, int coverage, Cell::State targetState)
 {
-    // check validity
-    if (!isValidField(target.x(), target.y()))
-        return false;
-
-    Cell& c = m_map[target.x()][target.y()];
+    Cell c = cell(target);
 
     // exit, if nothing to change
     if (c.state() & targetState)
         return false;
 
-    // count the corners lying in the circle
-    const QRectF& r = c.rect();
-    const qreal x1 = r.left();
-    const qreal x2 = r.right();
-    const qreal y1 = r.top();
-    const qreal y2 = r.bottom();
-
-    Cell& centerCell = m_map[center.x()][center.y()];
-    const qreal xCenter = centerCell.center().x();
-    const qreal yCenter = centerCell.center().y();
-
-    int count = 0;
-    if (inCircle(xCenter, yCenter, radius, x1, y1)) ++count;
-    if (inCircle(xCenter, yCenter, radius, x1, y2)) ++count;
-    if (inCircle(xCenter, yCenter, radius, x2, y1)) ++count;
-    if (inCircle(xCenter, yCenter, radius, x2, y2)) ++count;
-
-    // exit, if outside radius
-    if (count == 0)
-        return false;
-
-    // make sure the path is visible
-    if (!pathVisible(center, target))
-        return false;
-
     // if inside, mark as targetState, otherwise as Frontier
     bool changed = false;
-    if (count == 4) {
+    if (coverage == 4) {
         changed = setState(c, targetState);
     } else {
         changed = setState(c, c.isObstacle() ? targetState : Cell::Frontier);
     }
 
-    // update pixmap cache
-    if (changed)
-        updateCell(target.x(), target.y());
-
     return changed;
 }
 
@@ -527,70 +546,52 @@ bool GridMap::exploreInRadius(const QPointF& worldPos, double radius, bool markA
     const int yCell = yCenter / resolution();
     const QPoint robotIndex(xCell, yCell);
 
+    if (!isValidField(robotIndex))
+        return false;
+
     bool changed = false;
-    int count = 0;
 
     //
-    // 1. explore from the center rectangular to the outside
+    // 1. explore all visible cells, the circle is centered in the robot's cell
     //
-    while (count * m_resolution <= radius) {
-
-        // explore square-like from left to right
-        for (int dx = -count; dx <= count; ++dx) {
-            const int x = xCell + dx;
-            changed = exploreCell(robotIndex, QPoint(x, yCell + count), radius, targetState) || changed;
-            changed = exploreCell(robotIndex, QPoint(x, yCell - count), radius, targetState) || changed;
-        }
-
-        // explore square-like from top to bottom
-        for (int dy = -count; dy <= count; ++dy) {
-            const int y = yCell + dy;
-            changed = exploreCell(robotIndex, QPoint(xCell + count, y), radius, targetState) || changed;
-            changed = exploreCell(robotIndex, QPoint(xCell - count, y), radius, targetState) || changed;
-        }
-
-        // add 4 missing corners
-        changed = exploreCell(robotIndex, QPoint(xCell + count, yCell + count), radius, targetState) || changed;
-        changed = exploreCell(robotIndex, QPoint(xCell + count, yCell - count), radius, targetState) || changed;
-        changed = exploreCell(robotIndex, QPoint(xCell - count, yCell + count), radius, targetState) || changed;
-        changed = exploreCell(robotIndex, QPoint(xCell - count, yCell - count), radius, targetState) || changed;
+    const CircleFootprint& footprint = mapFootprint(radius);
+    QVector<QPoint> visible;
+    castFieldOfView(robotIndex, footprint, false, visible);
 
-        ++count;
+    foreach (const QPoint& target, visible) {
+        const int coverage = footprint.coverage(target.x() - xCell, target.y() - yCell);
+        changed = exploreCell(target, coverage, targetState) || changed;
     }
 
     //
     // 2. neighbors to explored cells are either frontiers or explored
     //
-    const int minCellX = 0;
-    const int minCellY = 0;
-    const int maxCellX = m_map.size() - 1;
-    const int maxCellY = maxCellX > 0 ? m_map[0].size() - 1 : 0;
-
     const int xStart = qMax(0, xCell - cellRadius - 1);
-    const int xEnd = qMin(size().width() - 1, xCell + cellRadius + 1);
+    const int xEnd = qMin(m_width - 1, xCell + cellRadius + 1);
 
     const int yStart = qMax(0, yCell - cellRadius - 1);
-    const int yEnd = qMin(size().height() - 1, yCell + cellRadius + 1);
+    const int yEnd = qMin(m_height - 1, yCell + cellRadius + 1);
 
-    for (int a = xStart; a <= xEnd; ++a) {
-        for (int b = yStart; b <= yEnd; ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() & (Cell::Frontier | targetState /*| Cell::Obstacle*/)) continue;
+    for (int b = yStart; b <= yEnd; ++b) {
+        for (int a = xStart; a <= xEnd; ++a) {
+            const int index = linearIndex(a, b);
+            const quint8 state = m_state[index];
+            if (state & (Cell::Frontier | targetState /*| Cell::Obstacle*/)) continue;
 
+            // check the 8-neighborhood for a free cell with targetState
             bool freeNeighbor = false;
-            if ((a > minCellX && b > minCellY && m_map[a-1][b-1].state() & targetState && !(m_map[a-1][b-1].state() & Cell::Obstacle)) ||
-                (                b > minCellY && m_map[a  ][b-1].state() & targetState && !(m_map[a  ][b-1].state() & Cell::Obstacle)) ||
-                (a < maxCellX && b > minCellY && m_map[a+1][b-1].state() & targetState && !(m_map[a+1][b-1].state() & Cell::Obstacle)) ||
-                (a > minCellX &&                 m_map[a-1][b  ].state() & targetState && !(m_map[a-1][b  ].state() & Cell::Obstacle)) ||
-                (a < maxCellX &&                 m_map[a+1][b  ].state() & targetState && !(m_map[a+1][b  ].state() & Cell::Obstacle)) ||
-                (a > minCellX && b < maxCellY && m_map[a-1][b+1].state() & targetState && !(m_map[a-1][b+1].state() & Cell::Obstacle)) ||
-                (                b < maxCellY && m_map[a  ][b+1].state() & targetState && !(m_map[a  ][b+1].state() & Cell::Obstacle)) ||
-                (a < maxCellX && b < maxCellY && m_map[a+1][b+1].state() & targetState && !(m_map[a+1][b+1].state() & Cell::Obstacle))
-                ) freeNeighbor = true;
+            for (int i = 0; i < 8 && !freeNeighbor; ++i) {
+                const int x = a + directionMap[i][0];
+                const int y = b + directionMap[i][1];
+                if (!isValidField(x, y))
+                    continue;
+
+                const quint8 neighborState = m_state[linearIndex(x, y)];
+                freeNeighbor = (neighborState & targetState) && !(neighborState & Cell::Obstacle);
+            }
 
             if (freeNeighbor) {
-                changed = setState(c, c.isObstacle() ? targetState : Cell::Frontier) || changed;
-                updateCell(a, b);
+                changed = setState(Cell(this, index), (state & Cell::Obstacle) ? targetState : Cell::Frontier) || changed;
             }
         }
     }
@@ -600,159 +601,255 @@ bool GridMap::exploreInRadius(const QPointF& worldPos, double radius, bool markA
 
 void GridMap::unexploreAll()
 {
-    const QSize s = size();
-    for (int a = 0; a < s.width(); ++a) {
-        QVector<Cell>& row = m_map[a];
-        for (int b = 0; b < s.height(); ++b) {
-            setState(row[b], Cell::Unknown);
+    const int cellCount = m_state.size();
+    for (int i = 0; i < cellCount; ++i) {
+        setState(Cell(this, i), Cell::Unknown);
+    }
+}
+
+QVector<Cell> GridMap::visibleCells(const QPointF& worldPos, double radius)
+{
+    const QPoint center(worldPos.x() / resolution(), worldPos.y() / resolution());
+
+    QVector<Cell> cellVector;
+    if (!isValidField(center)) {
+        return cellVector;
+    }
+
+    QVector<QPoint> visible;
+    castFieldOfView(center, mapFootprint(radius), false, visible);
+
+    foreach (const QPoint& pt, visible) {
+        Cell c = cell(pt);
+        if (c.state() != (Cell::Explored | Cell::Obstacle)) {
+            cellVector.append(c);
         }
     }
+    return cellVector;
 }
 
-QVector<Cell*> GridMap::visibleCells(const QPointF& worldPos, double radius)
+bool GridMap::densityMoments(const QPointF& worldPos, double radius, Robot* robot, DensityMoments& moments) const
 {
-    const qreal x = worldPos.x();
-    const qreal y = worldPos.y();
+    moments = DensityMoments();
 
-    int cellX = x / resolution();
-    int cellY = y / resolution();
+    const QPoint center(worldPos.x() / resolution(), worldPos.y() / resolution());
+    if (!isValidField(center)) {
+        return true;
+    }
 
-    QVector<Cell*> cellVector;
-    if (!isValidField(cellX, cellY)) {
-        return cellVector;
+    if (!m_momentTable.isUpToDate(*this)) {
+        return false;
     }
 
-    const int cellRadius = ceil(radius / resolution());
+    const CircleFootprint& footprint = mapFootprint(radius);
+    const int r = footprint.radius();
+    const QRect box = QRect(center.x() - r, center.y() - r, 2 * r + 1, 2 * r + 1)
+                      .intersected(QRect(0, 0, m_width, m_height));
 
-    int xStart = qMax(0, cellX - cellRadius);
-    int xEnd = qMin(size().width() - 1, cellX + cellRadius);
+    // without occlusion, exactly the cells of the footprint are visible
+    if (m_momentTable.hasOccluders(box)) {
+        return false;
+    }
 
-    int yStart = qMax(0, cellY - cellRadius - 1);
-    int yEnd = qMin(size().height() - 1, cellY + cellRadius);
+    // the footprint covers the whole map, if it covers its corner cells
+    const bool coversMap =
+        footprint.coverage(-center.x(), -center.y()) > 0 &&
+        footprint.coverage(m_width - 1 - center.x(), -center.y()) > 0 &&
+        footprint.coverage(-center.x(), m_height - 1 - center.y()) > 0 &&
+        footprint.coverage(m_width - 1 - center.x(), m_height - 1 - center.y()) > 0;
 
-    for (int a = xStart; a <= xEnd; ++a) {
-        for (int b = yStart; b <= yEnd; ++b) {
-            Cell& c = m_map[a][b];
-            if (!(c.state() == (Cell::Explored | Cell::Obstacle))
-                && pathVisible(QPoint(cellX, cellY), QPoint(a, b)))
-            {
-                const QRectF& r = c.rect();
-                const qreal x1 = r.left();
-                const qreal x2 = r.right();
-                const qreal y1 = r.top();
-                const qreal y2 = r.bottom();
-
-                bool visible = inCircle(x, y, radius, x1, y1)
-                            || inCircle(x, y, radius, x1, y2)
-                            || inCircle(x, y, radius, x2, y1)
-                            || inCircle(x, y, radius, x2, y2);
-
-                if (visible) {
-                    cellVector.append(&c);
-                }
-            }
+    if (robot) {
+        // Voronoi cells are no rectangles
+        if (!coversMap) {
+            return false;
+        }
+        if (!m_momentTable.regionsUpToDate(*this)) {
+            return false;
         }
+        const int id = findRobotId(robot);
+        if (id >= 0) {
+            moments = m_momentTable.region(id);
+        }
+        return true;
     }
-    return cellVector;
+
+    if (coversMap) {
+        moments = m_momentTable.moments(box);
+        return true;
+    }
+
+    // sum up the footprint row by row
+    for (int y = box.top(); y <= box.bottom(); ++y) {
+        int rowRadius = footprint.rowRadius(y - center.y());
+        if (y == center.y()) {
+            // the center is always visible
+            rowRadius = qMax(rowRadius, 0);
+        } else if (rowRadius < 0) {
+            continue;
+        }
+
+        const int left = qMax(center.x() - rowRadius, 0);
+        const int right = qMin(center.x() + rowRadius, m_width - 1);
+        moments += m_momentTable.moments(QRect(QPoint(left, y), QPoint(right, y)));
+    }
+    return true;
 }
 
 int GridMap::numVisibleCellsUnrestricted(const QPointF& worldPos, double radius)
 {
-    const qreal x = worldPos.x();
-    const qreal y = worldPos.y();
+    const QPoint center(worldPos.x() / resolution(), worldPos.y() / resolution());
+
+    if (!isValidField(center)) {
+        return 0;
+    }
 
-    int cellX = x / resolution();
-    int cellY = y / resolution();
+    QVector<QPoint> visible;
+    castFieldOfView(center, mapFootprint(radius), true, visible);
 
+    // cells outside the map count as visible virtual cells
     int result = 0;
-    if (!isValidField(cellX, cellY)) {
-        return 0;
+    foreach (const QPoint& pt, visible) {
+        if (!isValidField(pt) || m_state[linearIndex(pt.x(), pt.y())] != (Cell::Explored | Cell::Obstacle)) {
+            ++result;
+        }
     }
+    return result;
+}
 
-    const int cellRadius = ceil(radius / resolution());
+//BEGIN field of view
+const CircleFootprint& GridMap::mapFootprint(double radius) const
+{
+    // Within the map, a footprint larger than the map diagonal covers the
+    // same cells completely. Clamping keeps huge ranges (e.g. 1000000 as
+    // 'unlimited') from allocating huge footprints.
+    const double maxRadius = sqrt(double(m_width) * m_width + double(m_height) * m_height) + 1.0;
+    return CircleFootprint::footprint(qMin(radius / m_resolution, maxRadius));
+}
 
-    // TODO: warum bei yStart -1 und bei x nicht?
-    int xStart = cellX - cellRadius;
-    int xEnd = cellX + cellRadius;
+struct GridMap::FieldOfView
+{
+    QPoint center;
+    const CircleFootprint* footprint;
+    bool unrestricted;
+    bool* lit;                  // footprint-sized mask, row-major
+};
 
-    int yStart = cellY - cellRadius - 1;
-    int yEnd = cellY + cellRadius;
+bool GridMap::blocksView(int x, int y, bool unrestricted) const
+{
+    if (!isValidField(x, y)) {
+        return !unrestricted;
+    }
 
-    for (int a = xStart; a <= xEnd; ++a) {
-        for (int b = yStart; b <= yEnd; ++b) {
-            if (isValidField(a, b))
-            {
-                Cell& c = m_map[a][b];
-                if (!(c.state() == (Cell::Explored | Cell::Obstacle))
-                    && pathVisibleUnrestricted(QPoint(cellX, cellY), QPoint(a, b)))
-                {
-                    const QRectF& r = c.rect();
-                    const qreal x1 = r.left();
-                    const qreal x2 = r.right();
-                    const qreal y1 = r.top();
-                    const qreal y2 = r.bottom();
-
-                    bool visible = inCircle(x, y, radius, x1, y1)
-                                || inCircle(x, y, radius, x1, y2)
-                                || inCircle(x, y, radius, x2, y1)
-                                || inCircle(x, y, radius, x2, y2);
-
-                    if (visible) {
-                        ++result;
-                    }
-                }
-            }
-            else if (pathVisibleUnrestricted(QPoint(cellX, cellY), QPoint(a, b)))
-            {
-                // create virtual cell
-                QRectF r(a * m_resolution, b * m_resolution, m_resolution, m_resolution);
-                
-                const qreal x1 = r.left();
-                const qreal x2 = r.right();
-                const qreal y1 = r.top();
-                const qreal y2 = r.bottom();
-
-                bool visible = inCircle(x, y, radius, x1, y1)
-                            || inCircle(x, y, radius, x1, y2)
-                            || inCircle(x, y, radius, x2, y1)
-                            || inCircle(x, y, radius, x2, y2);
-
-                if (visible) {
-                    ++result;
-                }
+    const quint8 state = m_state[linearIndex(x, y)];
+    if (unrestricted) {
+        return (state & (Cell::Obstacle | Cell::Explored)) == (Cell::Obstacle | Cell::Explored);
+    }
+    return state & Cell::Obstacle;
+}
+
+void GridMap::castFieldOfView(const QPoint& center, const CircleFootprint& footprint,
+                              bool unrestricted, QVector<QPoint>& visible)
+{
+    // octant transformations
+    static const int mult[4][8] = {
+        { 1,  0,  0, -1, -1,  0,  0,  1 },
+        { 0,  1, -1,  0,  0, -1,  1,  0 },
+        { 0,  1,  1,  0,  0, -1, -1,  0 },
+        { 1,  0,  0,  1, -1,  0,  0, -1 }
+    };
+
+    const int radius = footprint.radius();
+    const int size = 2 * radius + 1;
+
+    // the mask is reused per thread and all false on entry
+    QVector<bool>& mask = SearchWorkspace::threadLocal().visibilityMask(size * size);
+
+    FieldOfView fov;
+    fov.center = center;
+    fov.footprint = &footprint;
+    fov.unrestricted = unrestricted;
+    fov.lit = mask.data();
+
+    // the center is always visible
+    fov.lit[radius * size + radius] = true;
+
+    for (int octant = 0; octant < 8; ++octant) {
+        castLight(fov, 1, 1.0, 0.0, mult[0][octant], mult[1][octant], mult[2][octant], mult[3][octant]);
+    }
+
+    // the mask also removes duplicates along the octant borders
+    visible.clear();
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            bool& lit = fov.lit[(dy + radius) * size + dx + radius];
+            if (lit) {
+                visible.append(QPoint(center.x() + dx, center.y() + dy));
+                lit = false;
             }
         }
     }
-    return result;
 }
 
-QVector<Cell*> GridMap::visibleCells(Robot* robot, double radius)
+void GridMap::castLight(FieldOfView& fov, int row, double start, double end,
+                        int xx, int xy, int yx, int yy)
 {
-    Q_ASSERT(robot);
+    if (start < end)
+        return;
 
-    // if only one robot exists, just return all visible cells
-    QVector<Cell*> visibleList = visibleCells(robot->position(), radius);
-    if (RobotManager::self()->count() == 1) {
-        return visibleList;
-    }
+    const int radius = fov.footprint->radius();
+    const int size = 2 * radius + 1;
+    double newStart = 0.0;
 
-    // make sure the cell is assigned to this robot
-    QVector<Cell*> cellVector;
-    for (QVector<Cell*>::const_iterator it = visibleList.begin(); it != visibleList.end(); ++it)
-    {
-        if ((*it)->robot() == robot) {
-            cellVector.append(*it);
+    for (int j = row; j <= radius; ++j) {
+        const int dy = -j;
+        bool blocked = false;
+
+        for (int dx = -j; dx <= 0; ++dx) {
+            const double leftSlope = (dx - 0.5) / (dy + 0.5);
+            const double rightSlope = (dx + 0.5) / (dy - 0.5);
+
+            if (start < rightSlope)
+                continue;
+            if (end > leftSlope)
+                break;
+
+            // octant coordinates to map offsets
+            const int ox = dx * xx + dy * xy;
+            const int oy = dx * yx + dy * yy;
+            const int x = fov.center.x() + ox;
+            const int y = fov.center.y() + oy;
+
+            if (fov.footprint->coverage(ox, oy) > 0 && (fov.unrestricted || isValidField(x, y))) {
+                fov.lit[(oy + radius) * size + ox + radius] = true;
+            }
+
+            const bool opaque = blocksView(x, y, fov.unrestricted);
+            if (blocked) {
+                if (opaque) {
+                    newStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                start = newStart;
+            } else if (opaque && j < radius) {
+                // scan the part left of the obstacle in the next rows
+                blocked = true;
+                castLight(fov, j + 1, start, leftSlope, xx, xy, yx, yy);
+                newStart = rightSlope;
+            }
         }
-    }
 
-    return cellVector;
+        if (blocked)
+            break;
+    }
 }
+//END field of view
 
-void GridMap::filterCells(QVector<Cell*> & cells, Robot* robot)
+void GridMap::filterCells(QVector<Cell> & cells, Robot* robot)
 {
+    const int id = findRobotId(robot);
     for (int i = 0; i < cells.size(); ) {
-        Cell* c = cells[i];
-        if (c->robot() != robot) {
+        if (m_robotId[cells[i].m_index] != id) {
             // swap with last element, then delete last
             qSwap(cells[i], cells.last());
             cells.pop_back();
@@ -768,25 +865,55 @@ void GridMap::updateRobotFrontierCache()
     m_robotFrontierCache.clear();
 
     // shortcut for only one robot
-    if (RobotManager::self()->count() == 1) {
+    if (m_team.size() == 1) {
         if (m_frontierCache.size() > 0)
-            m_robotFrontierCache[RobotManager::self()->robot(0)] = m_frontierCache;
+            m_robotFrontierCache[m_team[0]] = m_frontierCache;
         return;
     }
 
     // now assign each frontier cell to the correct list
-    foreach (Cell* c, m_frontierCache) {
-        m_robotFrontierCache[c->robot()].append(c);
+    foreach (const Cell& c, m_frontierCache) {
+        m_robotFrontierCache[c.robot()].append(c);
+    }
+}
+
+const QList<FrontierSegment>& GridMap::frontierSegments()
+{
+    return m_frontierSegmentation->segments();
+}
+
+QList<FrontierSegment> GridMap::frontierSegments(Robot* robot)
+{
+    // same assignment as in updateRobotFrontierCache()
+    if (m_team.size() == 1) {
+        return m_team[0] == robot ? frontierSegments() : QList<FrontierSegment>();
+    }
+
+    QList<FrontierSegment> segments;
+    foreach (const FrontierSegment& segment, frontierSegments()) {
+        QList<Cell> cells;
+        foreach (const Cell& c, segment.m_cells) {
+            if (c.robot() == robot) {
+                cells.append(c);
+            }
+        }
+
+        if (cells.size() == segment.m_cells.size()) {
+            segments.append(segment);
+        } else if (!cells.isEmpty()) {
+            segments.append(FrontierSegment::fromCells(cells));
+        }
     }
+    return segments;
 }
 
-QList<Cell*> GridMap::frontiers(Robot* robot) const
+QList<Cell> GridMap::frontiers(Robot* robot) const
 {
     if (m_robotFrontierCache.contains(robot)) {
         return m_robotFrontierCache[robot];
     }
 
-    return QList<Cell*>();
+    return QList<Cell>();
 }
 
 bool GridMap::hasFrontiers(Robot* robot) const 
@@ -809,60 +936,97 @@ int GridMap::freeCellCount() const
 
 
 
-class PathField
+QList<Path> GridMap::frontierPaths(const QPoint& start, const QList<Cell>& frontiers, SearchWorkspace* workspace)
 {
-public:
-    PathField(const QPoint& field, Cell *cell)
-    {
-        x = field.x();
-        y = field.y();
-        this->cell = cell;
+    if (frontiers.isEmpty()) {
+        return QList<Path>();
     }
 
-    inline friend bool operator < (const PathField& lhs, const PathField& rhs)
-    {
-        return lhs.cell->m_costF < rhs.cell->m_costF;
-    }
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
 
-    inline friend bool operator == (const PathField& lhs, const PathField& rhs)
-    {
-        return lhs.cell->m_costF == rhs.cell->m_costF;
+//     QTime time;
+//     time.start();
+
+    frontierSearch(start, frontiers, frontiers.size(), -1.0f, ws);
+
+    QList<Path> frontierPaths;
+    foreach (const Cell& frontier, frontiers) {
+        frontierPaths.append(gridPath(frontier.linearIndex(), ws));
     }
 
-    int x, y;
-    Cell *cell;
-};
+//     qDebug() << "reconstruction" << time.elapsed();
 
+    return frontierPaths;
+}
 
-QList<Path> GridMap::frontierPaths(const QPoint& start, const QList<Cell*>& frontiers)
+QList<Path> GridMap::nearestFrontierPaths(const QPoint& start, const QList<Cell>& frontiers, int k, float maxCost, SearchWorkspace* workspace)
 {
-    if (frontiers.isEmpty()) {
+    if (frontiers.isEmpty() || k <= 0) {
         return QList<Path>();
     }
 
-//     QTime time;
-//     time.start();
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    frontierSearch(start, frontiers, k, maxCost, ws);
+
+    // reached frontiers, sorted by cost
+    QSet<int> targets;
+    foreach (const Cell& frontier, frontiers) {
+        targets.insert(frontier.linearIndex());
+    }
+
+    QVector<QPair<float, int> > reached;
+    foreach (int index, targets) {
+        if (ws.state(index) == SearchWorkspace::Closed
+            && (maxCost < 0.0f || ws.cost(index) <= maxCost))
+        {
+            reached.append(qMakePair(ws.cost(index), index));
+        }
+    }
+    qSort(reached.begin(), reached.end());
+
+    QList<Path> paths;
+    for (int i = 0; i < reached.size() && i < k; ++i) {
+        paths.append(gridPath(reached[i].second, ws));
+    }
+    return paths;
+}
+
+void GridMap::frontierSearch(const QPoint& start, const QList<Cell>& frontiers, int maxFrontiers, float maxCost, SearchWorkspace& ws)
+{
+    ws.reset(m_state.size());
 
-    // Multiset sowie ein Iterator
-    std::multiset<PathField> queue;
-    std::multiset<PathField>::iterator itr;
+    PriorityQueue& queue = ws.queue();
+
+    // the search stops once maxFrontiers of the frontiers are settled
+    QSet<int> openFrontiers;
+    foreach (const Cell& frontier, frontiers) {
+        openFrontiers.insert(frontier.linearIndex());
+    }
+    int remaining = qMin(maxFrontiers, openFrontiers.size());
 
     // Add starting square
-    Cell *pCell = &m_map[start.x()][start.y()];
-    pCell->m_costG = 0;
-    pCell->m_costF = 0;
-    pCell->setPathState(Cell::PathOpen);
-    queue.insert(PathField(start, pCell));
+    const int startIndex = linearIndex(start.x(), start.y());
+    ws.setCost(startIndex, 0);
+    ws.setState(startIndex, SearchWorkspace::Open);
+    queue.push(startIndex, 0);
 
-    while (!queue.empty())
+    while (!queue.isEmpty() && remaining > 0)
     {
         // Knoten mit den niedrigsten Kosten aus der Liste holen
 		// Get the node with the lowest cost from the list
-        PathField f = *queue.begin();
-        queue.erase(queue.begin());
+        const int baseIndex = queue.pop();
+
+        // all remaining cells are more expensive
+        if (maxCost >= 0.0f && ws.cost(baseIndex) > maxCost)
+            break;
 
-        f.cell->setPathState(Cell::PathClose);  // Jetzt geschlossen
-        int x = f.x, y = f.y;
+        ws.setState(baseIndex, SearchWorkspace::Closed);  // Jetzt geschlossen
+        if (openFrontiers.remove(baseIndex)) {
+            --remaining;
+        }
+
+        const int x = baseIndex % m_width;
+        const int y = baseIndex / m_width;
 
         // Alle angrenzenden Felder bearbeiten
 		// Process all adjacent fields
@@ -876,126 +1040,330 @@ QList<Path> GridMap::frontierPaths(const QPoint& start, const QList<Cell*>& fron
             if (!isValidField(ax, ay))
                 continue;
 
-            pCell = &m_map[ax][ay];
+            const int index = linearIndex(ax, ay);
 
             // Kosten um zu diesem Feld zu gelangen:
 			// Cost to get to this box:
             const float factor = i > 3 ? 1.41421356f : 1.0f;
-            float G = f.cell->m_costG + factor * pCell->cellCost();   // Vorherige + aktuelle Kosten vom Start
+            float G = ws.cost(baseIndex) + factor * Cell::cellCost(static_cast<Cell::State>(m_state[index]));   // Vorherige + aktuelle Kosten vom Start
 
             // Ignorieren wenn Knoten geschlossen ist und bessere Kosten hat
 			// Ignore if node is closed and has better cost
-            if (pCell->pathState() == Cell::PathClose && pCell->m_costG < G)
+            if (ws.state(index) == SearchWorkspace::Closed && ws.cost(index) < G)
                 continue;
 
             // Cell ist bereits in der Queue, nur ersetzen wenn Kosten besser
 			// Cell is already in the queue, only replace if better cost
-            if (pCell->pathState() == Cell::PathOpen)
+            if (ws.state(index) == SearchWorkspace::Open)
             {
-                if (pCell->m_costG < G)
+                if (ws.cost(index) < G)
                     continue;
-
-                // Alten Eintrag aus der Queue entfernen
-				// Remove the old entry from the queue
-                itr = queue.find(PathField(QPoint( ax, ay), pCell));
-                if (itr != queue.end())
-                {
-                    // Es k�nnen mehrere Eintr�ge mit den gleichen Kosten vorhanden sein
-                    // wir m�ssen den richtigen suchen
-					// There can be several records with all same cost exist
-					// We need the right search
-                    while ((*itr).cell != pCell)
-                        itr++;
-
-                    queue.erase(itr);
-                }
             }
 
             // Knoten berechnen
 			// Get node
-            pCell->m_costG  = G;
-            pCell->m_costF  = G + 0;
-            pCell->m_pathParent = i;
+            ws.setCost(index, G);
+            ws.setParent(index, i);
 
             // Zu OPEN hinzufuegen
-			// Add to OPEN
-            pCell->setPathState(Cell::PathOpen);
-            queue.insert(PathField( QPoint( ax, ay ), pCell));
+			// Add to OPEN, replaces the old entry if already queued
+            ws.setState(index, SearchWorkspace::Open);
+            queue.push(index, G + 0);
         }
     }
+}
 
-    QList<Path> frontierPaths;
-    foreach (Cell* frontier, frontiers) {
-        // den Weg vom Ziel zum Start zurueckverfolgen und markieren
-        int x = frontier->index().x();
-        int y = frontier->index().y();
-
-        Path path;
-        while (true) {
-            path.m_path.prepend(QPoint(x, y));
-            pCell = &m_map[x][y];
+Path GridMap::gridPath(int target, SearchWorkspace& ws)
+{
+    Path path;
+    if (ws.state(target) != SearchWorkspace::Closed)
+        return path;
 
-            // Abbrechen wenn wir am Startknoten angekommen sind
-            int nParent = pCell->m_pathParent;
-            if( nParent == -1 )
-                break;
+    // den Weg vom Ziel zum Start zurueckverfolgen und markieren
+    int x = target % m_width;
+    int y = target / m_width;
 
-            x -= directionMap[nParent][0];
-            y -= directionMap[nParent][1];
+    while (true) {
+        path.m_path.prepend(QPoint(x, y));
+        const int index = linearIndex(x, y);
 
-            path.m_cost += pCell->cellCost();
-            path.m_length += nParent < 4 ? 1.0f : 1.41421356f;
-        }
-        path.m_length *= resolution();
-        frontierPaths.append(path);
-    }
+        // Abbrechen wenn wir am Startknoten angekommen sind
+        int nParent = ws.parent(index);
+        if( nParent == -1 )
+            break;
 
-//     qDebug() << "reconstruction" << time.elapsed();
+        x -= directionMap[nParent][0];
+        y -= directionMap[nParent][1];
 
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[0].size(); ++b) {
-            Cell& cell = m_map[a][b];
-            cell.m_costF = 0.0f;
-            cell.m_costG = 0.0f;
-            cell.m_pathParent = -1;
-            cell.setPathState(Cell::PathNone);
-        }
+        path.m_cost += Cell::cellCost(static_cast<Cell::State>(m_state[index]));
+        path.m_length += nParent < 4 ? 1.0f : 1.41421356f;
     }
-//     qDebug() << "cleanup" << time.elapsed();
+    path.m_length *= resolution();
 
-    return frontierPaths;
+    return path;
 }
 
 
-Path GridMap::aStar(const QPoint& from, const QPoint& to)
+PathSummary GridMap::gridSummary(int target, SearchWorkspace& ws)
 {
-    QList<Cell*> dirtyCells;
+    PathSummary summary;
+    summary.m_target = QPoint(target % m_width, target / m_width);
+    if (ws.state(target) != SearchWorkspace::Closed)
+        return summary;
+
+    summary.m_reachable = true;
+
+    // same accounting as gridPath(), without storing the cells
+    int x = summary.m_target.x();
+    int y = summary.m_target.y();
+    while (true) {
+        const int index = linearIndex(x, y);
+        const int nParent = ws.parent(index);
+        if (nParent == -1)
+            break;
 
-//     QTime time;
-//     time.start();
+        summary.m_firstStep = QPoint(x, y);
+        x -= directionMap[nParent][0];
+        y -= directionMap[nParent][1];
 
-    // Multiset sowie ein Iterator
-    std::multiset<PathField> queue;
-    std::multiset<PathField>::iterator itr;
+        summary.m_cost += Cell::cellCost(static_cast<Cell::State>(m_state[index]));
+        summary.m_length += nParent < 4 ? 1.0f : 1.41421356f;
+    }
+    summary.m_length *= resolution();
+
+    return summary;
+}
+
+QVector<PathSummary> GridMap::frontierSummaries(const QPoint& start, const QList<Cell>& frontiers, SearchWorkspace* workspace)
+{
+    QVector<PathSummary> summaries;
+    if (frontiers.isEmpty()) {
+        return summaries;
+    }
+
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    frontierSearch(start, frontiers, frontiers.size(), -1.0f, ws);
+
+    summaries.reserve(frontiers.size());
+    foreach (const Cell& frontier, frontiers) {
+        summaries.append(gridSummary(frontier.linearIndex(), ws));
+    }
+    return summaries;
+}
+
+Path GridMap::gridPath(const QPoint& target, SearchWorkspace* workspace)
+{
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    return gridPath(linearIndex(target.x(), target.y()), ws);
+}
+
+
+void GridMap::computeFrontierField(FrontierField& field, const QList<Cell>& frontiers, SearchWorkspace* workspace)
+{
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    ws.reset(m_state.size());
+
+    PriorityQueue& queue = ws.queue();
+
+    // reverse Dijkstra: start at all frontiers at once, so that each cell
+    // ends up with the cost of its shortest path to the nearest frontier
+    foreach (const Cell& frontier, frontiers) {
+        const int index = frontier.linearIndex();
+        ws.setCost(index, 0);
+        ws.setState(index, SearchWorkspace::Open);
+        queue.push(index, 0);
+    }
+
+    while (!queue.isEmpty())
+    {
+        const int baseIndex = queue.pop();
+        ws.setState(baseIndex, SearchWorkspace::Closed);
+        const int x = baseIndex % m_width;
+        const int y = baseIndex / m_width;
+
+        // a path of a neighbor continues via this cell, so it pays for entering it
+        const float baseCost = Cell::cellCost(static_cast<Cell::State>(m_state[baseIndex]));
+
+        for (int i = 0; i < 8; ++i) {
+            int ax = x + directionMap[i][0];
+            int ay = y + directionMap[i][1];
+
+            if (!isValidField(ax, ay))
+                continue;
+
+            const int index = linearIndex(ax, ay);
+            if (ws.state(index) == SearchWorkspace::Closed)
+                continue;
+
+            const float factor = i > 3 ? 1.41421356f : 1.0f;
+            const float G = ws.cost(baseIndex) + factor * baseCost;
+
+            if (ws.state(index) == SearchWorkspace::Open && ws.cost(index) <= G)
+                continue;
+
+            ws.setCost(index, G);
+            ws.setParent(index, i);
+            ws.setState(index, SearchWorkspace::Open);
+            queue.push(index, G);
+        }
+    }
+
+    // copy result into the field
+    const int cellCount = m_state.size();
+    field.m_map = this;
+    field.m_revision = m_revision;
+    field.m_frontiers = frontiers;
+    field.m_width = m_width;
+    field.m_distance.resize(cellCount);
+    field.m_next.resize(cellCount);
+    field.m_waypoint.fill(-1, cellCount);
+
+    for (int i = 0; i < cellCount; ++i) {
+        if (ws.state(i) != SearchWorkspace::Closed) {
+            field.m_distance[i] = -1.0f;
+            field.m_next[i] = -1;
+            continue;
+        }
+
+        field.m_distance[i] = ws.cost(i);
+
+        // the parent direction points from the next cell to this cell
+        const int parent = ws.parent(i);
+        field.m_next[i] = parent < 0 ? -1
+            : linearIndex(i % m_width - directionMap[parent][0], i / m_width - directionMap[parent][1]);
+    }
+}
+
+// solution T of (T - a)^2 + (T - b)^2 = h^2 with T >= a, b, where a and b
+// are the neighbor values of two orthogonal axes (-1 if none), -1 if both are none
+static inline float eikonalUpdate(float a, float b, float h)
+{
+    if (a < 0.0f && b < 0.0f)
+        return -1.0f;
+    if (a < 0.0f || b < 0.0f || fabs(a - b) >= h)
+        return (a < 0.0f ? b : (b < 0.0f ? a : qMin(a, b))) + h;
+    return 0.5f * (a + b + sqrt(2.0f * h * h - (a - b) * (a - b)));
+}
+
+void GridMap::computeEikonalField(EikonalField& field, const QList<Cell>& seeds, float maxCost)
+{
+    const int cellCount = m_state.size();
+    field.m_map = this;
+    field.m_revision = m_revision;
+    field.m_seeds = seeds;
+    field.m_maxCost = maxCost;
+    field.m_width = m_width;
+    field.m_height = m_height;
+    field.m_resolution = m_resolution;
+    field.m_distance.fill(-1.0f, cellCount);
+
+    float* T = field.m_distance.data();
+    QVector<quint8> closed(cellCount, 0);
+
+    // The update below uses fractional costs, so the queue must order
+    // them exactly. A RadixBucket queue only orders the integer part.
+    PriorityQueue* queue = PriorityQueue::create(PriorityQueue::IndexedHeap);
+    queue->reset(cellCount);
+
+    foreach (const Cell& seed, seeds) {
+        const int index = seed.linearIndex();
+        T[index] = 0.0f;
+        queue->push(index, 0.0f);
+    }
+
+    while (!queue->isEmpty()) {
+        const int baseIndex = queue->pop();
+        if (maxCost >= 0.0f && T[baseIndex] > maxCost)
+            break;
+        closed[baseIndex] = 1;
+
+        const int xBase = baseIndex % m_width;
+        const int yBase = baseIndex / m_width;
+
+        // 8-neighborhood
+        for (int i = 0; i < 8; ++i) {
+            const int x = xBase + directionMap[i][0];
+            const int y = yBase + directionMap[i][1];
+            if (!isValidField(x, y))
+                continue;
+
+            const int index = linearIndex(x, y);
+            if (closed[index] || (m_state[index] & Cell::Obstacle))
+                continue;
+
+            // smallest accepted neighbor along each stencil axis, -1 for none:
+            // left/right, top/bottom, and the two diagonals
+            float axis[4] = { -1.0f, -1.0f, -1.0f, -1.0f };
+            for (int k = 0; k < 8; ++k) {
+                const int nx = x + directionMap[k][0];
+                const int ny = y + directionMap[k][1];
+                if (!isValidField(nx, ny) || !closed[linearIndex(nx, ny)])
+                    continue;
+
+                // do not pass between two diagonally adjacent obstacles
+                if (k >= 4 && (m_state[linearIndex(nx, y)] & Cell::Obstacle)
+                           && (m_state[linearIndex(x, ny)] & Cell::Obstacle))
+                    continue;
+
+                const int a = k < 4 ? (k & 1) : 2 + (k & 1);
+                const float t = T[linearIndex(nx, ny)];
+                if (axis[a] < 0.0f || t < axis[a])
+                    axis[a] = t;
+            }
+
+            // first-order upwind solutions of the axis-aligned and the
+            // diagonal stencil, the diagonal one reduces the error of the
+            // 4-neighborhood along the diagonals
+            const float f = Cell::cellCost(static_cast<Cell::State>(m_state[index]));
+            float t = eikonalUpdate(axis[0], axis[1], f);
+            const float diagonal = eikonalUpdate(axis[2], axis[3], 1.41421356f * f);
+            if (t < 0.0f || (diagonal >= 0.0f && diagonal < t))
+                t = diagonal;
+
+            if (T[index] < 0.0f || t < T[index]) {
+                T[index] = t;
+                queue->push(index, t);
+            }
+        }
+    }
+
+    delete queue;
+
+    // cells still queued when stopping at maxCost count as not reached
+    if (maxCost >= 0.0f) {
+        for (int i = 0; i < cellCount; ++i) {
+            if (!closed[i])
+                T[i] = -1.0f;
+        }
+    }
+}
+
+Path GridMap::aStar(const QPoint& from, const QPoint& to, SearchWorkspace* workspace)
+{
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    ws.reset(m_state.size(), false);
+
+//     QTime time;
+//     time.start();
+
+    PriorityQueue& queue = ws.queue();
 
     // 1.Add starting square
-    Cell *pCell = &m_map[from.x()][from.y()];
-    pCell->m_costG = 0;
-    pCell->m_costF = heuristic(from, to);
-    pCell->setPathState(Cell::PathOpen);
-    queue.insert(PathField(from, pCell));
+    const int fromIndex = linearIndex(from.x(), from.y());
+    ws.setCost(fromIndex, 0);
+    ws.setState(fromIndex, SearchWorkspace::Open);
+    queue.push(fromIndex, heuristic(from, to));
 
     bool success = false;
 
-    while (!queue.empty())
+    while (!queue.isEmpty())
     {
         // Knoten mit den niedrigsten Kosten aus der Liste holen
-        PathField f = *queue.begin();
-        queue.erase(queue.begin());
-        dirtyCells.append(f.cell);
+        const int baseIndex = queue.pop();
 
-        f.cell->setPathState(Cell::PathClose);  // Jetzt geschlossen
-        int x = f.x, y = f.y;
+        ws.setState(baseIndex, SearchWorkspace::Closed);  // Jetzt geschlossen
+        const int x = baseIndex % m_width;
+        const int y = baseIndex / m_width;
 
         // Wenn Ziel sind wir fertig
         if (x == to.x() && y == to.y()) {
@@ -1013,43 +1381,30 @@ Path GridMap::aStar(const QPoint& from, const QPoint& to)
             if (!isValidField(ax, ay))
                 continue;
 
-            pCell = &m_map[ax][ay];
+            const int index = linearIndex(ax, ay);
 
             // Kosten um zu diesem Feld zu gelangen:
             const float factor = i > 3 ? 1.41421356f : 1.0f;
-            float G = f.cell->m_costG + factor * pCell->cellCost();   // Vorherige + aktuelle Kosten vom Start
+            float G = ws.cost(baseIndex) + factor * Cell::cellCost(static_cast<Cell::State>(m_state[index]));   // Vorherige + aktuelle Kosten vom Start
 
             // Ignorieren wenn Knoten geschlossen ist und bessere Kosten hat
-            if (pCell->pathState() == Cell::PathClose && pCell->m_costG < G)
+            if (ws.state(index) == SearchWorkspace::Closed && ws.cost(index) < G)
                 continue;
 
             // Cell ist bereits in der Queue, nur ersetzen wenn Kosten besser
-            if (pCell->pathState() == Cell::PathOpen)
+            if (ws.state(index) == SearchWorkspace::Open)
             {
-                if (pCell->m_costG < G)
+                if (ws.cost(index) < G)
                     continue;
-
-                // Alten Eintrag aus der Queue entfernen
-                itr = queue.find(PathField(QPoint( ax, ay), pCell));
-                if (itr != queue.end())
-                {
-                    // Es k�nnen mehrere Eintr�ge mit den gleichen Kosten vorhanden sein
-                    // wir m�ssen den richtigen suchen
-                    while ((*itr).cell != pCell)
-                        itr++;
-
-                    queue.erase(itr);
-                }
             }
 
             // Knoten berechnen
-            pCell->m_costG  = G;
-            pCell->m_costF  = G + heuristic(QPoint(ax, ay), to); // Kosten vom Start + Kosten zum Ziel
-            pCell->m_pathParent = i;
+            ws.setCost(index, G);
+            ws.setParent(index, i);
 
-            // Zu OPEN hinzuf�gen
-            pCell->setPathState(Cell::PathOpen);
-            queue.insert(PathField( QPoint( ax, ay ), pCell));
+            // Zu OPEN hinzufuegen (ersetzt einen alten Eintrag)
+            ws.setState(index, SearchWorkspace::Open);
+            queue.push(index, G + heuristic(QPoint(ax, ay), to)); // Kosten vom Start + Kosten zum Ziel
         }
     }
 
@@ -1059,14 +1414,13 @@ Path GridMap::aStar(const QPoint& from, const QPoint& to)
 
     if (success) {
         // den Weg vom Ziel zum Start zurueckverfolgen und markieren
-        Cell *pCell = &m_map[to.x()][to.y()];
         int x = to.x();
         int y = to.y();
         int nParent;
 
         while (true) {
-            pCell = &m_map[x][y];
-            nParent = pCell->m_pathParent;
+            const int index = linearIndex(x, y);
+            nParent = ws.parent(index);
             path.m_path.prepend(QPoint(x, y));
 
             // Abbrechen wenn wir am Startknoten angekommen sind
@@ -1076,23 +1430,13 @@ Path GridMap::aStar(const QPoint& from, const QPoint& to)
             x -= directionMap[nParent][0];
             y -= directionMap[nParent][1];
 
-            path.m_cost += pCell->cellCost();
+            path.m_cost += Cell::cellCost(static_cast<Cell::State>(m_state[index]));
             path.m_length += nParent < 4 ? 1.0f : 1.41421356f;
         }
     }
 
 //     qDebug() << "reconstruction" << time.elapsed();
 
-    foreach (Cell* cell, dirtyCells) {
-        cell->m_costF = 0.0f;
-        cell->m_costG = 0.0f;
-        cell->m_pathParent = -1;
-        cell->setPathState(Cell::PathNone);
-    }
-//     qDebug() << "cleanup" << time.elapsed();
-
-    qDebug() << "dirty cells:" << dirtyCells.size();
-
     return path;
 }
 
@@ -1109,6 +1453,284 @@ float GridMap::heuristic(const QPoint& start, const QPoint& end)
         return qMin(dx, dy) * 1.4 + (qMax(dx, dy) - qMin(dx, dy));
 }
 
+bool GridMap::segmentCost(const QPoint& from, const QPoint& to, float& cost) const
+{
+    const int dx = to.x() - from.x();
+    const int dy = to.y() - from.y();
+    const int steps = qMax(qAbs(dx), qAbs(dy));
+
+    cost = 0.0f;
+    if (steps == 0)
+        return true;
+
+    // walk along the major axis. Where the line passes between two cells of
+    // the minor axis, both must be free, like in aaPathVisible(). The cost is
+    // taken from the cell nearest to the line.
+    const bool xMajor = qAbs(dx) >= qAbs(dy);
+    const int majorStep = (xMajor ? dx : dy) > 0 ? 1 : -1;
+    const int minorDelta = xMajor ? dy : dx;
+    const int majorStart = xMajor ? from.x() : from.y();
+    const int minorStart = xMajor ? from.y() : from.x();
+
+    float sum = 0.0f;
+    for (int i = 1; i <= steps; ++i) {
+        const int major = majorStart + i * majorStep;
+
+        // minor position is minorStart + minorDelta * i / steps, in units of 1/steps
+        const int numerator = minorStart * steps + minorDelta * i;
+        const int lower = numerator >= 0 ? numerator / steps : -((-numerator + steps - 1) / steps);
+        const int remainder = numerator - lower * steps;
+        const int nearest = 2 * remainder <= steps ? lower : lower + 1;
+
+        const int index = xMajor ? linearIndex(major, nearest) : linearIndex(nearest, major);
+        if (m_state[index] & Cell::Obstacle)
+            return false;
+
+        if (remainder != 0) {
+            const int other = nearest == lower ? lower + 1 : lower;
+            const int otherIndex = xMajor ? linearIndex(major, other) : linearIndex(other, major);
+            if (m_state[otherIndex] & Cell::Obstacle)
+                return false;
+        }
+
+        sum += Cell::cellCost(static_cast<Cell::State>(m_state[index]));
+    }
+
+    cost = sum * sqrt((double)(dx * dx + dy * dy)) / steps;
+    return true;
+}
+
+void GridMap::anyAngleSearch(const QPoint& start, const QVector<int>& targets, float maxCost, SearchWorkspace& ws)
+{
+    ws.reset(m_state.size(), false);
+    PriorityQueue& queue = ws.queue();
+
+    // A* heuristic for a single target, Dijkstra otherwise. The Euclidean
+    // distance is admissible, since every cell costs at least 1.
+    const bool useHeuristic = targets.size() == 1;
+    const QPoint goal = useHeuristic ? QPoint(targets[0] % m_width, targets[0] / m_width) : QPoint();
+
+    // the search stops as soon as all targets are closed
+    QSet<int> openTargets;
+    foreach (int target, targets) {
+        openTargets.insert(target);
+    }
+
+    const int startIndex = linearIndex(start.x(), start.y());
+    ws.setCost(startIndex, 0);
+    ws.setParentCell(startIndex, startIndex);
+    ws.setState(startIndex, SearchWorkspace::Open);
+    queue.push(startIndex, 0);
+
+    while (!queue.isEmpty() && !openTargets.isEmpty())
+    {
+        const int baseIndex = queue.pop();
+        const int x = baseIndex % m_width;
+        const int y = baseIndex / m_width;
+
+        // without heuristic, the cost is the key of the queue
+        if (maxCost >= 0.0f && ws.cost(baseIndex) > maxCost)
+            break;
+
+        // Lazy Theta*: the line of sight to the parent was assumed when the
+        // cell was queued. Verify it now, and fall back to the best grid
+        // neighbor if the line is blocked or more expensive.
+        const int parentIndex = ws.parentCell(baseIndex);
+        if (parentIndex != baseIndex) {
+            float bestCost = 0.0f;
+            int bestParent = -1;
+
+            float lineCost;
+            if (segmentCost(QPoint(parentIndex % m_width, parentIndex / m_width), QPoint(x, y), lineCost)) {
+                bestCost = ws.cost(parentIndex) + lineCost;
+                bestParent = parentIndex;
+            }
+
+            const float baseCost = Cell::cellCost(static_cast<Cell::State>(m_state[baseIndex]));
+            for (int i = 0; i < 8; ++i) {
+                const int ax = x + directionMap[i][0];
+                const int ay = y + directionMap[i][1];
+                if (!isValidField(ax, ay))
+                    continue;
+
+                const int index = linearIndex(ax, ay);
+                if (ws.state(index) != SearchWorkspace::Closed)
+                    continue;
+
+                const float factor = i > 3 ? 1.41421356f : 1.0f;
+                const float G = ws.cost(index) + factor * baseCost;
+                if (bestParent == -1 || G < bestCost) {
+                    bestCost = G;
+                    bestParent = index;
+                }
+            }
+
+            ws.setCost(baseIndex, bestCost);
+            ws.setParentCell(baseIndex, bestParent);
+        }
+
+        ws.setState(baseIndex, SearchWorkspace::Closed);
+        openTargets.remove(baseIndex);
+
+        // neighbors optimistically inherit the parent of this cell
+        const int inherited = ws.parentCell(baseIndex);
+        const int px = inherited % m_width;
+        const int py = inherited / m_width;
+
+        for (int i = 0; i < 8; ++i) {
+            const int ax = x + directionMap[i][0];
+            const int ay = y + directionMap[i][1];
+            if (!isValidField(ax, ay))
+                continue;
+
+            const int index = linearIndex(ax, ay);
+            if (ws.state(index) == SearchWorkspace::Closed)
+                continue;
+
+            const double ex = ax - px;
+            const double ey = ay - py;
+            const float G = ws.cost(inherited)
+                + sqrt(ex * ex + ey * ey) * Cell::cellCost(static_cast<Cell::State>(m_state[index]));
+
+            if (ws.state(index) == SearchWorkspace::Open && ws.cost(index) <= G)
+                continue;
+
+            ws.setCost(index, G);
+            ws.setParentCell(index, inherited);
+            ws.setState(index, SearchWorkspace::Open);
+
+            float key = G;
+            if (useHeuristic) {
+                const double hx = goal.x() - ax;
+                const double hy = goal.y() - ay;
+                key += sqrt(hx * hx + hy * hy);
+            }
+            queue.push(index, key);
+        }
+    }
+}
+
+Path GridMap::anyAnglePath(int target, SearchWorkspace& ws)
+{
+    Path path;
+    if (ws.state(target) != SearchWorkspace::Closed)
+        return path;
+
+    path.m_cost = ws.cost(target);
+
+    int index = target;
+    path.m_path.prepend(QPoint(index % m_width, index / m_width));
+    while (ws.parentCell(index) != index) {
+        const int parent = ws.parentCell(index);
+        const int dx = index % m_width - parent % m_width;
+        const int dy = index / m_width - parent / m_width;
+        path.m_length += sqrt((double)(dx * dx + dy * dy));
+
+        index = parent;
+        path.m_path.prepend(QPoint(index % m_width, index / m_width));
+    }
+    path.m_length *= resolution();
+
+    return path;
+}
+
+PathSummary GridMap::anyAngleSummary(int target, SearchWorkspace& ws)
+{
+    PathSummary summary;
+    summary.m_target = QPoint(target % m_width, target / m_width);
+    if (ws.state(target) != SearchWorkspace::Closed)
+        return summary;
+
+    summary.m_reachable = true;
+    summary.m_cost = ws.cost(target);
+
+    int index = target;
+    while (ws.parentCell(index) != index) {
+        const int parent = ws.parentCell(index);
+        const int dx = index % m_width - parent % m_width;
+        const int dy = index / m_width - parent / m_width;
+        summary.m_length += sqrt((double)(dx * dx + dy * dy));
+        summary.m_firstStep = QPoint(index % m_width, index / m_width);
+        index = parent;
+    }
+    summary.m_length *= resolution();
+
+    return summary;
+}
+
+QVector<PathSummary> GridMap::anyAngleFrontierSummaries(const QPoint& start, const QList<Cell>& frontiers, float maxCost, SearchWorkspace* workspace)
+{
+    QVector<PathSummary> summaries;
+    if (frontiers.isEmpty()) {
+        return summaries;
+    }
+
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+
+    QVector<int> targets;
+    targets.reserve(frontiers.size());
+    foreach (const Cell& frontier, frontiers) {
+        targets.append(frontier.linearIndex());
+    }
+
+    anyAngleSearch(start, targets, maxCost, ws);
+
+    summaries.reserve(targets.size());
+    foreach (int target, targets) {
+        if (maxCost >= 0.0f && ws.cost(target) > maxCost) {
+            PathSummary summary;
+            summary.m_target = QPoint(target % m_width, target / m_width);
+            summaries.append(summary);
+        } else {
+            summaries.append(anyAngleSummary(target, ws));
+        }
+    }
+    return summaries;
+}
+
+Path GridMap::anyAnglePath(const QPoint& target, SearchWorkspace* workspace)
+{
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+    return anyAnglePath(linearIndex(target.x(), target.y()), ws);
+}
+
+QList<Path> GridMap::anyAngleFrontierPaths(const QPoint& start, const QList<Cell>& frontiers, float maxCost, SearchWorkspace* workspace)
+{
+    if (frontiers.isEmpty()) {
+        return QList<Path>();
+    }
+
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+
+    QVector<int> targets;
+    targets.reserve(frontiers.size());
+    foreach (const Cell& frontier, frontiers) {
+        targets.append(frontier.linearIndex());
+    }
+
+    anyAngleSearch(start, targets, maxCost, ws);
+
+    QList<Path> paths;
+    foreach (int target, targets) {
+        if (maxCost >= 0.0f && ws.cost(target) > maxCost) {
+            paths.append(Path());
+        } else {
+            paths.append(anyAnglePath(target, ws));
+        }
+    }
+    return paths;
+}
+
+Path GridMap::thetaStar(const QPoint& from, const QPoint& to, SearchWorkspace* workspace)
+{
+    SearchWorkspace& ws = workspace ? *workspace : SearchWorkspace::threadLocal();
+
+    const int target = linearIndex(to.x(), to.y());
+    anyAngleSearch(from, QVector<int>(1, target), -1.0f, ws);
+
+    return anyAnglePath(target, ws);
+}
+
 bool GridMap::pathVisible(const QPoint& from, const QPoint& to)
 {
     int ystep, xstep;    // the step on y and x axis
@@ -1148,7 +1770,7 @@ bool GridMap::pathVisible(const QPoint& from, const QPoint& to)
                 error -= ddx;
             }
             if (i == dx - 1) return true;
-            if (m_map[x][y].state() & Cell::Obstacle)
+            if (m_state[linearIndex(x, y)] & Cell::Obstacle)
                 return false;
 //             result.append( QPoint( x, y ) );
         }
@@ -1163,7 +1785,7 @@ bool GridMap::pathVisible(const QPoint& from, const QPoint& to)
                 error -= ddy;
             }
             if (i == dy - 1) return true;
-            if (m_map[x][y].state() & Cell::Obstacle)
+            if (m_state[linearIndex(x, y)] & Cell::Obstacle)
                 return false;
 //             result.append( QPoint( x, y ) );
         }
@@ -1210,7 +1832,7 @@ bool GridMap::pathVisibleUnrestricted(const QPoint& from, const QPoint& to)
                 error -= ddx;
             }
             if (!isValidField(x, y) || i == dx - 1) return true;
-            if (m_map[x][y].state() & Cell::Obstacle && m_map[x][y].state() & Cell::Explored)
+            if ((m_state[linearIndex(x, y)] & (Cell::Obstacle | Cell::Explored)) == (Cell::Obstacle | Cell::Explored))
                 return false;
 //             result.append( QPoint( x, y ) );
         }
@@ -1225,7 +1847,7 @@ bool GridMap::pathVisibleUnrestricted(const QPoint& from, const QPoint& to)
                 error -= ddy;
             }
             if (!isValidField(x, y) || i == dy - 1) return true;
-            if (m_map[x][y].state() & Cell::Obstacle && m_map[x][y].state() & Cell::Explored)
+            if ((m_state[linearIndex(x, y)] & (Cell::Obstacle | Cell::Explored)) == (Cell::Obstacle | Cell::Explored))
                 return false;
 //             result.append( QPoint( x, y ) );
         }
@@ -1270,7 +1892,7 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
     }
     /* Draw the initial pixel, which is always exactly intersected by
     the line and so needs no weighting */
-    if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor);
+    if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor);
 
     if ((DeltaX = X1 - X0) >= 0) {
         XDir = 1;
@@ -1285,7 +1907,7 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
         /* Horizontal line */
         while (DeltaX-- != 0) {
             X0 += XDir;
-            if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor);
+            if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor);
         }
         return true;
     }
@@ -1293,7 +1915,7 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
         /* Vertical line */
         do {
             Y0++;
-            if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor);
+            if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor);
         } while (--DeltaY != 0);
         return true;
     }
@@ -1302,7 +1924,7 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
         do {
             X0 += XDir;
             Y0++;
-            if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor);
+            if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor);
         } while (--DeltaY != 0);
         return true;
     }
@@ -1332,13 +1954,13 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
             intensity weighting for this pixel, and the complement of the
             weighting for the paired pixel */
 //             Weighting = ErrorAcc >> IntensityShift;
-            if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor + Weighting);
-            if (m_map[X0 + XDir][Y0].isObstacle()) return false; // DrawPixel(X0 + XDir, Y0, BaseColor + (Weighting ^ WeightingComplementMask));
+            if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor + Weighting);
+            if ((m_state[linearIndex(X0 + XDir, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0 + XDir, Y0, BaseColor + (Weighting ^ WeightingComplementMask));
         }
         /* Draw the final pixel, which is 
         always exactly intersected by the line
         and so needs no weighting */
-        if (m_map[X1][Y1].isObstacle()) return false; // DrawPixel(X1, Y1, BaseColor);
+        if ((m_state[linearIndex(X1, Y1)] & Cell::Obstacle)) return false; // DrawPixel(X1, Y1, BaseColor);
         return true;
     }
     /* It's an X-major line; calculate 16-bit fixed-point fractional part of a
@@ -1358,131 +1980,69 @@ bool GridMap::aaPathVisible(const QPoint& from, const QPoint& to)
         intensity weighting for this pixel, and the complement of the
         weighting for the paired pixel */
 //         Weighting = ErrorAcc >> IntensityShift;
-        if (m_map[X0][Y0].isObstacle()) return false; // DrawPixel(X0, Y0, BaseColor + Weighting);
-        if (m_map[X0][Y0 + 1].isObstacle()) return false; // DrawPixel(X0, Y0 + 1, BaseColor + (Weighting ^ WeightingComplementMask));
+        if ((m_state[linearIndex(X0, Y0)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0, BaseColor + Weighting);
+        if ((m_state[linearIndex(X0, Y0 + 1)] & Cell::Obstacle)) return false; // DrawPixel(X0, Y0 + 1, BaseColor + (Weighting ^ WeightingComplementMask));
     }
     /* Draw the final pixel, which is always exactly intersected by the line
     and so needs no weighting */
-    if (m_map[X1][Y1].isObstacle()) return false; // DrawPixel(X1, Y1, BaseColor);
+    if ((m_state[linearIndex(X1, Y1)] & Cell::Obstacle)) return false; // DrawPixel(X1, Y1, BaseColor);
     
     return true;
 }
 
-static inline int sgn(int val) {
-    return (0 < val) - (val < 0);
-}
-
 void GridMap::computeDistanceTransform(Robot* robot)
 {
 //     QTime time;
 //     time.start();
 
-    const QList<Cell*> f = frontiers(robot);
+    const QList<Cell> f = frontiers(robot);
+    const int id = findRobotId(robot);
+    const quint8 freeExplored = Cell::Free | Cell::Explored;
+    const int cellCount = m_state.size();
 
     // if no frontiers -> set dist to 0 everywhere
     if (f.isEmpty()) {
-        for (int a = 0; a < m_map.size(); ++a) {
-            for (int b = 0; b < m_map[a].size(); ++b) {
-                Cell& c = m_map[a][b];
-                if (c.robot() == robot && c.state() == (Cell::Free | Cell::Explored)) {
-                    c.setFrontierDist(0);
-                }
+        for (int i = 0; i < cellCount; ++i) {
+            if (m_robotId[i] == id && m_state[i] == freeExplored) {
+                m_frontierDist[i] = 0;
             }
         }
         return;
     }
 
-    QList<Cell*> queue;
-
-    // queue all frontier cells
-    foreach (Cell* frontierCell, f) {
-        frontierCell->setFrontierDist(0);
-        queue.append(frontierCell);
+    // free explored cells can be passed, if in correct voronoi cell also reached
+    ChamferPropagation propagation(m_width, m_height, m_resolution);
+    QVector<quint8>& flags = propagation.flags();
+    for (int i = 0; i < cellCount; ++i) {
+        if (m_state[i] == freeExplored) {
+            flags[i] = ChamferPropagation::Transparent;
+            if (robot == 0 || m_robotId[i] == id)
+                flags[i] |= ChamferPropagation::Passable;
+        }
     }
 
-    QList<Cell*> dirtyCells;
-    // now we have all free explored cells next to the frontier in the queue
-    // next, as long as the queue is not empty, flood by iterating the neighbors
-    while (queue.size()) {
-        Cell* baseCell = queue.takeFirst();
-        dirtyCells.append(baseCell);
-        baseCell->setPathState(Cell::PathClose);
-
-        const int xBase = baseCell->index().x();
-        const int yBase = baseCell->index().y();
-
-        // 16-neighborhood
-        for (int i = 0; i < 16; ++i) {
-            const int x = xBase + directionMap[i][0];
-            const int y = yBase + directionMap[i][1];
-
-            // check validity
-            if (!isValidField(x, y))
-                continue;
-
-            Cell* cell = &m_map[x][y];
-
-            // if not in correct voronoi cell, ignore
-            if (robot != 0 && cell->robot() != robot)
-                continue;
-
-            // obstacle or not explored
-            if (!(cell->state() == (Cell::Free | Cell::Explored)))
-                continue;
-
-            // chess horse jumps: make sure cells inbetween are free and explored
-            if (i >= 8 && i < 12) {
-                // {  2, -1},  // top right right
-                // {  2,  1},  // bottom right right
-                // { -2,  1},  // bottom left left
-                // { -2, -1},  // top left left
-                const int xIdx = xBase + sgn(directionMap[i][0]);
-                if (!isValidField(xIdx, yBase) || m_map[xIdx][yBase].state() != (Cell::Free | Cell::Explored)
-                 || !isValidField(xIdx, yBase + directionMap[i][1]) || m_map[xIdx][yBase + directionMap[i][1]].state() != (Cell::Free | Cell::Explored))
-                    continue;
-            } else if (i >= 12) {
-                // {  1, -2},  // top top right
-                // {  1,  2},  // bottom bottom right
-                // { -1,  2},  // bottom bottom left
-                // { -1, -2}   // top top bottom left
-                const int yIdx = yBase + sgn(directionMap[i][1]);
-                if (!isValidField(xBase, yIdx) || m_map[xBase][yIdx].state() != (Cell::Free | Cell::Explored)
-                 || !isValidField(xBase + directionMap[i][0], yIdx) || m_map[xBase + directionMap[i][0]][yIdx].state() != (Cell::Free | Cell::Explored))
-                    continue;
-            }
-
-            const float dist = baseCell->frontierDist()
-                     + m_resolution * (i < 4 ? 1.0 : (i < 8 ? 1.4142136 : 2.236068));
-
-            // Ignorieren wenn Knoten geschlossen ist und bessere Kosten hat
-            if (cell->pathState() == Cell::PathClose && cell->frontierDist() < dist)
-                continue;
-
-            // cell already in queue, only replace, if shorter path
-            if (cell->pathState() == Cell::PathOpen) {
-                if (cell->frontierDist() <= dist)
-                    continue;
-
-                // remove all entry
-                queue.removeOne(cell);
-            }
-
-            cell->setFrontierDist(dist);
-
-            // flag open and queue
-            cell->setPathState(Cell::PathOpen);
-            queue.append(cell);
-        }
+    // all frontier cells are seeds
+    foreach (const Cell& frontierCell, f) {
+        propagation.addSeed(frontierCell.m_index);
     }
 
-    // cleanup again
-    foreach (Cell* cell, dirtyCells) {
-        cell->setPathState(Cell::PathNone);
+    propagation.propagate();
+
+    // cells not reached keep their old distance
+    for (int i = 0; i < cellCount; ++i) {
+        if (propagation.isReached(i))
+            m_frontierDist[i] = propagation.distance(i);
     }
 
 //     qDebug() << "computeDistanceTransform took " << time.elapsed() << "milli seconds";
 }
 
+void GridMap::computeDistanceTransforms()
+{
+    RobotMethodTask<GridMap> task(this, &GridMap::computeDistanceTransform);
+    task.run(m_team);
+}
+
 
 bool GridMap::cellInCentroid(const Cell& cell ,const QPointF& worldPos, double radius)
 {
@@ -1492,7 +2052,7 @@ bool GridMap::cellInCentroid(const Cell& cell ,const QPointF& worldPos, double r
 //	int cellX = x / resolution();
 //	int cellY = y / resolution();
 
-	const QRectF& r = cell.rect();
+	const QRectF r = cell.rect();
 	const qreal x1 = r.left();
 	const qreal x2 = r.right();
 	const qreal y1 = r.top();
@@ -1507,432 +2067,260 @@ bool GridMap::cellInCentroid(const Cell& cell ,const QPointF& worldPos, double r
 }
 
 
-bool GridMap::cellInNetwork(const Cell& cell, double radius)
+void GridMap::updateRobotNetwork(const QVector<QPointF>& positions, double radius)
 {
-	int count = 0;
-	for (int i = 0; i < RobotManager::self()->count(); ++i) {
-		Robot* robot = RobotManager::self()->robot(i);
-		if (cellInCentroid(cell, robot->position(), radius))
-			count++;
-		}
-
-	if (count < 2)
-		return false;
-
-	return true;
+    Q_ASSERT(positions.size() == m_team.size());
+    m_robotNetwork.update(positions, radius + 1);
 }
 
-bool GridMap::robotsInNetwork(const Cell& cell , double radius)
+bool GridMap::cellInNetwork(const Cell& cell, double radius)
 {
+	// in range of at least two robots
+	return m_robotNetwork.coverage(cell.rect(), radius) >= 2;
+}
 
-	QList<Robot*> robots;
-	for (int i = 0; i < RobotManager::self()->count(); ++i) {
-		Robot* robot = RobotManager::self()->robot(i);
-		robots.append(robot);
-		}
-
-	Robot* startRobot = cell.robot();
-
-	robotInRange(startRobot, &robots, radius);
+bool GridMap::robotsInNetwork(const Cell& cell)
+{
+	// all robots are connected to the robot of the cell; the robot ids
+	// follow the order of robots(), see computeVoronoiPartition()
+	const int id = m_robotId[cell.linearIndex()];
+	if (id == 0 || id > m_robotNetwork.robotCount())
+		return m_robotNetwork.robotCount() == 0;
 
-	if (robots.size())
-		return false;
-	return true;
+	return m_robotNetwork.componentSize(id - 1) == m_robotNetwork.robotCount();
 }
 
-void GridMap::robotInRange(Robot* startRobot, QList<Robot*>* robots, double radius){
 
-	robots->removeOne(startRobot);
-	foreach(Robot* robot, *robots) {
-		if (startRobot){
-			qreal x = startRobot->position().x();
-			qreal y = startRobot->position().y();
-			qreal x1 = robot->position().x();
-			qreal y1 = robot->position().y();
+//Ruffin's Bookmark
+void GridMap::computeVoronoiPartition(const QVector<QPointF>& positions)
+{
+    Q_ASSERT(positions.size() == m_team.size());
+    computeVoronoiLabels(positions);
 
-			if(inCircle(x, y, radius+1, x1, y1))
-				robotInRange(robot, robots, radius);
-		}
-	}
+    // the moments of the Voronoi cells follow the partition, even if the
+    // density is not updated
+    if (m_momentTable.isUpToDate(*this) && !m_momentTable.regionsUpToDate(*this)) {
+        updateMomentRegions();
+    }
 }
 
-
-//Ruffin's Bookmark
-void GridMap::computeVoronoiPartition()
+void GridMap::computeVoronoiLabels(const QVector<QPointF>& positions)
 {
 //     QTime time;
 //     time.start();
 
 
+	const int cellCount = m_state.size();
 	float mindist = HUGE_VALF;
-	Robot* minRobot;
+	Robot* minRobot = 0;
 	if (m_isunemployed){
-		for (int a = 0; a < m_map.size(); ++a) {
-			for (int b = 0; b < m_map[a].size(); ++b) {
-				Cell& c = m_map[a][b];
-				if((c.state()==(Cell::Free | Cell::Frontier))|(c.state()==(Cell::Unknown | Cell::Frontier))|(c.state()==(Cell::Obstacle | Cell::Frontier))){
-					int dist = c.robotDist();
-					if(dist <= mindist){
-						mindist = c.robotDist();
-						minRobot = c.robot();
-					}
+		for (int i = 0; i < cellCount; ++i) {
+			const quint8 state = m_state[i];
+			if((state==(Cell::Free | Cell::Frontier))|(state==(Cell::Unknown | Cell::Frontier))|(state==(Cell::Obstacle | Cell::Frontier))){
+				int dist = m_robotDist[i];
+				if(dist <= mindist){
+					mindist = m_robotDist[i];
+					minRobot = robotForId(m_robotId[i]);
 				}
 			}
 		}
 	}
 
+    // all cells are reassigned below, so rebuild the robot id table:
+    // robot i gets the id i + 1, 0 means no robot
+    const QVector<Robot*> oldRobots = m_robots;
+    m_robots.resize(1);
+    m_robots += m_team;
+    if (m_robots != oldRobots) {
+        ++m_partitionRevision;
+    }
+
     // take shortcut: if only one robot, assign it to all cells
-    if (RobotManager::self()->count() == 1) {
-        Robot* robot = RobotManager::self()->robot(0);
-        for (int a = 0; a < m_map.size(); ++a) {
-            for (int b = 0; b < m_map[a].size(); ++b) {
-                Cell& c = m_map[a][b];
-                c.setRobot(robot);
-            }
+    if (m_team.size() == 1) {
+        for (int index = 0; index < cellCount; ++index) {
+            setRobotId(index, 1);
         }
 //         qDebug() << "computeVoronoiPartition took " << time.elapsed() << "milli seconds";
         return;
     }
 
-    // set robot of all cells to 0
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            m_map[a][b].setRobot(0);
-        }
-    }
-
-    // flooding algorithm with robots as seeds
-    QList<Cell*> queue;
-
-    // queue all robots
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        Robot* robot = RobotManager::self()->robot(i);
-        QPoint cellIndex = worldToIndex(robot->position());
+    // robots are the seeds, the label of a cell is its robot id
+    QMap<int, quint8> seeds;
+    for (int i = 0; i < positions.size(); ++i) {
+        QPoint cellIndex = worldToIndex(positions[i]);
         if (isValidField(cellIndex)) {
-            Cell* cell = &m_map[cellIndex.x()][cellIndex.y()];
-            cell->setRobot(robot);
-            cell->setRobotDist(0);
-            queue.append(cell);
+            seeds[linearIndex(cellIndex.x(), cellIndex.y())] = i + 1;
         }
     }
+    const bool hasSeeds = !seeds.isEmpty();
 
 	// Ruffin's Code
 	//###########################################################
 	qreal radius = 5;
 	QPointF centroid;
 	// get centroid of all robots
-	for (int i = 0; i < RobotManager::self()->count(); ++i) {
-		Robot* robot = RobotManager::self()->robot(i);
-		centroid += robot->position();
+	for (int i = 0; i < positions.size(); ++i) {
+		centroid += positions[i];
 	}
-	centroid /= RobotManager::self()->count();
+	centroid /= positions.size();
 
 	qDebug() << "centroid: x" << centroid.x() << " y"<< centroid.y();
 
-	//###########################################################
-
-    QList<Cell*> dirtyCells;
-    // now we have all robots as seeds in the queue
-    // next, as long as the queue is not empty, flood by iterating the neighbors
-    while (queue.size()) {
-        Cell* baseCell = queue.takeFirst();
-        dirtyCells.append(baseCell);
-        baseCell->setPathState(Cell::PathClose);
-
-        const int xBase = baseCell->index().x();
-        const int yBase = baseCell->index().y();
-
-        // 16-neighborhood
-        for (int i = 0; i < 16; ++i) {
-            const int x = xBase + directionMap[i][0];
-            const int y = yBase + directionMap[i][1];
-
-			// check validity
-			if (!isValidField(x, y))
-				continue;
-
-
-			Cell* cell = &m_map[x][y];
-
-//			//####################################
-//			// check if in range
-//			if (!cellInCentroid(*cell, centroid, radius))
-//				continue;
-//			//####################################
-
-//			//####################################
-//			// check if in range of all robots
-//			if (!cellInNetwork(*cell, radius))
-//				continue;
-//			//####################################
+	updateRobotNetwork(positions, radius);
 
-			//####################################
-			// check if in range of all robots
-			if(m_oldexploredCellCount != m_exploredCellCount){
-				m_isunemployed = false;
-			}
-
-			qreal unemployed = 0.0;
-			const int count = RobotManager::self()->count();
-			for (int i = 0; i < count; ++i) {
-				if (RobotManager::self()->robot(i)->stats().isUnemployed())
-					unemployed += 1;
-			}
-			unemployed /= count;
-			if (unemployed == 1.0){
-				m_oldexploredCellCount = m_exploredCellCount;
-				m_isunemployed = true;
-				minRobot = 0;
-			}
+	//###########################################################
 
-			if (!m_isunemployed){
-				if (!cellInNetwork(*cell, radius))
-					continue;
-			}
-			else{
-				Robot* myrobot = baseCell->robot();
-				if ((myrobot == minRobot)|(minRobot==0)){
-					int lol;
-					lol = 1;
-				}
-				else{
-					if (!cellInNetwork(*cell, radius)){
-						continue;
-					}
-				}
-			}
-			//####################################
+	//####################################
+	// check if in range of all robots
+	if (hasSeeds) {
+		if(m_oldexploredCellCount != m_exploredCellCount){
+			m_isunemployed = false;
+		}
 
+		qreal unemployed = 0.0;
+		// a robot is unemployed if no frontier is left in its Voronoi cell
+		const int count = m_team.size();
+		for (int i = 0; i < count; ++i) {
+			if (!hasFrontiers(m_team[i]))
+				unemployed += 1;
+		}
+		unemployed /= count;
+		if (unemployed == 1.0){
+			m_oldexploredCellCount = m_exploredCellCount;
+			m_isunemployed = true;
+			minRobot = 0;
+		}
+	}
+	//####################################
+
+    if (m_isunemployed && minRobot) {
+        // outside the network, only the robot closest to a frontier may enter
+        // cells. The dynamic partition does not support this, so flood the map.
+        const quint8 favoredLabel = findRobotId(minRobot);
+        ChamferPropagation propagation(m_width, m_height, m_resolution);
+        for (int index = 0; index < cellCount; ++index) {
+            propagation.flags()[index] = voronoiFlags(index, false, true, radius);
+        }
+        QMapIterator<int, quint8> it(seeds);
+        while (it.hasNext()) {
+            it.next();
+            propagation.addSeed(it.key(), it.value());
+        }
 
-            // obstacle or not explored
-//             if (!(cell->state() == (Cell::Free | Cell::Explored)))
-            if (cell->state() == (Cell::Obstacle | Cell::Explored)) {
-                cell->setRobot(0);
-                continue;
-            }
+        propagation.propagate(true, favoredLabel);
 
-            // chess horse jumps: make sure cells inbetween are free and explored
-            if (i >= 8 && i < 12) {
-                // {  2, -1},  // top right right
-                // {  2,  1},  // bottom right right
-                // { -2,  1},  // bottom left left
-                // { -2, -1},  // top left left
-                const int xIdx = xBase + sgn(directionMap[i][0]);
-                if (!isValidField(xIdx, yBase) || m_map[xIdx][yBase].state() != (Cell::Free | Cell::Explored)
-                    || !isValidField(xIdx, yBase + directionMap[i][1]) || m_map[xIdx][yBase + directionMap[i][1]].state() != (Cell::Free | Cell::Explored))
-                    continue;
-            } else if (i >= 12) {
-                // {  1, -2},  // top top right
-                // {  1,  2},  // bottom bottom right
-                // { -1,  2},  // bottom bottom left
-                // { -1, -2}   // top top bottom left
-                const int yIdx = yBase + sgn(directionMap[i][1]);
-                if (!isValidField(xBase, yIdx) || m_map[xBase][yIdx].state() != (Cell::Free | Cell::Explored)
-                    || !isValidField(xBase + directionMap[i][0], yIdx) || m_map[xBase + directionMap[i][0]][yIdx].state() != (Cell::Free | Cell::Explored))
-                    continue;
+        // write back the reached cells, the others keep their distance
+        for (int index = 0; index < cellCount; ++index) {
+            if (propagation.isReached(index)) {
+                m_robotDist[index] = propagation.distance(index);
+                setRobotId(index, propagation.label(index));
+            } else {
+                setRobotId(index, 0);
             }
+            cleanupVoronoiCell(index);
+        }
 
-            const float dist = baseCell->robotDist()
-                + m_resolution * (i < 4 ? 1.0 : (i < 8 ? 1.4142136 : 2.236068));
+        // the dynamic partition is outdated now
+        m_voronoiPositions.clear();
+        return;
+    }
 
-            // Ignorieren wenn Knoten geschlossen ist und bessere Kosten hat
-            if (cell->pathState() == Cell::PathClose && cell->robotDist() < dist)
-                continue;
+    // Repair the dynamic partition. The flags of a cell only change if its
+    // state changed, or if a robot moved and the cell is in range of the old
+    // or the new robot position.
+    const bool allPassable = m_isunemployed;
+    DynamicVoronoi& voronoi = *m_dynamicVoronoi;
+    const QList<int> changedCells = voronoi.takeChangedCells();
+    const bool rebuild = voronoi.needsReset()
+        || m_voronoiPositions.isEmpty()
+        || m_voronoiPositions.size() != positions.size()
+        || m_voronoiAllPassable != allPassable;
+
+    if (rebuild) {
+        voronoi.reset();
+        for (int index = 0; index < cellCount; ++index) {
+            voronoi.setFlags(index, voronoiFlags(index, allPassable, false, radius));
+        }
+    } else {
+        foreach (int index, changedCells) {
+            voronoi.setFlags(index, voronoiFlags(index, allPassable, false, radius));
+        }
 
-            // cell already in queue, only replace, if shorter path
-            if (cell->pathState() == Cell::PathOpen) {
-                if (cell->robotDist() <= dist)
+        if (!allPassable) {
+            for (int i = 0; i < positions.size(); ++i) {
+                if (positions[i] == m_voronoiPositions[i])
                     continue;
 
-                // remove all entry
-                queue.removeOne(cell);
+                const QPointF pts[2] = { m_voronoiPositions[i], positions[i] };
+                for (int k = 0; k < 2; ++k) {
+                    const QPoint topLeft = worldToIndex(pts[k] - QPointF(radius, radius)) - QPoint(1, 1);
+                    const QPoint bottomRight = worldToIndex(pts[k] + QPointF(radius, radius)) + QPoint(1, 1);
+                    for (int y = qMax(0, topLeft.y()); y <= qMin(m_height - 1, bottomRight.y()); ++y) {
+                        for (int x = qMax(0, topLeft.x()); x <= qMin(m_width - 1, bottomRight.x()); ++x) {
+                            const int index = linearIndex(x, y);
+                            voronoi.setFlags(index, voronoiFlags(index, allPassable, false, radius));
+                        }
+                    }
+                }
             }
-
-            cell->setRobotDist(dist);
-            cell->setRobot(baseCell->robot());
-
-            // flag open and queue
-            cell->setPathState(Cell::PathOpen);
-            queue.append(cell);
         }
     }
 
-    // cleanup again
-	foreach (Cell* cell, dirtyCells) {
-		if (!robotsInNetwork(*cell, radius))
-				if (cell->state() == (Cell::Unknown))
-					cell->setRobot(0);
-        cell->setPathState(Cell::PathNone);
-    }
-
-//     qDebug() << "computeVoronoiPartition took " << time.elapsed() << "milli seconds";
-}
-
-void GridMap::exportToTikz(QTikzPicture& tp)
-{
-    const bool showVectorField = Config::self()->showVectorField();
-    const bool showDensity = Config::self()->showDensity();
-
-    QSizeF mapSize(size());
-    mapSize *= m_resolution;
-    QRectF clipRect(QPointF(border*m_resolution, border*m_resolution), mapSize - QSizeF(2*border*m_resolution, 2*border*m_resolution));
-    tp.clip(clipRect);
+    voronoi.setSeeds(seeds);
+    voronoi.update();
 
-    // 1st round: export all explored free cells
-    tp.newline();
-    tp.comment("explored cells");
-    if (!showDensity && showVectorField) tp.beginScope("gray");
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() == (Cell::Explored | Cell::Free))
-                c.exportToTikz(tp, showDensity, showVectorField);
-        }
-    }
-    if (!showDensity && showVectorField) tp.endScope();
-
-#if 0
-    // 2nd round: all unexplored cells (not frontiers)
-    tp.newline();
-    tp.comment("all unexplored cells and obstacles except frontiers");
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() & Cell::Unknown)
-                c.exportToTikz(tp, showDensity, showVectorField);
+    // write back the changed cells. The cleanup depends on the state of a cell
+    // and on whether the network is connected, so changes of those count, too.
+    const bool connected = m_robotNetwork.isConnected();
+    QList<int> cells;
+    if (rebuild || connected != m_voronoiConnected) {
+        for (int index = 0; index < cellCount; ++index) {
+            cells.append(index);
         }
+    } else {
+        cells = voronoi.lastUpdatedCells();
+        cells += changedCells;
     }
 
-    // 3nd round: all frontiers
-    tp.newline();
-    tp.comment("all frontiers");
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() & Cell::Frontier)
-                c.exportToTikz(tp, showDensity, showVectorField);
+    foreach (int index, cells) {
+        if (voronoi.isReached(index)) {
+            m_robotDist[index] = voronoi.distance(index);
+            setRobotId(index, voronoi.label(index));
+        } else {
+            setRobotId(index, 0);
         }
+        cleanupVoronoiCell(index);
     }
-#else
-    exportToTikzOpt(tp);
-#endif
 
-    // export partition
-    tp.comment("Voronoi partition");
-    if (Config::self()->showPartition() && RobotManager::self()->count() > 1) {
-        for (int i = 0; i < RobotManager::self()->count(); ++i) {
-            Robot* robot = RobotManager::self()->robot(i);
-            if (!m_partitionMap.contains(robot))
-                continue;
+    m_voronoiPositions = positions;
+    m_voronoiAllPassable = allPassable;
+    m_voronoiConnected = connected;
 
-            const QPainterPath& path = m_partitionMap[robot];
-            tp.beginScope();
-            tp.clip(path);
-            QString col = tp.registerColor(robot->color());
-            tp.path(path, "ultra thick, draw=" + col);
-            tp.endScope();
-        }
-    }
+//     qDebug() << "computeVoronoiPartition took " << time.elapsed() << "milli seconds";
 }
 
-void GridMap::exportToTikzOpt(QTikzPicture& tp)
+quint8 GridMap::voronoiFlags(int index, bool allPassable, bool favoredOutside, double radius)
 {
-    // collect connecting regions
-    QPainterPath unexploredRegion;
-    QPainterPath exploredObstacles;
-    QPainterPath unexploredObstacles;
-    QPainterPath frontiers;
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() & (Cell::Frontier | Cell::Unknown))
-                unexploredRegion.addRect(c.rect());
-
-            if (c.state() == (Cell::Obstacle | Cell::Explored))
-                exploredObstacles.addRect(c.rect());
-
-            if (c.state() == (Cell::Obstacle | Cell::Unknown))
-                unexploredObstacles.addRect(c.rect());
-
-            if (c.state() & Cell::Frontier)
-                frontiers.addRect(c.rect());
-        }
-    }
-
-    // simplify paths to reduce tikz size
-    unexploredRegion = unexploredRegion.simplified();
-    exploredObstacles = exploredObstacles.simplified();
-    unexploredObstacles = unexploredObstacles.simplified();
-    frontiers = frontiers.simplified();
+    const quint8 state = m_state[index];
+    quint8 flags = state == (Cell::Free | Cell::Explored) ? ChamferPropagation::Transparent : 0;
 
-    const QRectF sceneRect(0, 0, m_resolution * size().width(), m_resolution * size().height());
+    // obstacle or not explored
+    if (state == (Cell::Obstacle | Cell::Explored))
+        return flags;
 
-    // draw frontiers
-    if (!frontiers.isEmpty()) {
-        tp.beginScope();
-            tp.clip(frontiers);
-            tp.path(sceneRect, "fill=colFrontier");
-        tp.endScope();
-    }
-
-    // draw unexplored obstacles
-    if (!unexploredObstacles.isEmpty()) {
-        tp.beginScope();
-            tp.clip(unexploredObstacles);
-            tp.path(sceneRect, "fill=colUnexploredObstacle");
-        tp.endScope();
-    }
-
-    // draw explored obstacles
-    if (!exploredObstacles.isEmpty()) {
-        tp.beginScope();
-            tp.clip(exploredObstacles);
-            tp.path(sceneRect, "fill=colExploredObstacle");
-        tp.endScope();
-    }
+    if (allPassable || cellInNetwork(Cell(this, index), radius))
+        flags |= ChamferPropagation::Passable;
+    else if (favoredOutside)
+        flags |= ChamferPropagation::PassableForFavored;
 
-    // draw grid for unexplored cells
-    if (!unexploredRegion.isEmpty()) {
-        tp.beginScope();
-            tp.path(unexploredRegion, "draw=colBorder");
-            tp.clip(unexploredRegion);
-            tp << "\\draw[draw=colBorder] (0, 0) grid [step=" << m_resolution << "] ("
-            << m_resolution * size().width() << ", "
-            << m_resolution * size().height() << ");\n";
-        tp.endScope();
-    }
+    return flags;
 }
 
-void GridMap::exportLegend(QTikzPicture& tp)
+void GridMap::cleanupVoronoiCell(int index)
 {
-    // find maximum distance
-    double maxDist = 0;
-    for (int a = 0; a < m_map.size(); ++a) {
-        for (int b = 0; b < m_map[a].size(); ++b) {
-            Cell& c = m_map[a][b];
-            if (c.state() == (Cell::Free | Cell::Explored)) {
-                if (maxDist < c.frontierDist())
-                    maxDist = c.frontierDist();
-            }
-        }
-    }
-
-    const double h = m_resolution * (size().height() - 4);
-    tp.begin("yscale=-1");
-    const int imax = 100;
-    for (int i = 0; i < imax; i++) {
-        double dist = (i * maxDist) / imax;
-        QString c = tp.registerColor(Cell::densityToColor(exp(-0.5/(2*2)*dist*dist)));
-        double y = h * i / imax;
-        QRectF rect(0.0, y, 0.8, h / imax);
-        tp.path(rect, "fill=" + c + ", draw=" + c);
-    }
-    tp.newline();
-    tp.path(QRectF(0.0, 0.0, 0.8, h), "draw=black");
-    tp.newline();
-    tp << "\\node[below] at (0.4, 0) {$\\phi_\\text{max}$};\n";
-    tp << "\\node[above] at (0.4, " << h << ") {$\\phi_\\text{min}$};\n";
-    tp.end();
+    // unknown cells only belong to a robot if all robots are connected
+    if (m_robotId[index] != 0 && m_state[index] == Cell::Unknown && !robotsInNetwork(Cell(this, index)))
+        setRobotId(index, 0);
 }
 
 // kate: replace-tabs on; indent-width 4;
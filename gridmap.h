@@ -21,18 +21,27 @@
 #define GRIDMAP_H
 
 #include "cell.h"
+#include "robotnetwork.h"
+#include "momenttable.h"
 
-#include <QtGui/QPixmap>
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
 #include <QtCore/QSet>
 #include <QtCore/QSize>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 
 class QSettings;
 class GridMap;
-class Scene;
-class QTikzPicture;
+class SearchWorkspace;
+class FrontierField;
+class EikonalField;
+class GridMapObserver;
+class CircleFootprint;
+class FrontierSegment;
+class FrontierSegmentation;
+class DynamicVoronoi;
 
 class Path
 {
@@ -45,67 +54,61 @@ class Path
         void beautify(GridMap& gridMap, bool computeExactLength = true);
 };
 
+// cost, length and direction of a path, without the list of path cells
+class PathSummary
+{
+    public:
+        PathSummary() : m_firstStep(-1, -1), m_cost(0.0f), m_length(0.0f), m_reachable(false) { }
+        QPoint m_target;
+        QPoint m_firstStep;     // path cell after the start (any-angle: first waypoint)
+        float m_cost;
+        float m_length;
+        bool m_reachable;
+
+        inline bool hasFirstStep() const { return m_firstStep.x() >= 0; }
+};
+
 class GridMap : public QObject
 {
     Q_OBJECT
+    friend class Cell;
 
     public:
-        GridMap(Scene* scene, double width, double height, double resolution);
+        // drawing and export is done by the GridMapView, the map only
+        // depends on QtCore
+        GridMap(QObject* parent, double width, double height, double resolution);
         virtual ~GridMap();
 
     //
-    // load from / save to given config object, and export
+    // load from / save to given config object
     //
     public:
         void load(QSettings& config);
         void save(QSettings& config);
 
-        void exportToTikz(QTikzPicture& tp);
-        void exportToTikzOpt(QTikzPicture& tp);
-
-        void exportLegend(QTikzPicture& tp);
-
     //
-    // drawing
+    // robots on the map
     //
-    public slots:
-        void updateCache();
-        void updateCell(int xIndex, int yIndex);
-        void updateCell(Cell& cell);
-        void draw(QPainter& p);
+    public:
+        // robot ids are stored in 8 bits, 0 means no robot
+        enum { MaxRobots = 255 };
+
+        // The map does not own the robots. The order defines the robot ids
+        // of the next computeVoronoiPartition(), set the robots whenever
+        // robots are added or removed. Robots beyond MaxRobots are ignored.
+        void setRobots(const QVector<Robot*>& robots);
+        const QVector<Robot*>& robots() const;
 
     //
     // map properties
     //
     public:
-        QSize displaySize() const;      // returns desired widget size in pixel, equals pixmap-cache size
-        qreal scaleFactor() const;      // zoom factor for visualization
-        void incScaleFactor();          // increase zoom factor
-        void decScaleFactor();          // decrease zoom factor
-
         inline qreal resolution() const;// grid resolution. 0.2 means 0.2m x 0.2m
         QSize size() const;             // amount of cells in the grid map in
         QSizeF worldSize() const;       // returns the size in world/robot coordinates
         QPointF center() const;         // returns the center of the map in world coordinates
         double convexDiameter() const;  // returns the diameter (=diagonal of rectangular region)
 
-        inline int screenToIndex(qreal screenPos) const {
-            return screenPos / (scaleFactor() * resolution());
-        }
-
-        inline QPoint screenToIndex(const QPointF& screenPos) const {
-            QPointF pt(screenPos / (scaleFactor() * resolution()));
-            return QPoint(pt.x(), pt.y());
-        }
-
-        inline qreal screenToWorld(qreal screenPos) const {
-            return screenPos / scaleFactor();
-        }
-
-        inline QPointF screenToWorld(const QPointF& screenPos) const {
-            return screenPos / scaleFactor();
-        }
-
         inline int worldToIndex(qreal mapPos) const {
             return mapPos / resolution();
         }
@@ -114,63 +117,106 @@ class GridMap : public QObject
             return QPoint(mapPos.x() / resolution(), mapPos.y() / resolution());
         }
 
-
-        inline qreal worldToScreen(qreal mapPos) const {
-            return mapPos * scaleFactor();
-        }
-
-        inline QPointF worldToScreen(const QPointF& mapPos) const {
-            return mapPos * scaleFactor();
-        }
-
     //
     // cell accessors
     //
     public:
-        Cell& cell(int xIndex, int yIndex);                     // cell accessor
-        Cell& cell(const QPoint & cellIndex);                   // cell accessor
+        inline Cell cell(int xIndex, int yIndex);               // cell accessor
+        inline Cell cell(const QPoint & cellIndex);             // cell accessor
         inline bool isValidField(int xIndex, int yIndex) const; // index check for
         inline bool isValidField(const QPoint& cellIndex) const;// index check for
+        inline int linearIndex(int xIndex, int yIndex) const;   // row-major index into the cell planes
+
+        bool setState(Cell cell, Cell::State newState);         // modify cell state
+        inline quint32 revision() const;                        // changes whenever a cell state changes
+        inline quint32 partitionRevision() const;               // changes whenever a cell changes its robot
+        inline quint32 densityRevision() const;                 // changes with each updateDensity()
 
-        bool setState(Cell& cell, Cell::State newState);        // modify cell state
+        void addObserver(GridMapObserver* observer);            // notify observer about cell changes
+        void removeObserver(GridMapObserver* observer);
 
     //
     // Exploration & Density
     //
     public:
+        // distance fields are propagated with raster sweeps, see ChamferPropagation
+        // only writes the cells of the Voronoi cell of robot, so that calls for
+        // different robots can run in parallel
         void computeDistanceTransform(Robot* robot = 0);
+        // computeDistanceTransform() for all robots(), in parallel, see RobotTask
+        void computeDistanceTransforms();
 		bool cellInCentroid	(const Cell& cell, const QPointF& worldPos, double radius);
+        // Robots within radius + 1 of each other are linked. The queries below
+        // use the network of the last call, computeVoronoiPartition() updates
+        // it once per call. positions[i] is the position of robots()[i].
+        void updateRobotNetwork(const QVector<QPointF>& positions, double radius);
+        inline const RobotNetwork& robotNetwork() const { return m_robotNetwork; }
 		bool cellInNetwork	(const Cell& cell, double radius);
-		bool robotsInNetwork(const Cell& cell, double radius);
-		void robotInRange(Robot* startRobot, QList<Robot*>* robots, double radius);
-        void computeVoronoiPartition();
+		bool robotsInNetwork(const Cell& cell);
+        // only repairs the cells affected by moved robots and changed cells.
+        // positions[i] is the position of robots()[i], the map does not know
+        // the robot dynamics.
+        void computeVoronoiPartition(const QVector<QPointF>& positions);
         void updateDensity();
         bool exploreInRadius(const QPointF& worldPos, double radius, bool markAsExplored);
         void unexploreAll();
 
         double explorationProgress() const;
         int freeCellCount() const;
-        QVector<Cell*> visibleCells(const QPointF& worldPos, double radius);
-        QVector<Cell*> visibleCells(Robot* robot, double radius);
+        QVector<Cell> visibleCells(const QPointF& worldPos, double radius);
         int numVisibleCellsUnrestricted(const QPointF& worldPos, double radius);
-        void filterCells(QVector<Cell*> & cells, Robot* robot);
+        void filterCells(QVector<Cell> & cells, Robot* robot);
+        // Density moments of visibleCells(worldPos, radius), restricted to the
+        // Voronoi cell of robot if given, from the summed-area tables of the
+        // last updateDensity(). Only possible if the map did not change since
+        // then and no obstacle blocks the view within radius, and, with a
+        // robot, if radius covers the whole map. Returns false otherwise.
+        bool densityMoments(const QPointF& worldPos, double radius, Robot* robot, DensityMoments& moments) const;
 
     //
     // Frontier caching for each robot
     //
     public:
-        inline const QList<Cell*>& frontiers() const;           // cached list of all frontiers
+        inline const QList<Cell>& frontiers() const;            // cached list of all frontiers
 
         void updateRobotFrontierCache();
-        QList<Cell*> frontiers(Robot* robot) const;             // frontiers for robot
+        QList<Cell> frontiers(Robot* robot) const;              // frontiers for robot
         bool hasFrontiers(Robot* robot) const;
-        QList<Cell*> frontiersForRobot(Robot* robot) const;
+        QList<Cell> frontiersForRobot(Robot* robot) const;
+
+        const QList<FrontierSegment>& frontierSegments();       // connected groups of frontiers
+        QList<FrontierSegment> frontierSegments(Robot* robot);  // segment parts of robot's frontiers
 
     private:
-        QHash<Robot*, QList<Cell*> > m_robotFrontierCache;
+        QHash<Robot*, QList<Cell> > m_robotFrontierCache;
+        FrontierSegmentation* m_frontierSegmentation;
 
     private:
-        bool exploreCell(const QPoint& center, const QPoint& target, qreal radius, Cell::State targetState);
+        bool exploreCell(const QPoint& target, int coverage, Cell::State targetState);
+        quint8 voronoiFlags(int index, bool allPassable, bool favoredOutside, double radius);
+        void cleanupVoronoiCell(int index);
+        inline void setRobotId(int index, quint8 id);
+        void updateMomentTable();
+        void updateMomentRegions();
+        void computeVoronoiLabels(const QVector<QPointF>& positions);
+
+    //
+    // field of view (recursive shadowcasting)
+    //
+    private:
+        struct FieldOfView;
+
+        // footprint for a radius in world units, limited to the map size
+        const CircleFootprint& mapFootprint(double radius) const;
+
+        // all cells within footprint visible from center, in row-major order.
+        // If unrestricted, only explored obstacles block the view, and cells
+        // outside the map are visible as well.
+        void castFieldOfView(const QPoint& center, const CircleFootprint& footprint,
+                             bool unrestricted, QVector<QPoint>& visible);
+        void castLight(FieldOfView& fov, int row, double start, double end,
+                       int xx, int xy, int yx, int yy);
+        inline bool blocksView(int x, int y, bool unrestricted) const;
 
     //
     // path finding
@@ -179,27 +225,91 @@ class GridMap : public QObject
         bool pathVisible(const QPoint& from, const QPoint& to);
         bool pathVisibleUnrestricted(const QPoint& from, const QPoint& to);
         bool aaPathVisible(const QPoint& from, const QPoint& to);
-        QList<Path> frontierPaths(const QPoint& start, const QList<Cell*>& frontiers);
-        Path aStar(const QPoint& from, const QPoint& to);
+        // The graph searches below keep their scratch data in a SearchWorkspace.
+        // If none is given, the workspace of the calling thread is used.
+        QList<Path> frontierPaths(const QPoint& start, const QList<Cell>& frontiers, SearchWorkspace* workspace = 0);
+        // paths to the k cheapest frontiers with cost <= maxCost (if maxCost >= 0), cheapest first
+        QList<Path> nearestFrontierPaths(const QPoint& start, const QList<Cell>& frontiers, int k,
+                                         float maxCost = -1.0f, SearchWorkspace* workspace = 0);
+        void computeFrontierField(FrontierField& field, const QList<Cell>& frontiers, SearchWorkspace* workspace = 0);
+        // Fast Marching from the seeds, stops at maxCost (if maxCost >= 0)
+        void computeEikonalField(EikonalField& field, const QList<Cell>& seeds, float maxCost = -1.0f);
+        Path aStar(const QPoint& from, const QPoint& to, SearchWorkspace* workspace = 0);
         float heuristic(const QPoint& start, const QPoint& end);
 
+        // Any-angle paths (Lazy Theta*): m_path only contains the waypoints,
+        // which are connected by obstacle-free lines, and m_length is the exact
+        // Euclidean length, so Path::beautify() is not needed. A line costs its
+        // length times the cost of the cells it passes. Frontiers with a cost
+        // above maxCost (if maxCost >= 0) are not searched and get an empty path.
+        QList<Path> anyAngleFrontierPaths(const QPoint& start, const QList<Cell>& frontiers,
+                                          float maxCost = -1.0f, SearchWorkspace* workspace = 0);
+        Path thetaStar(const QPoint& from, const QPoint& to, SearchWorkspace* workspace = 0);
+
+        // Like frontierPaths() and anyAngleFrontierPaths(), but only the summary
+        // of each path is computed. The full path to a target can be obtained
+        // afterwards with gridPath() or anyAnglePath() from the same workspace.
+        QVector<PathSummary> frontierSummaries(const QPoint& start, const QList<Cell>& frontiers, SearchWorkspace* workspace = 0);
+        QVector<PathSummary> anyAngleFrontierSummaries(const QPoint& start, const QList<Cell>& frontiers,
+                                                       float maxCost = -1.0f, SearchWorkspace* workspace = 0);
+        Path gridPath(const QPoint& target, SearchWorkspace* workspace = 0);
+        Path anyAnglePath(const QPoint& target, SearchWorkspace* workspace = 0);
+
     private:
-        GridMap(); // disable default constructor
+        // Dijkstra from start, stops once maxFrontiers frontiers are settled or
+        // the cost exceeds maxCost (if maxCost >= 0)
+        void frontierSearch(const QPoint& start, const QList<Cell>& frontiers, int maxFrontiers,
+                            float maxCost, SearchWorkspace& ws);
+        Path gridPath(int target, SearchWorkspace& ws);
+        PathSummary gridSummary(int target, SearchWorkspace& ws);
+
+        bool segmentCost(const QPoint& from, const QPoint& to, float& cost) const;
+        void anyAngleSearch(const QPoint& start, const QVector<int>& targets, float maxCost, SearchWorkspace& ws);
+        Path anyAnglePath(int target, SearchWorkspace& ws);
+        PathSummary anyAngleSummary(int target, SearchWorkspace& ws);
 
-        Scene* m_scene;
+    private:
+        GridMap(); // disable default constructor
 
-        QVector<QVector<Cell> > m_map;
-        QPixmap m_pixmapCache;
-        QMap<Robot*, QPainterPath> m_partitionMap;
+        void resize(int width, int height);             // (re)allocate all cell planes
+        int findRobotId(Robot* robot) const;            // like robotId(), but -1 if not registered
+        inline Robot* robotForId(quint8 id) const;
+
+        //
+        // cell data, stored as flat row-major planes (index = y * width + x)
+        //
+        int m_width;
+        int m_height;
+        QVector<quint8> m_state;                // Cell::State
+        QVector<float> m_density;
+        QVector<float> m_frontierDist;
+        QVector<float> m_robotDist;
+        QVector<float> m_gradient;              // interleaved x, y
+        QVector<quint8> m_robotId;              // index into m_robots
+        QVector<Robot*> m_robots;               // m_robots[0] is always 0
+        QVector<Robot*> m_team;                 // see setRobots()
+        quint32 m_revision;
+        quint32 m_partitionRevision;
+        quint32 m_densityRevision;
+        QList<GridMapObserver*> m_observers;
 
         qreal m_resolution;
 
         // track a list of frontiers for fast lookup/iteration
-        QList<Cell*> m_frontierCache;
+        QList<Cell> m_frontierCache;
 		int m_freeCellCount;
 		int m_exploredCellCount;
 		int m_oldexploredCellCount;
 		bool m_isunemployed;
+        RobotNetwork m_robotNetwork;
+        MomentTable m_momentTable;
+
+        // partition kept across calls of computeVoronoiPartition(), and the
+        // input it was computed for
+        DynamicVoronoi* m_dynamicVoronoi;
+        QVector<QPointF> m_voronoiPositions;
+        bool m_voronoiAllPassable;
+        bool m_voronoiConnected;
 };
 
 //
@@ -215,8 +325,8 @@ bool GridMap::isValidField(int xIndex, int yIndex) const
 {
     return xIndex >= 0 &&
            yIndex >= 0 &&
-           xIndex < m_map.size() &&
-           yIndex < m_map[0].size();
+           xIndex < m_width &&
+           yIndex < m_height;
 }
 
 bool GridMap::isValidField(const QPoint& cellIndex) const
@@ -224,11 +334,160 @@ bool GridMap::isValidField(const QPoint& cellIndex) const
     return isValidField(cellIndex.x(), cellIndex.y());
 }
 
-const QList<Cell*>& GridMap::frontiers() const
+int GridMap::linearIndex(int xIndex, int yIndex) const
+{
+    return yIndex * m_width + xIndex;
+}
+
+quint32 GridMap::revision() const
+{
+    return m_revision;
+}
+
+quint32 GridMap::partitionRevision() const
+{
+    return m_partitionRevision;
+}
+
+quint32 GridMap::densityRevision() const
+{
+    return m_densityRevision;
+}
+
+void GridMap::setRobotId(int index, quint8 id)
+{
+    if (m_robotId[index] != id) {
+        m_robotId[index] = id;
+        ++m_partitionRevision;
+    }
+}
+
+Cell GridMap::cell(int xIndex, int yIndex)
+{
+    // assert on index-out-of-range
+    Q_ASSERT(isValidField(xIndex, yIndex));
+    return Cell(this, linearIndex(xIndex, yIndex));
+}
+
+Cell GridMap::cell(const QPoint & cellIndex)
+{
+    return cell(cellIndex.x(), cellIndex.y());
+}
+
+Robot* GridMap::robotForId(quint8 id) const
+{
+    return m_robots[id];
+}
+
+const QList<Cell>& GridMap::frontiers() const
 {
     return m_frontierCache;
 }
 
+//
+// inline Cell methods, they need the complete GridMap type
+//
+
+Cell::Cell()
+    : m_map(0)
+    , m_index(-1)
+{
+}
+
+Cell::Cell(GridMap* map, int linearIndex)
+    : m_map(map)
+    , m_index(linearIndex)
+{
+}
+
+bool Cell::isValid() const
+{
+    return m_map != 0;
+}
+
+GridMap* Cell::map() const
+{
+    return m_map;
+}
+
+int Cell::linearIndex() const
+{
+    return m_index;
+}
+
+QPoint Cell::index() const
+{
+    return QPoint(m_index % m_map->m_width, m_index / m_map->m_width);
+}
+
+QRectF Cell::rect() const
+{
+    const qreal res = m_map->m_resolution;
+    return QRectF((m_index % m_map->m_width) * res, (m_index / m_map->m_width) * res, res, res);
+}
+
+QPointF Cell::center() const
+{
+    const qreal res = m_map->m_resolution;
+    return QPointF((m_index % m_map->m_width + 0.5) * res, (m_index / m_map->m_width + 0.5) * res);
+}
+
+bool Cell::isObstacle() const
+{
+    return m_map->m_state[m_index] & Obstacle;
+}
+
+Cell::State Cell::state() const
+{
+    return static_cast<State>(m_map->m_state[m_index]);
+}
+
+float Cell::density() const
+{
+    return m_map->m_density[m_index];
+}
+
+void Cell::setDensity(float density)
+{
+    m_map->m_density[m_index] = density;
+}
+
+QPointF Cell::gradient() const
+{
+    return QPointF(m_map->m_gradient[2 * m_index], m_map->m_gradient[2 * m_index + 1]);
+}
+
+void Cell::setGradient(const QPointF& gradient)
+{
+    m_map->m_gradient[2 * m_index] = gradient.x();
+    m_map->m_gradient[2 * m_index + 1] = gradient.y();
+}
+
+float Cell::frontierDist() const
+{
+    return m_map->m_frontierDist[m_index];
+}
+
+void Cell::setFrontierDist(float dist)
+{
+    m_map->m_frontierDist[m_index] = dist;
+}
+
+Robot* Cell::robot() const
+{
+    return m_map->robotForId(m_map->m_robotId[m_index]);
+}
+
+float Cell::robotDist() const
+{
+    return m_map->m_robotDist[m_index];
+}
+
+void Cell::setRobotDist(float dist)
+{
+    m_map->m_robotDist[m_index] = dist;
+}
+
 #endif // GRIDMAP_H
 
 // kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,48 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_GRIDMAP_OBSERVER_H
+#define DISCOVERAGE_GRIDMAP_OBSERVER_H
+
+#include "cell.h"
+
+/**
+ * Interface for classes that keep data derived from the cells of a GridMap.
+ * Register with GridMap::addObserver(). Notifications arrive synchronously,
+ * so implementations should only record what changed and do the actual work
+ * later.
+ */
+class GridMapObserver
+{
+    public:
+        virtual ~GridMapObserver();
+
+        // state of cell changed through GridMap::setState()
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState) = 0;
+
+        // all cells changed, e.g. the map was resized or loaded
+        virtual void mapReset() = 0;
+
+        // the map is being deleted, the observer is unregistered afterwards
+        virtual void mapDestroyed() = 0;
+};
+
+#endif // DISCOVERAGE_GRIDMAP_OBSERVER_H
+
+// kate: replace-tabs on; indent-width 4;
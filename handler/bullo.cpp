@@ -19,11 +19,12 @@
 
 #include "bullo.h"
 #include "scene.h"
+#include "simulationcontext.h"
 #include "mainwindow.h"
 #include "tikzexport.h"
 #include "robot.h"
 #include "robotmanager.h"
-#include "config.h"
+#include "robotview.h"
 
 #include "ui_discoveragefrontierwidget.h"
 
@@ -33,16 +34,14 @@
 #include <QtCore/QSettings>
 #include <QtGui/QDockWidget>
 
-#include <math.h>
-
 //BEGIN DisCoverageBulloHandler
 DisCoverageBulloHandler::DisCoverageBulloHandler(Scene* scene)
     : QObject()
     , ToolHandler(scene)
+    , m_strategy(&scene->context())
     , m_dock(0)
     , m_ui(0)
 {
-    toolHandlerActive(false);
 }
 
 DisCoverageBulloHandler::~DisCoverageBulloHandler()
@@ -50,14 +49,22 @@ DisCoverageBulloHandler::~DisCoverageBulloHandler()
     delete m_ui;
 }
 
-QString DisCoverageBulloHandler::name() const
+DisCoverageBulloStrategy* DisCoverageBulloHandler::strategy()
 {
-    return QString("DisCoverage-centroid");
+    return &m_strategy;
 }
 
 void DisCoverageBulloHandler::toolHandlerActive(bool activated)
 {
-    dockWidget()->setVisible(activated);
+    // the dock widget is created on first activation only, and never
+    // without main window
+    if (!scene()->mainWindow()) {
+        return;
+    }
+
+    if (activated || m_dock) {
+        dockWidget()->setVisible(activated);
+    }
 }
 
 QDockWidget* DisCoverageBulloHandler::dockWidget()
@@ -72,75 +79,54 @@ QDockWidget* DisCoverageBulloHandler::dockWidget()
         m_dock->setWidget(w);
         scene()->mainWindow()->addDockWidget(Qt::LeftDockWidgetArea, m_dock);
 
-        connect(m_ui->sbIntegrationRange, SIGNAL(valueChanged(double)), this, SLOT(updateParameters()));
+        updateWidgets();
 
-        updateParameters();
+        connect(m_ui->sbIntegrationRange, SIGNAL(valueChanged(double)), this, SLOT(updateParameters()));
     }
     return m_dock;
 }
 
-void DisCoverageBulloHandler::setIntegrationRange(double range)
+void DisCoverageBulloHandler::updateWidgets()
 {
+    if (!m_ui) {
+        return;
+    }
+
     m_ui->sbIntegrationRange->blockSignals(true);
-    m_ui->sbIntegrationRange->setValue(range);
+    m_ui->sbIntegrationRange->setValue(m_strategy.integrationRange());
     m_ui->sbIntegrationRange->blockSignals(false);
 }
 
-double DisCoverageBulloHandler::integrationRange() const
-{
-    return m_ui->sbIntegrationRange->value();
-}
-
 void DisCoverageBulloHandler::save(QSettings& config)
 {
     ToolHandler::save(config);
-
-    config.beginGroup("dis-coverage-frontier-weights");
-    config.setValue("integration-range", integrationRange());
-    config.endGroup();
+    m_strategy.save(config);
 }
 
 void DisCoverageBulloHandler::load(QSettings& config)
 {
     ToolHandler::load(config);
-
-    config.beginGroup("dis-coverage-frontier-weights");
-    setIntegrationRange(config.value("integration-range", 0.5).toDouble());
-    config.endGroup();
+    m_strategy.load(config);
+    updateWidgets();
 }
 
 void DisCoverageBulloHandler::exportToTikz(QTikzPicture& tp)
 {
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        Robot* robot = RobotManager::self()->robot(i);
-        const double rint = scene()->map().hasFrontiers(robot) ? integrationRange() : 1000000;
-        QPainterPath visibleArea = robot->visibleArea(rint, true);
+    for (int i = 0; i < context()->robotManager().count(); ++i) {
+        Robot* robot = context()->robotManager().robot(i);
+        const double rint = context()->map().hasFrontiers(robot) ? m_strategy.integrationRange() : 1000000;
+        QPainterPath visibleArea = RobotView::visibleArea(robot, rint, true);
         tp.path(visibleArea, "very thick, cyan!90!black");
     }
 }
 
-void DisCoverageBulloHandler::exportObjectiveFunction(QTextStream& ts)
-{
-    const int dx = scene()->map().size().width();
-    const int dy = scene()->map().size().height();
-    for (int b = 0; b < dy; ++b) {
-        for (int a = 0; a < dx; ++a) {
-            Cell& c = scene()->map().cell(a, b);
-            double y = scene()->map().cell(dx-1, dy-1).center().y() - c.center().y();
-            if (c.state() == (Cell::Explored | Cell::Free)) {
-                QVector<Cell*> visibleCells = scene()->map().visibleCells(c.center(), integrationRange());
-                const qreal f = fitness(c.center(), visibleCells);
-                ts << c.center().x() << " " << y << " " << -log(-f) << "\n";
-            } else {
-                ts << c.center().x() << " " << y << " " << "nan" << "\n";
-            }
-        }
-    }
-}
-
 void DisCoverageBulloHandler::updateParameters()
 {
-    postProcess();
+    DisCoverageBulloParameters parameters(m_strategy.parameters());
+    parameters.integrationRange = m_ui->sbIntegrationRange->value();
+    m_strategy.setParameters(parameters);
+
+    context()->postProcess();
     scene()->update();
 }
 
@@ -152,12 +138,12 @@ void DisCoverageBulloHandler::draw(QPainter& p)
 
     // draw trajectories
     p.setRenderHints(QPainter::Antialiasing, true);
-    p.setPen(QPen(QColor(0, 0, 0, 196), scene()->map().resolution() * 0.3, Qt::DotLine));
+    p.setPen(QPen(QColor(0, 0, 0, 196), context()->map().resolution() * 0.3, Qt::DotLine));
     p.setBrush(Qt::NoBrush);
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        Robot* robot = RobotManager::self()->robot(i);
-        double rint = scene()->map().hasFrontiers(robot) ? integrationRange() : 1000000;
-        QPainterPath visibleArea = robot->visibleArea(rint, true);
+    for (int i = 0; i < context()->robotManager().count(); ++i) {
+        Robot* robot = context()->robotManager().robot(i);
+        double rint = context()->map().hasFrontiers(robot) ? m_strategy.integrationRange() : 1000000;
+        QPainterPath visibleArea = RobotView::visibleArea(robot, rint, true);
         p.drawPath(visibleArea);
     }
 
@@ -178,191 +164,6 @@ void DisCoverageBulloHandler::mouseReleaseEvent(QMouseEvent* event)
 {
     ToolHandler::mouseReleaseEvent(event);
 }
-
-void DisCoverageBulloHandler::reset()
-{
-}
-
-qreal DisCoverageBulloHandler::performance(const QPointF& p, const QPointF& q)
-{
-    const qreal dx = p.x() - q.x();
-    const qreal dy = p.y() - q.y();
-    const qreal squareDist = (dx * dx + dy * dy);
-    return -squareDist;
-}
-
-qreal DisCoverageBulloHandler::fitness(const QPointF& robotPos, const QVector<Cell*>& cells)
-{
-    qreal sum = 0;
-    foreach (Cell* cell, cells) {
-        sum += performance(robotPos, cell->center()) * cell->density();
-    }
-    return sum;
-}
-
-QPointF DisCoverageBulloHandler::gradient(Robot* robot, bool interpolate)
-{
-    if (interpolate) {
-        return interpolatedGradient(robot->position(), robot);
-    } else {
-        const double rint = scene()->map().hasFrontiers(robot) ? integrationRange() : 1000000;
-        QVector<Cell*> visibleCells = scene()->map().visibleCells(robot, rint);
-        return gradient(robot->position(), visibleCells);
-    }
-}
-
-QPointF DisCoverageBulloHandler::gradient(const QPointF& robotPos, const QVector<Cell*>& visibleCells)
-{
-    static const qreal dx = 0.005;
-    static const qreal dy = 0.005;
-    const qreal x1 = fitness(robotPos - QPointF(dx, 0.0), visibleCells);
-    const qreal x2 = fitness(robotPos + QPointF(dx, 0.0), visibleCells);
-    const qreal y1 = fitness(robotPos - QPointF(0.0, dy), visibleCells);
-    const qreal y2 = fitness(robotPos + QPointF(0.0, dy), visibleCells);
-
-    QPointF grad ((x2 - x1) / (2*dx), (y2 - y1) / (2*dy));
-    if (!grad.isNull()) {
-        // normalize vector (1 sqrt)
-        const qreal len = sqrt(grad.x() * grad.x() + grad.y() * grad.y());
-        if (len < 0.0000001) {
-            grad = QPointF(0, 0);
-        } else {
-            grad /= len;
-        }
-    }
-    return grad;
-}
-
-QPointF DisCoverageBulloHandler::interpolatedGradient(const QPointF& robotPos, Robot* robot)
-{
-    GridMap& m = scene()->map();
-    QPoint cellIndex(m.worldToIndex(robotPos));
-
-    const double diffx = 1.0 - fabs(robotPos.x() - m.cell(cellIndex).center().x()) / scene()->map().resolution();
-    const double diffy = 1.0 - fabs(robotPos.y() - m.cell(cellIndex).center().y()) / scene()->map().resolution();
-
-    const int dx = (robotPos.x() < m.cell(cellIndex).center().x()) ? -1 : 1;
-    const int dy = (robotPos.y() < m.cell(cellIndex).center().y()) ? -1 : 1;
-
-    QPointF g00(m.cell(cellIndex).center());
-    QPointF g01(g00);
-    QPointF g10(g00);
-    QPointF g11(g00);
-
-    if (m.isValidField(cellIndex + QPoint(dx, 0))) g01 = (m.cell(cellIndex + QPoint(dx, 0)).center());
-    if (m.isValidField(cellIndex + QPoint(0, dy))) g10 = (m.cell(cellIndex + QPoint(0, dy)).center());
-    if (m.isValidField(cellIndex + QPoint(dx,dy))) g11 = (m.cell(cellIndex + QPoint(dx, dy)).center());
-
-    double rint = m.hasFrontiers(robot) ? integrationRange() : 1000000;
-    QVector<Cell*> c00 = m.visibleCells(g00, rint);
-    QVector<Cell*> c01 = m.visibleCells(g01, rint);
-    QVector<Cell*> c10 = m.visibleCells(g10, rint);
-    QVector<Cell*> c11 = m.visibleCells(g11, rint);
-    if (robot) {
-        m.filterCells(c00, robot);
-        m.filterCells(c01, robot);
-        m.filterCells(c10, robot);
-        m.filterCells(c11, robot);
-    }
-
-    QPointF grad00(gradient(g00, c00));
-    QPointF grad01(gradient(g01, c01));
-    QPointF grad10(gradient(g10, c10));
-    QPointF grad11(gradient(g11, c11));
-
-    QPointF gradX0(diffx * grad00 + (1 - diffx) * grad01);
-    QPointF gradX1(diffx * grad10 + (1 - diffx) * grad11);
-
-    QPointF grad(diffy * gradX0 + (1 - diffy) * gradX1);
-
-    return grad;
-}
-
-void DisCoverageBulloHandler::tick()
-{
-}
-
-void DisCoverageBulloHandler::postProcess()
-{
-    // compute geodesic Voronoi partition
-    scene()->map().computeVoronoiPartition();
-
-    // update the frontier cache
-    scene()->map().updateRobotFrontierCache();
-
-    // compute distance transform in each Voronoi cell with respect to the frontiers
-    for (int i = 0; i < RobotManager::self()->count(); ++i)
-        scene()->map().computeDistanceTransform(RobotManager::self()->robot(i));
-
-    // now that each cell contains the correct distance to the frontier, update density
-    scene()->map().updateDensity();
-
-    // compute vector field in each cell if needed
-    if (Config::self()->showVectorField()) {
-        updateVectorField();
-    }
-
-    // redraw pixmap cache
-    scene()->map().updateCache();
-}
-
-void DisCoverageBulloHandler::updateVectorField()
-{
-    const int dx = scene()->map().size().width();
-    const int dy = scene()->map().size().height();
-
-    const bool hasPartition = RobotManager::self()->count() > 1;
-
-    QVector<Cell*> visibleCells;
-    QPointF grad;
-
-    for (int a = 0; a < dx; ++a) {
-        for (int b = 0; b < dy; ++b) {
-            Cell& c = scene()->map().cell(a, b);
-            if (c.state() == (Cell::Explored | Cell::Free)) {
-                double rint = integrationRange();
-                if (c.robot() != 0 && !scene()->map().hasFrontiers(c.robot()))
-                    rint = 100;
-                visibleCells = scene()->map().visibleCells(c.center(), rint);
-                if (hasPartition && c.robot() != 0) {
-                    // honor Voronoi partition
-                    scene()->map().filterCells(visibleCells, c.robot());
-                }
-                grad = gradient(c.center(), visibleCells);
-                c.setGradient(grad);
-            }
-        }
-    }
-}
-
-void DisCoverageBulloHandler::updateVectorField(Robot* robot)
-{
-    Q_ASSERT(robot);
-
-    const int dx = scene()->map().size().width();
-    const int dy = scene()->map().size().height();
-
-    QVector<Cell*> visibleCells;
-    QPointF grad;
-
-    for (int a = 0; a < dx; ++a) {
-        for (int b = 0; b < dy; ++b) {
-            Cell& c = scene()->map().cell(a, b);
-            if (c.state() == (Cell::Explored | Cell::Free) && c.robot() == robot) {
-                double rint = integrationRange();
-                if (c.robot() != 0 && !scene()->map().hasFrontiers(c.robot()))
-                    rint = 100;
-                visibleCells = scene()->map().visibleCells(c.center(), rint);
-                // honor Voronoi partition
-                scene()->map().filterCells(visibleCells, c.robot());
-
-                grad = gradient(c.center(), visibleCells);
-                c.setGradient(grad);
-            }
-        }
-    }
-}
-
 //END DisCoverageBulloHandler
 
 // kate: replace-tabs on; indent-width 4;
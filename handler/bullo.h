@@ -23,17 +23,20 @@
 #include <QtCore/QPoint>
 #include <QtCore/QObject>
 #include <QtGui/QFrame>
-#include "cell.h"
-#include "gridmap.h"
 #include "toolhandler.h"
+#include "bullostrategy.h"
 
 class QMouseEvent;
 class QPainter;
-class Scene;
 class QDockWidget;
+class QTikzPicture;
 
 namespace Ui { class DisCoverageFrontierWidget; }
 
+/**
+ * Tool of the DisCoverageBulloStrategy: the dock widget mirrors its
+ * parameters, draw() shows the integration range of each robot.
+ */
 class DisCoverageBulloHandler : public QObject, public ToolHandler
 {
     Q_OBJECT
@@ -42,47 +45,30 @@ class DisCoverageBulloHandler : public QObject, public ToolHandler
         DisCoverageBulloHandler(Scene* scene);
         virtual ~DisCoverageBulloHandler();
 
+        virtual DisCoverageBulloStrategy* strategy();
+
     public:
         virtual void draw(QPainter& p);
         virtual void mouseMoveEvent(QMouseEvent* event);
         virtual void mousePressEvent(QMouseEvent* event);
         virtual void mouseReleaseEvent(QMouseEvent* event);
         virtual void toolHandlerActive(bool activated);
-        virtual void reset();
-        virtual void tick();
-        virtual void postProcess();
-
-        virtual QPointF gradient(Robot* robot, bool interpolate);
-        virtual QString name() const;
 
         // serialization
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
         virtual void exportToTikz(QTikzPicture& tp);
-        virtual void exportObjectiveFunction(QTextStream& ts);
-
-        // udpate vector field only for one robot
-        void updateVectorField(Robot* robot);
-    protected:
-        // update vector field for all explored cells
-        void updateVectorField();
-
-        void setIntegrationRange(double range);
-        double integrationRange() const;
 
     private Q_SLOTS:
         void updateParameters();
 
     private:
-        QPointF gradient(const QPointF& robotPos, const QVector<Cell*>& visibleCells);
-        QPointF interpolatedGradient(const QPointF& robotPos, Robot* robot);
-
-        qreal performance(const QPointF& p, const QPointF& q);
-        qreal fitness(const QPointF& robotPos, const QVector<Cell*>& cells);
-
         QDockWidget* dockWidget();
+        void updateWidgets();
 
     private:
+        DisCoverageBulloStrategy m_strategy;
+
         QDockWidget* m_dock;
         Ui::DisCoverageFrontierWidget* m_ui;
 };
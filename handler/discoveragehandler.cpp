@@ -22,12 +22,12 @@
 
 #include "discoveragehandler.h"
 #include "scene.h"
+#include "simulationcontext.h"
 #include "mainwindow.h"
 #include "ui_discoveragewidget.h"
 #include "robot.h"
 #include "robotmanager.h"
-#include "config.h"
-#include "bullo.h"
+#include "robotview.h"
 
 #include <qglobal.h> // qFuzzyCompare
 
@@ -43,15 +43,14 @@
 #include <QClipboard>
  
 //BEGIN DisCoverageHandler
-DisCoverageHandler::DisCoverageHandler(Scene* scene, DisCoverageBulloHandler* centroidalSearch)
+DisCoverageHandler::DisCoverageHandler(Scene* scene, DisCoverageBulloStrategy* centroidalSearch)
     : QObject()
     , ToolHandler(scene)
+    , m_strategy(&scene->context(), centroidalSearch)
     , m_dock(0)
     , m_ui(0)
     , m_plotter(0)
-    , m_centroidalSearch(centroidalSearch)
 {
-    toolHandlerActive(false);
 }
 
 DisCoverageHandler::~DisCoverageHandler()
@@ -59,18 +58,24 @@ DisCoverageHandler::~DisCoverageHandler()
     delete m_ui;
 }
 
-QString DisCoverageHandler::name() const
+DisCoverageStrategy* DisCoverageHandler::strategy()
 {
-    return QString("DisCoverage-orient-");
+    return &m_strategy;
 }
 
 void DisCoverageHandler::toolHandlerActive(bool activated)
 {
+    // the dock widget is created on first activation only, and never in
+    // batch runs without main window
+    if (!scene()->mainWindow() || (!activated && !m_dock)) {
+        return;
+    }
+
     dockWidget()->setVisible(activated);
     if (activated) {
-        connect(RobotManager::self(), SIGNAL(activeRobotChanged(Robot*)), m_plotter, SLOT(updatePlot(Robot*)));
+        connect(&context()->robotManager(), SIGNAL(activeRobotChanged(Robot*)), m_plotter, SLOT(updatePlot(Robot*)));
     } else {
-        disconnect(RobotManager::self(), 0, m_plotter, 0);
+        disconnect(&context()->robotManager(), 0, m_plotter, 0);
     }
 }
 
@@ -82,137 +87,81 @@ QDockWidget* DisCoverageHandler::dockWidget()
         m_ui = new Ui::DisCoverageWidget();
         QWidget* w = new QWidget();
         m_ui->setupUi(w);
-        m_plotter = new OrientationPlotter(this, w);
+        m_plotter = new OrientationPlotter(&m_strategy, w);
         m_ui->gbOptimization->layout()->addWidget(m_plotter);
         m_dock->setWidget(w);
         scene()->mainWindow()->addDockWidget(Qt::LeftDockWidgetArea, m_dock);
 
+        updateWidgets();
+
         connect(m_ui->sbTheta, SIGNAL(valueChanged(double)), this, SLOT(updateParameters()));
         connect(m_ui->sbSigma, SIGNAL(valueChanged(double)), this, SLOT(updateParameters()));
         connect(m_ui->chkLocalOptimum, SIGNAL(toggled(bool)), this, SLOT(updateParameters()));
-
-        updateParameters();
+        connect(m_ui->chkAutoDist, SIGNAL(toggled(bool)), this, SLOT(updateParameters()));
     }
     return m_dock;
 }
 
-void DisCoverageHandler::setOpeningAngleStdDeviation(double theta)
+void DisCoverageHandler::updateWidgets()
 {
+    if (!m_ui) {
+        return;
+    }
+
     m_ui->sbTheta->blockSignals(true);
-    m_ui->sbTheta->setValue(theta);
+    m_ui->sbTheta->setValue(m_strategy.parameters().theta);
     m_ui->sbTheta->blockSignals(false);
-}
 
-double DisCoverageHandler::openingAngleStdDeviation() const
-{
-    return m_ui->sbTheta->value();
-}
-
-void DisCoverageHandler::setAutoAdaptDistanceStdDeviation(bool autoAdapt)
-{
-    m_ui->chkAutoDist->blockSignals(true);
-    m_ui->chkAutoDist->setChecked(autoAdapt);
-    m_ui->chkAutoDist->blockSignals(false);
-}
-
-bool DisCoverageHandler::autoAdaptDistanceStdDeviation() const
-{
-    return m_ui->chkAutoDist->isChecked();
-}
-
-void DisCoverageHandler::setDistanceStdDeviation(double sigma)
-{
     m_ui->sbSigma->blockSignals(true);
-    m_ui->sbSigma->setValue(sigma);
+    m_ui->sbSigma->setValue(m_strategy.parameters().sigma);
     m_ui->sbSigma->blockSignals(false);
-}
 
-double DisCoverageHandler::distanceStdDeviation() const
-{
-    return m_ui->sbSigma->value();
-}
-
-void DisCoverageHandler::setFollowLocalOptimum(bool localOptimum)
-{
     m_ui->chkLocalOptimum->blockSignals(true);
-    m_ui->chkLocalOptimum->setChecked(localOptimum);
+    m_ui->chkLocalOptimum->setChecked(m_strategy.parameters().followLocalOptimum);
     m_ui->chkLocalOptimum->blockSignals(false);
-}
 
-bool DisCoverageHandler::followLocalOptimum() const
-{
-    return m_ui->chkLocalOptimum->isChecked();
+    m_ui->chkAutoDist->blockSignals(true);
+    m_ui->chkAutoDist->setChecked(m_strategy.parameters().autoAdaptSigma);
+    m_ui->chkAutoDist->blockSignals(false);
 }
 
 void DisCoverageHandler::save(QSettings& config)
 {
     ToolHandler::save(config);
-
-    config.beginGroup("dis-coverage");
-    config.setValue("theta", openingAngleStdDeviation());
-    config.setValue("sigma", distanceStdDeviation());
-    config.setValue("local-optimum", followLocalOptimum());
-    config.setValue("auto-dist", autoAdaptDistanceStdDeviation());
-    config.endGroup();
+    m_strategy.save(config);
 }
 
 void DisCoverageHandler::load(QSettings& config)
 {
     ToolHandler::load(config);
-
-    config.beginGroup("dis-coverage");
-    setOpeningAngleStdDeviation(config.value("theta", 0.5).toDouble());
-    setDistanceStdDeviation(config.value("sigma", 2.0).toDouble());
-    setFollowLocalOptimum(config.value("local-optimum", true).toBool());
-    setAutoAdaptDistanceStdDeviation(config.value("auto-dist", false).toBool());
-    config.endGroup();
+    m_strategy.load(config);
+    updateWidgets();
 }
 
 void DisCoverageHandler::updateParameters()
 {
-    postProcess();
-    scene()->update();
-}
+    DisCoverageParameters parameters(m_strategy.parameters());
+    parameters.theta = m_ui->sbTheta->value();
+    parameters.sigma = m_ui->sbSigma->value();
+    parameters.followLocalOptimum = m_ui->chkLocalOptimum->isChecked();
+    parameters.autoAdaptSigma = m_ui->chkAutoDist->isChecked();
+    m_strategy.setParameters(parameters);
 
-void DisCoverageHandler::updateVectorField()
-{
-    // FIXME: this is slow: compute for all explored free cells the shortest paths
-    //        to all frontiers. Then pick the shortest one, and set the gradient
-    //        according to direction of the first path segment
-    const int count = RobotManager::self()->count();
-
-    if (count > 0) {
-        for (int r = 0; r < count; ++r) {
-            updateVectorField(RobotManager::self()->robot(r));
-        }
-    } else {
-        updateVectorField(0);
-    }
+    context()->postProcess();
+    scene()->update();
 }
 
-void DisCoverageHandler::updateVectorField(Robot* robot)
+void DisCoverageHandler::updateView()
 {
-    const int dx = scene()->map().size().width();
-    const int dy = scene()->map().size().height();
-    const QList<Cell*> frontiers = scene()->map().frontiers(robot);
-
-    // iterate over all free explored cells
-    for (int a = 0; a < dx; ++a) {
-        for (int b = 0; b < dy; ++b) {
-            Cell& c = scene()->map().cell(a, b);
-            if (robot && robot != c.robot())
-                continue;
+    ToolHandler::updateView();
 
-            if (c.state() != (Cell::Explored | Cell::Free))
-                continue;
-
-            c.setGradient(gradient(robot, c.center()));
-        }
+    if (m_plotter) {
+        m_plotter->updatePlot(context()->robotManager().activeRobot());
     }
 
-    // fallback to centroidal search if no frontiers exist
-    if (robot && !scene()->map().hasFrontiers(robot)) {
-        m_centroidalSearch->updateVectorField(robot);
+    // show the auto adapted sigma
+    if (m_strategy.autoAdaptDistanceStdDeviation()) {
+        updateWidgets();
     }
 }
 
@@ -228,8 +177,8 @@ void DisCoverageHandler::mouseMoveEvent(QMouseEvent* event)
     ToolHandler::mouseMoveEvent(event);
 
     // update plot, if a robot is being moved
-    if (event->buttons() & Qt::LeftButton) {
-        m_plotter->updatePlot(RobotManager::self()->activeRobot());
+    if (m_plotter && event->buttons() & Qt::LeftButton) {
+        m_plotter->updatePlot(context()->robotManager().activeRobot());
     }
 }
 
@@ -237,206 +186,15 @@ void DisCoverageHandler::mousePressEvent(QMouseEvent* event)
 {
     mouseMoveEvent(event);
 }
-
-void DisCoverageHandler::reset()
-{
-}
-
-void DisCoverageHandler::tick()
-{
-}
-
-void DisCoverageHandler::postProcess()
-{
-    // compute geodesic Voronoi partition
-    scene()->map().computeVoronoiPartition();
-
-    // update the frontier cache
-    scene()->map().updateRobotFrontierCache();
-
-    // compute vector field in each cell if needed
-    if (Config::self()->showVectorField()) {
-        updateVectorField();
-    }
-
-    // redraw pixmap cache
-    scene()->map().updateCache();
-
-    m_plotter->updatePlot(RobotManager::self()->activeRobot());
-}
-
-QPointF DisCoverageHandler::gradient(Robot* robot, bool interpolate)
-{
-    // no frontiers: fallback to centroidal search-based DisCoverage
-    if (!scene()->map().hasFrontiers(robot)) {
-        return m_centroidalSearch->gradient(robot, interpolate);
-    }
-
-    const bool enableInterpolation = false;
-    if (enableInterpolation && interpolate) {
-        return interpolatedGradient(robot);
-    } else {
-        const bool allowAutoAdjustDistanceComponent = true;
-        const double orientation = robot->orientation();
-        return gradient(robot, robot->position(), robot->hasOrientation() ? &orientation : 0, allowAutoAdjustDistanceComponent);
-    }
-}
-
-QPointF DisCoverageHandler::interpolatedGradient(Robot* robot)
-{
-    const QPointF robotPos = robot->position();
-    GridMap& m = scene()->map();
-    QPoint cellIndex(m.worldToIndex(robotPos));
-
-    // generate 4 samplings points in adjacent cell centers
-    const double diffx = 1.0 - fabs(robotPos.x() - m.cell(cellIndex).center().x()) / scene()->map().resolution();
-    const double diffy = 1.0 - fabs(robotPos.y() - m.cell(cellIndex).center().y()) / scene()->map().resolution();
-
-    const int dx = (robotPos.x() < m.cell(cellIndex).center().x()) ? -1 : 1;
-    const int dy = (robotPos.y() < m.cell(cellIndex).center().y()) ? -1 : 1;
-
-    QPointF g00(m.cell(cellIndex).center());
-    QPointF g01(g00);
-    QPointF g10(g00);
-    QPointF g11(g00);
-
-    if (m.isValidField(cellIndex + QPoint(dx, 0))) g01 = (m.cell(cellIndex + QPoint(dx, 0)).center());
-    if (m.isValidField(cellIndex + QPoint(0, dy))) g10 = (m.cell(cellIndex + QPoint(0, dy)).center());
-    if (m.isValidField(cellIndex + QPoint(dx,dy))) g11 = (m.cell(cellIndex + QPoint(dx, dy)).center());
-
-    // get robot orientation, if available
-    double orientation = robot->orientation();
-    double* pOrientation = robot->hasOrientation() ? (&orientation) : 0;
-
-    // compute gradients in all 4 sampling points
-    QPointF grad00(gradient(robot, g00, pOrientation, true)); // first time, allow to auto adjust distance component
-    QPointF grad01(gradient(robot, g01, pOrientation));
-    QPointF grad10(gradient(robot, g10, pOrientation));
-    QPointF grad11(gradient(robot, g11, pOrientation));
-
-    // interpolate: compute linear combination
-    QPointF gradX0(diffx * grad00 + (1 - diffx) * grad01);
-    QPointF gradX1(diffx * grad10 + (1 - diffx) * grad11);
-
-    QPointF grad(diffy * gradX0 + (1 - diffy) * gradX1);
-
-    // return gradient
-    return grad;
-}
-
-QPointF DisCoverageHandler::gradient(Robot* robot, const QPointF& robotPos, const double* startOrientation, bool adjustDistanceComponent)
-{
-    const QList<Cell*> frontiers = Scene::self()->map().frontiers(robot);
-    
-    if (frontiers.size() == 0)
-        return QPointF(0, 0);
-
-    GridMap& m = Scene::self()->map();
-    QPoint pt = m.worldToIndex(robotPos);
-    QList<Path> allPaths = m.frontierPaths(pt, frontiers);
-
-    double shortestPath = 1000000000.0;
-    for (int i = 0; i < allPaths.size(); ++i) {
-        allPaths[i].beautify(m);
-        if (allPaths[i].m_length < shortestPath) {
-            shortestPath = allPaths[i].m_length;
-        }
-    }
-
-    if (autoAdaptDistanceStdDeviation() && adjustDistanceComponent) {
-        setDistanceStdDeviation(shortestPath);
-    }
-
-    QVector<QPointF> deltaPoints;
-
-    double delta = -M_PI;
-    double sMax = 0.0;
-    double deltaMax = 0.0;
-    while (delta < M_PI) {
-        double s = 0;
-        int i = 0;
-        foreach (Cell* q, frontiers) {
-            s += disCoverage(robotPos, delta, q->rect().center(), allPaths[i]);
-            ++i;
-        }
-
-        deltaPoints.append(QPointF(delta, s));
-
-        if (s > sMax) {
-            sMax = s;
-            deltaMax = delta;
-        }
-        delta += 0.1;
-    }
-
-    // follow local optimum
-    if (followLocalOptimum() && startOrientation) {
-        int i;
-        for (i = 0; i < deltaPoints.size(); ++i) {
-            if (qFuzzyCompare(deltaPoints[i].x(), *startOrientation))
-                break;
-        }
-
-        // first time m_delta == 0.0, so no index found
-        if (deltaPoints.size() == i) {
-//             qDebug() << "found no correct orientation!";
-            i = 0;
-        }
-
-        const int n = deltaPoints.size();
-        int c = 0; // avoid infinite loop
-        while (deltaPoints[i].y() <= deltaPoints[(i + 1) % n].y() && c < n) {
-            i = (i + 1) % n;
-            ++c;
-        }
-
-        c = 0;
-        while (deltaPoints[i].y() <= deltaPoints[(i - 1 + n) % n].y() && c < n) {
-            i = (i - 1 + n) % n;
-            ++c;
-        }
-
-        deltaMax = deltaPoints[i].x();
-    }
-
-    return QPointF(cos(deltaMax), sin(deltaMax));
-}
-
-double DisCoverageHandler::disCoverage(const QPointF& pos, double delta, const QPointF& q, const Path& path)
-{
-    if (path.m_path.size() < 2) {
-        return 0.0f;
-    }
-
-    const double theta = openingAngleStdDeviation();
-    const double sigma = distanceStdDeviation();
-
-    const QPointF cellCenter = scene()->map().cell(path.m_path[1]).rect().center();
-
-    // pos is continuous robot position
-    // cellCenter is center of 2nd path cell
-    const double dx = cellCenter.x() - pos.x();
-    const double dy = cellCenter.y() - pos.y();
-
-    float alpha = - delta + atan2(dy, dx);
-
-    if (alpha > M_PI) alpha -= 2 * M_PI;
-    else if (alpha < -M_PI) alpha += 2 * M_PI;
-
-    const double len = path.m_length;
-
-    return exp(- alpha*alpha/(2.0*theta*theta)
-               - len*len/(2.0*sigma*sigma));
-}
 //END DisCoverageHandler
 
 
 
 
 
-OrientationPlotter::OrientationPlotter(DisCoverageHandler* handler, QWidget* parent)
+OrientationPlotter::OrientationPlotter(DisCoverageStrategy* strategy, QWidget* parent)
     : QFrame(parent)
-    , m_handler(handler)
+    , m_strategy(strategy)
 {
     setFrameStyle(QFrame::Panel | QFrame::Sunken);
     setFixedHeight(100);
@@ -450,49 +208,21 @@ void OrientationPlotter::updatePlot(Robot* robot)
 {
     if (!robot) return;
 
-    const QList<Cell*> frontiers = Scene::self()->map().frontiers(robot);
-    GridMap& m = Scene::self()->map();
-    QPoint pt = m.worldToIndex(robot->position());
-    QList<Path> allPaths = m.frontierPaths(pt, frontiers);
+    QVector<QPointF> deltaPoints = m_strategy->orientationObjective(robot).curve(0.02);
 
-    double shortestPath = 1000000000.0;
-    for (int i = 0; i < allPaths.size(); ++i) {
-        allPaths[i].beautify(m);
-        if (allPaths[i].m_length < shortestPath) {
-            shortestPath = allPaths[i].m_length;
-        }
-    }
-
-    if (m_handler->autoAdaptDistanceStdDeviation()) {
-        m_handler->setDistanceStdDeviation(shortestPath);
-    }
-
-    QVector<QPointF> deltaPoints;
-
-    double delta = -M_PI;
     double sMax = 0.0;
     double deltaMax = 0.0;
-    while (delta < M_PI) {
-        double s = 0;
-        int i = 0;
-        foreach (Cell* q, frontiers) {
-            s += m_handler->disCoverage(robot->position(), delta, q->rect().center(), allPaths[i]);
-            ++i;
-        }
-
-        deltaPoints.append(QPointF(delta, s));
-
-        if (s > sMax) {
-            sMax = s;
-            deltaMax = delta;
+    foreach (const QPointF& point, deltaPoints) {
+        if (point.y() > sMax) {
+            sMax = point.y();
+            deltaMax = point.x();
         }
-        delta += 0.02;
     }
 
     m_data = deltaPoints;
 
     // follow local optimum
-    if (m_handler->followLocalOptimum()) {
+    if (m_strategy->followLocalOptimum()) {
         int i;
         double robotOrientation = robot->orientation();
         for (i = 0; i < deltaPoints.size(); ++i) {
@@ -569,8 +299,8 @@ void OrientationPlotter::paintEvent(QPaintEvent* event)
 
     // mark chosen orientation with a circle, filled by the robot color
     p.setPen(Qt::black);
-    if (Robot* robot = RobotManager::self()->activeRobot()) {
-        p.setBrush(robot->color());
+    if (Robot* robot = m_strategy->context()->robotManager().activeRobot()) {
+        p.setBrush(RobotView::color(robot));
     } else {
         p.setBrush(QColor(255, 0, 0, 128));
     }
@@ -23,72 +23,56 @@
 #include <QtCore/QPoint>
 #include <QtCore/QObject>
 #include <QtGui/QFrame>
-#include "cell.h"
-#include "gridmap.h"
 #include "toolhandler.h"
+#include "discoveragestrategy.h"
 
 class QMouseEvent;
 class QPainter;
-class Scene;
 class QDockWidget;
 class OrientationPlotter;
-class DisCoverageBulloHandler;
+class DisCoverageBulloStrategy;
 
 namespace Ui { class DisCoverageWidget; }
 
+/**
+ * Tool of the DisCoverageStrategy: the dock widget mirrors its parameters
+ * and plots the objective over the start orientation of the active robot.
+ */
 class DisCoverageHandler : public QObject, public ToolHandler
 {
     Q_OBJECT
 
     public:
-        DisCoverageHandler(Scene* scene, DisCoverageBulloHandler* centroidalSearch);
+        DisCoverageHandler(Scene* scene, DisCoverageBulloStrategy* centroidalSearch);
         virtual ~DisCoverageHandler();
 
-        double disCoverage(const QPointF& pos, double delta, const QPointF& q, const Path& path);
+        virtual DisCoverageStrategy* strategy();
 
-        void setOpeningAngleStdDeviation(double theta);
-        double openingAngleStdDeviation() const;
-
-        void setAutoAdaptDistanceStdDeviation(bool autoAdapt);
-        bool autoAdaptDistanceStdDeviation() const;
-
-        void setFollowLocalOptimum(bool localOptimum);
-        bool followLocalOptimum() const;
-
-        void setDistanceStdDeviation(double sigma);
-        double distanceStdDeviation() const;
+        // map cache, plot, and the auto adapted sigma
+        virtual void updateView();
 
     public:
         virtual void draw(QPainter& p);
         virtual void mouseMoveEvent(QMouseEvent* event);
         virtual void mousePressEvent(QMouseEvent* event);
         virtual void toolHandlerActive(bool activated);
-        virtual void reset();
-        virtual void tick();
-        virtual void postProcess();
 
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
 
-        virtual QPointF gradient(Robot* robot, bool interpolate);
-        virtual QString name() const;
-
     private Q_SLOTS:
-        void updateVectorField();
-        void updateVectorField(Robot* robot);
         void updateParameters();
 
     private:
         QDockWidget* dockWidget();
-        QPointF interpolatedGradient(Robot* robot);
-        QPointF gradient(Robot* robot, const QPointF& robotPos, const double* startOrientation = 0, bool adjustDistanceComponent = false);
+        void updateWidgets();
 
     private:
+        DisCoverageStrategy m_strategy;
+
         QDockWidget* m_dock;
         Ui::DisCoverageWidget* m_ui;
         OrientationPlotter* m_plotter;
-
-        DisCoverageBulloHandler* m_centroidalSearch;
 };
 
 class OrientationPlotter : public QFrame
@@ -96,7 +80,7 @@ class OrientationPlotter : public QFrame
     Q_OBJECT
 
     public:
-        OrientationPlotter(DisCoverageHandler* handler, QWidget* parent = 0);
+        OrientationPlotter(DisCoverageStrategy* strategy, QWidget* parent = 0);
         virtual ~OrientationPlotter();
 
         void setCurrentOrientation(const QPointF& currentOrientation);
@@ -109,7 +93,7 @@ class OrientationPlotter : public QFrame
         void contextMenuEvent(QContextMenuEvent * event);
 
     private:
-        DisCoverageHandler* m_handler;
+        DisCoverageStrategy* m_strategy;
         QVector<QPointF> m_data;
         QPointF m_currentOrientation;
 };
@@ -3,6 +3,7 @@
 
 
 #include "toolhandler.h"
+#include "maxareastrategy.h"
 
 #include <QtCore/QObject>
 
@@ -15,23 +16,13 @@ class MaxAreaHandler : public QObject, public ToolHandler
 public:
     MaxAreaHandler(Scene* scene);
 
-    virtual void tick();
-    virtual void postProcess();
+    virtual MaxAreaStrategy* strategy();
     virtual void draw(QPainter& p);    
     virtual void mouseMoveEvent(QMouseEvent* event);
     virtual void mousePressEvent(QMouseEvent* event);
-    virtual QPointF gradient(Robot* robot, bool interpolate);
-	
-	virtual QPointF gradient(Robot* robot, const QPointF& robotPos);
-	
-	virtual void updateVectorField();
-	
-	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
-	
-    virtual QString name() const;
-	
+
 private:
-    double computeDistance(QPointF arg1, QPointF arg2);
+	MaxAreaStrategy m_strategy;
 };
 
 #endif // MAXAREAHANDLER_H
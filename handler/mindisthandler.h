@@ -20,52 +20,36 @@
 #ifndef MINDIST_HANDLER_H
 #define MINDIST_HANDLER_H
 
-#include <QtCore/QPoint>
 #include <QtCore/QObject>
-#include <QtGui/QFrame>
-#include "cell.h"
-#include "gridmap.h"
 #include "toolhandler.h"
+#include "mindiststrategy.h"
 
 class QMouseEvent;
 class QPainter;
-class Scene;
-class DisCoverageBulloHandler;
+class DisCoverageBulloStrategy;
 
 class MinDistHandler : public QObject, public ToolHandler
 {
     Q_OBJECT
 
     public:
-        MinDistHandler(Scene* scene, DisCoverageBulloHandler* centroidalSearch);
+        MinDistHandler(Scene* scene, DisCoverageBulloStrategy* centroidalSearch);
         virtual ~MinDistHandler();
 
+        virtual MinDistStrategy* strategy();
+
     public:
         virtual void draw(QPainter& p);
         virtual void mouseMoveEvent(QMouseEvent* event);
         virtual void mousePressEvent(QMouseEvent* event);
         virtual void toolHandlerActive(bool activated);
-        virtual void reset();
-        virtual void tick();
-
-        virtual void postProcess();
-
-        virtual QPointF gradient(Robot* robot, bool interpolate);
-        virtual QString name() const;
 
         // serialization
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
 
-    protected:
-        void updateVectorField();
-        void updateVectorField(Robot* robot);
-
-        QPointF gradient(const QPointF& robotPos, const QList<Cell*>& frontiers);
-        QPointF interpolatedGradient(const QPointF& robotPos, Robot* robot);
-
     private:
-        DisCoverageBulloHandler* m_centroidalSearch;
+        MinDistStrategy m_strategy;
 };
 
 #endif // MINDIST_HANDLER_H
@@ -2,6 +2,7 @@
 #define RANDOMHANDLER_H
 
 #include "toolhandler.h"
+#include "randomstrategy.h"
 
 #include <QtCore/QObject>
 
@@ -13,17 +14,13 @@ class RandomHandler : public QObject, public ToolHandler
 public:
     RandomHandler(Scene* scene);
 
-    virtual void tick();
-    virtual void postProcess();
+    virtual RandomStrategy* strategy();
     virtual void draw(QPainter& p);    
     virtual void mouseMoveEvent(QMouseEvent* event);
     virtual void mousePressEvent(QMouseEvent* event);
-    virtual QPointF gradient(Robot* robot, bool interpolate);
 
 private:
-	QPointF grad;
-	
-	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
+	RandomStrategy m_strategy;
 };
 
 #endif // RANDOMHANDLER_H
@@ -1,16 +1,13 @@
 #include "ruffinshandler.h"
-
-#include "robot.h"
 #include "scene.h"
 
-#include <iostream>
-#include <cmath>
-
-#include <QtCore/QList>
+RuffinsHandler::RuffinsHandler(Scene* scene): QObject(), ToolHandler(scene), m_strategy(&scene->context())
+{
+}
 
-RuffinsHandler::RuffinsHandler(Scene* scene): QObject(), ToolHandler(scene), grad(1, 0)
+RuffinsStrategy* RuffinsHandler::strategy()
 {
-	srand(42);
+	return &m_strategy;
 }
 
 void RuffinsHandler::mouseMoveEvent(QMouseEvent* event)
@@ -29,82 +26,3 @@ void RuffinsHandler::mousePressEvent(QMouseEvent* event)
 {
     mouseMoveEvent(event);
 }
-
-void RuffinsHandler::tick()
-{
-    ToolHandler::tick();
-}
-
-void RuffinsHandler::postProcess()
-{
-    ToolHandler::postProcess();
-	
-    // update the frontier cache
-    scene()->map().updateRobotFrontierCache();
-}
-
-QPointF RuffinsHandler::gradient(Robot* robot, bool interpolate)
-{
-    GridMap& m = *robot->map();
-	
-	if (rand() % 10) {
-		QPoint pos = m.worldToIndex(robot->position()) + grad.toPoint();
-		if (! m.cell(pos).isObstacle()) {
-			return this->grad;
-		}
-		else{
-			std::cout << "oww I've crashed into an obstacle!" << std::endl;
-		}
-	}
-	
-    while (1) {
-
-		double x = rand() - RAND_MAX / 2;
-		double y = rand() - RAND_MAX / 2;
-		std::cout << x << " : " << y << std::endl;
-		double scale = sqrt(x * x + y * y);
-		QPointF newGrad(x / scale , y / scale);
-//		robot->position();
-
-        //m = *robot->map();
-		QPoint pos = m.worldToIndex(robot->position()) + newGrad.toPoint();
-
-		if (! m.cell(pos).isObstacle()) {
-			grad = newGrad;
-			return newGrad;
-		}
-		else{
-			QPointF newGrad(-grad.x(), -grad.y());
-//			grad = newGrad;
-			return newGrad;
-		}
-	}
-    return QPointF();
-}
-
-double RuffinsHandler::explorationPotential(GridMap& m, QPoint position, int radius)
-{
-	double result = 0.0;
-	
-	if (m.isValidField(position))
-	{
-		return 0.0;
-	}
-	
-	int xStart = position.x() - radius;
-	int xEnd = position.x() + radius;
-	int yStart = position.y() - radius;
-	int yEnd = position.y() + radius;
-	
-	for ( int a = xStart; a <= xEnd; ++a) {
-		for (int b = yStart; b <= yEnd; ++b) {
-			if (m.isValidField(a, b)) {
-				
-			}
-			else {
-				
-			}
-		}
-	}
-	return result;
-}
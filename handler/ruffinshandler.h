@@ -2,6 +2,7 @@
 #define RUFFINSHANDLER_H
 
 #include "toolhandler.h"
+#include "ruffinsstrategy.h"
 
 #include <QtCore/QObject>
 
@@ -13,17 +14,13 @@ class RuffinsHandler : public QObject, public ToolHandler
 public:
     RuffinsHandler(Scene* scene);
 
-    virtual void tick();
-    virtual void postProcess();
+    virtual RuffinsStrategy* strategy();
     virtual void draw(QPainter& p);    
     virtual void mouseMoveEvent(QMouseEvent* event);
     virtual void mousePressEvent(QMouseEvent* event);
-    virtual QPointF gradient(Robot* robot, bool interpolate);
 
 private:
-	QPointF grad;
-	
-	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
+	RuffinsStrategy m_strategy;
 };
 
 #endif // RUFFINSHANDLER_H
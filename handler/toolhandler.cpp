@@ -19,6 +19,7 @@
 
 #include "toolhandler.h"
 #include "scene.h"
+#include "simulationcontext.h"
 #include "mainwindow.h"
 #include "robotmanager.h"
 #include "robot.h"
@@ -28,7 +29,6 @@
 #include <QtGui/QKeyEvent>
 #include <QtCore/QSettings>
 #include <QtCore/QDebug>
-#include <QtCore/QTextStream>
 
 #include <math.h>
 
@@ -51,15 +51,32 @@ Scene* ToolHandler::scene() const
     return m_scene;
 }
 
+SimulationContext* ToolHandler::context() const
+{
+    return &m_scene->context();
+}
+
+Strategy* ToolHandler::strategy()
+{
+    return 0;
+}
+
+void ToolHandler::updateView()
+{
+    scene()->mapView().updateCache();
+}
+
 QPoint ToolHandler::cellForMousePosition(const QPoint& mousePosition)
 {
-    return Scene::self()->map().screenToIndex(mousePosition);
+    return Scene::self()->mapView().screenToIndex(mousePosition);
 }
 
 void ToolHandler::setCurrentCell(const QPoint& cellIndex)
 {
     s_currentCell = cellIndex;
-    Scene::self()->mainWindow()->setStatusPosition(cellIndex + QPoint(1, 1));
+    if (Scene::self() && Scene::self()->mainWindow()) {
+        Scene::self()->mainWindow()->setStatusPosition(cellIndex + QPoint(1, 1));
+    }
 }
 
 void ToolHandler::updateCurrentCell(const QPoint& mousePos)
@@ -98,8 +115,8 @@ void ToolHandler::draw(QPainter& p)
 void ToolHandler::mousePressEvent(QMouseEvent* event)
 {
     if (event->buttons() & Qt::LeftButton) {
-        if (Robot* robot = RobotManager::self()->activeRobot()) {
-            QPointF pos = scene()->map().screenToWorld(event->posF());
+        if (Robot* robot = context()->robotManager().activeRobot()) {
+            QPointF pos = scene()->mapView().screenToWorld(event->posF());
             robot->setPosition(pos);
             Scene::self()->mainWindow()->statusBar()->showMessage(QString("%1, %2").arg(pos.x(), pos.y()));
         }
@@ -109,8 +126,8 @@ void ToolHandler::mousePressEvent(QMouseEvent* event)
 void ToolHandler::mouseMoveEvent(QMouseEvent* event)
 {
     if (event->buttons() & Qt::LeftButton) {
-        if (Robot* robot = RobotManager::self()->activeRobot()) {
-            QPointF pos = scene()->map().screenToWorld(event->posF());
+        if (Robot* robot = context()->robotManager().activeRobot()) {
+            QPointF pos = scene()->mapView().screenToWorld(event->posF());
             robot->setPosition(pos);
             Scene::self()->mainWindow()->statusBar()->showMessage(QString("%1, %2").arg(pos.x()).arg(pos.y()));
         }
@@ -125,8 +142,8 @@ void ToolHandler::keyPressEvent(QKeyEvent* event)
 {
     int index = event->key() - Qt::Key_1;
 
-    if (index >= 0 && index < RobotManager::self()->count()) {
-        RobotManager::self()->setActiveRobot(RobotManager::self()->robot(index));
+    if (index >= 0 && index < context()->robotManager().count()) {
+        context()->robotManager().setActiveRobot(context()->robotManager().robot(index));
     }
 }
 
@@ -134,19 +151,6 @@ void ToolHandler::toolHandlerActive(bool activated)
 {
 }
 
-void ToolHandler::reset()
-{
-}
-
-void ToolHandler::tick()
-{
-}
-
-void ToolHandler::postProcess()
-{
-    scene()->map().updateCache();
-}
-
 void ToolHandler::save(QSettings& config)
 {
     config.beginGroup("tool-handler");
@@ -169,27 +173,23 @@ void ToolHandler::exportToTikz(QTikzPicture& tp)
 {
 }
 
-void ToolHandler::exportObjectiveFunction(QTextStream& ts)
-{
-}
-
 void ToolHandler::drawOperationRadius(QPainter& p)
 {
     p.setOpacity(0.2);
     QPainter::RenderHints rh = p.renderHints();
     p.setRenderHints(QPainter::Antialiasing, true);
     p.setBrush(QBrush(Qt::blue));
-    p.drawEllipse(scene()->map().screenToWorld(mousePosition()), operationRadius(), operationRadius());
+    p.drawEllipse(scene()->mapView().screenToWorld(mousePosition()), operationRadius(), operationRadius());
     p.setRenderHints(rh, true);
     p.setOpacity(1.0);
 }
 
 void ToolHandler::highlightCurrentCell(QPainter& p)
 {
-    if (s_currentCell.x() >= 0 && s_currentCell.x() < scene()->map().size().width() &&
-        s_currentCell.y() >= 0 && s_currentCell.y() < scene()->map().size().height())
+    if (s_currentCell.x() >= 0 && s_currentCell.x() < context()->map().size().width() &&
+        s_currentCell.y() >= 0 && s_currentCell.y() < context()->map().size().height())
     {
-        Cell& cell = scene()->map().cell(s_currentCell.x(), s_currentCell.y());
+        Cell cell = context()->map().cell(s_currentCell.x(), s_currentCell.y());
 
         // scale by 2
         p.save();
@@ -198,23 +198,13 @@ void ToolHandler::highlightCurrentCell(QPainter& p)
         p.setOpacity(0.7);
 
         // draw cell in double size
-        cell.draw(p, true, true);
+        GridMapView::drawCell(p, cell, true, true);
         p.setPen(Qt::black);
         p.drawRect(cell.rect());
 
         p.restore();
     }
 }
-
-QPointF ToolHandler::gradient(Robot* /*robot*/, bool /*interpolate*/)
-{
-    return QPointF();
-}
-
-QString ToolHandler::name() const
-{
-    return QString();
-}
 //END ToolHandler
 
 
@@ -237,7 +227,7 @@ void RobotHandler::draw(QPainter& p)
 
     highlightCurrentCell(p);
 
-    GridMap &m = scene()->map();
+    GridMap &m = context()->map();
 
     QPainter::RenderHints rh = p.renderHints();
     p.setRenderHints(QPainter::Antialiasing, true);
@@ -273,8 +263,8 @@ void ObstacleHandler::draw(QPainter& p)
     ToolHandler::draw(p);
 
     p.setOpacity(0.2);
-    QRectF rect(scene()->map().screenToWorld(mousePosition()), 2 * QSizeF(1, 1) * scene()->map().resolution());
-    rect.moveTo(rect.topLeft() - scene()->map().resolution() * QPointF(1, 1));
+    QRectF rect(scene()->mapView().screenToWorld(mousePosition()), 2 * QSizeF(1, 1) * context()->map().resolution());
+    rect.moveTo(rect.topLeft() - context()->map().resolution() * QPointF(1, 1));
     p.fillRect(rect, Qt::black);
     p.setOpacity(1.0);
 }
@@ -297,13 +287,13 @@ void ObstacleHandler::updateObstacles()
         destState = Cell::Free;
     }
 
-    qreal x = scene()->map().screenToWorld(mousePosition().x());
-    qreal y = scene()->map().screenToWorld(mousePosition().y());
+    qreal x = scene()->mapView().screenToWorld(mousePosition().x());
+    qreal y = scene()->mapView().screenToWorld(mousePosition().y());
 
-    const qreal res = scene()->map().resolution();
+    const qreal res = context()->map().resolution();
     QRectF rect(QPointF(x - res, y - res), 2 * res * QSizeF(1, 1));
 
-    GridMap& m = scene()->map();
+    GridMap& m = context()->map();
 
     int xStart = qMax(0, (int)(rect.left() / res /*- 1*/));
     int xEnd = qMin(m.size().width() - 1, (int)(rect.right() / res /*+ 1*/));
@@ -312,11 +302,10 @@ void ObstacleHandler::updateObstacles()
     int yEnd = qMin(m.size().height() - 1, (int)(rect.bottom() / res /*+ 1*/));
     for (int a = xStart; a <= xEnd; ++a) {
         for (int b = yStart; b <= yEnd; ++b) {
-            Cell& c = m.cell(a, b);
+            Cell c = m.cell(a, b);
             if (!(c.state() & destState)) {
                 if (rect.contains(c.center())) {
                     m.setState(c, destState);
-                    m.updateCell(a, b);
                 }
             }
         }
@@ -363,9 +352,9 @@ void ExplorationHandler::updateExploredState()
 {
     const bool markAsExplored = !(QApplication::keyboardModifiers() & Qt::ControlModifier);
 
-    QPointF pos = scene()->map().screenToWorld(mousePosition());
-    if (scene()->map().isValidField(pos.x(), pos.y())) {
-        scene()->map().exploreInRadius(pos, operationRadius(), markAsExplored);
+    QPointF pos = scene()->mapView().screenToWorld(mousePosition());
+    if (context()->map().isValidField(pos.x(), pos.y())) {
+        context()->map().exploreInRadius(pos, operationRadius(), markAsExplored);
     }
 }
 //END ExplorationHandler
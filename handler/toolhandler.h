@@ -27,10 +27,12 @@
 class QMouseEvent;
 class QPainter;
 class Scene;
+class SimulationContext;
 class QSettings;
-class QTextStream;
 class QKeyEvent;
+class QTikzPicture;
 class Robot;
+class Strategy;
 
 class ToolHandler
 {
@@ -46,7 +48,9 @@ class ToolHandler
         ToolHandler(Scene* scene);
         virtual ~ToolHandler();
 
+        // the scene this tool works on, and its simulation
         Scene* scene() const;
+        SimulationContext* context() const;
 
         QPoint currentCell() const;
         QPoint mousePosition() const;
@@ -54,6 +58,20 @@ class ToolHandler
         void drawOperationRadius(QPainter& p);
         void highlightCurrentCell(QPainter& p);
 
+        /**
+         * Strategy of this tool, used as strategy of the simulation while
+         * the tool is selected. The default returns 0, for tools that only
+         * edit the scene.
+         */
+        virtual Strategy* strategy();
+
+        /**
+         * Called after the strategy prepared the next iteration, see
+         * SimulationContext::postProcessed(). The default implementation
+         * refreshes the map cache of the scene.
+         */
+        virtual void updateView();
+
     //
     // event handling
     //
@@ -68,61 +86,15 @@ class ToolHandler
         virtual void keyPressEvent(QKeyEvent* event);
         virtual void toolHandlerActive(bool activated);
 
-    //
-    // strategy specifics
-    //
-    public:
-        /**
-         * This function is called when the "Reset" action is triggered.
-         * Usually, cleanup routines are called here, such as cleaning trajectories.
-         *
-         * The default implementation does nothing.
-         */
-        virtual void reset();
-
-        /**
-         * This function is called each iteration and is basically one step
-         * of a discrete-time implementation of the algorithm.
-         *
-         * To move the robots, use the Robot::setPosition() and Robot::position().
-         *
-         * The default implementation does nothing.
-         *
-         * @see RobotManager, Robot::position(), Robot::setPosition()
-         */
-        virtual void tick();
-
-        /**
-         * This function is called after tick().
-         * The idea is to prepare everything for the next iteration.
-         * Examples include the computation of the Voronoi partition, distance
-         * transforms or information needed when painting the environment.
-         */
-        virtual void postProcess();
-
-        /**
-         * Return the gradient for @p robot at robot->position().
-         * Usually, @p interpolate is true. This means that the returned gradient
-         * should be interpolated between the 4 adjacent grid map cells of the
-         * current robot position.
-         */
-        virtual QPointF gradient(Robot* robot, bool interpolate);
-
-        /**
-         * Return a GUI readable name of the strategy.
-         * Examples: "MinDist", "MaxArea", "DisCoverage", ...
-         */
-        virtual QString name() const;
-
     //
     // load & save, and export
     //
     public:
+        // the mouse state, reimplement to load and save the strategy, too
         virtual void save(QSettings& config);
         virtual void load(QSettings& config);
 
         virtual void exportToTikz(QTikzPicture& tp);
-        virtual void exportObjectiveFunction(QTextStream& ts);
 
     private:
         Scene* m_scene;
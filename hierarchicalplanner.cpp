@@ -0,0 +1,566 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "hierarchicalplanner.h"
+#include "priorityqueue.h"
+
+#include <QtCore/QtAlgorithms>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+// same order as the first 8 entries of the direction map of the GridMap:
+// 4 orthogonal neighbors, then 4 diagonal neighbors
+static const int s_neighbors[8][2] = {
+    {  0, -1},  // top
+    {  1,  0},  // right
+    {  0,  1},  // bottom
+    { -1,  0},  // left
+    {  1, -1},  // top right
+    {  1,  1},  // bottom right
+    { -1,  1},  // bottom left
+    { -1, -1}   // top left
+};
+
+static const float s_infinity = std::numeric_limits<float>::infinity();
+
+// runs of at least this length get an entrance at both ends
+static const int s_longEntrance = 6;
+
+//BEGIN HierarchicalPlanner
+HierarchicalPlanner::HierarchicalPlanner(GridMap* map, int tileSize)
+    : m_map(map)
+    , m_tileQueue(PriorityQueue::create(PriorityQueue::IndexedHeap))
+    , m_nodeQueue(PriorityQueue::create(PriorityQueue::IndexedHeap))
+    , m_tileSize(qMax(tileSize, 2))
+    , m_width(0)
+    , m_height(0)
+    , m_tilesX(0)
+    , m_tilesY(0)
+    , m_resetPending(true)
+    , m_nodesValid(false)
+    , m_lastRebuildCount(0)
+{
+    m_map->addObserver(this);
+}
+
+HierarchicalPlanner::~HierarchicalPlanner()
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+    delete m_tileQueue;
+    delete m_nodeQueue;
+}
+
+GridMap* HierarchicalPlanner::map() const
+{
+    return m_map;
+}
+
+int HierarchicalPlanner::tileSize() const
+{
+    return m_tileSize;
+}
+
+int HierarchicalPlanner::lastRebuildCount() const
+{
+    return m_lastRebuildCount;
+}
+
+int HierarchicalPlanner::entranceCount() const
+{
+    return m_nodeCell.size();
+}
+
+int HierarchicalPlanner::tileOf(int x, int y) const
+{
+    return (y / m_tileSize) * m_tilesX + x / m_tileSize;
+}
+
+QRect HierarchicalPlanner::tileRect(int tile) const
+{
+    const int x = (tile % m_tilesX) * m_tileSize;
+    const int y = (tile / m_tilesX) * m_tileSize;
+    return QRect(x, y, qMin(m_tileSize, m_width - x), qMin(m_tileSize, m_height - y));
+}
+
+int HierarchicalPlanner::localIndex(int tile, int index) const
+{
+    const int x = index % m_width - (tile % m_tilesX) * m_tileSize;
+    const int y = index / m_width - (tile / m_tilesX) * m_tileSize;
+    return y * m_tileSize + x;
+}
+
+float HierarchicalPlanner::cellCost(int index) const
+{
+    return Cell(m_map, index).cellCost();
+}
+
+void HierarchicalPlanner::update()
+{
+    if (!m_map)
+        return;
+
+    if (m_resetPending) {
+        rebuild();
+    }
+
+    m_lastRebuildCount = m_dirtyTiles.size();
+    foreach (int tile, m_dirtyTiles) {
+        rebuildTile(tile);
+    }
+    m_dirtyTiles.clear();
+
+    if (!m_nodesValid) {
+        numberNodes();
+    }
+}
+
+void HierarchicalPlanner::rebuild()
+{
+    const QSize size = m_map->size();
+    m_width = size.width();
+    m_height = size.height();
+    m_tilesX = (m_width + m_tileSize - 1) / m_tileSize;
+    m_tilesY = (m_height + m_tileSize - 1) / m_tileSize;
+
+    const int tileCount = m_tilesX * m_tilesY;
+    m_tiles = QVector<Tile>(tileCount);
+    m_dirtyTiles.clear();
+    for (int tile = 0; tile < tileCount; ++tile) {
+        m_tiles[tile].dirty = true;
+        m_dirtyTiles.append(tile);
+    }
+
+    m_tileCost.resize(m_tileSize * m_tileSize);
+    m_tileParent.resize(m_tileSize * m_tileSize);
+
+    m_resetPending = false;
+    m_nodesValid = false;
+}
+
+void HierarchicalPlanner::markDirty(int tile)
+{
+    if (!m_tiles[tile].dirty) {
+        m_tiles[tile].dirty = true;
+        m_dirtyTiles.append(tile);
+    }
+    m_nodesValid = false;
+}
+
+void HierarchicalPlanner::addBorderEntrances(const QPoint& inside, const QPoint& outside,
+                                             const QPoint& along, int length, QVector<int>& entrances) const
+{
+    // Split the border into runs of cell pairs with equal costs on both sides.
+    // Both tiles walk the border in the same direction, so they agree on the
+    // entrances.
+    int runStart = 0;
+    for (int i = 1; i <= length; ++i) {
+        if (i < length) {
+            const QPoint a = inside + i * along;
+            const QPoint b = outside + i * along;
+            const QPoint prevA = a - along;
+            const QPoint prevB = b - along;
+            if (cellCost(m_map->linearIndex(a.x(), a.y())) == cellCost(m_map->linearIndex(prevA.x(), prevA.y()))
+                && cellCost(m_map->linearIndex(b.x(), b.y())) == cellCost(m_map->linearIndex(prevB.x(), prevB.y())))
+            {
+                continue;
+            }
+        }
+
+        // run [runStart, i - 1] ends here
+        const int runLength = i - runStart;
+        if (runLength >= s_longEntrance) {
+            const QPoint first = inside + runStart * along;
+            const QPoint last = inside + (i - 1) * along;
+            entrances.append(m_map->linearIndex(first.x(), first.y()));
+            entrances.append(m_map->linearIndex(last.x(), last.y()));
+        } else {
+            const QPoint middle = inside + (runStart + (runLength - 1) / 2) * along;
+            entrances.append(m_map->linearIndex(middle.x(), middle.y()));
+        }
+        runStart = i;
+    }
+}
+
+void HierarchicalPlanner::rebuildTile(int tile)
+{
+    const QRect rect = tileRect(tile);
+
+    QVector<int> entrances;
+    if (rect.top() > 0) {
+        addBorderEntrances(rect.topLeft(), rect.topLeft() + QPoint(0, -1),
+                           QPoint(1, 0), rect.width(), entrances);
+    }
+    if (rect.right() + 1 < m_width) {
+        addBorderEntrances(rect.topRight(), rect.topRight() + QPoint(1, 0),
+                           QPoint(0, 1), rect.height(), entrances);
+    }
+    if (rect.bottom() + 1 < m_height) {
+        addBorderEntrances(rect.bottomLeft(), rect.bottomLeft() + QPoint(0, 1),
+                           QPoint(1, 0), rect.width(), entrances);
+    }
+    if (rect.left() > 0) {
+        addBorderEntrances(rect.topLeft(), rect.topLeft() + QPoint(-1, 0),
+                           QPoint(0, 1), rect.height(), entrances);
+    }
+
+    // corner cells may be entrances of two borders
+    qSort(entrances.begin(), entrances.end());
+    entrances.erase(std::unique(entrances.begin(), entrances.end()), entrances.end());
+
+    // cheapest paths between all entrances within the tile
+    const int n = entrances.size();
+    QVector<float> costs(n * n);
+    for (int i = 0; i < n; ++i) {
+        searchTile(tile, QVector<int>(1, entrances[i]), QVector<float>(1, 0.0f), false);
+        for (int j = 0; j < n; ++j) {
+            costs[i * n + j] = m_tileCost[localIndex(tile, entrances[j])];
+        }
+    }
+
+    Tile& t = m_tiles[tile];
+    t.entrances = entrances;
+    t.costs = costs;
+    t.dirty = false;
+}
+
+void HierarchicalPlanner::numberNodes()
+{
+    m_nodeCell.clear();
+    m_nodeTile.clear();
+    m_nodeOfCell.clear();
+    m_tileFirstNode.resize(m_tiles.size());
+
+    for (int tile = 0; tile < m_tiles.size(); ++tile) {
+        m_tileFirstNode[tile] = m_nodeCell.size();
+        foreach (int cell, m_tiles[tile].entrances) {
+            m_nodeOfCell.insert(cell, m_nodeCell.size());
+            m_nodeCell.append(cell);
+            m_nodeTile.append(tile);
+        }
+    }
+
+    m_nodesValid = true;
+}
+
+void HierarchicalPlanner::searchTile(int tile, const QVector<int>& seeds, const QVector<float>& seedCosts, bool reverse)
+{
+    const QRect rect = tileRect(tile);
+
+    m_tileCost.fill(s_infinity);
+    m_tileParent.fill(-1);
+    m_tileQueue->reset(m_tileSize * m_tileSize);
+
+    for (int i = 0; i < seeds.size(); ++i) {
+        const int local = localIndex(tile, seeds[i]);
+        if (seedCosts[i] < m_tileCost[local]) {
+            m_tileCost[local] = seedCosts[i];
+            m_tileQueue->push(local, seedCosts[i]);
+        }
+    }
+
+    while (!m_tileQueue->isEmpty()) {
+        const int local = m_tileQueue->pop();
+        const int x = rect.x() + local % m_tileSize;
+        const int y = rect.y() + local / m_tileSize;
+        const float baseCost = reverse ? cellCost(m_map->linearIndex(x, y)) : 0.0f;
+
+        for (int i = 0; i < 8; ++i) {
+            const int ax = x + s_neighbors[i][0];
+            const int ay = y + s_neighbors[i][1];
+            if (!rect.contains(ax, ay))
+                continue;
+
+            // forward: pay for entering the neighbor,
+            // reverse: the neighbor pays for entering this cell
+            const int neighbor = (ay - rect.y()) * m_tileSize + (ax - rect.x());
+            const float factor = i > 3 ? 1.41421356f : 1.0f;
+            const float G = m_tileCost[local]
+                + factor * (reverse ? baseCost : cellCost(m_map->linearIndex(ax, ay)));
+
+            if (G < m_tileCost[neighbor]) {
+                m_tileCost[neighbor] = G;
+                m_tileParent[neighbor] = local;
+                m_tileQueue->push(neighbor, G);
+            }
+        }
+    }
+}
+
+QList<QPoint> HierarchicalPlanner::tilePath(int tile, int from, int to)
+{
+    searchTile(tile, QVector<int>(1, from), QVector<float>(1, 0.0f), false);
+
+    const QRect rect = tileRect(tile);
+    QList<QPoint> cells;
+    for (int local = localIndex(tile, to); local >= 0; local = m_tileParent[local]) {
+        cells.prepend(QPoint(rect.x() + local % m_tileSize, rect.y() + local / m_tileSize));
+    }
+    return cells;
+}
+
+void HierarchicalPlanner::relaxNode(int node, float cost, int parent)
+{
+    if (cost < m_nodeCost[node]) {
+        m_nodeCost[node] = cost;
+        m_nodeParent[node] = parent;
+        m_nodeQueue->push(node, cost);
+    }
+}
+
+void HierarchicalPlanner::searchAbstract(int startTile, const QVector<float>& startCosts, int goalTile,
+                                         const QVector<float>& goalCosts, float directCost)
+{
+    const int nodeCount = m_nodeCell.size();
+    const int startNode = nodeCount;
+    const int goalNode = nodeCount + 1;
+
+    m_nodeCost.fill(s_infinity, nodeCount + 2);
+    m_nodeParent.fill(-1, nodeCount + 2);
+    m_nodeQueue->reset(nodeCount + 2);
+
+    m_nodeCost[startNode] = 0.0f;
+    m_nodeQueue->push(startNode, 0.0f);
+
+    while (!m_nodeQueue->isEmpty()) {
+        const int node = m_nodeQueue->pop();
+        if (node == goalNode)
+            break;
+
+        const float cost = m_nodeCost[node];
+
+        if (node == startNode) {
+            const int first = m_tileFirstNode[startTile];
+            for (int j = 0; j < startCosts.size(); ++j) {
+                relaxNode(first + j, cost + startCosts[j], startNode);
+            }
+            if (directCost >= 0.0f) {
+                relaxNode(goalNode, directCost, startNode);
+            }
+            continue;
+        }
+
+        // entrances of the same tile
+        const int tile = m_nodeTile[node];
+        const Tile& t = m_tiles[tile];
+        const int first = m_tileFirstNode[tile];
+        const int n = t.entrances.size();
+        const int i = node - first;
+        for (int j = 0; j < n; ++j) {
+            if (j != i) {
+                relaxNode(first + j, cost + t.costs[i * n + j], node);
+            }
+        }
+
+        // entrances across the border
+        const int cell = m_nodeCell[node];
+        const int x = cell % m_width;
+        const int y = cell / m_width;
+        for (int d = 0; d < 4; ++d) {
+            const int ax = x + s_neighbors[d][0];
+            const int ay = y + s_neighbors[d][1];
+            if (!m_map->isValidField(ax, ay) || tileOf(ax, ay) == tile)
+                continue;
+
+            const int neighborCell = m_map->linearIndex(ax, ay);
+            QHash<int, int>::const_iterator it = m_nodeOfCell.constFind(neighborCell);
+            if (it != m_nodeOfCell.constEnd()) {
+                relaxNode(it.value(), cost + cellCost(neighborCell), node);
+            }
+        }
+
+        if (tile == goalTile) {
+            relaxNode(goalNode, cost + goalCosts[i], node);
+        }
+    }
+}
+
+QVector<float> HierarchicalPlanner::distances(const QPoint& start, const QList<Cell>& targets)
+{
+    QVector<float> result(targets.size(), -1.0f);
+    if (!m_map || targets.isEmpty())
+        return result;
+
+    update();
+
+    const int startIndex = m_map->linearIndex(start.x(), start.y());
+    const int startTile = tileOf(start.x(), start.y());
+
+    // costs from the start to the entrances of its tile
+    searchTile(startTile, QVector<int>(1, startIndex), QVector<float>(1, 0.0f), false);
+    const QVector<int>& startEntrances = m_tiles[startTile].entrances;
+    QVector<float> startCosts(startEntrances.size());
+    for (int j = 0; j < startEntrances.size(); ++j) {
+        startCosts[j] = m_tileCost[localIndex(startTile, startEntrances[j])];
+    }
+
+    searchAbstract(startTile, startCosts, -1, QVector<float>(), -1.0f);
+
+    // one search per tile with targets, seeded with the costs of its entrances
+    QHash<int, QList<int> > targetsOfTile;
+    for (int k = 0; k < targets.size(); ++k) {
+        const QPoint pt = targets[k].index();
+        targetsOfTile[tileOf(pt.x(), pt.y())].append(k);
+    }
+
+    QHash<int, QList<int> >::const_iterator it = targetsOfTile.constBegin();
+    for (; it != targetsOfTile.constEnd(); ++it) {
+        const int tile = it.key();
+        const int first = m_tileFirstNode[tile];
+
+        QVector<int> seeds;
+        QVector<float> seedCosts;
+        const QVector<int>& entrances = m_tiles[tile].entrances;
+        for (int j = 0; j < entrances.size(); ++j) {
+            if (m_nodeCost[first + j] != s_infinity) {
+                seeds.append(entrances[j]);
+                seedCosts.append(m_nodeCost[first + j]);
+            }
+        }
+        if (tile == startTile) {
+            seeds.append(startIndex);
+            seedCosts.append(0.0f);
+        }
+
+        searchTile(tile, seeds, seedCosts, false);
+
+        foreach (int k, it.value()) {
+            const float cost = m_tileCost[localIndex(tile, targets[k].linearIndex())];
+            result[k] = cost == s_infinity ? -1.0f : cost;
+        }
+    }
+
+    return result;
+}
+
+Path HierarchicalPlanner::path(const QPoint& from, const QPoint& to, int refinedSegments)
+{
+    Path path;
+    if (!m_map)
+        return path;
+
+    update();
+
+    const int fromIndex = m_map->linearIndex(from.x(), from.y());
+    const int toIndex = m_map->linearIndex(to.x(), to.y());
+    const int startTile = tileOf(from.x(), from.y());
+    const int goalTile = tileOf(to.x(), to.y());
+
+    // start tile: costs from the start to the entrances
+    searchTile(startTile, QVector<int>(1, fromIndex), QVector<float>(1, 0.0f), false);
+    const QVector<int>& startEntrances = m_tiles[startTile].entrances;
+    QVector<float> startCosts(startEntrances.size());
+    for (int j = 0; j < startEntrances.size(); ++j) {
+        startCosts[j] = m_tileCost[localIndex(startTile, startEntrances[j])];
+    }
+    const float directCost = startTile == goalTile ? m_tileCost[localIndex(goalTile, toIndex)] : -1.0f;
+
+    // goal tile: costs from the entrances to the goal
+    searchTile(goalTile, QVector<int>(1, toIndex), QVector<float>(1, 0.0f), true);
+    const QVector<int>& goalEntrances = m_tiles[goalTile].entrances;
+    QVector<float> goalCosts(goalEntrances.size());
+    for (int j = 0; j < goalEntrances.size(); ++j) {
+        goalCosts[j] = m_tileCost[localIndex(goalTile, goalEntrances[j])];
+    }
+
+    searchAbstract(startTile, startCosts, goalTile, goalCosts, directCost);
+
+    const int startNode = m_nodeCell.size();
+    const int goalNode = startNode + 1;
+    if (m_nodeCost[goalNode] == s_infinity)
+        return path;
+
+    path.m_cost = m_nodeCost[goalNode];
+
+    // cells along the abstract path
+    QList<int> cells;
+    cells.append(toIndex);
+    for (int node = m_nodeParent[goalNode]; node != startNode; node = m_nodeParent[node]) {
+        cells.prepend(m_nodeCell[node]);
+    }
+    cells.prepend(fromIndex);
+
+    // refine the first segments
+    path.m_path.append(from);
+    int refined = 0;
+    for (int i = 0; i + 1 < cells.size(); ++i) {
+        const int a = cells[i];
+        const int b = cells[i + 1];
+        if (a == b)
+            continue;
+
+        const int tile = tileOf(a % m_width, a / m_width);
+        if (refined < refinedSegments && tile == tileOf(b % m_width, b / m_width)) {
+            const QList<QPoint> segment = tilePath(tile, a, b);
+            for (int j = 1; j < segment.size(); ++j) {
+                path.m_path.append(segment[j]);
+            }
+        } else {
+            path.m_path.append(QPoint(b % m_width, b / m_width));
+        }
+        ++refined;
+    }
+
+    for (int i = 0; i + 1 < path.m_path.size(); ++i) {
+        const QPoint d = path.m_path[i + 1] - path.m_path[i];
+        path.m_length += sqrt((double)(d.x() * d.x() + d.y() * d.y()));
+    }
+    path.m_length *= m_map->resolution();
+
+    return path;
+}
+
+void HierarchicalPlanner::cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState)
+{
+    if (m_resetPending || Cell::cellCost(oldState) == Cell::cellCost(newState))
+        return;
+
+    const QPoint pt = cell.index();
+    const int tile = tileOf(pt.x(), pt.y());
+    markDirty(tile);
+
+    // cells on the tile border also change the entrances of the neighbor tile
+    const QRect rect = tileRect(tile);
+    if (pt.x() == rect.left() && pt.x() > 0)
+        markDirty(tileOf(pt.x() - 1, pt.y()));
+    if (pt.x() == rect.right() && pt.x() + 1 < m_width)
+        markDirty(tileOf(pt.x() + 1, pt.y()));
+    if (pt.y() == rect.top() && pt.y() > 0)
+        markDirty(tileOf(pt.x(), pt.y() - 1));
+    if (pt.y() == rect.bottom() && pt.y() + 1 < m_height)
+        markDirty(tileOf(pt.x(), pt.y() + 1));
+}
+
+void HierarchicalPlanner::mapReset()
+{
+    m_resetPending = true;
+}
+
+void HierarchicalPlanner::mapDestroyed()
+{
+    m_map->removeObserver(this);
+    m_map = 0;
+    m_resetPending = true;
+}
+//END HierarchicalPlanner
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,158 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_HIERARCHICAL_PLANNER_H
+#define DISCOVERAGE_HIERARCHICAL_PLANNER_H
+
+#include "gridmapobserver.h"
+#include "gridmap.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+#include <QtCore/QRect>
+#include <QtCore/QVector>
+
+class PriorityQueue;
+
+/**
+ * Hierarchical path planning (HPA*) for large maps.
+ *
+ * The map is split into square tiles. Along each border between two tiles,
+ * runs of cell pairs with equal cell costs form entrances. The abstract graph
+ * connects the entrance cells across the borders, and all entrances of a
+ * tile with the cost of the cheapest path inside the tile.
+ *
+ * A query searches the start and goal tile at cell level and the rest of
+ * the map on the abstract graph, so long-range queries cost about as much
+ * as the number of tiles on the way. Costs are the ones of
+ * GridMap::frontierPaths(), restricted to paths through the entrances, so
+ * they are upper bounds of the exact costs.
+ *
+ * Tiles with cells whose cost changed through GridMap::setState() are
+ * rebuilt lazily in update(), which is called by all queries.
+ */
+class HierarchicalPlanner : public GridMapObserver
+{
+    public:
+        HierarchicalPlanner(GridMap* map, int tileSize = 16);
+        virtual ~HierarchicalPlanner();
+
+        GridMap* map() const;
+        int tileSize() const;
+
+        // rebuild all tiles that changed since the last call
+        void update();
+
+        // number of tiles rebuilt by the last update()
+        int lastRebuildCount() const;
+
+        // number of entrance cells in the abstract graph
+        int entranceCount() const;
+
+    //
+    // queries
+    //
+    public:
+        // path cost from start to each target, -1 if unreachable
+        QVector<float> distances(const QPoint& start, const QList<Cell>& targets);
+
+        // Path from -> to. The first refinedSegments segments between entrances
+        // contain all cells, the rest of m_path are entrance cells only.
+        // m_cost is the cost of the entire path, m_length the length of m_path.
+        Path path(const QPoint& from, const QPoint& to, int refinedSegments = 1);
+
+    //
+    // GridMapObserver
+    //
+    public:
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState);
+        virtual void mapReset();
+        virtual void mapDestroyed();
+
+    private:
+        struct Tile
+        {
+            QVector<int> entrances;     // linear cell indices
+            QVector<float> costs;       // entrance i to entrance j at i * n + j
+            bool dirty;
+        };
+
+        void rebuild();
+        void markDirty(int tile);
+        void rebuildTile(int tile);
+        void addBorderEntrances(const QPoint& inside, const QPoint& outside,
+                                const QPoint& along, int length, QVector<int>& entrances) const;
+        void numberNodes();
+
+        inline int tileOf(int x, int y) const;
+        inline QRect tileRect(int tile) const;
+        inline int localIndex(int tile, int index) const;
+        inline float cellCost(int index) const;
+
+        // Dijkstra restricted to tile from the seeds, results in m_tileCost
+        // and m_tileParent. Reverse computes costs towards the seeds.
+        void searchTile(int tile, const QVector<int>& seeds, const QVector<float>& seedCosts, bool reverse);
+        QList<QPoint> tilePath(int tile, int from, int to);
+
+        // Dijkstra on the abstract graph from a start node connected to the
+        // entrances of startTile. If goalTile >= 0, the search stops at a goal
+        // node connected to the entrances of goalTile. directCost >= 0
+        // connects start and goal directly.
+        void searchAbstract(int startTile, const QVector<float>& startCosts, int goalTile,
+                            const QVector<float>& goalCosts, float directCost);
+        inline void relaxNode(int node, float cost, int parent);
+
+    private:
+        Q_DISABLE_COPY(HierarchicalPlanner)
+
+        GridMap* m_map;
+        PriorityQueue* m_tileQueue;
+        PriorityQueue* m_nodeQueue;
+        int m_tileSize;
+
+        int m_width;
+        int m_height;
+        int m_tilesX;
+        int m_tilesY;
+        bool m_resetPending;
+        bool m_nodesValid;
+        int m_lastRebuildCount;
+
+        QVector<Tile> m_tiles;
+        QList<int> m_dirtyTiles;
+
+        // abstract graph, numbered by numberNodes()
+        QVector<int> m_nodeCell;
+        QVector<int> m_nodeTile;
+        QVector<int> m_tileFirstNode;
+        QHash<int, int> m_nodeOfCell;
+
+        // scratch data of searchTile()
+        QVector<float> m_tileCost;
+        QVector<int> m_tileParent;
+
+        // scratch data of searchAbstract(), start node = n, goal node = n + 1
+        QVector<float> m_nodeCost;
+        QVector<int> m_nodeParent;
+};
+
+#endif // DISCOVERAGE_HIERARCHICAL_PLANNER_H
+
+// kate: replace-tabs on; indent-width 4;
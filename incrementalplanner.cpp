@@ -0,0 +1,407 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "incrementalplanner.h"
+#include "priorityqueue.h"
+
+#include <limits>
+#include <math.h>
+
+// same order as the first 8 entries of the direction map of the GridMap:
+// 4 orthogonal neighbors, then 4 diagonal neighbors
+static const int s_neighbors[8][2] = {
+    {  0, -1},  // top
+    {  1,  0},  // right
+    {  0,  1},  // bottom
+    { -1,  0},  // left
+    {  1, -1},  // top right
+    {  1,  1},  // bottom right
+    { -1,  1},  // bottom left
+    { -1, -1}   // top left
+};
+
+static const float s_infinity = std::numeric_limits<float>::infinity();
+
+//BEGIN IncrementalPlanner
+IncrementalPlanner::IncrementalPlanner(GridMap* map, Direction direction)
+    : m_map(map)
+    , m_direction(direction)
+    , m_queue(PriorityQueue::create(PriorityQueue::IndexedHeap)) // keys are not monotone across updates
+    , m_width(0)
+    , m_height(0)
+    , m_resetPending(true)
+    , m_lastUpdateCount(0)
+    , m_revision(0)
+{
+    m_map->addObserver(this);
+}
+
+IncrementalPlanner::~IncrementalPlanner()
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+    delete m_queue;
+}
+
+GridMap* IncrementalPlanner::map() const
+{
+    return m_map;
+}
+
+IncrementalPlanner::Direction IncrementalPlanner::direction() const
+{
+    return m_direction;
+}
+
+void IncrementalPlanner::setSources(const QList<Cell>& sources)
+{
+    QList<int> indices;
+    foreach (const Cell& cell, sources) {
+        indices.append(cell.linearIndex());
+    }
+
+    if (indices == m_sources) {
+        return;
+    }
+
+    if (!m_resetPending) {
+        // old and new sources need a new rhs value
+        foreach (int index, m_sources) {
+            m_isSource[index] = false;
+            markDirty(index);
+        }
+        foreach (int index, indices) {
+            m_isSource[index] = true;
+            markDirty(index);
+        }
+    }
+
+    m_sources = indices;
+}
+
+void IncrementalPlanner::setSource(const QPoint& cellIndex)
+{
+    setSources(QList<Cell>() << m_map->cell(cellIndex));
+}
+
+int IncrementalPlanner::lastUpdateCount() const
+{
+    return m_lastUpdateCount;
+}
+
+void IncrementalPlanner::update()
+{
+    Q_ASSERT(m_map);
+
+    m_lastUpdateCount = 0;
+
+    if (m_resetPending) {
+        rebuild();
+    } else if (m_dirty.isEmpty()) {
+        return;
+    }
+
+    foreach (int index, m_dirty) {
+        m_isDirty[index] = false;
+
+        // FromSources: the cost to enter a cell changes the rhs of the cell itself.
+        // ToSources:   the cost to leave a cell changes the rhs of its neighbors.
+        updateRhs(index);
+        updateQueue(index);
+
+        if (m_direction == ToSources) {
+            const int x = index % m_width;
+            const int y = index / m_width;
+            for (int i = 0; i < 8; ++i) {
+                const int ax = x + s_neighbors[i][0];
+                const int ay = y + s_neighbors[i][1];
+                if (!m_map->isValidField(ax, ay))
+                    continue;
+
+                const int neighbor = m_map->linearIndex(ax, ay);
+                updateRhs(neighbor);
+                updateQueue(neighbor);
+            }
+        }
+    }
+    m_dirty.clear();
+
+    computeShortestPaths();
+
+    // invalidates all cached waypoints
+    ++m_revision;
+}
+
+void IncrementalPlanner::rebuild()
+{
+    m_width = m_map->size().width();
+    m_height = m_map->size().height();
+    const int cellCount = m_width * m_height;
+
+    m_g.fill(s_infinity, cellCount);
+    m_rhs.fill(s_infinity, cellCount);
+    m_parent.fill(-1, cellCount);
+    m_isSource.fill(false, cellCount);
+    m_isDirty.fill(false, cellCount);
+    m_waypoint.fill(-1, cellCount);
+    m_waypointRevision.fill(0, cellCount);
+    m_queue->reset(cellCount);
+    m_dirty.clear();
+
+    // sources of a different map size are meaningless
+    QList<int> sources;
+    foreach (int index, m_sources) {
+        if (index < cellCount) {
+            sources.append(index);
+        }
+    }
+    m_sources = sources;
+
+    foreach (int index, m_sources) {
+        m_isSource[index] = true;
+        markDirty(index);
+    }
+
+    m_resetPending = false;
+}
+
+void IncrementalPlanner::markDirty(int index)
+{
+    if (!m_isDirty[index]) {
+        m_isDirty[index] = true;
+        m_dirty.append(index);
+    }
+}
+
+float IncrementalPlanner::edgeCost(int from, int to, int direction) const
+{
+    // the path pays for every cell it enters. In ToSources mode, the path runs
+    // against the edge direction and enters 'from'.
+    const int entered = m_direction == FromSources ? to : from;
+    const float factor = direction > 3 ? 1.41421356f : 1.0f;
+    return factor * Cell(m_map, entered).cellCost();
+}
+
+void IncrementalPlanner::updateRhs(int index)
+{
+    if (m_isSource[index]) {
+        m_rhs[index] = 0;
+        m_parent[index] = -1;
+        return;
+    }
+
+    const int x = index % m_width;
+    const int y = index / m_width;
+
+    float rhs = s_infinity;
+    int parent = -1;
+    for (int i = 0; i < 8; ++i) {
+        // previous cell on the path
+        const int px = x - s_neighbors[i][0];
+        const int py = y - s_neighbors[i][1];
+        if (!m_map->isValidField(px, py))
+            continue;
+
+        const int prev = m_map->linearIndex(px, py);
+        if (m_g[prev] == s_infinity)
+            continue;
+
+        const float cost = m_g[prev] + edgeCost(prev, index, i);
+        if (cost < rhs) {
+            rhs = cost;
+            parent = i;
+        }
+    }
+
+    m_rhs[index] = rhs;
+    m_parent[index] = parent;
+}
+
+void IncrementalPlanner::updateQueue(int index)
+{
+    if (m_g[index] != m_rhs[index]) {
+        m_queue->push(index, qMin(m_g[index], m_rhs[index]));
+    } else {
+        m_queue->remove(index);
+    }
+}
+
+void IncrementalPlanner::computeShortestPaths()
+{
+    while (!m_queue->isEmpty()) {
+        const int index = m_queue->pop();
+        ++m_lastUpdateCount;
+
+        const int x = index % m_width;
+        const int y = index / m_width;
+
+        if (m_g[index] > m_rhs[index]) {
+            // overconsistent: the cost decreased, propagate to the neighbors
+            m_g[index] = m_rhs[index];
+
+            for (int i = 0; i < 8; ++i) {
+                const int ax = x + s_neighbors[i][0];
+                const int ay = y + s_neighbors[i][1];
+                if (!m_map->isValidField(ax, ay))
+                    continue;
+
+                const int neighbor = m_map->linearIndex(ax, ay);
+                if (m_isSource[neighbor])
+                    continue;
+
+                const float cost = m_g[index] + edgeCost(index, neighbor, i);
+                if (cost < m_rhs[neighbor]) {
+                    m_rhs[neighbor] = cost;
+                    m_parent[neighbor] = i;
+                    updateQueue(neighbor);
+                }
+            }
+        } else {
+            // underconsistent: the cost increased, all cells whose path runs
+            // through this cell need a new rhs value
+            m_g[index] = s_infinity;
+            updateRhs(index);
+            updateQueue(index);
+
+            for (int i = 0; i < 8; ++i) {
+                const int ax = x + s_neighbors[i][0];
+                const int ay = y + s_neighbors[i][1];
+                if (!m_map->isValidField(ax, ay))
+                    continue;
+
+                const int neighbor = m_map->linearIndex(ax, ay);
+                if (m_parent[neighbor] == i) {
+                    updateRhs(neighbor);
+                    updateQueue(neighbor);
+                }
+            }
+        }
+    }
+}
+
+float IncrementalPlanner::distance(const QPoint& cellIndex) const
+{
+    const float g = m_g[m_map->linearIndex(cellIndex.x(), cellIndex.y())];
+    return g == s_infinity ? -1.0f : g;
+}
+
+QPoint IncrementalPlanner::nextStep(const QPoint& cellIndex) const
+{
+    const int index = m_map->linearIndex(cellIndex.x(), cellIndex.y());
+    const int parent = m_parent[index];
+    if (parent < 0 || m_g[index] == s_infinity) {
+        return cellIndex;
+    }
+    return QPoint(cellIndex.x() - s_neighbors[parent][0], cellIndex.y() - s_neighbors[parent][1]);
+}
+
+Path IncrementalPlanner::path(const QPoint& cellIndex) const
+{
+    Path path;
+    if (distance(cellIndex) < 0) {
+        return path;
+    }
+
+    // same cost and length accounting as GridMap::frontierPaths()
+    QPoint pt(cellIndex);
+    while (true) {
+        if (m_direction == FromSources) {
+            path.m_path.prepend(pt);
+        } else {
+            path.m_path.append(pt);
+        }
+
+        const int parent = m_parent[m_map->linearIndex(pt.x(), pt.y())];
+        if (parent < 0)
+            break;
+
+        const QPoint prev(pt.x() - s_neighbors[parent][0], pt.y() - s_neighbors[parent][1]);
+        const QPoint entered = m_direction == FromSources ? pt : prev;
+        path.m_cost += m_map->cell(entered).cellCost();
+        path.m_length += parent < 4 ? 1.0f : 1.41421356f;
+        pt = prev;
+    }
+    path.m_length *= m_map->resolution();
+
+    return path;
+}
+
+QPoint IncrementalPlanner::waypoint(const QPoint& cellIndex)
+{
+    const int index = m_map->linearIndex(cellIndex.x(), cellIndex.y());
+    if (m_waypointRevision[index] == m_revision && m_waypoint[index] >= 0) {
+        return QPoint(m_waypoint[index] % m_width, m_waypoint[index] / m_width);
+    }
+
+    // follow the tree towards the source
+    QVector<QPoint> path;
+    path.append(cellIndex);
+    while (true) {
+        const QPoint next = nextStep(path.last());
+        if (next == path.last())
+            break;
+        path.append(next);
+    }
+
+    // binary search for the furthest visible path cell, like Path::beautify()
+    int visible = qMin(1, path.size() - 1);
+    int end = path.size() - 1;
+    if (end > visible && !m_map->aaPathVisible(path[0], path[end])) {
+        while (end - visible > 1) {
+            const int mid = (visible + end) / 2;
+            if (m_map->aaPathVisible(path[0], path[mid])) {
+                visible = mid;
+            } else {
+                end = mid;
+            }
+        }
+    } else {
+        visible = end;
+    }
+
+    m_waypoint[index] = m_map->linearIndex(path[visible].x(), path[visible].y());
+    m_waypointRevision[index] = m_revision;
+    return path[visible];
+}
+
+void IncrementalPlanner::cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState)
+{
+    if (m_resetPending)
+        return;
+
+    if (Cell::cellCost(oldState) != Cell::cellCost(newState)) {
+        markDirty(cell.linearIndex());
+    }
+}
+
+void IncrementalPlanner::mapReset()
+{
+    m_resetPending = true;
+}
+
+void IncrementalPlanner::mapDestroyed()
+{
+    m_map->removeObserver(this);
+    m_map = 0;
+    m_resetPending = true;
+}
+//END IncrementalPlanner
+
+// kate: replace-tabs on; indent-width 4;
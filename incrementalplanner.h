@@ -0,0 +1,136 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_INCREMENTAL_PLANNER_H
+#define DISCOVERAGE_INCREMENTAL_PLANNER_H
+
+#include "gridmapobserver.h"
+#include "gridmap.h"
+
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+#include <QtCore/QVector>
+
+class PriorityQueue;
+
+/**
+ * Shortest path tree over the GridMap that is kept across ticks (LPA* without
+ * heuristic, i.e. an incremental Dijkstra over the entire map).
+ *
+ * The tree is rooted at a set of source cells. The planner observes the map,
+ * cell cost changes reported by GridMap::setState() and changes of the source
+ * set are collected and repaired in update(). Only cells whose path cost
+ * actually changes are touched, so an update after exploring a few cells is
+ * much cheaper than a new search.
+ *
+ * The path costs are the ones of GridMap::frontierPaths() and GridMap::aStar():
+ * - FromSources: cost of the path from the nearest source to a cell, e.g. with
+ *                the robot cell as single source, path() equals frontierPaths().
+ * - ToSources:   cost of the path from a cell to the nearest source, e.g. with
+ *                the frontiers as sources, this equals computeFrontierField().
+ *
+ * Moving a source (e.g. the robot position in FromSources mode) changes most
+ * of the tree, so sources should be the cells that rarely move.
+ */
+class IncrementalPlanner : public GridMapObserver
+{
+    public:
+        enum Direction {
+            FromSources = 0,
+            ToSources
+        };
+
+        IncrementalPlanner(GridMap* map, Direction direction);
+        virtual ~IncrementalPlanner();
+
+        GridMap* map() const;
+        Direction direction() const;
+
+        void setSources(const QList<Cell>& sources);
+        void setSource(const QPoint& cellIndex);
+
+        // repair the tree for all changes since the last call
+        void update();
+
+        // number of cells processed by the last update()
+        int lastUpdateCount() const;
+
+    //
+    // queries, only valid after update()
+    //
+    public:
+        // path cost from/to the nearest source, -1 if unreachable
+        float distance(const QPoint& cellIndex) const;
+
+        // neighbor towards the nearest source, cellIndex itself for sources
+        // and unreachable cells
+        QPoint nextStep(const QPoint& cellIndex) const;
+
+        // path from the nearest source to cellIndex (FromSources) or from
+        // cellIndex to the nearest source (ToSources)
+        Path path(const QPoint& cellIndex) const;
+
+        // furthest cell towards the nearest source still visible from cellIndex
+        QPoint waypoint(const QPoint& cellIndex);
+
+    //
+    // GridMapObserver
+    //
+    public:
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState);
+        virtual void mapReset();
+        virtual void mapDestroyed();
+
+    private:
+        void rebuild();
+        void markDirty(int index);
+        void updateRhs(int index);
+        void updateQueue(int index);
+        void computeShortestPaths();
+
+        inline float edgeCost(int from, int to, int direction) const;
+
+    private:
+        Q_DISABLE_COPY(IncrementalPlanner)
+
+        GridMap* m_map;
+        Direction m_direction;
+        PriorityQueue* m_queue;
+
+        int m_width;
+        int m_height;
+        bool m_resetPending;
+        int m_lastUpdateCount;
+        quint32 m_revision;
+
+        QList<int> m_sources;
+        QList<int> m_dirty;
+
+        QVector<float> m_g;
+        QVector<float> m_rhs;
+        QVector<qint8> m_parent;        // direction from the previous cell on the path, -1 for none
+        QVector<bool> m_isSource;
+        QVector<bool> m_isDirty;
+        QVector<int> m_waypoint;
+        QVector<quint32> m_waypointRevision;
+};
+
+#endif // DISCOVERAGE_INCREMENTAL_PLANNER_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -25,6 +25,7 @@
 #include "robotmanager.h"
 #include "robotlistview.h"
 #include "tikzexport.h"
+#include "strategy.h"
 
 #include <QDebug>
 #include <QtGui/QLabel>
@@ -41,9 +42,6 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
 {
     setupUi(this);
 
-    // instantiate singleton
-    new RobotManager(this);
-
     QWidget* toolsWidget = new QWidget();
     m_toolsUi = new Ui::ToolWidget();
     m_toolsUi->setupUi(toolsWidget);
@@ -80,7 +78,7 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
     scrollArea->setWidget(m_scene);
     scrollArea->installEventFilter(this);
 
-    m_robotListView = new RobotListView(this);
+    m_robotListView = new RobotListView(&m_scene->context().robotManager(), this);
     dwRobotManager->setWidget(m_robotListView);
 
 
@@ -261,7 +259,7 @@ void MainWindow::exportToTikz()
         QTextStream ts(&file);
         QTikzPicture tikzPicture;
         tikzPicture.setStream(&ts);
-        m_scene->map().exportLegend(tikzPicture);
+        m_scene->mapView().exportLegend(tikzPicture);
     }
 
     file.close();
@@ -270,7 +268,9 @@ void MainWindow::exportToTikz()
         QTextStream ts(&file);
         ts.setRealNumberPrecision(2);
         ts.setRealNumberNotation(QTextStream::FixedNotation);
-        m_scene->toolHandler()->exportObjectiveFunction(ts);
+        if (Strategy* strategy = m_scene->context().strategy()) {
+            strategy->exportObjectiveFunction(ts);
+        }
     }
 }
 
@@ -0,0 +1,47 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "momenttable.h"
+#include "gridmap.h"
+
+MomentTable::MomentTable()
+    : m_map(0)
+    , m_revision(0)
+    , m_partitionRevision(0)
+    , m_width(0)
+    , m_height(0)
+{
+}
+
+bool MomentTable::isUpToDate(const GridMap& map) const
+{
+    return m_map == &map
+        && m_revision == map.revision()
+        && m_width == map.size().width()
+        && m_height == map.size().height();
+}
+
+bool MomentTable::regionsUpToDate(const GridMap& map) const
+{
+    return isUpToDate(map)
+        && m_partitionRevision == map.partitionRevision();
+}
+
+// kate: replace-tabs on; indent-width 4;
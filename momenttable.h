@@ -0,0 +1,145 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_MOMENT_TABLE_H
+#define DISCOVERAGE_MOMENT_TABLE_H
+
+#include <QtCore/QPointF>
+#include <QtCore/QRect>
+#include <QtCore/QVector>
+
+class GridMap;
+
+/**
+ * Zeroth and first moment of the density over a set of cells: the total
+ * density and the density weighted sum of the cell centers.
+ */
+struct DensityMoments
+{
+    DensityMoments()
+        : mass(0.0), x(0.0), y(0.0)
+    {}
+
+    inline void add(const QPointF& center, double density)
+    {
+        mass += density;
+        x += density * center.x();
+        y += density * center.y();
+    }
+
+    inline DensityMoments& operator+=(const DensityMoments& other)
+    {
+        mass += other.mass;
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    double mass;    // sum of density
+    double x;       // sum of density * center.x
+    double y;       // sum of density * center.y
+};
+
+/**
+ * Summed-area tables of the density moments of the GridMap, filled by
+ * GridMap::updateDensity(). Explored obstacles have no density, as they are
+ * never part of the visible cells.
+ *
+ * The moments of a rectangle of cells are available in O(1). Additionally,
+ * the table counts the obstacles that may block the view, so that callers
+ * can check whether a rectangle is free of occlusion, and it keeps the
+ * moments of each Voronoi cell.
+ *
+ * The table only stays valid as long as the map does not change, see
+ * isUpToDate(). The moments of the Voronoi cells additionally depend on the
+ * partition, see regionsUpToDate().
+ */
+class MomentTable
+{
+    friend class GridMap;
+
+    public:
+        MomentTable();
+
+        // true, if filled for the current state of map
+        bool isUpToDate(const GridMap& map) const;
+
+        // true, if region() also matches the current partition of map
+        bool regionsUpToDate(const GridMap& map) const;
+
+        // moments of the cells in rect, which must be inside the map
+        inline DensityMoments moments(const QRect& rect) const;
+
+        // true, if an obstacle inside rect may block the view
+        inline bool hasOccluders(const QRect& rect) const;
+
+        // moments of all cells assigned to the robot with this map id
+        inline DensityMoments region(int robotId) const
+        { return robotId < m_regions.size() ? m_regions[robotId] : DensityMoments(); }
+
+    private:
+        template <typename T>
+        inline T rectSum(const QVector<T>& table, const QRect& rect) const;
+
+    private:
+        const GridMap* m_map;
+        quint32 m_revision;
+        quint32 m_partitionRevision;
+        int m_width;
+        int m_height;
+
+        // (width + 1) x (height + 1) entries, entry (x, y) holds the sum over
+        // all cells left of x and above y
+        QVector<double> m_mass;
+        QVector<double> m_x;
+        QVector<double> m_y;
+        QVector<int> m_occluders;
+
+        QVector<DensityMoments> m_regions;  // indexed by robot map id
+};
+
+template <typename T>
+T MomentTable::rectSum(const QVector<T>& table, const QRect& rect) const
+{
+    const int stride = m_width + 1;
+    const int top = rect.top() * stride;
+    const int bottom = (rect.bottom() + 1) * stride;
+    const int left = rect.left();
+    const int right = rect.right() + 1;
+    return table[bottom + right] - table[bottom + left] - table[top + right] + table[top + left];
+}
+
+DensityMoments MomentTable::moments(const QRect& rect) const
+{
+    DensityMoments result;
+    result.mass = rectSum(m_mass, rect);
+    result.x = rectSum(m_x, rect);
+    result.y = rectSum(m_y, rect);
+    return result;
+}
+
+bool MomentTable::hasOccluders(const QRect& rect) const
+{
+    return rectSum(m_occluders, rect) > 0;
+}
+
+#endif // DISCOVERAGE_MOMENT_TABLE_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,159 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "orientationobjective.h"
+
+#include <math.h>
+
+OrientationObjective::OrientationObjective(int binCount)
+    : m_binCount(binCount)
+    , m_binWidth(2.0 * M_PI / binCount)
+    , m_theta(-1.0)
+{
+    Q_ASSERT(binCount > 0 && (binCount & (binCount - 1)) == 0);
+
+    m_histogram.fill(0.0, m_binCount);
+    m_objective.fill(0.0, m_binCount);
+}
+
+void OrientationObjective::clear()
+{
+    m_histogram.fill(0.0, m_binCount);
+    m_objective.fill(0.0, m_binCount);
+}
+
+void OrientationObjective::addDirection(double angle, double weight)
+{
+    // bin i is centered at -pi + i * binWidth, split the weight linearly
+    const double t = (angle + M_PI) / m_binWidth;
+    const double bin = floor(t);
+    const double frac = t - bin;
+
+    int i = static_cast<int>(bin) % m_binCount;
+    if (i < 0)
+        i += m_binCount;
+
+    m_histogram[i] += (1.0 - frac) * weight;
+    m_histogram[(i + 1) % m_binCount] += frac * weight;
+}
+
+void OrientationObjective::update(double theta)
+{
+    const int n = m_binCount;
+
+    if (theta != m_theta) {
+        // Gaussian over the wrapped bin offsets. Its spectrum is real, since
+        // the offsets m and n - m have the same weight.
+        QVector<double> re(n);
+        QVector<double> im(n, 0.0);
+        for (int m = 0; m < n; ++m) {
+            double alpha = m * m_binWidth;
+            if (alpha > M_PI)
+                alpha -= 2.0 * M_PI;
+            re[m] = theta > 0.0 ? exp(-alpha * alpha / (2.0 * theta * theta)) : (m == 0 ? 1.0 : 0.0);
+        }
+        fft(re, im, false);
+
+        m_kernel = re;
+        m_theta = theta;
+    }
+
+    QVector<double> re(m_histogram);
+    QVector<double> im(n, 0.0);
+    fft(re, im, false);
+    for (int k = 0; k < n; ++k) {
+        re[k] *= m_kernel[k];
+        im[k] *= m_kernel[k];
+    }
+    fft(re, im, true);
+
+    for (int i = 0; i < n; ++i) {
+        // the inverse transform is not normalized, clip round-off below zero
+        m_objective[i] = qMax(0.0, re[i] / n);
+    }
+}
+
+double OrientationObjective::value(double delta) const
+{
+    const double t = (delta + M_PI) / m_binWidth;
+    const double bin = floor(t);
+    const double frac = t - bin;
+
+    int i = static_cast<int>(bin) % m_binCount;
+    if (i < 0)
+        i += m_binCount;
+
+    return (1.0 - frac) * m_objective[i] + frac * m_objective[(i + 1) % m_binCount];
+}
+
+QVector<QPointF> OrientationObjective::curve(double step) const
+{
+    QVector<QPointF> points;
+    double delta = -M_PI;
+    while (delta < M_PI) {
+        points.append(QPointF(delta, value(delta)));
+        delta += step;
+    }
+    return points;
+}
+
+void OrientationObjective::fft(QVector<double>& re, QVector<double>& im, bool inverse)
+{
+    const int n = re.size();
+
+    // bit reversal permutation
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            qSwap(re[i], re[j]);
+            qSwap(im[i], im[j]);
+        }
+    }
+
+    for (int length = 2; length <= n; length <<= 1) {
+        const double angle = (inverse ? 2.0 : -2.0) * M_PI / length;
+        const double wRe = cos(angle);
+        const double wIm = sin(angle);
+        for (int i = 0; i < n; i += length) {
+            double uRe = 1.0;
+            double uIm = 0.0;
+            for (int j = 0; j < length / 2; ++j) {
+                const int a = i + j;
+                const int b = a + length / 2;
+                const double vRe = re[b] * uRe - im[b] * uIm;
+                const double vIm = re[b] * uIm + im[b] * uRe;
+                re[b] = re[a] - vRe;
+                im[b] = im[a] - vIm;
+                re[a] += vRe;
+                im[a] += vIm;
+
+                const double nextRe = uRe * wRe - uIm * wIm;
+                uIm = uRe * wIm + uIm * wRe;
+                uRe = nextRe;
+            }
+        }
+    }
+}
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,79 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_ORIENTATION_OBJECTIVE_H
+#define DISCOVERAGE_ORIENTATION_OBJECTIVE_H
+
+#include <QtCore/QPointF>
+#include <QtCore/QVector>
+
+/**
+ * DisCoverage objective as a function of the start orientation delta:
+ *
+ *   f(delta) = sum_i w_i * exp(-(angle_i - delta)^2 / (2 theta^2))
+ *
+ * with the angle difference wrapped to [-pi, pi].
+ *
+ * Instead of evaluating all terms for each orientation, the weights are
+ * binned by angle into a circular histogram, which is convolved with the
+ * Gaussian of the opening angle theta by FFT. Adding the directions costs
+ * O(F), update() O(K log K) for K bins, and afterwards value() interpolates
+ * the objective at any orientation in O(1).
+ */
+class OrientationObjective
+{
+    public:
+        // binCount must be a power of two
+        explicit OrientationObjective(int binCount = 512);
+
+        // remove all directions
+        void clear();
+
+        // add a direction with angle in radians
+        void addDirection(double angle, double weight);
+
+        // convolve the directions with the Gaussian of the opening angle,
+        // required after adding directions
+        void update(double theta);
+
+        // objective at the start orientation delta
+        double value(double delta) const;
+
+        // (delta, value) for delta = -pi, -pi + step, ... < pi
+        QVector<QPointF> curve(double step) const;
+
+    private:
+        // in-place radix-2 transform, not normalized
+        static void fft(QVector<double>& re, QVector<double>& im, bool inverse);
+
+    private:
+        int m_binCount;
+        double m_binWidth;
+        QVector<double> m_histogram;
+        QVector<double> m_objective;
+
+        // spectrum of the Gaussian, real as the Gaussian is symmetric
+        double m_theta;
+        QVector<double> m_kernel;
+};
+
+#endif // DISCOVERAGE_ORIENTATION_OBJECTIVE_H
+
+// kate: replace-tabs on; indent-width 4;
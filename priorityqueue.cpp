@@ -0,0 +1,434 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "priorityqueue.h"
+
+#include <set>
+
+//BEGIN MultisetQueue
+class MultisetQueue : public PriorityQueue
+{
+    struct Entry
+    {
+        Entry(int index, float key) : index(index), key(key) {}
+
+        inline friend bool operator < (const Entry& lhs, const Entry& rhs)
+        {
+            return lhs.key < rhs.key;
+        }
+
+        int index;
+        float key;
+    };
+
+    public:
+        virtual Type type() const
+        {
+            return Multiset;
+        }
+
+        virtual void reset(int cellCount)
+        {
+            if (m_key.size() != cellCount) {
+                m_key = QVector<float>(cellCount, 0.0f);
+                m_queued = QVector<bool>(cellCount, false);
+            } else {
+                for (std::multiset<Entry>::const_iterator it = m_set.begin(); it != m_set.end(); ++it) {
+                    m_queued[it->index] = false;
+                }
+            }
+            m_set.clear();
+        }
+
+        virtual bool isEmpty() const
+        {
+            return m_set.empty();
+        }
+
+        virtual void push(int index, float key)
+        {
+            remove(index);
+
+            m_key[index] = key;
+            m_queued[index] = true;
+            m_set.insert(Entry(index, key));
+        }
+
+        virtual int pop()
+        {
+            const int index = m_set.begin()->index;
+            m_set.erase(m_set.begin());
+            m_queued[index] = false;
+            return index;
+        }
+
+        virtual void remove(int index)
+        {
+            if (!m_queued[index])
+                return;
+
+            // there can be several entries with the same key,
+            // we need to search the right one
+            std::multiset<Entry>::iterator it = m_set.find(Entry(index, m_key[index]));
+            while (it != m_set.end() && it->index != index) {
+                ++it;
+            }
+            if (it != m_set.end()) {
+                m_set.erase(it);
+            }
+            m_queued[index] = false;
+        }
+
+    private:
+        std::multiset<Entry> m_set;
+        QVector<float> m_key;
+        QVector<bool> m_queued;
+};
+//END MultisetQueue
+
+//BEGIN IndexedHeapQueue
+class IndexedHeapQueue : public PriorityQueue
+{
+    static const int Arity = 4;
+
+    struct Entry
+    {
+        int index;
+        float key;
+    };
+
+    public:
+        virtual Type type() const
+        {
+            return IndexedHeap;
+        }
+
+        virtual void reset(int cellCount)
+        {
+            if (m_pos.size() != cellCount) {
+                m_pos = QVector<int>(cellCount, -1);
+            } else {
+                for (int i = 0; i < m_heap.size(); ++i) {
+                    m_pos[m_heap[i].index] = -1;
+                }
+            }
+            m_heap.clear();
+        }
+
+        virtual bool isEmpty() const
+        {
+            return m_heap.isEmpty();
+        }
+
+        virtual void push(int index, float key)
+        {
+            int pos = m_pos[index];
+            if (pos < 0) {
+                Entry e;
+                e.index = index;
+                e.key = key;
+                m_heap.append(e);
+                pos = m_heap.size() - 1;
+                m_pos[index] = pos;
+                siftUp(pos);
+            } else if (key < m_heap[pos].key) {
+                m_heap[pos].key = key;
+                siftUp(pos);
+            } else {
+                m_heap[pos].key = key;
+                siftDown(pos);
+            }
+        }
+
+        virtual int pop()
+        {
+            const int index = m_heap[0].index;
+            m_pos[index] = -1;
+
+            const Entry last = m_heap.last();
+            m_heap.pop_back();
+            if (!m_heap.isEmpty()) {
+                m_heap[0] = last;
+                m_pos[last.index] = 0;
+                siftDown(0);
+            }
+            return index;
+        }
+
+        virtual void remove(int index)
+        {
+            const int pos = m_pos[index];
+            if (pos < 0)
+                return;
+            m_pos[index] = -1;
+
+            // move last entry into the gap
+            const Entry last = m_heap.last();
+            m_heap.pop_back();
+            if (pos < m_heap.size()) {
+                m_heap[pos] = last;
+                m_pos[last.index] = pos;
+                siftUp(pos);
+                siftDown(m_pos[last.index]);
+            }
+        }
+
+    private:
+        void siftUp(int pos)
+        {
+            const Entry e = m_heap[pos];
+            while (pos > 0) {
+                const int parent = (pos - 1) / Arity;
+                if (!(e.key < m_heap[parent].key))
+                    break;
+                m_heap[pos] = m_heap[parent];
+                m_pos[m_heap[pos].index] = pos;
+                pos = parent;
+            }
+            m_heap[pos] = e;
+            m_pos[e.index] = pos;
+        }
+
+        void siftDown(int pos)
+        {
+            const Entry e = m_heap[pos];
+            const int size = m_heap.size();
+            while (true) {
+                const int first = Arity * pos + 1;
+                if (first >= size)
+                    break;
+
+                // find smallest child
+                int child = first;
+                const int end = qMin(first + Arity, size);
+                for (int c = first + 1; c < end; ++c) {
+                    if (m_heap[c].key < m_heap[child].key)
+                        child = c;
+                }
+
+                if (!(m_heap[child].key < e.key))
+                    break;
+
+                m_heap[pos] = m_heap[child];
+                m_pos[m_heap[pos].index] = pos;
+                pos = child;
+            }
+            m_heap[pos] = e;
+            m_pos[e.index] = pos;
+        }
+
+    private:
+        QVector<Entry> m_heap;
+        QVector<int> m_pos;     // position in m_heap, -1 if not queued
+};
+//END IndexedHeapQueue
+
+//BEGIN RadixBucketQueue
+static inline int highestBit(quint64 value)
+{
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = -1;
+    while (value) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+class RadixBucketQueue : public PriorityQueue
+{
+    static const int BucketCount = 65;
+
+    struct Entry
+    {
+        int index;
+        float key;
+    };
+
+    public:
+        RadixBucketQueue()
+            : m_last(0)
+            , m_size(0)
+        {
+        }
+
+        virtual Type type() const
+        {
+            return RadixBucket;
+        }
+
+        virtual void reset(int cellCount)
+        {
+            if (m_key.size() != cellCount) {
+                m_key = QVector<float>(cellCount, 0.0f);
+                m_queued = QVector<bool>(cellCount, false);
+            } else {
+                for (int b = 0; b < BucketCount; ++b) {
+                    foreach (const Entry& e, m_buckets[b]) {
+                        m_queued[e.index] = false;
+                    }
+                }
+            }
+
+            for (int b = 0; b < BucketCount; ++b) {
+                m_buckets[b].clear();
+            }
+            m_last = 0;
+            m_size = 0;
+        }
+
+        virtual bool isEmpty() const
+        {
+            return m_size == 0;
+        }
+
+        virtual void push(int index, float key)
+        {
+            // entries with an outdated key stay in the buckets and are
+            // skipped in pop(), so a key change is a plain insert
+            if (!m_queued[index]) {
+                m_queued[index] = true;
+                ++m_size;
+            }
+            m_key[index] = key;
+
+            Entry e;
+            e.index = index;
+            e.key = key;
+            m_buckets[bucket(quantize(key))].append(e);
+        }
+
+        virtual int pop()
+        {
+            while (true) {
+                if (m_buckets[0].isEmpty()) {
+                    refill();
+                }
+
+                const Entry e = m_buckets[0].last();
+                m_buckets[0].pop_back();
+
+                // skip outdated entries
+                if (!m_queued[e.index] || e.key != m_key[e.index])
+                    continue;
+
+                m_queued[e.index] = false;
+                --m_size;
+                return e.index;
+            }
+        }
+
+        virtual void remove(int index)
+        {
+            // the entry stays in its bucket and is skipped in pop()
+            if (m_queued[index]) {
+                m_queued[index] = false;
+                --m_size;
+            }
+        }
+
+    private:
+        inline quint64 quantize(float key) const
+        {
+            // the queue is monotone: keys smaller than the last
+            // extracted key are treated as equal to it
+            const quint64 q = key > 0.0f ? static_cast<quint64>(key) : 0;
+            return q < m_last ? m_last : q;
+        }
+
+        inline int bucket(quint64 q) const
+        {
+            return q == m_last ? 0 : highestBit(q ^ m_last) + 1;
+        }
+
+        void refill()
+        {
+            int b = 1;
+            while (m_buckets[b].isEmpty()) {
+                ++b;
+            }
+
+            // the new minimum is the smallest key of the first non-empty bucket
+            QVector<Entry> entries;
+            qSwap(entries, m_buckets[b]);
+
+            quint64 minKey = quantize(entries[0].key);
+            for (int i = 1; i < entries.size(); ++i) {
+                minKey = qMin(minKey, quantize(entries[i].key));
+            }
+            m_last = minKey;
+
+            // redistribute, all entries move to lower buckets
+            for (int i = 0; i < entries.size(); ++i) {
+                const Entry& e = entries[i];
+                m_buckets[bucket(quantize(e.key))].append(e);
+            }
+        }
+
+    private:
+        QVector<Entry> m_buckets[BucketCount];
+        QVector<float> m_key;
+        QVector<bool> m_queued;
+        quint64 m_last;
+        int m_size;
+};
+//END RadixBucketQueue
+
+//BEGIN PriorityQueue
+PriorityQueue::Type PriorityQueue::s_defaultType = PriorityQueue::IndexedHeap;
+
+PriorityQueue::~PriorityQueue()
+{
+}
+
+PriorityQueue* PriorityQueue::create(Type type)
+{
+    switch (type) {
+        case Multiset: return new MultisetQueue();
+        case IndexedHeap: return new IndexedHeapQueue();
+        case RadixBucket: return new RadixBucketQueue();
+    }
+    return new IndexedHeapQueue();
+}
+
+const char* PriorityQueue::typeName(Type type)
+{
+    switch (type) {
+        case Multiset: return "multiset";
+        case IndexedHeap: return "indexed-heap";
+        case RadixBucket: return "radix-bucket";
+    }
+    return "unknown";
+}
+
+PriorityQueue::Type PriorityQueue::defaultType()
+{
+    return s_defaultType;
+}
+
+void PriorityQueue::setDefaultType(Type type)
+{
+    s_defaultType = type;
+}
+//END PriorityQueue
+
+// kate: replace-tabs on; indent-width 4;
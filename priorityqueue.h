@@ -0,0 +1,81 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_PRIORITY_QUEUE_H
+#define DISCOVERAGE_PRIORITY_QUEUE_H
+
+#include <QtCore/QVector>
+
+/**
+ * Open list of the grid searches (GridMap::aStar(), GridMap::frontierPaths()).
+ * Elements are linear cell indices, keys are the path costs.
+ *
+ * Available implementations:
+ * - Multiset:    std::multiset ordered by key; decrease-key searches the old
+ *                entry among all entries with equal key (the original queue).
+ * - IndexedHeap: 4-ary heap with a position index per cell, decrease-key
+ *                in O(log n).
+ * - RadixBucket: monotone radix heap over the integer part of the key. All
+ *                edge costs of the grid are >= 1, so the order within one
+ *                integer bucket does not change the result of Dijkstra.
+ *                This does not hold for A* or any-angle keys, which always
+ *                use IndexedHeap, see SearchWorkspace::reset().
+ */
+class PriorityQueue
+{
+    public:
+        enum Type {
+            Multiset = 0,
+            IndexedHeap,
+            RadixBucket
+        };
+
+        virtual ~PriorityQueue();
+
+        static PriorityQueue* create(Type type);
+        static const char* typeName(Type type);
+
+        // queue type used by the searches of the GridMap
+        static Type defaultType();
+        static void setDefaultType(Type type);
+
+    public:
+        virtual Type type() const = 0;
+
+        // remove all elements, prepare for indices in [0, cellCount)
+        virtual void reset(int cellCount) = 0;
+
+        virtual bool isEmpty() const = 0;
+
+        // insert index with key, or change the key if index is queued already
+        virtual void push(int index, float key) = 0;
+
+        // remove and return the index with the smallest key
+        virtual int pop() = 0;
+
+        // remove index from the queue, if queued
+        virtual void remove(int index) = 0;
+
+    private:
+        static Type s_defaultType;
+};
+
+#endif // DISCOVERAGE_PRIORITY_QUEUE_H
+
+// kate: replace-tabs on; indent-width 4;
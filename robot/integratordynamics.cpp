@@ -18,27 +18,22 @@
 */
 
 #include "integratordynamics.h"
-#include "integratordynamicsconfigwidget.h"
 #include "robotmanager.h"
-#include "tikzexport.h"
-#include "scene.h"
+#include "simulationcontext.h"
 #include "gridmap.h"
-#include "config.h"
 
 #include <QtCore/QDebug>
-#include <QtGui/QPainter>
 #include <QtCore/QSettings>
 
 #include <math.h>
 
-IntegratorDynamics::IntegratorDynamics(Scene* scene)
-    : Robot(scene)
+IntegratorDynamics::IntegratorDynamics(SimulationContext* context)
+    : Robot(context)
 {
 }
 
 IntegratorDynamics::~IntegratorDynamics()
 {
-    delete m_configWidget;
 }
 
 Robot::Dynamics IntegratorDynamics::type()
@@ -46,15 +41,6 @@ Robot::Dynamics IntegratorDynamics::type()
     return Robot::IntegratorDynamics;
 }
 
-RobotConfigWidget* IntegratorDynamics::configWidget()
-{
-    if (!m_configWidget) {
-        m_configWidget = new IntegratorDynamicsConfigWidget(this);
-    }
-
-    return m_configWidget;
-}
-
 bool IntegratorDynamics::hasOrientation() const
 {
     return (trajectory().size() > 1);
@@ -86,48 +72,6 @@ QPointF IntegratorDynamics::orientationVector() const
     }
 }
 
-void IntegratorDynamics::draw(QPainter& p)
-{
-    p.setRenderHints(QPainter::Antialiasing, true);
-    p.setPen(QPen(color(), map()->resolution() * 0.3, Qt::SolidLine));
-
-    drawTrajectory(p);
-    drawRobot(p);
-    drawSensedArea(p);
-
-    p.setRenderHints(QPainter::Antialiasing, false);
-}
-
-void IntegratorDynamics::drawRobot(QPainter& p)
-{
-    static QPen blackPen(Qt::black);
-    blackPen.setWidthF(map()->resolution() * 0.1);
-    p.setOpacity(1.0);
-    p.setPen(blackPen);
-    p.setBrush(color());
-    p.drawEllipse(position(), 0.05, 0.05);
-}
-
-void IntegratorDynamics::exportToTikz(QTikzPicture& tp)
-{
-    const QString c = tp.registerColor(color());
-    tp.comment("robot trajectory (integrator dynamics)");
-    tp.line(trajectory(), "very thick, draw=" + c);
-
-    if (isActive() && Config::self()->showPreviewTrajectory()) {
-        QVector<QPointF> t = previewTrajectory();
-        tp.comment("robot preview trajectory (integrator dynamics)");
-        tp.line(t, "very thick, draw=" + c);
-    }
-
-    // construct path of visibility region
-    tp.comment("robot sensed area");
-    QPainterPath visiblePath = visibleArea(sensingRange());
-    tp.path(visiblePath, "very thick, draw=" + c); // + ", fill=black, fill opacity=0.2");
-
-    tp.circle(position(), 0.05, "draw=black, fill=white");
-}
-
 void IntegratorDynamics::load(QSettings& config)
 {
     Robot::load(config);
@@ -144,10 +88,10 @@ void IntegratorDynamics::tick()
 
     QPointF pos = position();
 
-    pos += scene()->toolHandler()->gradient(this, true) * scene()->map().resolution();
+    pos += context()->gradient(this, true) * context()->map().resolution();
     setPosition(pos, true);
 
-    scene()->map().exploreInRadius(pos, sensingRange(), Cell::Explored);
+    context()->map().exploreInRadius(pos, sensingRange(), Cell::Explored);
 }
 
 void IntegratorDynamics::reset()
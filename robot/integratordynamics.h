@@ -23,12 +23,11 @@
 #include "robot.h"
 
 #include <QtCore/QVector>
-#include <QtCore/QPointer>
 
 class IntegratorDynamics : public Robot
 {
     public:
-        IntegratorDynamics(Scene *scene);
+        IntegratorDynamics(SimulationContext* context);
         virtual ~IntegratorDynamics();
 
         virtual Dynamics type();
@@ -36,8 +35,6 @@ class IntegratorDynamics : public Robot
         virtual void tick();
         virtual void reset();
 
-        virtual RobotConfigWidget* configWidget();
-
     //
     // IntegratorDynamics properties
     //
@@ -50,27 +47,12 @@ class IntegratorDynamics : public Robot
         // orientation of last move as unit vector
         virtual QPointF orientationVector() const;
 
-    //
-    // environment information
-    //
-    public:
-        virtual void draw(QPainter& p);
-        void drawRobot(QPainter& p);
-
-    private:
-        void drawIntegratorDynamics(QPainter& p);
-
     //
     // load/save & export functions
     //
     public:
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
-
-        virtual void exportToTikz(QTikzPicture& tp);
-
-    private:
-        QPointer<RobotConfigWidget> m_configWidget;
 };
 
 #endif // DISCOVERAGE_INTEGRATOR_DYNAMICS_H
@@ -21,6 +21,7 @@
 #include "integratordynamics.h"
 #include "robotmanager.h"
 #include "scene.h"
+#include "robotview.h"
 #include "ui_integratordynamicsconfigwidget.h"
 
 #include <QtCore/QDebug>
@@ -77,7 +78,7 @@ QPixmap IntegratorDynamicsConfigWidget::pixmap()
     p.drawRect(rect);
 
     p.setRenderHints(QPainter::Antialiasing, true);
-    p.setBrush(robot()->color());
+    p.setBrush(RobotView::color(robot()));
     p.drawEllipse(3, 3, 10, 10);
     p.end();
     return pixmap;
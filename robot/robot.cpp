@@ -17,22 +17,17 @@
    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 
-#define _USE_MATH_DEFINES 
-#include <math.h>
-
 #include "robot.h"
 #include "robotmanager.h"
-#include "tikzexport.h"
-#include "scene.h"
+#include "simulationcontext.h"
 #include "gridmap.h"
 
 #include <QtCore/QDebug>
-#include <QtGui/QPainter>
 #include <QtCore/QSettings>
 
-Robot::Robot(Scene* scene)
-    : m_scene(scene)
-    , m_position(scene->map().center())
+Robot::Robot(SimulationContext* context)
+    : m_context(context)
+    , m_position(context->map().center())
 	, m_sensingRange(1.0)
 	, m_fillSensingRange(false)
 	, m_stats(this)
@@ -76,39 +71,19 @@ QPointF Robot::orientationVector() const
 
 bool Robot::isActive() const
 {
-    return RobotManager::self()->activeRobot() == this;
+    return m_context->robotManager().activeRobot() == this;
 }
 
-Scene* Robot::scene() const
+SimulationContext* Robot::context() const
 {
-    return m_scene;
+    return m_context;
 }
 
 GridMap* Robot::map() const
 {
     // do not keep a local pointer to the grid map, as the pointer
     // changes when creating a new scene.
-    return &m_scene->map();
-}
-
-QColor Robot::color()
-{
-    const int index = RobotManager::self()->indexOf(this);
-    static QColor orange(255, 128, 0);
-    static QColor lila(191, 127, 255);
-
-    switch (index) {
-        case 0: return Qt::blue;
-        case 1: return Qt::green;
-        case 2: return Qt::red;
-        case 3: return Qt::yellow;
-        case 4: return Qt::magenta;
-        case 5: return Qt::cyan;
-        case 6: return Qt::gray;
-        case 7: return orange;
-        case 8: return lila;
-        default: return Qt::white;
-    }
+    return &m_context->map();
 }
 
 void Robot::setSensingRange(double sensingRange)
@@ -131,91 +106,26 @@ bool Robot::fillSensingRange() const
     return m_fillSensingRange;
 }
 
-static QPainterPath circularPath(const QPointF& center, qreal radius)
-{
-    int segmentCount = static_cast<int>((radius + 1.0) * 20);
-
-    QPainterPath path;
-    path.moveTo(center + QPointF(radius, 0));
-
-    for (int i = 1; i < segmentCount; ++i) {
-        QPointF p(radius * cos(i * 2.0 * M_PI / segmentCount), radius * sin(i * 2.0 * M_PI / segmentCount));
-        path.lineTo(center + p);
-    }
-
-    path.closeSubpath();
-    return path;
-}
-
-QPainterPath Robot::visibleArea(double radius, bool limitToVoronoiCell)
-{
-    QVector<Cell*> visibleCells = scene()->map().visibleCells(m_position, radius);
-    QPainterPath visiblePath;
-    foreach (Cell* cell, visibleCells) {
-        if (!limitToVoronoiCell || cell->robot() == this)
-            visiblePath.addRect(cell->rect());
-    }
-    visiblePath = visiblePath.simplified();
-
-    // potentially limit with visibility radius
-    if (radius < scene()->map().convexDiameter()) {
-        visiblePath = visiblePath.intersected(circularPath(m_position, radius));
-    }
-
-    return visiblePath;
-}
-
-void Robot::draw(QPainter& p)
-{
-}
-
-void Robot::drawTrajectory(QPainter& p)
-{
-    if (m_trajectory.size()) {
-        p.save();
-        p.setRenderHints(QPainter::Antialiasing, true);
-        p.setPen(QPen(color(), map()->resolution() * 0.3, Qt::SolidLine));
-        p.drawPolyline(&m_trajectory[0], m_trajectory.size());
-        p.restore();
-    }
-}
-
-void Robot::drawSensedArea(QPainter& p)
-{
-    QColor col(color());
-    QPen pen(col, map()->resolution() * 0.3);
-    p.setPen(pen);
-    if (fillSensingRange()) {
-        col.setAlpha(50);
-        p.setBrush(col);
-    } else {
-        p.setBrush(Qt::NoBrush);
-    }
-
-    QPainterPath visiblePath = visibleArea(m_sensingRange);
-    p.drawPath(visiblePath);
-}
-
 QVector<QPointF> Robot::previewTrajectory()
 {
     QVector<QPointF> previewPath;
     previewPath.append(m_position);
 
-    const QPoint index = scene()->map().worldToIndex(m_position);
-    if (!scene()->map().isValidField(index)) return previewPath;
+    const QPoint index = map()->worldToIndex(m_position);
+    if (!map()->isValidField(index)) return previewPath;
 
     const QPointF backupPos = m_position;
     double length = 0;
 
     do {
         m_position = previewPath.last();
-        const QPointF& nextPos = m_position + scene()->toolHandler()->gradient(this, true) * scene()->map().resolution()*0.5;
+        const QPointF& nextPos = m_position + m_context->gradient(this, true) * map()->resolution()*0.5;
         previewPath.append(nextPos);
         const QPointF& cmpPos = previewPath[qMax(0, previewPath.size() - 5)];
         length = (nextPos - cmpPos).manhattanLength();
-    } while (length >= 0.5*scene()->map().resolution() &&
-        scene()->map().isValidField(scene()->map().worldToIndex(previewPath.last())) &&
-        !(scene()->map().cell(scene()->map().worldToIndex(previewPath.last())).state() & Cell::Frontier)
+    } while (length >= 0.5*map()->resolution() &&
+        map()->isValidField(map()->worldToIndex(previewPath.last())) &&
+        !(map()->cell(map()->worldToIndex(previewPath.last())).state() & Cell::Frontier)
     );
 
     m_position = backupPos;
@@ -223,18 +133,6 @@ QVector<QPointF> Robot::previewTrajectory()
     return previewPath;
 }
 
-void Robot::drawPreviewTrajectory(QPainter& p)
-{
-    QVector<QPointF> previewPath = previewTrajectory();
-    if (previewPath.size()) {
-        p.save();
-        p.setRenderHints(QPainter::Antialiasing, true);
-        p.setPen(QPen(color(), 0.05, Qt::DashLine));
-        p.drawPolyline(&previewPath[0], previewPath.size());
-        p.restore();
-    }
-}
-
 void Robot::clearTrajectory()
 {
     m_trajectory.clear();
@@ -245,10 +143,6 @@ const QVector<QPointF>& Robot::trajectory() const
     return m_trajectory;
 }
 
-void Robot::exportToTikz(QTikzPicture& tp)
-{
-}
-
 void Robot::tick()
 {
     m_stats.tick();
@@ -21,23 +21,20 @@
 #define DISCOVERAGE_ROBOT_H
 
 #include <QPointF>
-#include <QtGui/QColor>
-#include <QPainterPath>
 #include <QVector>
-#include <QPixmap>
 
 #include "robotstats.h"
 
-class Scene;
+class SimulationContext;
 class GridMap;
-class QTikzPicture;
-class QPainter;
 class QSettings;
-class RobotConfigWidget;
 
 /**
  * Base class for Robots.
  * Inherit this class and reimplement tick() with your own dynamics.
+ *
+ * Robots only depend on QtCore. Drawing, colors and the TikZ export are
+ * in RobotView, the config widgets are created by the RobotListView.
  */
 class Robot
 {
@@ -48,7 +45,7 @@ class Robot
         };
 
     public:
-        Robot(Scene *scene);
+        Robot(SimulationContext* context);
         virtual ~Robot();
 
         virtual Dynamics type() = 0;
@@ -62,8 +59,6 @@ class Robot
         // reimplement for robot dynamics. Always call the super class first!
         virtual void reset();
 
-        virtual RobotConfigWidget* configWidget() = 0;
-
     //
     // Robot properties
     //
@@ -97,16 +92,9 @@ class Robot
     // environment information
     //
     public:
-        Scene* scene() const;
+        SimulationContext* context() const;
         GridMap* map() const;
 
-        QColor color();
-        virtual void draw(QPainter& p);
-        virtual void drawPreviewTrajectory(QPainter& p);
-        virtual void drawTrajectory(QPainter& p);
-        virtual void drawSensedArea(QPainter& p);
-        virtual QPainterPath visibleArea(double radius, bool limitToVoronoiCell = false);
-
     //
     // load/save & export functions
     //
@@ -114,10 +102,8 @@ class Robot
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
 
-        virtual void exportToTikz(QTikzPicture& tp);
-
     private:
-        Scene* m_scene;
+        SimulationContext* m_context;
         QPointF m_position;
         QVector<QPointF> m_trajectory;
 
@@ -20,6 +20,7 @@
 #include "robotconfigwidget.h"
 #include "robot.h"
 #include "robotmanager.h"
+#include "simulationcontext.h"
 
 #include <QtCore/QDebug>
 #include <QtGui/QPainter>
@@ -55,7 +56,7 @@ RobotConfigWidget::RobotConfigWidget(Robot* robot, const QString& robotName)
     header->addWidget(btnRemoveRobot);
 
     connect(btnRemoveRobot, SIGNAL(clicked()), this, SLOT(removeRobot()));
-    connect(this, SIGNAL(removeRobot(Robot*)), RobotManager::self(), SLOT(removeRobot(Robot*)), Qt::QueuedConnection);
+    connect(this, SIGNAL(removeRobot(Robot*)), &robot->context()->robotManager(), SLOT(removeRobot(Robot*)), Qt::QueuedConnection);
 }
 
 RobotConfigWidget::~RobotConfigWidget()
@@ -80,7 +81,7 @@ void RobotConfigWidget::mousePressEvent(QMouseEvent * event)
 
 void RobotConfigWidget::setRobotActive()
 {
-    RobotManager::self()->setActiveRobot(m_robot);
+    m_robot->context()->robotManager().setActiveRobot(m_robot);
 }
 
 void RobotConfigWidget::setConfigWidget(QWidget* widget)
@@ -96,4 +97,8 @@ void RobotConfigWidget::updatePixmap()
     m_lblPixmap->setPixmap(pixmap());
 }
 
+void RobotConfigWidget::updateFromRobot()
+{
+}
+
 // kate: replace-tabs on; indent-width 4;
@@ -59,6 +59,12 @@ class RobotConfigWidget : public QWidget
 
         virtual QPixmap pixmap() = 0;
 
+        /**
+         * @internal called by RobotListView after each simulation step, so
+         * that the widgets show the state the robot moved to.
+         */
+        virtual void updateFromRobot();
+
     protected slots:
         // mark robot() as active robot.
         void setRobotActive();
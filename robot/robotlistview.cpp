@@ -21,6 +21,8 @@
 #include "robotmanager.h"
 #include "robotconfigwidget.h"
 #include "robot.h"
+#include "robotview.h"
+#include "simulationcontext.h"
 
 #include <QtCore/QDebug>
 #include <QtGui/QPushButton>
@@ -28,8 +30,9 @@
 #include <QtGui/QVBoxLayout>
 #include <QtGui/QComboBox>
 
-RobotListView::RobotListView(QWidget* parent)
+RobotListView::RobotListView(RobotManager* robotManager, QWidget* parent)
     : QScrollArea(parent)
+    , m_robotManager(robotManager)
 {
     setWidget(new QWidget(this));
     setWidgetResizable(true);
@@ -61,52 +64,65 @@ RobotListView::RobotListView(QWidget* parent)
 
     connect(newRobot, SIGNAL(clicked()), this, SLOT(addRobot()));
 
-    connect(RobotManager::self(), SIGNAL(robotCountChanged()), this, SLOT(updateList()), Qt::QueuedConnection);
-    connect(RobotManager::self(), SIGNAL(activeRobotChanged(Robot*)), this, SLOT(updateActiveRobot(Robot*)));
+    connect(m_robotManager, SIGNAL(robotCountChanged()), this, SLOT(updateList()), Qt::QueuedConnection);
+    connect(m_robotManager, SIGNAL(activeRobotChanged(Robot*)), this, SLOT(updateActiveRobot(Robot*)));
+    connect(m_robotManager->context(), SIGNAL(postProcessed()), this, SLOT(updateRobotWidgets()));
 }
 
 RobotListView::~RobotListView()
 {
+    qDeleteAll(m_configWidgets);
 }
 
 void RobotListView::addRobot()
 {
     if (m_cbRobots->currentIndex() == 0) {
-        RobotManager::self()->addRobot(Robot::IntegratorDynamics);
+        m_robotManager->addRobot(Robot::IntegratorDynamics);
     } else if (m_cbRobots->currentIndex() == 1) {
-        RobotManager::self()->addRobot(Robot::Unicycle);
+        m_robotManager->addRobot(Robot::Unicycle);
     }
 }
 
 void RobotListView::updateList()
 {
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        Robot* robot = RobotManager::self()->robot(i);
-        RobotConfigWidget* cw = robot->configWidget();
-        int index = m_robotLayout->indexOf(cw);
-        if (index == -1) {
-            m_robotLayout->insertWidget(i, cw);
-        }
+    // the widgets are rebuilt, since a removed robot's address may be reused
+    // by a robot added in the meantime
+    qDeleteAll(m_configWidgets);
+    m_configWidgets.clear();
+
+    for (int i = 0; i < m_robotManager->count(); ++i) {
+        Robot* robot = m_robotManager->robot(i);
+        RobotConfigWidget* cw = RobotView::createConfigWidget(robot);
+        m_robotLayout->insertWidget(i, cw);
+        m_configWidgets.append(cw);
 
         cw->updatePixmap();
+    }
+
+    updateActiveRobot(m_robotManager->activeRobot());
+}
+
+void RobotListView::updateActiveRobot(Robot* robot)
+{
+    // highlight the active robot with a selection color. Until the queued
+    // updateList() runs, widgets of removed robots are still listed, so
+    // only compare the robot pointers.
+    for (int i = 0; i < m_configWidgets.size(); ++i) {
+        RobotConfigWidget* cw = m_configWidgets[i];
         cw->setBackgroundRole((i % 2) ? QPalette::AlternateBase : QPalette::Base);
 
-        // see updateActiveRobot()
-        if (robot->isActive()) {
+        if (robot && cw->robot() == robot) {
             cw->setBackgroundRole(QPalette::Highlight);
         }
     }
 }
 
-void RobotListView::updateActiveRobot(Robot* robot)
+void RobotListView::updateRobotWidgets()
 {
-    // highlight the active robot with a selection color
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        Robot* robot = RobotManager::self()->robot(i);
-        robot->configWidget()->setBackgroundRole((i % 2) ? QPalette::AlternateBase : QPalette::Base);
-
-        if (robot->isActive()) {
-            robot->configWidget()->setBackgroundRole(QPalette::Highlight);
+    // skip widgets whose robot was removed before the queued updateList()
+    for (int i = 0; i < m_configWidgets.size() && i < m_robotManager->count(); ++i) {
+        if (m_configWidgets[i]->robot() == m_robotManager->robot(i)) {
+            m_configWidgets[i]->updateFromRobot();
         }
     }
 }
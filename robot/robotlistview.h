@@ -27,13 +27,14 @@ class RobotConfigWidget;
 class QBoxLayout;
 class QComboBox;
 class Robot;
+class RobotManager;
 
 class RobotListView : public QScrollArea
 {
     Q_OBJECT
 
     public:
-        RobotListView(QWidget* parent = 0);
+        RobotListView(RobotManager* robotManager, QWidget* parent = 0);
         virtual ~RobotListView();
 
     public slots:
@@ -43,9 +44,16 @@ class RobotListView : public QScrollArea
     private slots:
         void addRobot();
 
+        // show the state the robots moved to in the last simulation step
+        void updateRobotWidgets();
+
     private:
+        RobotManager* m_robotManager;
         QBoxLayout* m_robotLayout;
         QComboBox* m_cbRobots;
+
+        // one config widget per robot, in the order of the RobotManager
+        QVector<RobotConfigWidget*> m_configWidgets;
 };
 
 #endif // DISCOVERAGE_ROBOT_LIST_VIEW_H
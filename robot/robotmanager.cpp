@@ -20,47 +20,48 @@
 #include "robotmanager.h"
 #include "integratordynamics.h"
 #include "unicycle.h"
-#include "scene.h"
+#include "simulationcontext.h"
+#include "gridmap.h"
 
 #include <QtCore/QDebug>
-#include <QtGui/QPainter>
 #include <QtCore/QSettings>
 
-RobotManager* RobotManager::s_self = 0;
-
-RobotManager* RobotManager::self()
-{
-    return s_self;
-}
-
-RobotManager::RobotManager(QObject* parent)
-    : QObject(parent)
+RobotManager::RobotManager(SimulationContext* context)
+    : QObject(context)
+    , m_context(context)
     , m_activeRobot(0)
 {
-    s_self = this;
 }
 
 RobotManager::~RobotManager()
 {
     qDeleteAll(m_robots);
     m_robots.clear();
+}
 
-    s_self = 0;
+SimulationContext* RobotManager::context() const
+{
+    return m_context;
 }
 
-static Robot* createRobot(Robot::Dynamics dynamics)
+Robot* RobotManager::createRobot(Robot::Dynamics dynamics)
 {
     Robot* robot = 0;
     if (dynamics == Robot::IntegratorDynamics) {
-        robot = new IntegratorDynamics(Scene::self());
+        robot = new IntegratorDynamics(m_context);
     } else if (dynamics == Robot::Unicycle) {
-        robot = new Unicycle(Scene::self());
+        robot = new Unicycle(m_context);
     }
     return robot;
 }
 
 void RobotManager::addRobot(Robot::Dynamics dynamics)
 {
+    if (m_robots.size() >= GridMap::MaxRobots) {
+        qWarning() << "RobotManager::addRobot(): at most" << int(GridMap::MaxRobots) << "robots are supported";
+        return;
+    }
+
     Robot* robot = createRobot(dynamics);
 
     // abort, if robit is unknown
@@ -130,24 +131,15 @@ Robot* RobotManager::robot(int index) const
     return m_robots[index];
 }
 
-void RobotManager::reset()
-{
-    foreach (Robot* robot, m_robots) {
-        robot->reset();
-    }
-}
-
-void RobotManager::draw(QPainter& p)
+const QVector<Robot*>& RobotManager::robots() const
 {
-    foreach (Robot* robot, m_robots) {
-        robot->draw(p);
-    }
+    return m_robots;
 }
 
-void RobotManager::exportToTikz(QTikzPicture& tp)
+void RobotManager::reset()
 {
     foreach (Robot* robot, m_robots) {
-        robot->exportToTikz(tp);
+        robot->reset();
     }
 }
 
@@ -160,7 +152,11 @@ void RobotManager::load(QSettings& config)
     qDeleteAll(m_robots);
     m_robots.clear();
 
-    for (int i = 0; i < robotCount; ++i) {
+    if (robotCount > GridMap::MaxRobots) {
+        qWarning() << "RobotManager::load(): ignoring" << robotCount - GridMap::MaxRobots << "robots, at most" << int(GridMap::MaxRobots) << "are supported";
+    }
+
+    for (int i = 0; i < qMin(robotCount, int(GridMap::MaxRobots)); ++i) {
         config.beginGroup("robots");
         Robot::Dynamics dynamics = static_cast<Robot::Dynamics>(config.value(QString("robot-dynamics-%1").arg(i), 0).toInt());
         config.endGroup();
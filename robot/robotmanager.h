@@ -27,22 +27,17 @@
 #include <QtCore/QObject>
 
 class QSettings;
-class QPainter;
-class QTikzPicture;
+class SimulationContext;
 
 class RobotManager : public QObject
 {
     Q_OBJECT
 
-        static RobotManager* s_self;
-
     public:
-        RobotManager(QObject* parent);
+        RobotManager(SimulationContext* context);
         virtual ~RobotManager();
 
-        static RobotManager* self();
-
-        void draw(QPainter& p);
+        SimulationContext* context() const;
 
     //
     // manage robots
@@ -61,6 +56,7 @@ class RobotManager : public QObject
         int count() const;
         int indexOf(Robot* robot) const;
         Robot* robot(int index) const;
+        const QVector<Robot*>& robots() const;
 
     signals:
         // whenever a robot is added or deleted, changed() is emitted.
@@ -76,9 +72,11 @@ class RobotManager : public QObject
         void load(QSettings& config);
         void save(QSettings& config);
 
-        void exportToTikz(QTikzPicture& tp);
+    private:
+        Robot* createRobot(Robot::Dynamics dynamics);
 
     private:
+        SimulationContext* m_context;
         QVector<Robot*> m_robots;
         Robot* m_activeRobot;
 };
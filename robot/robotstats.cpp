@@ -1,7 +1,7 @@
 #include "robotstats.h"
 
 #include "gridmap.h"
-#include "scene.h"
+#include "robot.h"
 
 RobotStats::RobotStats(Robot* robot)
     : m_robot(robot)
@@ -16,14 +16,14 @@ void RobotStats::reset()
 
 void RobotStats::tick()
 {
-    if (! Scene::self()->map().hasFrontiers(m_robot)) {
+    if (! m_robot->map()->hasFrontiers(m_robot)) {
         ++m_itUnemployed;
     }
 }
 
 bool RobotStats::isUnemployed() const
 {
-    return ! Scene::self()->map().hasFrontiers(m_robot);
+    return ! m_robot->map()->hasFrontiers(m_robot);
 }
 
 int RobotStats::unemployedCount() const
@@ -23,14 +23,11 @@
 #include "robot.h"
 
 #include <QtCore/QVector>
-#include <QtCore/QPointer>
-
-class UnicycleConfigWidget;
 
 class Unicycle : public Robot
 {
     public:
-        Unicycle(Scene *scene);
+        Unicycle(SimulationContext* context);
         virtual ~Unicycle();
 
         virtual Dynamics type();
@@ -38,8 +35,6 @@ class Unicycle : public Robot
         virtual void tick();
         virtual void reset();
 
-        virtual RobotConfigWidget* configWidget();
-
     //
     // Unicycle properties
     //
@@ -54,15 +49,6 @@ class Unicycle : public Robot
         // orientation of last move as unit vector
         virtual QPointF orientationVector() const;
 
-    //
-    // environment information
-    //
-    public:
-        virtual void draw(QPainter& p);
-
-        void drawRobot(QPainter& p);
-        void drawUnicycle(QPainter& p);
-
     //
     // load/save & export functions
     //
@@ -70,11 +56,7 @@ class Unicycle : public Robot
         virtual void load(QSettings& config);
         virtual void save(QSettings& config);
 
-        virtual void exportToTikz(QTikzPicture& tp);
-
     private:
-        QPointer<UnicycleConfigWidget> m_configWidget;
-
         double m_orientation;
 };
 
@@ -21,6 +21,7 @@
 #include "unicycle.h"
 #include "robotmanager.h"
 #include "scene.h"
+#include "robotview.h"
 #include "ui_unicycleconfigwidget.h"
 
 #include <QtCore/QDebug>
@@ -61,6 +62,11 @@ UnicycleConfigWidget::~UnicycleConfigWidget()
     delete m_ui;
 }
 
+void UnicycleConfigWidget::updateFromRobot()
+{
+    setOrientationFromRobot(static_cast<Unicycle*>(robot())->orientation());
+}
+
 void UnicycleConfigWidget::setOrientationFromRobot(double value)
 {
     value = value * 180 / M_PI;
@@ -128,7 +134,7 @@ QPixmap UnicycleConfigWidget::pixmap()
     p.drawRect(rect);
 
     p.setRenderHints(QPainter::Antialiasing, true);
-    p.setBrush(robot()->color());
+    p.setBrush(RobotView::color(robot()));
     p.translate(7, 8);
     p.scale(38, 38);
 //     p.rotate(90);
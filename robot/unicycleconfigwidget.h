@@ -38,6 +38,9 @@ class UnicycleConfigWidget : public RobotConfigWidget
 
         virtual QPixmap pixmap();
 
+        // reimplemented to show the orientation the robot turned to
+        virtual void updateFromRobot();
+
     public slots:
         // used to update the orientatio in the gui
         void setOrientationFromRobot(double value);
@@ -0,0 +1,125 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "robotnetwork.h"
+
+#include <math.h>
+
+static inline bool inRange(const QPointF& a, qreal px, qreal py, double range)
+{
+    const qreal dx = a.x() - px;
+    const qreal dy = a.y() - py;
+
+    return (dx*dx + dy*dy) <= range*range;
+}
+
+RobotNetwork::RobotNetwork()
+    : m_linkRange(1.0)
+{
+}
+
+RobotNetwork::Bucket RobotNetwork::bucket(const QPointF& pos) const
+{
+    return Bucket(static_cast<int>(floor(pos.x() / m_linkRange)),
+                  static_cast<int>(floor(pos.y() / m_linkRange)));
+}
+
+int RobotNetwork::find(int robot)
+{
+    while (m_parent[robot] != robot) {
+        // path halving
+        m_parent[robot] = m_parent[m_parent[robot]];
+        robot = m_parent[robot];
+    }
+    return robot;
+}
+
+void RobotNetwork::update(const QVector<QPointF>& positions, double linkRange)
+{
+    const int count = positions.size();
+
+    m_linkRange = linkRange > 0.0 ? linkRange : 1.0;
+    m_positions = positions;
+    m_buckets.clear();
+    m_parent.resize(count);
+
+    for (int i = 0; i < count; ++i) {
+        m_parent[i] = i;
+        m_buckets[bucket(positions[i])].append(i);
+    }
+
+    // linked robots are in the same or in adjacent buckets
+    for (int i = 0; i < count; ++i) {
+        const Bucket b = bucket(positions[i]);
+        for (int bx = b.first - 1; bx <= b.first + 1; ++bx) {
+            for (int by = b.second - 1; by <= b.second + 1; ++by) {
+                const QVector<int> robots = m_buckets.value(Bucket(bx, by));
+                foreach (int j, robots) {
+                    if (j <= i || !inRange(positions[i], positions[j].x(), positions[j].y(), m_linkRange))
+                        continue;
+
+                    const int a = find(i);
+                    const int c = find(j);
+                    if (a != c) {
+                        m_parent[c] = a;
+                    }
+                }
+            }
+        }
+    }
+
+    // number the components
+    QVector<int> rootComponent(count, -1);
+    m_component.resize(count);
+    m_componentSize.clear();
+    for (int i = 0; i < count; ++i) {
+        const int root = find(i);
+        if (rootComponent[root] < 0) {
+            rootComponent[root] = m_componentSize.size();
+            m_componentSize.append(0);
+        }
+        m_component[i] = rootComponent[root];
+        ++m_componentSize[m_component[i]];
+    }
+}
+
+int RobotNetwork::coverage(const QRectF& rect, double radius) const
+{
+    const Bucket topLeft = bucket(QPointF(rect.left() - radius, rect.top() - radius));
+    const Bucket bottomRight = bucket(QPointF(rect.right() + radius, rect.bottom() + radius));
+
+    int count = 0;
+    for (int bx = topLeft.first; bx <= bottomRight.first; ++bx) {
+        for (int by = topLeft.second; by <= bottomRight.second; ++by) {
+            const QVector<int> robots = m_buckets.value(Bucket(bx, by));
+            foreach (int i, robots) {
+                const QPointF& pos = m_positions[i];
+                if (inRange(pos, rect.left(), rect.top(), radius)
+                 || inRange(pos, rect.left(), rect.bottom(), radius)
+                 || inRange(pos, rect.right(), rect.top(), radius)
+                 || inRange(pos, rect.right(), rect.bottom(), radius))
+                    ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,86 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_ROBOT_NETWORK_H
+#define DISCOVERAGE_ROBOT_NETWORK_H
+
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QVector>
+
+/**
+ * Communication graph of the robots: two robots are linked if they are at
+ * most linkRange apart.
+ *
+ * update() sorts the robot positions into a spatial hash with buckets of
+ * size linkRange, so that links are only checked between robots in adjacent
+ * buckets, and merges linked robots with union-find. Afterwards, the
+ * connected component of a robot is known in O(1).
+ *
+ * Robots are identified by their index in the position list.
+ */
+class RobotNetwork
+{
+    public:
+        RobotNetwork();
+
+        // rebuild the graph for the given robot positions
+        void update(const QVector<QPointF>& positions, double linkRange);
+
+        inline int robotCount() const
+        { return m_positions.size(); }
+
+        // connected component of robot, in [0, componentCount())
+        inline int component(int robot) const
+        { return m_component[robot]; }
+
+        inline int componentCount() const
+        { return m_componentSize.size(); }
+
+        // number of robots in the component of robot
+        inline int componentSize(int robot) const
+        { return m_componentSize[m_component[robot]]; }
+
+        // true, if all robots are in one component
+        inline bool isConnected() const
+        { return m_componentSize.size() <= 1; }
+
+        // number of robots within radius of at least one corner of rect
+        int coverage(const QRectF& rect, double radius) const;
+
+    private:
+        typedef QPair<int, int> Bucket;
+
+        Bucket bucket(const QPointF& pos) const;
+        int find(int robot);
+
+    private:
+        double m_linkRange;
+        QVector<QPointF> m_positions;
+        QHash<Bucket, QVector<int> > m_buckets;
+        QVector<int> m_parent;          // union-find forest
+        QVector<int> m_component;
+        QVector<int> m_componentSize;
+};
+
+#endif // DISCOVERAGE_ROBOT_NETWORK_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,113 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "robottask.h"
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QThreadStorage>
+
+bool RobotTask::s_parallel = true;
+
+// set in the threads of the global pool while they process a robot
+static QThreadStorage<bool*> s_workerThread;
+
+//BEGIN RobotRunnable
+class RobotRunnable : public QRunnable
+{
+    public:
+        RobotRunnable(RobotTask* task, Robot* robot, QSemaphore* done)
+            : m_task(task)
+            , m_robot(robot)
+            , m_done(done)
+        {
+        }
+
+        virtual void run()
+        {
+            if (!s_workerThread.hasLocalData()) {
+                s_workerThread.setLocalData(new bool(false));
+            }
+
+            *s_workerThread.localData() = true;
+            m_task->process(m_robot);
+            *s_workerThread.localData() = false;
+
+            m_done->release();
+        }
+
+    private:
+        RobotTask* m_task;
+        Robot* m_robot;
+        QSemaphore* m_done;
+};
+//END RobotRunnable
+
+//BEGIN RobotTask
+RobotTask::~RobotTask()
+{
+}
+
+void RobotTask::run(const QVector<Robot*>& robots)
+{
+    QThreadPool* pool = QThreadPool::globalInstance();
+
+    if (!s_parallel || robots.size() < 2 || pool->maxThreadCount() < 2) {
+        foreach (Robot* robot, robots) {
+            process(robot);
+        }
+    } else {
+        QSemaphore done;
+        for (int i = 1; i < robots.size(); ++i) {
+            pool->start(new RobotRunnable(this, robots[i], &done));
+        }
+
+        // the calling thread takes the first robot instead of waiting idle
+        process(robots[0]);
+        done.acquire(robots.size() - 1);
+    }
+
+    foreach (Robot* robot, robots) {
+        merge(robot);
+    }
+}
+
+void RobotTask::merge(Robot* robot)
+{
+    Q_UNUSED(robot)
+}
+
+void RobotTask::setParallel(bool parallel)
+{
+    s_parallel = parallel;
+}
+
+bool RobotTask::isParallel()
+{
+    return s_parallel;
+}
+
+bool RobotTask::isWorkerThread()
+{
+    return s_workerThread.hasLocalData() && *s_workerThread.localData();
+}
+//END RobotTask
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,95 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_ROBOT_TASK_H
+#define DISCOVERAGE_ROBOT_TASK_H
+
+#include <QtCore/QVector>
+
+class Robot;
+
+/**
+ * Work that is done for each robot separately, e.g. the distance transform
+ * or the vector field in the Voronoi cell of a robot.
+ *
+ * run() calls process() for all robots, distributed over the threads of the
+ * global QThreadPool, and returns when all robots are done. process() must
+ * only write data that belongs to its robot, e.g. the cells of the robot's
+ * Voronoi cell. Afterwards, merge() is called for all robots in the given
+ * order in the calling thread, so that shared results are combined in the
+ * same order as in a sequential run.
+ */
+class RobotTask
+{
+    public:
+        virtual ~RobotTask();
+
+        // process all robots, in parallel if enabled. Pass GridMap::robots()
+        // to process all robots of a map.
+        void run(const QVector<Robot*>& robots);
+
+        // parallel execution is enabled by default
+        static void setParallel(bool parallel);
+        static bool isParallel();
+
+        // true, if the calling thread processes a robot for run() as a
+        // thread of the global QThreadPool
+        static bool isWorkerThread();
+
+    protected:
+        // called concurrently for different robots
+        virtual void process(Robot* robot) = 0;
+
+        // called sequentially after all robots are processed
+        virtual void merge(Robot* robot);
+
+    private:
+        friend class RobotRunnable;
+        static bool s_parallel;
+};
+
+/**
+ * RobotTask that calls a member function for each robot, without merge step.
+ */
+template <class T>
+class RobotMethodTask : public RobotTask
+{
+    public:
+        typedef void (T::*Method)(Robot*);
+
+        RobotMethodTask(T* object, Method method)
+            : m_object(object)
+            , m_method(method)
+        {
+        }
+
+    protected:
+        virtual void process(Robot* robot)
+        {
+            (m_object->*m_method)(robot);
+        }
+
+    private:
+        T* m_object;
+        Method m_method;
+};
+
+#endif // DISCOVERAGE_ROBOT_TASK_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -24,6 +24,7 @@
 #include "config.h"
 #include "robotmanager.h"
 #include "robot.h"
+#include "robotview.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
@@ -41,14 +42,15 @@ Scene* Scene::self()
 
 Scene::Scene(MainWindow* mainWindow, QWidget* parent)
     : QFrame(parent)
-    , m_map(new GridMap(this, 15, 10, 0.2))
+    , m_context(Config::self())
+    , m_mapView(this)
     , m_mainWindow(mainWindow)
     , m_robotHandler(this)
     , m_obstacleHandler(this)
     , m_explorationHandler(this)
     , m_bulloHandler(this)
-    , m_discoverageHandler(this, &m_bulloHandler)
-    , m_minDistHandler(this, &m_bulloHandler)
+    , m_discoverageHandler(this, m_bulloHandler.strategy())
+    , m_minDistHandler(this, m_bulloHandler.strategy())
 	, m_randomHandler(this)
 	, m_maxAreaHandler(this)
 	, m_ruffinsHandler(this)
@@ -63,17 +65,19 @@ Scene::Scene(MainWindow* mainWindow, QWidget* parent)
     setFrameStyle(Panel | Sunken);
 
     m_toolHandler = &m_robotHandler;
+    m_context.setStrategy(m_toolHandler->strategy());
 
-    m_map->updateCache();
-
+    m_mapView.setMap(&m_context.map());
+    m_mapView.updateCache();
 
     // add one robot by default
-	RobotManager::self()->addRobot(Robot::Unicycle);
+	m_context.robotManager().addRobot(Robot::Unicycle);
 
-    connect(RobotManager::self(), SIGNAL(robotCountChanged()), this, SLOT(update()), Qt::QueuedConnection);
-    connect(RobotManager::self(), SIGNAL(activeRobotChanged(Robot*)), this, SLOT(update()));
+    connect(&m_context.robotManager(), SIGNAL(robotCountChanged()), this, SLOT(update()), Qt::QueuedConnection);
+    connect(&m_context.robotManager(), SIGNAL(activeRobotChanged(Robot*)), this, SLOT(update()));
 
     connect(Config::self(), SIGNAL(configChanged()), this, SLOT(slotConfigChanged()));
+    connect(&m_context, SIGNAL(postProcessed()), this, SLOT(updateView()));
 }
 
 Scene::~Scene()
@@ -91,12 +95,13 @@ void Scene::newScene()
         const double width = ui.sbWidth->value();
         const double height = ui.sbHeight->value();
 
-        delete m_map;
-        m_map = new GridMap(this, width, height, res);
+        m_context.setMap(new GridMap(&m_context, width, height, res));
+        m_mapView.setMap(&m_context.map());
+        m_mapView.updateCache();
         mainWindow()->setStatusResolution(res);
         mainWindow()->updateExplorationProgress();
 
-        RobotManager::self()->reset();
+        m_context.robotManager().reset();
 
         setFixedSize(sizeHint());
         update();
@@ -105,14 +110,14 @@ void Scene::newScene()
 
 void Scene::load(QSettings& config)
 {
-    m_map->load(config);
-    m_map->updateCache();
+    m_context.load(config);
+    m_mapView.updateCache();
 
-    mainWindow()->setStatusResolution(m_map->resolution());
+    if (m_mainWindow) {
+        mainWindow()->setStatusResolution(map().resolution());
+    }
     setFixedSize(sizeHint());
 
-    RobotManager::self()->load(config);
-
     m_minDistHandler.load(config);
     m_discoverageHandler.load(config);
     m_explorationHandler.load(config);
@@ -124,15 +129,13 @@ void Scene::load(QSettings& config)
 
 void Scene::save(QSettings& config)
 {
-    m_map->save(config);
+    m_context.save(config);
 
     m_obstacleHandler.save(config);
     m_explorationHandler.save(config);
     m_discoverageHandler.save(config);
     m_minDistHandler.save(config);
     m_bulloHandler.save(config);
-
-    RobotManager::self()->save(config);
 }
 
 void Scene::wheelEvent(QWheelEvent* event)
@@ -151,7 +154,7 @@ void Scene::wheelEvent(QWheelEvent* event)
 
 QSize Scene::sizeHint() const
 {
-    return m_map->displaySize();
+    return m_mapView.displaySize();
 }
 
 MainWindow* Scene::mainWindow() const
@@ -161,13 +164,13 @@ MainWindow* Scene::mainWindow() const
 
 void Scene::zoomIn()
 {
-    m_map->incScaleFactor();
+    m_mapView.incScaleFactor();
     setFixedSize(sizeHint());
 }
 
 void Scene::zoomOut()
 {
-    m_map->decScaleFactor();
+    m_mapView.decScaleFactor();
     setFixedSize(sizeHint());
 }
 
@@ -182,65 +185,80 @@ void Scene::selectTool(int toolIndex)
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_robotHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->showMessage("Click to place the robot.");
+            showMessage("Click to place the robot.");
             break;
         case 2:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_obstacleHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->showMessage("Use the CTRL modifier to remove obstacles.");
+            showMessage("Use the CTRL modifier to remove obstacles.");
             break;
         case 3:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_explorationHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->showMessage("Use the CTRL modifier to mark area as unexplored.");
+            showMessage("Use the CTRL modifier to mark area as unexplored.");
             break;
         case 5:
             // TODO FIXME implement DisCoverage handler
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_discoverageHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->clearMessage();
+            showMessage(QString());
             break;
         case 6:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_minDistHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->clearMessage();
+            showMessage(QString());
             break;
         case 7:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_bulloHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->clearMessage();
+            showMessage(QString());
             break;
         case 8:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_randomHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->clearMessage();
+            showMessage(QString());
             break;
         case 9:
             m_toolHandler->toolHandlerActive(false);
             m_toolHandler = &m_maxAreaHandler;
             m_toolHandler->toolHandlerActive(true);
-            mainWindow()->statusBar()->clearMessage();
+            showMessage(QString());
             break;
 		case 10:
 			m_toolHandler->toolHandlerActive(false);
 			m_toolHandler = &m_ruffinsHandler;
 			m_toolHandler->toolHandlerActive(true);
-			mainWindow()->statusBar()->clearMessage();
+			showMessage(QString());
 			break;
 
         default:
             qWarning() << "Scene::selectTool() called with invalid index";
     }
 
+    m_context.setStrategy(m_toolHandler->strategy());
+
     update();
 }
 
+void Scene::showMessage(const QString& message)
+{
+    if (!m_mainWindow) {
+        return;
+    }
+
+    if (message.isEmpty()) {
+        mainWindow()->statusBar()->clearMessage();
+    } else {
+        mainWindow()->statusBar()->showMessage(message);
+    }
+}
+
 void Scene::setOperationRadius(double radius)
 {
     m_toolHandler->setOperationRadius(radius);
@@ -255,15 +273,18 @@ void Scene::draw(QPaintDevice* paintDevice)
 
     QPainter p(&m_pixmapCache);
 
-    m_map->draw(p);
+    m_mapView.draw(p);
 
     // print overlays in scaled coordinate system
-    p.scale(m_map->scaleFactor(), m_map->scaleFactor());
+    p.scale(m_mapView.scaleFactor(), m_mapView.scaleFactor());
     m_toolHandler->draw(p);
-    RobotManager::self()->draw(p);
+    for (int i = 0; i < m_context.robotManager().count(); ++i) {
+        RobotView::draw(p, m_context.robotManager().robot(i));
+    }
 
-    if (Config::self()->showPreviewTrajectory() && RobotManager::self()->activeRobot()) {
-        RobotManager::self()->activeRobot()->drawPreviewTrajectory(p);
+    Robot* activeRobot = m_context.robotManager().activeRobot();
+    if (m_context.config().showPreviewTrajectory() && activeRobot) {
+        RobotView::drawPreviewTrajectory(p, activeRobot);
     }
 
     p.end();
@@ -324,19 +345,30 @@ void Scene::mouseReleaseEvent(QMouseEvent* event)
     m_toolHandler->mouseReleaseEvent(&constrainedEvent);
 }
 
+SimulationContext& Scene::context()
+{
+    return m_context;
+}
+
 GridMap& Scene::map()
 {
-    return *m_map;
+    return m_context.map();
+}
+
+GridMapView& Scene::mapView()
+{
+    return m_mapView;
 }
 
 void Scene::tick()
 {
 	//Ruffin's Bookmark
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        RobotManager::self()->robot(i)->tick();
-    }
+    m_context.tick();
 
-    m_toolHandler->postProcess();
+    // without main window (batch runs) nothing is displayed
+    if (!m_mainWindow) {
+        return;
+    }
 
     m_mainWindow->updateExplorationProgress();
 
@@ -346,18 +378,23 @@ void Scene::tick()
 
 void Scene::reset()
 {
-    m_map->unexploreAll();
-    RobotManager::self()->reset();
-    m_map->updateCache();
+    map().unexploreAll();
+    m_context.robotManager().reset();
+    m_mapView.updateCache();
     update();
 }
 
 void Scene::slotConfigChanged()
 {
-    m_toolHandler->postProcess();
+    m_context.postProcess();
     update();
 }
 
+void Scene::updateView()
+{
+    m_toolHandler->updateView();
+}
+
 void Scene::saveImage(const QString& filename)
 {
     m_pixmapCache.save(filename);
@@ -368,10 +405,10 @@ void Scene::exportToTikz(QTikzPicture& tp)
     tp.begin("yscale=-1");
 
     tp.comment("export grid map");
-    m_map->exportToTikz(tp);
+    m_mapView.exportToTikz(tp);
 
-    for (int i = 0; i < RobotManager::self()->count(); ++i) {
-        RobotManager::self()->robot(i)->exportToTikz(tp);
+    for (int i = 0; i < m_context.robotManager().count(); ++i) {
+        RobotView::exportToTikz(tp, m_context.robotManager().robot(i));
     }
 
     tp.comment("export tool handler");
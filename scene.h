@@ -25,6 +25,8 @@
 
 #include "cell.h"
 #include "gridmap.h"
+#include "gridmapview.h"
+#include "simulationcontext.h"
 #include "toolhandler.h"
 #include "discoveragehandler.h"
 #include "mindisthandler.h"
@@ -49,12 +51,17 @@ class Scene : public QFrame
     static Scene* s_self;
 
     public:
+        // without main window, the scene is never shown (batch runs)
         Scene(MainWindow* mainWindow, QWidget* parent = 0);
         virtual ~Scene();
 
         static Scene* self();
 
+        // the displayed simulation
+        SimulationContext& context();
+
         GridMap& map();
+        GridMapView& mapView();
         MainWindow* mainWindow() const;
 
         ToolHandler* toolHandler()
@@ -90,6 +97,9 @@ class Scene : public QFrame
 
         void slotConfigChanged();
 
+        // refresh the tool's view after the strategy's post processing
+        void updateView();
+
     public:
         virtual QSize sizeHint() const;
 
@@ -103,10 +113,14 @@ class Scene : public QFrame
         void drawMap(QPainter& p);
         QMouseEvent constrainEvent(QMouseEvent* event);
 
+        // status bar message of the main window, if any
+        void showMessage(const QString& message);
+
     private:
         QPixmap m_pixmapCache;
 
-        GridMap* m_map;
+        SimulationContext m_context;
+        GridMapView m_mapView;
         MainWindow* m_mainWindow;
 
         ToolHandler* m_toolHandler;
@@ -0,0 +1,90 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "searchworkspace.h"
+#include "priorityqueue.h"
+
+#include <QtCore/QThreadStorage>
+
+static QThreadStorage<SearchWorkspace*> s_threadWorkspace;
+
+SearchWorkspace::SearchWorkspace()
+    : m_queue(0)
+    , m_generation(1)
+{
+}
+
+SearchWorkspace::~SearchWorkspace()
+{
+    delete m_queue;
+}
+
+void SearchWorkspace::reset(int cellCount, bool gridCosts)
+{
+    // a RadixBucket queue only orders the integer part of the keys
+    PriorityQueue::Type type = PriorityQueue::defaultType();
+    if (!gridCosts && type == PriorityQueue::RadixBucket) {
+        type = PriorityQueue::IndexedHeap;
+    }
+
+    if (!m_queue || m_queue->type() != type) {
+        delete m_queue;
+        m_queue = PriorityQueue::create(type);
+    }
+    m_queue->reset(cellCount);
+
+    if (m_stamp.size() != cellCount) {
+        // map size changed: reallocate, all stamps are invalid afterwards
+        m_stamp = QVector<quint32>(cellCount, 0);
+        m_cost = QVector<float>(cellCount, 0.0f);
+        m_parent = QVector<qint8>(cellCount, -1);
+        m_parentCell = QVector<int>(cellCount, -1);
+        m_state = QVector<quint8>(cellCount, None);
+        m_generation = 1;
+        return;
+    }
+
+    ++m_generation;
+
+    // on wrap-around, old stamps could become valid again
+    if (m_generation == 0) {
+        m_stamp.fill(0);
+        m_generation = 1;
+    }
+}
+
+SearchWorkspace& SearchWorkspace::threadLocal()
+{
+    // QThreadStorage takes ownership and deletes the workspace on thread exit
+    if (!s_threadWorkspace.hasLocalData()) {
+        s_threadWorkspace.setLocalData(new SearchWorkspace());
+    }
+    return *s_threadWorkspace.localData();
+}
+
+QVector<bool>& SearchWorkspace::visibilityMask(int size)
+{
+    // only grows, the user clears the entries it set
+    if (m_visibilityMask.size() < size) {
+        m_visibilityMask.fill(false, size);
+    }
+    return m_visibilityMask;
+}
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,130 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_SEARCH_WORKSPACE_H
+#define DISCOVERAGE_SEARCH_WORKSPACE_H
+
+#include <QtCore/QVector>
+
+class PriorityQueue;
+
+/**
+ * Scratch data of a single graph search over the GridMap (cost, parent
+ * direction or parent cell and open/closed state for each cell).
+ *
+ * Each entry carries a generation stamp. An entry whose stamp differs from
+ * the current generation reads as untouched (cost 0, no parent, state None),
+ * so reset() costs O(1) instead of clearing the whole grid.
+ *
+ * The workspace also owns the open list of the search, see queue(). Its
+ * type follows PriorityQueue::defaultType(), except that searches whose
+ * keys are not plain grid path costs never get a RadixBucket queue.
+ *
+ * Field of view computations borrow visibilityMask(), which is independent
+ * of the search entries.
+ *
+ * A workspace must only be used by one search at a time. Searches running
+ * in parallel each use their own workspace, see threadLocal().
+ */
+class SearchWorkspace
+{
+    public:
+        enum NodeState {
+            None = 0,
+            Open,
+            Closed
+        };
+
+        SearchWorkspace();
+        ~SearchWorkspace();
+
+        // Start a new search over cellCount cells, invalidates all entries
+        // and empties the queue. gridCosts is false for searches with keys
+        // other than the grid path cost from the start (A* heuristics,
+        // any-angle shortcuts), which need an exactly ordered queue.
+        void reset(int cellCount, bool gridCosts = true);
+
+        // open list of the current search
+        inline PriorityQueue& queue()
+        { return *m_queue; }
+
+        // workspace of the calling thread, created on first use
+        static SearchWorkspace& threadLocal();
+
+        // Scratch mask of GridMap::castFieldOfView(), at least size entries.
+        // All entries are false between two field of view computations.
+        QVector<bool>& visibilityMask(int size);
+
+    public:
+        inline NodeState state(int index) const
+        { return isTouched(index) ? static_cast<NodeState>(m_state[index]) : None; }
+
+        inline void setState(int index, NodeState state)
+        { touch(index); m_state[index] = state; }
+
+        inline float cost(int index) const
+        { return isTouched(index) ? m_cost[index] : 0.0f; }
+
+        inline void setCost(int index, float cost)
+        { touch(index); m_cost[index] = cost; }
+
+        inline int parent(int index) const
+        { return isTouched(index) ? m_parent[index] : -1; }
+
+        inline void setParent(int index, int parent)
+        { touch(index); m_parent[index] = parent; }
+
+        // parent cell of any-angle searches, -1 for none
+        inline int parentCell(int index) const
+        { return isTouched(index) ? m_parentCell[index] : -1; }
+
+        inline void setParentCell(int index, int parentCell)
+        { touch(index); m_parentCell[index] = parentCell; }
+
+    private:
+        inline bool isTouched(int index) const
+        { return m_stamp[index] == m_generation; }
+
+        inline void touch(int index)
+        {
+            if (m_stamp[index] != m_generation) {
+                m_stamp[index] = m_generation;
+                m_cost[index] = 0.0f;
+                m_parent[index] = -1;
+                m_parentCell[index] = -1;
+                m_state[index] = None;
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(SearchWorkspace)
+
+        PriorityQueue* m_queue;
+        quint32 m_generation;
+        QVector<quint32> m_stamp;
+        QVector<float> m_cost;
+        QVector<qint8> m_parent;    // index into the direction map, -1 for none
+        QVector<int> m_parentCell;  // linear index, -1 for none
+        QVector<quint8> m_state;    // NodeState
+        QVector<bool> m_visibilityMask;
+};
+
+#endif // DISCOVERAGE_SEARCH_WORKSPACE_H
+
+// kate: replace-tabs on; indent-width 4;
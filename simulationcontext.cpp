@@ -0,0 +1,146 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "simulationcontext.h"
+#include "gridmap.h"
+#include "config.h"
+#include "robotmanager.h"
+#include "robot.h"
+#include "strategy.h"
+
+#include <QtCore/QSettings>
+
+SimulationContext::SimulationContext(Config* config, QObject* parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_ownsConfig(config == 0)
+    , m_map(0)
+    , m_robotManager(0)
+    , m_strategy(0)
+{
+    if (m_ownsConfig) {
+        m_config = new Config();
+    }
+
+    m_map = new GridMap(this, 15, 10, 0.2);
+    m_robotManager = new RobotManager(this);
+
+    // the map must know the robots before the next tick, so no queued connection
+    connect(m_robotManager, SIGNAL(robotCountChanged()), this, SLOT(updateRobots()));
+}
+
+SimulationContext::~SimulationContext()
+{
+    // the robots go before the map
+    delete m_robotManager;
+    delete m_map;
+
+    if (m_ownsConfig) {
+        delete m_config;
+    }
+}
+
+GridMap& SimulationContext::map()
+{
+    return *m_map;
+}
+
+void SimulationContext::setMap(GridMap* map)
+{
+    Q_ASSERT(map);
+
+    delete m_map;
+    m_map = map;
+    updateRobots();
+}
+
+RobotManager& SimulationContext::robotManager()
+{
+    return *m_robotManager;
+}
+
+Config& SimulationContext::config()
+{
+    return *m_config;
+}
+
+Strategy* SimulationContext::strategy() const
+{
+    return m_strategy;
+}
+
+void SimulationContext::setStrategy(Strategy* strategy)
+{
+    m_strategy = strategy;
+}
+
+QPointF SimulationContext::gradient(Robot* robot, bool interpolate)
+{
+    if (!m_strategy) {
+        return QPointF(0.0, 0.0);
+    }
+
+    return m_strategy->gradient(robot, interpolate);
+}
+
+void SimulationContext::computeVoronoiPartition()
+{
+    QVector<QPointF> positions;
+    foreach (Robot* robot, m_map->robots()) {
+        positions.append(robot->position());
+    }
+    m_map->computeVoronoiPartition(positions);
+}
+
+void SimulationContext::load(QSettings& config)
+{
+    m_map->load(config);
+    m_robotManager->load(config);
+}
+
+void SimulationContext::save(QSettings& config)
+{
+    m_map->save(config);
+    m_robotManager->save(config);
+}
+
+void SimulationContext::tick()
+{
+    for (int i = 0; i < m_robotManager->count(); ++i) {
+        m_robotManager->robot(i)->tick();
+    }
+
+    postProcess();
+}
+
+void SimulationContext::postProcess()
+{
+    if (m_strategy) {
+        m_strategy->postProcess();
+    }
+
+    emit postProcessed();
+}
+
+void SimulationContext::updateRobots()
+{
+    m_map->setRobots(m_robotManager->robots());
+}
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,103 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_SIMULATION_CONTEXT_H
+#define DISCOVERAGE_SIMULATION_CONTEXT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointF>
+
+class QSettings;
+class GridMap;
+class RobotManager;
+class Robot;
+class Config;
+class Strategy;
+
+/**
+ * One simulation: the GridMap, the robots, the strategy that moves them and
+ * the config. Robots and strategies reach the map and each other through
+ * their context, so several contexts can exist in one process, e.g. one per
+ * thread in the discoverage-batch tool.
+ *
+ * A context is only used by one thread at a time. The main window displays
+ * the context of its Scene, which follows postProcessed(). The context
+ * itself only depends on QtCore.
+ */
+class SimulationContext : public QObject
+{
+    Q_OBJECT
+
+    public:
+        // without config, the context creates and owns its own config
+        SimulationContext(Config* config = 0, QObject* parent = 0);
+        virtual ~SimulationContext();
+
+        GridMap& map();
+        // takes ownership of map and deletes the old one
+        void setMap(GridMap* map);
+
+        RobotManager& robotManager();
+        Config& config();
+
+        // The strategy moves the robots, see Strategy::gradient(). The
+        // context does not own the strategy.
+        Strategy* strategy() const;
+        void setStrategy(Strategy* strategy);
+
+        // gradient of the strategy for robot, a null vector without strategy
+        QPointF gradient(Robot* robot, bool interpolate);
+
+        // GridMap::computeVoronoiPartition() with the current robot positions
+        void computeVoronoiPartition();
+
+    //
+    // load & save
+    //
+    public:
+        // map and robots. Strategies load their parameters themselves.
+        void load(QSettings& config);
+        void save(QSettings& config);
+
+    public slots:
+        // one iteration: all robots move, then postProcess()
+        void tick();
+
+        // the strategy prepares the next iteration, then postProcessed()
+        void postProcess();
+
+    signals:
+        // the robots moved or the strategy changed its state, views update
+        void postProcessed();
+
+    private slots:
+        // keep the robots of the map in sync with the robot manager
+        void updateRobots();
+
+    private:
+        Config* m_config;
+        bool m_ownsConfig;
+        GridMap* m_map;
+        RobotManager* m_robotManager;
+        Strategy* m_strategy;
+};
+
+#endif // DISCOVERAGE_SIMULATION_CONTEXT_H
+
+// kate: replace-tabs on; indent-width 4;
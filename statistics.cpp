@@ -22,14 +22,10 @@
 #include "scene.h"
 #include "gridmap.h"
 #include "robotmanager.h"
-#include "tikzexport.h"
-
-#include <cmath>
-
-#include <algorithm>
+#include "simulationcontext.h"
+#include "strategy.h"
 
 #include <QtCore/QDebug>
-#include <QtCore/QFile>
 #include <QtCore/QSettings>
 #include <QtGui/QMouseEvent>
 #include <QtGui/QPainter>
@@ -43,39 +39,6 @@
 #include <QtGui/QLineEdit>
 #include <QtGui/QLabel>
 #include <QTime>
-#include <QtAlgorithms>
-
-int TestRun::iterationForPercentExplored(qreal percent)
-{
-    for (int i = 0; i < stats.size(); ++i) {
-        if (stats[i].percentExplored >= percent)
-            return i;
-    }
-
-    return stats.size();
-}
-
-Stats::Stats()
-    : iteration(0)
-    , percentExplored(0.0)
-    , percentUnemployed(0.0)
-{
-}
-
-TestRun::TestRun()
-    : testRun(0)
-    , stats()
-{
-}
-
-BoxPlotItem::BoxPlotItem()
-{
-    minimum = 0;
-    lowerQuartile = 0;
-    median = 0;
-    upperQuartile = 0;
-    maximum = 0;
-}
 
 Statistics::Statistics(MainWindow* mainWindow, QWidget* parent)
     : QFrame(parent)
@@ -177,7 +140,7 @@ void Statistics::paintEvent(QPaintEvent* event)
     p.restore();
 
     // Now paint batch statistics
-    p.drawText(QPoint(230, 20), QString("Run: %1").arg(m_testRuns.size()));
+    p.drawText(QPoint(230, 20), QString("Run: %1").arg(m_batch.runCount()));
 
     // prepare for progress line
     p.save();
@@ -188,11 +151,10 @@ void Statistics::paintEvent(QPaintEvent* event)
     p.drawLine(0, 0, 0, 100);
     p.drawLine(0, 0, 300, 0);
 
-    m_meanProgress.clear();
-    m_meanUnemployed.clear();
-    for (int i = 0; i < m_boxPlot.size(); ++i) {
+    const QVector<BoxPlotItem>& boxPlot = m_batch.boxPlot();
+    for (int i = 0; i < boxPlot.size(); ++i) {
         p.setPen(Qt::magenta);
-        p.drawPoint(i, meanUnemployed(i) * 100.0);
+        p.drawPoint(i, m_batch.meanUnemployed(i) * 100.0);
     }
 
     QPainterPath minPath;
@@ -200,20 +162,20 @@ void Statistics::paintEvent(QPaintEvent* event)
     QPainterPath medianPath;
     QPainterPath lowerPath;
     QPainterPath upperPath;
-    const int imax = m_boxPlot.size() - 1;
-    for (int i = 0; i < m_boxPlot.size(); ++i) {
+    const int imax = boxPlot.size() - 1;
+    for (int i = 0; i < boxPlot.size(); ++i) {
         if (i == 0) {
-            minPath.moveTo(QPointF(i, 100*m_boxPlot[i].minimum));
-            maxPath.moveTo(QPointF(imax - i, 100*m_boxPlot[imax - i].maximum));
-            medianPath.moveTo(QPointF(i, 100*m_boxPlot[i].median));
-            lowerPath.moveTo(QPointF(i, 100*m_boxPlot[i].lowerQuartile));
-            upperPath.moveTo(QPointF(imax - i, 100*m_boxPlot[imax - i].upperQuartile));
+            minPath.moveTo(QPointF(i, 100*boxPlot[i].minimum));
+            maxPath.moveTo(QPointF(imax - i, 100*boxPlot[imax - i].maximum));
+            medianPath.moveTo(QPointF(i, 100*boxPlot[i].median));
+            lowerPath.moveTo(QPointF(i, 100*boxPlot[i].lowerQuartile));
+            upperPath.moveTo(QPointF(imax - i, 100*boxPlot[imax - i].upperQuartile));
         } else {
-            minPath.lineTo(QPointF(i, 100*m_boxPlot[i].minimum));
-            maxPath.lineTo(QPointF(imax - i, 100*m_boxPlot[imax - i].maximum));
-            medianPath.lineTo(QPointF(i, 100*m_boxPlot[i].median));
-            lowerPath.lineTo(QPointF(i, 100*m_boxPlot[i].lowerQuartile));
-            upperPath.lineTo(QPointF(imax - i, 100*m_boxPlot[imax - i].upperQuartile));
+            minPath.lineTo(QPointF(i, 100*boxPlot[i].minimum));
+            maxPath.lineTo(QPointF(imax - i, 100*boxPlot[imax - i].maximum));
+            medianPath.lineTo(QPointF(i, 100*boxPlot[i].median));
+            lowerPath.lineTo(QPointF(i, 100*boxPlot[i].lowerQuartile));
+            upperPath.lineTo(QPointF(imax - i, 100*boxPlot[imax - i].upperQuartile));
         }
     }
 
@@ -241,13 +203,13 @@ void Statistics::paintEvent(QPaintEvent* event)
 
     // Now paint batch statistics
     qreal mean, sigma;
-    statsForPercentExplored(0.9, mean, sigma);
+    m_batch.statsForPercentExplored(0.9, mean, sigma);
     p.drawText(QPoint(830, 20), QString(" 90%: %1 (%2)").arg(mean).arg(sigma));
-    statsForPercentExplored(0.95, mean, sigma);
+    m_batch.statsForPercentExplored(0.95, mean, sigma);
     p.drawText(QPoint(830, 40), QString(" 95%: %1 (%2)").arg(mean).arg(sigma));
-    statsForPercentExplored(0.98, mean, sigma);
+    m_batch.statsForPercentExplored(0.98, mean, sigma);
     p.drawText(QPoint(830, 60), QString(" 98%: %1 (%2)").arg(mean).arg(sigma));
-    statsForPercentExplored(1, mean, sigma);
+    m_batch.statsForPercentExplored(1, mean, sigma);
     p.drawText(QPoint(830, 80), QString("100%: %1 (%2)").arg(mean).arg(sigma));
 
     p.end();
@@ -265,8 +227,7 @@ void Statistics::reset()
     m_progress.clear();
     update();
 
-    m_testRuns.append(TestRun());
-    m_testRuns.last().testRun = m_testRuns.size();
+    m_batch.beginRun();
 }
 
 void Statistics::tick()
@@ -277,22 +238,7 @@ void Statistics::tick()
     m_progress.append(progress * 100);
     update();
 
-    if (m_testRuns.size()) {
-        qreal unemployed = 0.0;
-        const int count = RobotManager::self()->count();
-        if (progress < 1.0) { // only count as unemployed, if exploration is not finished
-            for (int i = 0; i < count; ++i) {
-                if (RobotManager::self()->robot(i)->stats().isUnemployed())
-                    unemployed += 1;
-            }
-            unemployed /= count;
-        }
-
-        m_testRuns.last().stats.append(Stats());
-        m_testRuns.last().stats.last().iteration = m_progress.size();
-        m_testRuns.last().stats.last().percentExplored = progress;
-        m_testRuns.last().stats.last().percentUnemployed = unemployed;
-    }
+    m_batch.recordIteration(m.robots(), progress);
 }
 
 void Statistics::contextMenuEvent(QContextMenuEvent* event)
@@ -311,127 +257,6 @@ void Statistics::contextMenuEvent(QContextMenuEvent* event)
     }
 }
 
-qreal Statistics::meanProgress(int iteration)
-{
-    const int N = m_testRuns.size();
-    qreal meanExplored = 0.0;
-    for (int i = 0; i < N; ++i) {
-        qreal explored = 1.0;
-        if (iteration < m_testRuns[i].stats.size()) {
-            explored = m_testRuns[i].stats[iteration].percentExplored;
-        }
-        meanExplored += explored;
-    }
-    m_meanProgress.append(meanExplored / N);
-    return meanExplored / N;
-}
-
-qreal Statistics::varianceProgress(int iteration)
-{
-//     qDebug () << m_meanProgress.size() << iter action;
-    if (iteration >= m_meanProgress.size()) return 0;
-
-    const qreal mean = m_meanProgress[iteration];
-
-    const int N = m_testRuns.size();
-    qreal variance = 0.0;
-    for (int i = 0; i < N; ++i) {
-        qreal explored = 1.0;
-        if (iteration < m_testRuns[i].stats.size()) {
-            explored = m_testRuns[i].stats[iteration].percentExplored;
-        }
-        variance += (explored - mean) * (explored - mean);
-    }
-    return variance / N;
-}
-
-qreal Statistics::meanUnemployed(int iteration)
-{
-    const int N = m_testRuns.size();
-    qreal meanUnemployed = 0.0;
-    for (int i = 0; i < N; ++i) {
-        qreal unemployed = 0.0;
-        if (iteration < m_testRuns[i].stats.size()) {
-            unemployed = m_testRuns[i].stats[iteration].percentUnemployed;
-        }
-        meanUnemployed += unemployed;
-    }
-    m_meanUnemployed.append(meanUnemployed / N);
-    return meanUnemployed / N;
-}
-
-qreal Statistics::varianceUnemployed(int iteration)
-{
-//     qDebug () << m_meanUnemployed.size() << iter action;
-    if (iteration >= m_meanUnemployed.size()) return 0;
-
-    const qreal mean = m_meanUnemployed[iteration];
-
-    const int N = m_testRuns.size();
-    qreal variance = 0.0;
-    for (int i = 0; i < N; ++i) {
-        qreal unemployed = 1.0;
-        if (iteration < m_testRuns[i].stats.size()) {
-            unemployed = m_testRuns[i].stats[iteration].percentUnemployed;
-        }
-        variance += (unemployed - mean) * (unemployed - mean);
-    }
-    return variance / N;
-}
-
-void Statistics::statsForPercentExplored(qreal percent, qreal & meanIteration, qreal & stdDeviation)
-{
-    meanIteration = 0;
-    stdDeviation = 0;
-
-    const int N = m_testRuns.size();
-
-    if (N < 2) return;
-
-    // calculate mean
-    for (int i = 0; i < N; ++i) {
-        meanIteration += m_testRuns[i].iterationForPercentExplored(percent);
-    }
-    meanIteration /= N;
-
-    // calculate variance
-    for (int i = 0; i < N; ++i) {
-        qreal it = m_testRuns[i].iterationForPercentExplored(percent);
-        stdDeviation += (it - meanIteration) * (it - meanIteration);
-    }
-
-    // empirical standard deviation
-    stdDeviation =  sqrt(stdDeviation / (N - 1));
-}
-
-QPointF Statistics::randomRobotPos(int robot)
-{
-    const QSizeF worldSize = m_mainWindow->scene()->map().worldSize();
-    while (true) {
-        const QPointF worldPos((rand() * worldSize.width()) / RAND_MAX,
-                               (rand() * worldSize.height()) / RAND_MAX);
-        const QPoint cellIndex = m_mainWindow->scene()->map().worldToIndex(worldPos);
-
-        // make sure cell is valid and no obstacle
-        if (!m_mainWindow->scene()->map().isValidField(cellIndex) ||
-            m_mainWindow->scene()->map().cell(cellIndex).isObstacle())
-        {
-            continue;
-        }
-
-		// Ruffin's Bookmark
-        // make sure no other robots is in the same cell
-        for (int i = 0; i < robot; ++i) {
-            const QPoint robotIndex = m_mainWindow->scene()->map().worldToIndex(
-                    RobotManager::self()->robot(i)->position());
-            if (robotIndex == cellIndex)
-                continue;
-        }
-
-        return worldPos;
-    }
-}
-
 QVector<qreal> Statistics::sensingRanges() const
 {
     QVector<qreal> ranges;
@@ -471,7 +296,7 @@ QVector<int> Statistics::strategies() const
 
 void Statistics::startStopBatchProcess()
 {
-	srand(42);
+	qsrand(42);
     if (!m_batchProcessRunning) {
         m_batchProcessRunning = true;
         m_btnStartStop->setText("Stop");
@@ -507,13 +332,7 @@ void Statistics::startStopBatchProcess()
 void Statistics::oneBatchRun(int * strategy, qreal * range)
 {
     // prepare
-    m_testRuns.clear();
-    m_boxPlot.clear();
-
-    // reproducible random numbers
-    srand(1);
-
-    int maxIterations = 0;
+    m_batch.clear();
 
     QTime tStart;
     tStart.start();
@@ -524,13 +343,18 @@ void Statistics::oneBatchRun(int * strategy, qreal * range)
 
         m_mainWindow->setStrategy(*strategy);
 
-		QPointF commonPoint = randomRobotPos(0);
+        // reproducible random numbers, depending on the run only as in
+        // discoverage-batch
+        qsrand(1 + run);
+
+		QPointF commonPoint = BatchStatistics::randomRobotPos(m_mainWindow->scene()->map(), 0);
 
 		// Ruffin's Mod
         // randomize robot positions
-        for (int i = 0; i < RobotManager::self()->count(); ++i) {
-			Robot* robot = RobotManager::self()->robot(i);
-//			robot->setPosition(randomRobotPos(i));
+        RobotManager& robotManager = m_mainWindow->scene()->context().robotManager();
+        for (int i = 0; i < robotManager.count(); ++i) {
+			Robot* robot = robotManager.robot(i);
+//			robot->setPosition(BatchStatistics::randomRobotPos(m_mainWindow->scene()->map(), i));
 			robot->setPosition(commonPoint);
             if (range) robot->setSensingRange(*range);
         }
@@ -540,9 +364,6 @@ void Statistics::oneBatchRun(int * strategy, qreal * range)
 			m_mainWindow->tick();
             QApplication::processEvents();
         }
-        if (m_progress.size() > maxIterations) {
-            maxIterations = m_progress.size();
-        }
         ++run;
 
         // status info
@@ -555,18 +376,7 @@ void Statistics::oneBatchRun(int * strategy, qreal * range)
     fprintf(stdout, "\n");
 
     // generate box plots:
-    m_boxPlot.resize(maxIterations);
-    for (int it = 0; it < maxIterations; ++it) {
-        QVector<qreal> percentExploredList = percentList(it);
-        const int count = percentExploredList.size();
-        Q_ASSERT(count > 0);
-
-        m_boxPlot[it].minimum = percentExploredList.first();
-        m_boxPlot[it].maximum = percentExploredList.last();
-        m_boxPlot[it].median = percentExploredList[count * 0.5];
-        m_boxPlot[it].lowerQuartile = percentExploredList[count * 0.25];
-        m_boxPlot[it].upperQuartile = percentExploredList[count * 0.75];
-    }
+    m_batch.finish();
 
     // auto-export if wanted and simulation was not aborted
     if (m_batchProcessRunning && m_cbAutoExport->isChecked()) {
@@ -574,218 +384,12 @@ void Statistics::oneBatchRun(int * strategy, qreal * range)
     }
 }
 
-QVector<qreal> Statistics::percentList(int iteration) const
-{
-    QVector<qreal> vec;
-    for (int run = 0; run < m_testRuns.size(); ++run) {
-        if (iteration < m_testRuns[run].stats.size()) {
-            vec.append(m_testRuns[run].stats[iteration].percentExplored);
-        } else {
-            vec.append(1.0);
-        }
-    }
-    qSort(vec.begin(), vec.end());
-    return vec;
-}
-
-inline static bool inCircle(qreal cellX, qreal cellY, qreal radius)
-{
-    return (cellX * cellX + cellY * cellY) <= radius*radius;
-}
-
-static int cellCountInCircle(qreal radius, qreal resolution)
-{
-    // compute amount of cells in one quadrant of the circle centered at (0, 0)
-    int cellCount = 0;
-    const int maxCellCount = ceil(radius / resolution);
-    for (int a = -maxCellCount; a < maxCellCount; ++a) {
-            const qreal startX = a * resolution - resolution / 2.0;
-            const qreal endX = (a + 1) * resolution - resolution / 2.0;
-        for (int b = -maxCellCount; b < maxCellCount; ++b) {
-            const qreal startY = b * resolution - resolution / 2.0;
-            const qreal endY = (b + 1) * resolution - resolution / 2.0;
-
-            // cell contained in circle?
-            if (inCircle(startX, startY, radius) &&
-                inCircle(startX, endY, radius) &&
-                inCircle(endX, startY, radius) &&
-                inCircle(endX, endY, radius))
-                ++cellCount;
-        }
-    }
-    return cellCount;
-}
-
 void Statistics::exportStatistics()
 {
-    if (!m_boxPlot.size()) return;
-
-    // create paths to export
-    QVector<QPointF> minPath;
-    QVector<QPointF> maxPath;
-    QVector<QPointF> medianPath;
-    QVector<QPointF> lowerPath;
-    QVector<QPointF> upperPath;
-    QVector<QPointF> unemployedPath;
-    for (int i = 0; i < m_boxPlot.size(); ++i) {
-        minPath.append(QPointF(i, 100*m_boxPlot[i].minimum));
-        maxPath.append(QPointF(i, 100*m_boxPlot[i].maximum));
-        medianPath.append(QPointF(i, 100*m_boxPlot[i].median));
-        lowerPath.append(QPointF(i, 100*m_boxPlot[i].lowerQuartile));
-        upperPath.append(QPointF(i, 100*m_boxPlot[i].upperQuartile));
-        unemployedPath.append(QPointF(i, meanUnemployed(i) * 100.0));
-    }
-
-    // create paths to fill
-    QVector<QPointF> minMaxPath = maxPath;
-    std::reverse(minMaxPath.begin(), minMaxPath.end());
-    minMaxPath = minPath + minMaxPath;
-
-    QVector<QPointF> lowUpPath = upperPath;
-    std::reverse(lowUpPath.begin(), lowUpPath.end());
-    lowUpPath = lowerPath + lowUpPath;
-
-    // compute time-optimal-case
-    const qreal res = m_mainWindow->scene()->map().resolution();
-    const qreal range = RobotManager::self()->robot(0)->sensingRange();
-    const int robotCount = RobotManager::self()->count();
-    const int totalCells = m_mainWindow->scene()->map().freeCellCount();
-    const int startCells = robotCount * cellCountInCircle(range, res);
-    const qreal cellsPerIteration = robotCount * 2.0 * floor(range / res);
-    const qreal percentPerIteration = cellsPerIteration / (totalCells - startCells);
-    const QPointF tocStart(0, (100.0 * startCells) / totalCells);
-    const QPointF tocEnd((1.0 - tocStart.y() / 100.0) / percentPerIteration, 100);
-
-    // export file name
-	QString fileName = m_mainWindow->sceneBaseName()
-		+ "-" + mainWindow()->scene()->toolHandler()->name()
-		+ "-robots-" + QString::number(robotCount)
-		+ "-range-" + QString::number(range)
-		+ "-runs-" + QString::number(m_testRuns.size())
-		+ "-statistics";
-
-	QString fileNametxt = fileName + ".txt";
-	fileName = fileName + ".tikz";
-
-	QFile file(fileNametxt);
-	if (file.open(QFile::WriteOnly | QFile::Truncate)) {
-		QTextStream ts(&file);
-		qreal mean, sigma;
-		statsForPercentExplored(0.90, mean, sigma);
-		ts << "mean and variance of 90% :" << "\n";
-		ts << mean << " " << sigma << "\n";
-		statsForPercentExplored(0.95, mean, sigma);
-		ts << "mean and variance of 95% :" << "\n";
-		ts << mean << " " << sigma << "\n";
-		statsForPercentExplored(0.98, mean, sigma);
-		ts << "mean and variance of 98% :" << "\n";
-		ts << mean << " " << sigma << "\n";
-		statsForPercentExplored(1.00, mean, sigma);
-		ts << "mean and variance of 100% :" << "\n";
-		ts << mean << " " << sigma << "\n";
-	}
-	file.close();
-
-	file.setFileName(fileName);
-    if (file.open(QFile::WriteOnly | QFile::Truncate)) {
-        QTextStream ts(&file);
-        QTikzPicture tikzPicture;
-        tikzPicture.setStream(&ts);
-
-        tikzPicture.begin("thick");
-
-        // plot data, scaled to 8cm
-        tikzPicture.newline(2);
-        tikzPicture.comment("plot data, scaled to 8cm");
-        tikzPicture.beginScope(QString("yscale=0.05, xscale=%1").arg(8.0 / m_boxPlot.size()));
-
-            tikzPicture.line(minMaxPath, "draw=orange, fill=orange!50");
-            tikzPicture.line(lowUpPath, "gray, densely dashed, fill=green!20");
-            tikzPicture.line(medianPath, "blue");
-            tikzPicture.line(unemployedPath, "densely dotted, magenta");
-
-            // time-optimal case
-            tikzPicture.line(tocStart, tocEnd, "black");
-
-            // draw grid
-            tikzPicture << QString("\\draw[densely dashed, thin, black, ystep=20, xstep=10, opacity=0.3] (0, 0) grid (%1, 100);").arg(m_boxPlot.size());
-
-            // axes
-            tikzPicture.newline();
-            tikzPicture.comment("axis lables");
-            for (int i = 0; i <= m_boxPlot.size(); i += m_boxPlot.size() >= 100 ? 20 : 10) {
-                tikzPicture << QString("\\node[below] at (%1, 0) {%1};\n").arg(i);
-            }
-
-            // mean and variance of 90%, 95% and 98% explored
-			qreal mean, sigma;
-            statsForPercentExplored(0.9, mean, sigma);
-            tikzPicture << QString("\\draw[|-|] (%1, 90) -- (%2, 90);\n").arg(mean - sigma).arg(mean + sigma);
-            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 90) {};\n").arg(mean);
-            tikzPicture.comment(QString("90: %1  +-  %2").arg(mean).arg(sigma));
-            statsForPercentExplored(0.95, mean, sigma);
-            tikzPicture << QString("\\draw[|-|] (%1, 95) -- (%2, 95);\n").arg(mean - sigma).arg(mean + sigma);
-            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 95) {};\n").arg(mean);
-            tikzPicture.comment(QString("95: %1  +-  %2").arg(mean).arg(sigma));
-            statsForPercentExplored(0.98, mean, sigma);
-            tikzPicture << QString("\\draw[|-|] (%1, 98) -- (%2, 98);\n").arg(mean - sigma).arg(mean + sigma);
-            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 98) {};\n").arg(mean);
-            tikzPicture.comment(QString("98: %1  +-  %2").arg(mean).arg(sigma));
-            statsForPercentExplored(1.0, mean, sigma);
-            tikzPicture << QString("\\draw[|-|] (%1, 100) -- (%2, 100);\n").arg(mean - sigma).arg(mean + sigma);
-            tikzPicture << QString("\\node[draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (%1, 100) {};\n").arg(mean);
-            tikzPicture.comment(QString("100: %1  +-  %2").arg(mean).arg(sigma));
-
-        tikzPicture.endScope();
-
-        // axes lables
-        tikzPicture.newline(2);
-        tikzPicture.comment("axes lables");
-        tikzPicture.beginScope("yscale=0.05");
-
-            // y axis lables
-            tikzPicture.line(QPointF(0, 0), QPointF(0, 100));
-            tikzPicture << "\\node[left] at (0, 20) {20};\n";
-            tikzPicture << "\\node[left] at (0, 40) {40};\n";
-            tikzPicture << "\\node[left] at (0, 60) {60};\n";
-            tikzPicture << "\\node[left] at (0, 80) {80};\n";
-            tikzPicture << "\\node[left] at (0, 100) {100};\n";
-
-            tikzPicture << "\\node[rotate=90] at (-0.8, 50) {exploration progress in \\%};\n";
-
-            // x axis lables
-            tikzPicture.line(QPointF(0, 0), QPointF(8.5, 0), "->, >=stealth'");
-            tikzPicture << "\\node[below] at (8.5, 0) {it};\n";
-
-        tikzPicture.endScope();
-
-        // legend
-        tikzPicture.newline(2);
-        tikzPicture.comment("legend");
-        tikzPicture.beginScope("xshift=6cm, yshift=2.5cm");
-
-            tikzPicture << "\\draw[semithick, fill=white, fill opacity=0.8] (0, -0.65) rectangle +(2.5, 2.6);\n";
-            tikzPicture << "\\scriptsize\n";
-
-            tikzPicture << "\\draw[semithick,|-|] (0.2, -.4) -- +(0.28, 0) node[right, black] {$\\text{mean} \\pm \\sqrt{\\text{var}}$};\n";
-            tikzPicture << "\\node[semithick,draw, circle, fill=white, inner sep=0mm, minimum size=1mm] at (0.34, -0.4) {};\n";
-            tikzPicture << "\\draw (0.2, -.1) -- +(0.28, 0) node[right, black] {time-opt. case};\n";
-            tikzPicture << "\\draw[magenta, densely dotted] (0.2, 0.2) -- +(0.28, 0) node[right, black] {unemployed};\n";
-
-            tikzPicture << "\\fill[orange!50] (0.2, 0.5) rectangle +(0.28, 1.2);\n";
-            tikzPicture << "\\fill[green!20] (0.2, 0.8) rectangle +(0.28, 0.6);\n";
-
-            tikzPicture << "\\draw[orange] (0.2, 1.7) -- +(0.28, 0) node[right, black] {best case};\n";
-            tikzPicture << "\\draw[gray, densely dashed] (0.2, 1.4) -- +(0.28, 0) node[right, black] {median $+25\\%$};\n";
-            tikzPicture << "\\draw[blue] (0.2, 1.1) -- +(0.28, 0) node[right, black] {median};\n";
-            tikzPicture << "\\draw[gray, densely dashed] (0.2, 0.8) -- +(0.28, 0) node[right, black] {median $-25\\%$};\n";
-            tikzPicture << "\\draw[orange] (0.2, 0.5) -- +(0.28, 0) node[right, black] {worst case};\n";
-
-        tikzPicture.endScope();
-
-        tikzPicture.end();
-
-        file.close();
-    }
+    Strategy* strategy = mainWindow()->scene()->context().strategy();
+    m_batch.exportStatistics(m_mainWindow->sceneBaseName(),
+                             strategy ? strategy->name() : QString(),
+                             mainWindow()->scene()->map());
 }
+
 // kate: replace-tabs on; indent-width 4;
@@ -22,6 +22,8 @@
 
 #include <QtGui/QFrame>
 
+#include "batchstatistics.h"
+
 class QSpinBox;
 class QPushButton;
 class QCheckBox;
@@ -30,36 +32,6 @@ class QPaintEvent;
 class MainWindow;
 class QContextMenuEvent;
 
-class Stats
-{
-    public:
-        Stats();
-
-        int iteration;
-        qreal percentExplored; // [0; 1]
-        qreal percentUnemployed; // [0; 1]
-};
-
-class TestRun
-{
-    public:
-        TestRun();
-        int iterationForPercentExplored(qreal percent); // [0; 1]
-        int testRun;
-        QVector<Stats> stats;
-};
-
-class BoxPlotItem
-{
-    public:
-        BoxPlotItem();
-        qreal minimum;
-        qreal lowerQuartile;
-        qreal median;
-        qreal upperQuartile;
-        qreal maximum;
-};
-
 class Statistics : public QFrame
 {
     Q_OBJECT
@@ -87,18 +59,6 @@ class Statistics : public QFrame
     // batch statistics
     //
     public:
-        qreal meanProgress(int iteration);
-        qreal varianceProgress(int iteration);
-        qreal meanUnemployed(int iteration);
-        qreal varianceUnemployed(int iteration);
-        QPointF randomRobotPos(int robot);
-
-        /**
-         * Get the iteration (mean and variance) for which @p percent are explored.
-         * @param percent percent explored in inverval [0; 1]
-         */
-        void statsForPercentExplored(qreal percent, qreal & meanIteration, qreal & stdDeviation);
-
         QVector<qreal> sensingRanges() const;
         QVector<int> strategies() const;
 
@@ -120,13 +80,7 @@ class Statistics : public QFrame
         
         QVector<double> m_progress;
 
-        QVector<TestRun> m_testRuns;
-        QVector<qreal> m_meanProgress;
-        QVector<qreal> m_meanUnemployed;
-
-        QVector<BoxPlotItem> m_boxPlot;
-    public:
-        QVector<qreal> percentList(int iterations) const;
+        BatchStatistics m_batch;
 };
 
 #endif // STATISTICS_H
@@ -0,0 +1,416 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "bullostrategy.h"
+#include "simulationcontext.h"
+#include "robot.h"
+#include "robotmanager.h"
+#include "config.h"
+#include "tiletask.h"
+#include "gradientcache.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QSettings>
+#include <QtCore/QTextStream>
+
+#include <math.h>
+
+//BEGIN BulloTileTask
+class BulloTileTask : public TileTask
+{
+    public:
+        // vector field, only the cells of robot if given
+        BulloTileTask(DisCoverageBulloStrategy* strategy, Robot* robot, double rint)
+            : m_strategy(strategy)
+            , m_robot(robot)
+            , m_rint(rint)
+            , m_values(0)
+        {
+        }
+
+        // fitness of all cells in row-major order
+        BulloTileTask(DisCoverageBulloStrategy* strategy, double rint, QVector<qreal>* values)
+            : m_strategy(strategy)
+            , m_robot(0)
+            , m_rint(rint)
+            , m_values(values)
+        {
+        }
+
+    protected:
+        virtual void process(const QRect& tile)
+        {
+            if (m_values) {
+                m_strategy->computeFitness(tile, m_rint, *m_values);
+            } else {
+                m_strategy->updateVectorField(tile, m_robot, m_rint);
+            }
+        }
+
+    private:
+        DisCoverageBulloStrategy* m_strategy;
+        Robot* m_robot;
+        double m_rint;
+        QVector<qreal>* m_values;
+};
+//END BulloTileTask
+
+//BEGIN DisCoverageBulloParameters
+DisCoverageBulloParameters::DisCoverageBulloParameters()
+    : integrationRange(0.5)
+{
+}
+
+void DisCoverageBulloParameters::load(QSettings& config)
+{
+    integrationRange = config.value("integration-range", 0.5).toDouble();
+}
+
+void DisCoverageBulloParameters::save(QSettings& config) const
+{
+    config.setValue("integration-range", integrationRange);
+}
+//END DisCoverageBulloParameters
+
+//BEGIN DisCoverageBulloStrategy
+DisCoverageBulloStrategy::DisCoverageBulloStrategy(SimulationContext* context)
+    : Strategy(context)
+{
+}
+
+DisCoverageBulloStrategy::~DisCoverageBulloStrategy()
+{
+    qDeleteAll(m_gradientCaches);
+}
+
+QString DisCoverageBulloStrategy::name() const
+{
+    return QString("DisCoverage-centroid");
+}
+
+const DisCoverageBulloParameters& DisCoverageBulloStrategy::parameters() const
+{
+    return m_parameters;
+}
+
+void DisCoverageBulloStrategy::setParameters(const DisCoverageBulloParameters& parameters)
+{
+    // the cached gradients depend on the integration range
+    if (parameters.integrationRange != m_parameters.integrationRange) {
+        clearGradientCaches();
+    }
+    m_parameters = parameters;
+}
+
+void DisCoverageBulloStrategy::setIntegrationRange(double range)
+{
+    DisCoverageBulloParameters parameters(m_parameters);
+    parameters.integrationRange = range;
+    setParameters(parameters);
+}
+
+double DisCoverageBulloStrategy::integrationRange() const
+{
+    return m_parameters.integrationRange;
+}
+
+void DisCoverageBulloStrategy::save(QSettings& config)
+{
+    config.beginGroup("dis-coverage-frontier-weights");
+    m_parameters.save(config);
+    config.endGroup();
+}
+
+void DisCoverageBulloStrategy::load(QSettings& config)
+{
+    DisCoverageBulloParameters parameters;
+    config.beginGroup("dis-coverage-frontier-weights");
+    parameters.load(config);
+    config.endGroup();
+
+    setParameters(parameters);
+}
+
+void DisCoverageBulloStrategy::exportObjectiveFunction(QTextStream& ts)
+{
+    const int dx = context()->map().size().width();
+    const int dy = context()->map().size().height();
+
+    QVector<qreal> values(dx * dy);
+    BulloTileTask task(this, integrationRange(), &values);
+    task.run(QRect(0, 0, dx, dy));
+
+    for (int b = 0; b < dy; ++b) {
+        for (int a = 0; a < dx; ++a) {
+            Cell c = context()->map().cell(a, b);
+            double y = context()->map().cell(dx-1, dy-1).center().y() - c.center().y();
+            if (c.state() == (Cell::Explored | Cell::Free)) {
+                ts << c.center().x() << " " << y << " " << -log(-values[b * dx + a]) << "\n";
+            } else {
+                ts << c.center().x() << " " << y << " " << "nan" << "\n";
+            }
+        }
+    }
+}
+
+void DisCoverageBulloStrategy::computeFitness(const QRect& tile, double range, QVector<qreal>& values)
+{
+    const int dx = context()->map().size().width();
+    for (int b = tile.top(); b <= tile.bottom(); ++b) {
+        for (int a = tile.left(); a <= tile.right(); ++a) {
+            Cell c = context()->map().cell(a, b);
+            if (c.state() == (Cell::Explored | Cell::Free)) {
+                QVector<Cell> visibleCells = context()->map().visibleCells(c.center(), range);
+                values[b * dx + a] = fitness(c.center(), visibleCells);
+            }
+        }
+    }
+}
+
+void DisCoverageBulloStrategy::reset()
+{
+    clearGradientCaches();
+}
+
+void DisCoverageBulloStrategy::clearGradientCaches()
+{
+    qDeleteAll(m_gradientCaches);
+    m_gradientCaches.clear();
+}
+
+qreal DisCoverageBulloStrategy::performance(const QPointF& p, const QPointF& q)
+{
+    const qreal dx = p.x() - q.x();
+    const qreal dy = p.y() - q.y();
+    const qreal squareDist = (dx * dx + dy * dy);
+    return -squareDist;
+}
+
+qreal DisCoverageBulloStrategy::fitness(const QPointF& robotPos, const QVector<Cell>& cells)
+{
+    qreal sum = 0;
+    foreach (const Cell& cell, cells) {
+        sum += performance(robotPos, cell.center()) * cell.density();
+    }
+    return sum;
+}
+
+QPointF DisCoverageBulloStrategy::gradient(Robot* robot, bool interpolate)
+{
+    if (interpolate) {
+        return interpolatedGradient(robot->position(), robot);
+    } else {
+        const double rint = context()->map().hasFrontiers(robot) ? integrationRange() : 1000000;
+        Robot* partition = context()->robotManager().count() > 1 ? robot : 0;
+        return gradient(robot->position(), visibleMoments(robot->position(), rint, partition));
+    }
+}
+
+DensityMoments DisCoverageBulloStrategy::visibleMoments(const QPointF& pos, double rint, Robot* robot)
+{
+    GridMap& m = context()->map();
+
+    // constant time without occlusion, see GridMap::densityMoments()
+    DensityMoments moments;
+    if (m.densityMoments(pos, rint, robot, moments)) {
+        return moments;
+    }
+
+    QVector<Cell> visibleCells = m.visibleCells(pos, rint);
+    if (robot) {
+        m.filterCells(visibleCells, robot);
+    }
+
+    foreach (const Cell& cell, visibleCells) {
+        moments.add(cell.center(), cell.density());
+    }
+    return moments;
+}
+
+QPointF DisCoverageBulloStrategy::gradient(const QPointF& robotPos, const DensityMoments& moments)
+{
+    // fitness = -sum(density * |p - q|^2), so grad = 2 * (sum(density * q) - p * sum(density))
+    QPointF grad(2.0 * (moments.x - robotPos.x() * moments.mass),
+                 2.0 * (moments.y - robotPos.y() * moments.mass));
+    if (!grad.isNull()) {
+        // normalize vector (1 sqrt)
+        const qreal len = sqrt(grad.x() * grad.x() + grad.y() * grad.y());
+        if (len < 0.0000001) {
+            grad = QPointF(0, 0);
+        } else {
+            grad /= len;
+        }
+    }
+    return grad;
+}
+
+QPointF DisCoverageBulloStrategy::interpolatedGradient(const QPointF& robotPos, Robot* robot)
+{
+    GridMap& m = context()->map();
+    QPoint cellIndex(m.worldToIndex(robotPos));
+
+    const double diffx = 1.0 - fabs(robotPos.x() - m.cell(cellIndex).center().x()) / context()->map().resolution();
+    const double diffy = 1.0 - fabs(robotPos.y() - m.cell(cellIndex).center().y()) / context()->map().resolution();
+
+    const int dx = (robotPos.x() < m.cell(cellIndex).center().x()) ? -1 : 1;
+    const int dy = (robotPos.y() < m.cell(cellIndex).center().y()) ? -1 : 1;
+
+    QPoint g00(cellIndex);
+    QPoint g01(g00);
+    QPoint g10(g00);
+    QPoint g11(g00);
+
+    if (m.isValidField(cellIndex + QPoint(dx, 0))) g01 = cellIndex + QPoint(dx, 0);
+    if (m.isValidField(cellIndex + QPoint(0, dy))) g10 = cellIndex + QPoint(0, dy);
+    if (m.isValidField(cellIndex + QPoint(dx,dy))) g11 = cellIndex + QPoint(dx, dy);
+
+    // repeated queries, e.g. of the preview trajectory, reuse the cell gradients
+    gradientCache(robot);
+    const double range = integrationRange();
+
+    QPointF grad00(cellGradient(robot, g00, range));
+    QPointF grad01(cellGradient(robot, g01, range));
+    QPointF grad10(cellGradient(robot, g10, range));
+    QPointF grad11(cellGradient(robot, g11, range));
+
+    QPointF gradX0(diffx * grad00 + (1 - diffx) * grad01);
+    QPointF gradX1(diffx * grad10 + (1 - diffx) * grad11);
+
+    QPointF grad(diffy * gradX0 + (1 - diffy) * gradX1);
+
+    return grad;
+}
+
+GradientCache& DisCoverageBulloStrategy::gradientCache(Robot* robot)
+{
+    GradientCache* cache = m_gradientCaches.value(robot);
+    if (!cache) {
+        cache = new GradientCache();
+        m_gradientCaches[robot] = cache;
+    }
+
+    // the density is an input, too
+    cache->validate(context()->map(), context()->map().densityRevision());
+    return *cache;
+}
+
+QPointF DisCoverageBulloStrategy::cellGradient(Robot* robot, const QPoint& cellIndex, double range)
+{
+    GridMap& m = context()->map();
+    GradientCache& cache = *m_gradientCaches.value(robot);
+    const int index = m.linearIndex(cellIndex.x(), cellIndex.y());
+
+    QPointF grad;
+    if (!cache.lookup(index, grad)) {
+        const double rint = m.hasFrontiers(robot) ? range : 1000000;
+        const QPointF center = m.cell(cellIndex).center();
+        grad = gradient(center, visibleMoments(center, rint, robot));
+        cache.store(index, grad);
+    }
+    return grad;
+}
+
+void DisCoverageBulloStrategy::tick()
+{
+}
+
+void DisCoverageBulloStrategy::postProcess()
+{
+    // compute geodesic Voronoi partition
+    context()->computeVoronoiPartition();
+
+    // update the frontier cache
+    context()->map().updateRobotFrontierCache();
+
+    // compute distance transform in each Voronoi cell with respect to the frontiers
+    context()->map().computeDistanceTransforms();
+
+    // now that each cell contains the correct distance to the frontier, update density
+    context()->map().updateDensity();
+
+    // compute vector field in each cell if needed
+    if (context()->config().showVectorField()) {
+        updateVectorField();
+    }
+}
+
+void DisCoverageBulloStrategy::updateVectorField()
+{
+    const int dx = context()->map().size().width();
+    const int dy = context()->map().size().height();
+
+    // the tiles fill the caches of all robots
+    prepareCaches();
+
+    BulloTileTask task(this, 0, integrationRange());
+    task.run(QRect(0, 0, dx, dy));
+}
+
+void DisCoverageBulloStrategy::prepareCaches()
+{
+    foreach (Robot* robot, m_gradientCaches.keys()) {
+        if (context()->robotManager().indexOf(robot) < 0) {
+            delete m_gradientCaches.take(robot);
+        }
+    }
+    for (int i = 0; i < context()->robotManager().count(); ++i) {
+        gradientCache(context()->robotManager().robot(i));
+    }
+}
+
+void DisCoverageBulloStrategy::updateVectorField(Robot* robot)
+{
+    Q_ASSERT(robot);
+
+    const int dx = context()->map().size().width();
+    const int dy = context()->map().size().height();
+
+    // robots run in parallel, so only validate the cache created by
+    // prepareCaches() and never insert into the hash
+    GradientCache* cache = m_gradientCaches.value(robot);
+    Q_ASSERT(cache);
+    cache->validate(context()->map(), context()->map().densityRevision());
+
+    BulloTileTask task(this, robot, integrationRange());
+    task.run(QRect(0, 0, dx, dy));
+}
+
+void DisCoverageBulloStrategy::updateVectorField(const QRect& tile, Robot* robot, double range)
+{
+    QPointF grad;
+
+    for (int a = tile.left(); a <= tile.right(); ++a) {
+        for (int b = tile.top(); b <= tile.bottom(); ++b) {
+            Cell c = context()->map().cell(a, b);
+            if (c.state() == (Cell::Explored | Cell::Free) && (!robot || c.robot() == robot)) {
+                if (c.robot() != 0) {
+                    // same value as the robot gets at the cell center
+                    grad = cellGradient(c.robot(), QPoint(a, b), range);
+                } else {
+                    grad = gradient(c.center(), visibleMoments(c.center(), range, 0));
+                }
+                c.setGradient(grad);
+            }
+        }
+    }
+}
+
+//END DisCoverageBulloStrategy
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,120 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_BULLO_STRATEGY_H
+#define DISCOVERAGE_BULLO_STRATEGY_H
+
+#include <QtCore/QPoint>
+#include <QtCore/QHash>
+#include "cell.h"
+#include "gridmap.h"
+#include "strategy.h"
+
+class SimulationContext;
+class GradientCache;
+
+/**
+ * Parameters of the DisCoverageBulloStrategy.
+ */
+struct DisCoverageBulloParameters
+{
+    DisCoverageBulloParameters();
+
+    void load(QSettings& config);
+    void save(QSettings& config) const;
+
+    double integrationRange;    // sensing range of the fitness integral [m]
+};
+
+/**
+ * Centroidal search: each robot moves towards the centroid of the density
+ * it sees in its Voronoi cell. DisCoverageStrategy and MinDistStrategy fall
+ * back to it for robots without frontiers.
+ */
+class DisCoverageBulloStrategy : public Strategy
+{
+    public:
+        DisCoverageBulloStrategy(SimulationContext* context);
+        virtual ~DisCoverageBulloStrategy();
+
+    public:
+        virtual void reset();
+        virtual void tick();
+        virtual void postProcess();
+
+        virtual QPointF gradient(Robot* robot, bool interpolate);
+        virtual QString name() const;
+
+        // serialization
+        virtual void load(QSettings& config);
+        virtual void save(QSettings& config);
+        virtual void exportObjectiveFunction(QTextStream& ts);
+
+        // udpate vector field only for one robot. If robots run in parallel,
+        // prepareCaches() must be called before.
+        void updateVectorField(Robot* robot);
+
+        // create the gradient caches of all robots and forget removed robots
+        void prepareCaches();
+
+        // update vector field for all explored cells
+        void updateVectorField();
+
+    public:
+        const DisCoverageBulloParameters& parameters() const;
+        void setParameters(const DisCoverageBulloParameters& parameters);
+
+        void setIntegrationRange(double range);
+        double integrationRange() const;
+
+    private:
+        friend class BulloTileTask;
+
+        // vector field of the explored cells in tile, only the cells of robot if given
+        void updateVectorField(const QRect& tile, Robot* robot, double range);
+        // fitness of the explored cells in tile, nan for all other cells
+        void computeFitness(const QRect& tile, double range, QVector<qreal>& values);
+
+        // exact gradient of fitness() from the density moments of the cells
+        QPointF gradient(const QPointF& robotPos, const DensityMoments& moments);
+        QPointF interpolatedGradient(const QPointF& robotPos, Robot* robot);
+
+        // moments of the cells visible from pos within rint, restricted to the
+        // Voronoi cell of robot if given
+        DensityMoments visibleMoments(const QPointF& pos, double rint, Robot* robot);
+
+        // gradient of robot at the center of a cell, computed on demand. The
+        // cache must be validated with gradientCache() before.
+        QPointF cellGradient(Robot* robot, const QPoint& cellIndex, double range);
+        GradientCache& gradientCache(Robot* robot);
+        void clearGradientCaches();
+
+        qreal performance(const QPointF& p, const QPointF& q);
+        qreal fitness(const QPointF& robotPos, const QVector<Cell>& cells);
+
+    private:
+        DisCoverageBulloParameters m_parameters;
+
+        // cell gradients of each robot, restricted to its Voronoi cell
+        QHash<Robot*, GradientCache*> m_gradientCaches;
+};
+
+#endif // DISCOVERAGE_BULLO_STRATEGY_H
+
+// kate: replace-tabs on; indent-width 4;
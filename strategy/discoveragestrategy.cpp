@@ -0,0 +1,502 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#define _USE_MATH_DEFINES 
+#include <math.h>
+
+#include "discoveragestrategy.h"
+#include "simulationcontext.h"
+#include "robot.h"
+#include "robotmanager.h"
+#include "config.h"
+#include "bullostrategy.h"
+#include "frontiersegmentation.h"
+#include "robottask.h"
+#include "fastmath.h"
+
+#include <qglobal.h> // qFuzzyCompare
+
+#include <QtCore/QDebug>
+#include <QtCore/QSettings>
+
+//BEGIN DisCoverageParameters
+DisCoverageParameters::DisCoverageParameters()
+    : theta(0.5)
+    , sigma(2.0)
+    , followLocalOptimum(true)
+    , autoAdaptSigma(false)
+{
+}
+
+void DisCoverageParameters::load(QSettings& config)
+{
+    theta = config.value("theta", 0.5).toDouble();
+    sigma = config.value("sigma", 2.0).toDouble();
+    followLocalOptimum = config.value("local-optimum", true).toBool();
+    autoAdaptSigma = config.value("auto-dist", false).toBool();
+}
+
+void DisCoverageParameters::save(QSettings& config) const
+{
+    config.setValue("theta", theta);
+    config.setValue("sigma", sigma);
+    config.setValue("local-optimum", followLocalOptimum);
+    config.setValue("auto-dist", autoAdaptSigma);
+}
+//END DisCoverageParameters
+
+//BEGIN DisCoverageStrategy
+DisCoverageStrategy::DisCoverageStrategy(SimulationContext* context, DisCoverageBulloStrategy* centroidalSearch)
+    : Strategy(context)
+    , m_centroidalSearch(centroidalSearch)
+{
+}
+
+DisCoverageStrategy::~DisCoverageStrategy()
+{
+}
+
+QString DisCoverageStrategy::name() const
+{
+    return QString("DisCoverage-orient-");
+}
+
+const DisCoverageParameters& DisCoverageStrategy::parameters() const
+{
+    return m_parameters;
+}
+
+void DisCoverageStrategy::setParameters(const DisCoverageParameters& parameters)
+{
+    m_parameters = parameters;
+}
+
+void DisCoverageStrategy::setOpeningAngleStdDeviation(double theta)
+{
+    m_parameters.theta = theta;
+}
+
+double DisCoverageStrategy::openingAngleStdDeviation() const
+{
+    return m_parameters.theta;
+}
+
+void DisCoverageStrategy::setAutoAdaptDistanceStdDeviation(bool autoAdapt)
+{
+    m_parameters.autoAdaptSigma = autoAdapt;
+}
+
+bool DisCoverageStrategy::autoAdaptDistanceStdDeviation() const
+{
+    return m_parameters.autoAdaptSigma;
+}
+
+void DisCoverageStrategy::setDistanceStdDeviation(double sigma)
+{
+    m_parameters.sigma = sigma;
+}
+
+double DisCoverageStrategy::distanceStdDeviation() const
+{
+    return m_parameters.sigma;
+}
+
+void DisCoverageStrategy::setFollowLocalOptimum(bool localOptimum)
+{
+    m_parameters.followLocalOptimum = localOptimum;
+}
+
+bool DisCoverageStrategy::followLocalOptimum() const
+{
+    return m_parameters.followLocalOptimum;
+}
+
+void DisCoverageStrategy::save(QSettings& config)
+{
+    config.beginGroup("dis-coverage");
+    m_parameters.save(config);
+    config.endGroup();
+}
+
+void DisCoverageStrategy::load(QSettings& config)
+{
+    config.beginGroup("dis-coverage");
+    m_parameters.load(config);
+    config.endGroup();
+}
+
+void DisCoverageStrategy::updateVectorField()
+{
+    // FIXME: this is slow: compute for all explored free cells the shortest paths
+    //        to all frontiers. Then pick the shortest one, and set the gradient
+    //        according to direction of the first path segment
+    const int count = context()->robotManager().count();
+
+    if (count > 0) {
+        // each robot only writes the cells of its Voronoi cell. The frontier
+        // segments are split lazily, so do it before the robots run in parallel.
+        context()->map().frontierSegments();
+
+        // the robots must not insert into the hashes while running in parallel
+        prepareCaches();
+
+        // robots without frontiers fall back to the centroidal search
+        m_centroidalSearch->prepareCaches();
+
+        RobotMethodTask<DisCoverageStrategy> task(this, &DisCoverageStrategy::updateVectorField);
+        task.run(context()->map().robots());
+    } else {
+        updateVectorField(0);
+    }
+}
+
+void DisCoverageStrategy::updateVectorField(Robot* robot)
+{
+    const int dx = context()->map().size().width();
+    const int dy = context()->map().size().height();
+    const QList<Cell> frontiers = context()->map().frontiers(robot);
+
+    // iterate over all free explored cells
+    for (int a = 0; a < dx; ++a) {
+        for (int b = 0; b < dy; ++b) {
+            Cell c = context()->map().cell(a, b);
+            if (robot && robot != c.robot())
+                continue;
+
+            if (c.state() != (Cell::Explored | Cell::Free))
+                continue;
+
+            c.setGradient(gradient(robot, c.center()));
+        }
+    }
+
+    // fallback to centroidal search if no frontiers exist
+    if (robot && !context()->map().hasFrontiers(robot)) {
+        m_centroidalSearch->updateVectorField(robot);
+    }
+}
+
+void DisCoverageStrategy::reset()
+{
+    m_eikonalFields.clear();
+    m_objectives.clear();
+}
+
+void DisCoverageStrategy::tick()
+{
+}
+
+void DisCoverageStrategy::postProcess()
+{
+    // compute geodesic Voronoi partition
+    context()->computeVoronoiPartition();
+
+    // update the frontier cache
+    context()->map().updateRobotFrontierCache();
+
+    // compute vector field in each cell if needed
+    if (context()->config().showVectorField()) {
+        updateVectorField();
+    }
+}
+
+QPointF DisCoverageStrategy::gradient(Robot* robot, bool interpolate)
+{
+    // no frontiers: fallback to centroidal search-based DisCoverage
+    if (!context()->map().hasFrontiers(robot)) {
+        return m_centroidalSearch->gradient(robot, interpolate);
+    }
+
+    const bool enableInterpolation = false;
+    if (enableInterpolation && interpolate) {
+        return interpolatedGradient(robot);
+    } else {
+        const double orientation = robot->orientation();
+        return gradient(orientationObjective(robot), robot->hasOrientation() ? &orientation : 0);
+    }
+}
+
+QPointF DisCoverageStrategy::interpolatedGradient(Robot* robot)
+{
+    const QPointF robotPos = robot->position();
+    GridMap& m = context()->map();
+    QPoint cellIndex(m.worldToIndex(robotPos));
+
+    // generate 4 samplings points in adjacent cell centers
+    const double diffx = 1.0 - fabs(robotPos.x() - m.cell(cellIndex).center().x()) / context()->map().resolution();
+    const double diffy = 1.0 - fabs(robotPos.y() - m.cell(cellIndex).center().y()) / context()->map().resolution();
+
+    const int dx = (robotPos.x() < m.cell(cellIndex).center().x()) ? -1 : 1;
+    const int dy = (robotPos.y() < m.cell(cellIndex).center().y()) ? -1 : 1;
+
+    QPointF g00(m.cell(cellIndex).center());
+    QPointF g01(g00);
+    QPointF g10(g00);
+    QPointF g11(g00);
+
+    if (m.isValidField(cellIndex + QPoint(dx, 0))) g01 = (m.cell(cellIndex + QPoint(dx, 0)).center());
+    if (m.isValidField(cellIndex + QPoint(0, dy))) g10 = (m.cell(cellIndex + QPoint(0, dy)).center());
+    if (m.isValidField(cellIndex + QPoint(dx,dy))) g11 = (m.cell(cellIndex + QPoint(dx, dy)).center());
+
+    // get robot orientation, if available
+    double orientation = robot->orientation();
+    double* pOrientation = robot->hasOrientation() ? (&orientation) : 0;
+
+    // compute gradients in all 4 sampling points
+    QPointF grad00(gradient(robot, g00, pOrientation, true)); // first time, allow to auto adjust distance component
+    QPointF grad01(gradient(robot, g01, pOrientation));
+    QPointF grad10(gradient(robot, g10, pOrientation));
+    QPointF grad11(gradient(robot, g11, pOrientation));
+
+    // interpolate: compute linear combination
+    QPointF gradX0(diffx * grad00 + (1 - diffx) * grad01);
+    QPointF gradX1(diffx * grad10 + (1 - diffx) * grad11);
+
+    QPointF grad(diffy * gradX0 + (1 - diffy) * gradX1);
+
+    // return gradient
+    return grad;
+}
+
+QPointF DisCoverageStrategy::gradient(Robot* robot, const QPointF& robotPos, const double* startOrientation, bool adjustDistanceComponent)
+{
+    OrientationObjective objective;
+    computeObjective(robot, robotPos, adjustDistanceComponent, objective);
+    return gradient(objective, startOrientation);
+}
+
+void DisCoverageStrategy::computeObjective(Robot* robot, const QPointF& robotPos, bool adjustDistanceComponent, OrientationObjective& objective)
+{
+    GridMap& m = context()->map();
+
+    objective.clear();
+
+    // each frontier segment counts as often as it has cells
+    const QList<FrontierSegment> segments = m.frontierSegments(robot);
+    if (segments.size() == 0) {
+        objective.update(openingAngleStdDeviation());
+        return;
+    }
+
+    // The fields accumulate cell costs. Through explored free cells each
+    // cell costs freeCost, so distance / freeCost is the path length in cells.
+    const float freeCost = Cell::cellCost(static_cast<Cell::State>(Cell::Explored | Cell::Free));
+
+    // With a fixed sigma, frontiers beyond 3 sigma contribute less than
+    // exp(-4.5) each and the distance fields stop there.
+    const float maxCost = (autoAdaptDistanceStdDeviation() && adjustDistanceComponent)
+        ? -1.0f : 3.0 * distanceStdDeviation() / m.resolution() * freeCost;
+
+    const QList<EikonalField>& fields = eikonalFields(robot, segments, maxCost);
+
+    // geodesic length and start direction of the shortest path to each segment
+    QVector<double> lengths(segments.size(), -1.0);
+    QVector<QPointF> directions(segments.size());
+    double shortestPath = 1000000000.0;
+    for (int i = 0; i < segments.size(); ++i) {
+        const float distance = fields[i].distance(robotPos);
+        if (distance < 0.0f)
+            continue;
+
+        lengths[i] = distance / freeCost * m.resolution();
+        directions[i] = fields[i].descent(robotPos);
+        if (lengths[i] < shortestPath) {
+            shortestPath = lengths[i];
+        }
+    }
+
+    // robots may run in parallel, views show the new sigma after postProcess()
+    if (autoAdaptDistanceStdDeviation() && adjustDistanceComponent) {
+        m_parameters.sigma = shortestPath;
+    }
+
+    // disCoverage() is the Gaussian of the opening angle around the start
+    // direction of a path, scaled by the distance component. The objective
+    // convolves the distance components with the Gaussian.
+    const double sigma = distanceStdDeviation();
+    QVector<int> reached;
+    QVector<float> exponents;
+    QVector<float> dy;
+    QVector<float> dx;
+    for (int i = 0; i < segments.size(); ++i) {
+        if (directions[i].isNull() || lengths[i] < 0.0)
+            continue;
+
+        reached.append(i);
+        exponents.append(-lengths[i]*lengths[i]/(2.0*sigma*sigma));
+        dy.append(directions[i].y());
+        dx.append(directions[i].x());
+    }
+
+    // distance components and angles of all segments in one pass each
+    const int count = reached.size();
+    QVector<float> weights(count);
+    QVector<float> angles(count);
+    FastMath::exp(exponents.constData(), weights.data(), count);
+    FastMath::atan2(dy.constData(), dx.constData(), angles.data(), count);
+
+    for (int j = 0; j < count; ++j) {
+        objective.addDirection(angles[j], segments[reached[j]].m_weight * weights[j]);
+    }
+
+    objective.update(openingAngleStdDeviation());
+}
+
+QPointF DisCoverageStrategy::gradient(const OrientationObjective& objective, const double* startOrientation)
+{
+    QVector<QPointF> deltaPoints = objective.curve(0.1);
+
+    double sMax = 0.0;
+    double deltaMax = 0.0;
+    foreach (const QPointF& point, deltaPoints) {
+        if (point.y() > sMax) {
+            sMax = point.y();
+            deltaMax = point.x();
+        }
+    }
+
+    // follow local optimum
+    if (followLocalOptimum() && startOrientation) {
+        int i;
+        for (i = 0; i < deltaPoints.size(); ++i) {
+            if (qFuzzyCompare(deltaPoints[i].x(), *startOrientation))
+                break;
+        }
+
+        // first time m_delta == 0.0, so no index found
+        if (deltaPoints.size() == i) {
+//             qDebug() << "found no correct orientation!";
+            i = 0;
+        }
+
+        const int n = deltaPoints.size();
+        int c = 0; // avoid infinite loop
+        while (deltaPoints[i].y() <= deltaPoints[(i + 1) % n].y() && c < n) {
+            i = (i + 1) % n;
+            ++c;
+        }
+
+        c = 0;
+        while (deltaPoints[i].y() <= deltaPoints[(i - 1 + n) % n].y() && c < n) {
+            i = (i - 1 + n) % n;
+            ++c;
+        }
+
+        deltaMax = deltaPoints[i].x();
+    }
+
+    return QPointF(cos(deltaMax), sin(deltaMax));
+}
+
+double DisCoverageStrategy::disCoverage(double delta, const QPointF& direction, double length)
+{
+    if (direction.isNull() || length < 0.0) {
+        return 0.0f;
+    }
+
+    const double theta = openingAngleStdDeviation();
+    const double sigma = distanceStdDeviation();
+
+    float alpha = - delta + FastMath::atan2(direction.y(), direction.x());
+
+    if (alpha > M_PI) alpha -= 2 * M_PI;
+    else if (alpha < -M_PI) alpha += 2 * M_PI;
+
+    return FastMath::exp(- alpha*alpha/(2.0*theta*theta)
+                         - length*length/(2.0*sigma*sigma));
+}
+
+const QList<EikonalField>& DisCoverageStrategy::eikonalFields(Robot* robot, const QList<FrontierSegment>& segments, float maxCost)
+{
+    GridMap& m = context()->map();
+
+    // the fields of one robot are only used by one thread. While robots run
+    // in parallel, prepareCaches() created all entries, so nothing is
+    // inserted and the references stay valid.
+    QHash<Robot*, QList<EikonalField> >::iterator it = m_eikonalFields.find(robot);
+    if (it == m_eikonalFields.end()) {
+        it = m_eikonalFields.insert(robot, QList<EikonalField>());
+    }
+    QList<EikonalField>& fields = it.value();
+    while (fields.size() > segments.size()) {
+        fields.removeLast();
+    }
+    while (fields.size() < segments.size()) {
+        fields.append(EikonalField());
+    }
+
+    for (int i = 0; i < segments.size(); ++i) {
+        if (!fields[i].isUpToDate(m, segments[i].m_cells, maxCost)) {
+            m.computeEikonalField(fields[i], segments[i].m_cells, maxCost);
+        }
+    }
+
+    return fields;
+}
+
+void DisCoverageStrategy::prepareCaches()
+{
+    foreach (Robot* robot, m_eikonalFields.keys()) {
+        if (robot && context()->robotManager().indexOf(robot) < 0) {
+            m_eikonalFields.remove(robot);
+        }
+    }
+    foreach (Robot* robot, context()->map().robots()) {
+        if (!m_eikonalFields.contains(robot)) {
+            m_eikonalFields.insert(robot, QList<EikonalField>());
+        }
+    }
+}
+DisCoverageStrategy::SharedObjective::SharedObjective()
+    : revision(0)
+    , partitionRevision(0)
+    , theta(-1.0)
+    , sigma(-1.0)
+    , autoAdapt(false)
+{
+}
+
+const OrientationObjective& DisCoverageStrategy::orientationObjective(Robot* robot)
+{
+    GridMap& m = context()->map();
+    SharedObjective& shared = m_objectives[robot];
+
+    // an auto adapted sigma is the same as long as everything else is
+    if (shared.revision != m.revision()
+        || shared.partitionRevision != m.partitionRevision()
+        || shared.position != robot->position()
+        || shared.theta != openingAngleStdDeviation()
+        || shared.sigma != distanceStdDeviation()
+        || shared.autoAdapt != autoAdaptDistanceStdDeviation())
+    {
+        computeObjective(robot, robot->position(), true, shared.objective);
+
+        shared.revision = m.revision();
+        shared.partitionRevision = m.partitionRevision();
+        shared.position = robot->position();
+        shared.theta = openingAngleStdDeviation();
+        shared.sigma = distanceStdDeviation();
+        shared.autoAdapt = autoAdaptDistanceStdDeviation();
+    }
+
+    return shared.objective;
+}
+//END DisCoverageStrategy
+
+// kate: replace-tabs on; indent-width 4;
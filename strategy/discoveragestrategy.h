@@ -0,0 +1,140 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_DISCOVERAGE_STRATEGY_H
+#define DISCOVERAGE_DISCOVERAGE_STRATEGY_H
+
+#include <QtCore/QPoint>
+#include <QtCore/QHash>
+#include "cell.h"
+#include "gridmap.h"
+#include "eikonalfield.h"
+#include "orientationobjective.h"
+#include "strategy.h"
+
+class SimulationContext;
+class DisCoverageBulloStrategy;
+class FrontierSegment;
+
+/**
+ * Parameters of the DisCoverageStrategy. The dock widget of the
+ * DisCoverageHandler only mirrors them, so the objective never reads
+ * widgets and works without a GUI.
+ */
+struct DisCoverageParameters
+{
+    DisCoverageParameters();
+
+    void load(QSettings& config);
+    void save(QSettings& config) const;
+
+    double theta;               // std deviation of the opening angle
+    double sigma;               // std deviation of the path length
+    bool followLocalOptimum;
+    bool autoAdaptSigma;        // sigma = length of the robot's shortest path
+};
+
+/**
+ * Orientation-based DisCoverage: each robot heads into the start direction
+ * that maximizes the frontiers weighted by opening angle and path length.
+ * Robots without frontiers fall back to the centroidal search.
+ */
+class DisCoverageStrategy : public Strategy
+{
+    public:
+        DisCoverageStrategy(SimulationContext* context, DisCoverageBulloStrategy* centroidalSearch);
+        virtual ~DisCoverageStrategy();
+
+        // direction: unit vector of the path start, length: geodesic path length
+        double disCoverage(double delta, const QPointF& direction, double length);
+
+        // distance fields of the frontier segments of robot, recomputed if the
+        // map changed. If robots run in parallel, prepareCaches() must be
+        // called before.
+        const QList<EikonalField>& eikonalFields(Robot* robot, const QList<FrontierSegment>& segments, float maxCost = -1.0f);
+
+        // objective over the start orientation at the position of robot, shared
+        // by gradient() and the OrientationPlotter until the map, the robot or
+        // the parameters change
+        const OrientationObjective& orientationObjective(Robot* robot);
+
+        const DisCoverageParameters& parameters() const;
+        void setParameters(const DisCoverageParameters& parameters);
+
+        void setOpeningAngleStdDeviation(double theta);
+        double openingAngleStdDeviation() const;
+
+        void setAutoAdaptDistanceStdDeviation(bool autoAdapt);
+        bool autoAdaptDistanceStdDeviation() const;
+
+        void setFollowLocalOptimum(bool localOptimum);
+        bool followLocalOptimum() const;
+
+        void setDistanceStdDeviation(double sigma);
+        double distanceStdDeviation() const;
+
+    public:
+        virtual void reset();
+        virtual void tick();
+        virtual void postProcess();
+
+        virtual void load(QSettings& config);
+        virtual void save(QSettings& config);
+
+        virtual QPointF gradient(Robot* robot, bool interpolate);
+        virtual QString name() const;
+
+    private:
+        void updateVectorField();
+        void updateVectorField(Robot* robot);
+
+        QPointF interpolatedGradient(Robot* robot);
+        QPointF gradient(Robot* robot, const QPointF& robotPos, const double* startOrientation = 0, bool adjustDistanceComponent = false);
+        QPointF gradient(const OrientationObjective& objective, const double* startOrientation);
+        void computeObjective(Robot* robot, const QPointF& robotPos, bool adjustDistanceComponent, OrientationObjective& objective);
+
+    private:
+        DisCoverageParameters m_parameters;
+
+        DisCoverageBulloStrategy* m_centroidalSearch;
+
+        // create the distance field lists of all robots and forget removed robots
+        void prepareCaches();
+
+        // one field per frontier segment of each robot
+        QHash<Robot*, QList<EikonalField> > m_eikonalFields;
+
+        struct SharedObjective
+        {
+            SharedObjective();
+
+            quint32 revision;
+            quint32 partitionRevision;
+            QPointF position;
+            double theta;
+            double sigma;
+            bool autoAdapt;
+            OrientationObjective objective;
+        };
+        QHash<Robot*, SharedObjective> m_objectives;
+};
+
+#endif // DISCOVERAGE_DISCOVERAGE_STRATEGY_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,181 @@
+#include "maxareastrategy.h"
+#include "robot.h"
+#include "simulationcontext.h"
+#include "config.h"
+#include "robotmanager.h"
+
+#include <iostream>
+#include <QtCore/QList>
+#include <cmath>
+
+MaxAreaStrategy::MaxAreaStrategy(SimulationContext* context): Strategy(context)
+{
+}
+
+void MaxAreaStrategy::tick()
+{
+    Strategy::tick();
+}
+
+QString MaxAreaStrategy::name() const
+{
+    return QString("MaxArea");
+}
+
+void MaxAreaStrategy::postProcess()
+{
+    Strategy::postProcess();
+	
+    // update the frontier cache
+    context()->map().updateRobotFrontierCache();
+	
+	if (context()->config().showVectorField()) {
+        // updateVectorField();
+    }
+}
+
+void MaxAreaStrategy::updateVectorField() {
+    const int dx = context()->map().size().width();
+    const int dy = context()->map().size().height();
+    const QList<Cell> frontiers = context()->map().frontiers(0);
+
+    // iterate over all free explored cells
+    for (int a = 0; a < dx; ++a) {
+		GridMap &m = context()->map();
+        for (int b = 0; b < dy; ++b) {
+            Cell c = m.cell(a, b);
+
+            if (c.state() != (Cell::Explored | Cell::Free))
+                continue;
+
+            c.setGradient(gradient(0, c.center()));
+        }
+    }
+}
+
+QPointF MaxAreaStrategy::gradient(Robot* robot, bool interpolate)
+{
+	return gradient(robot, robot->position());
+}
+
+QPointF MaxAreaStrategy::gradient(Robot* robot, const QPointF& robotPos) {
+	if (!robot) {
+		robot = context()->robotManager().activeRobot();
+	}
+    GridMap& m = context()->map();
+	double max = 0, x;
+	QPoint cell;
+	QList<Cell> front = m.frontiers(robot);
+	
+	/* include explored area?
+	for (int i = 0; i < m.size().width(); ++i) {
+		for (int j = 0; j < m.size().height(); ++j) {
+			if ((m.cell(i, j).state() & (Cell::Free | Cell::Explored)) == (Cell::Free | Cell::Explored)) {
+				double dist = computeDistance(m.cell(i, j).center(), robotPos);
+				if (dist > 1) {
+					front.append(m.cell(i, j));
+				}
+			}
+		}
+	}
+	*/
+	/*
+	QVector<Cell> visibleArea = m.visibleCells(robot->position(), robot->sensingRange());
+	m.filterCells(visibleArea, robot);
+	for (int i = 0; i < visibleArea.size(); ) {
+		if (visibleArea[i].isObstacle()) {
+			visibleArea.remove(i);
+		}
+		else {
+			++i;
+		}
+	}
+	front.append(QList<Cell>::fromVector(visibleArea));
+	*/
+	if (front.empty())
+	{
+		std::cout << "empty" << std::endl;
+		return QPointF();
+	}
+	QPoint pt = m.worldToIndex(robotPos);
+    const QVector<PathSummary> allPaths = m.anyAngleFrontierSummaries(pt, front);
+	
+	const PathSummary* favSummary = &allPaths[0];
+// 	std::cout << "###########################################################" << std::endl;
+    for (int i = 0; i < allPaths.size(); ++i) {
+		cell = allPaths[i].m_target;
+		double length = allPaths[i].m_length;
+		int size = m.numVisibleCellsUnrestricted(m.cell(cell).center(), robot->sensingRange());
+		x = size / std::pow(length, 1.5);
+// 			std::cout << "cell: [" << cell.x() << ";" << cell.y() << "] size: " << size << " length: " << length << " x: " << x << std::endl;
+		if(x > max) {
+			max = x;
+			favSummary = &allPaths[i];
+		}
+    }
+
+    // only the chosen path is needed in full, from the same search
+    const Path fav = m.anyAnglePath(favSummary->m_target);
+    const Path* favPath = &fav;
+    
+    // vector field creation for path
+    {
+		const int dx = context()->map().size().width();
+		const int dy = context()->map().size().height();
+		GridMap &m = context()->map();
+		for (int a = 0; a < dx; ++a) {
+			for (int b = 0; b < dy; ++b) {
+				m.cell(a, b).setGradient(QPointF());
+			}
+		}
+		for (int i = 1; i < favPath->m_path.size(); ++i) {
+			Cell c = m.cell(favPath->m_path[i-1]);
+			QPointF cellGrad = favPath->m_path[i] - favPath->m_path[i-1];
+			double length = sqrt(cellGrad.x()*cellGrad.x() + cellGrad.y()*cellGrad.y());
+			QPointF cellGradNorm = cellGrad / length;
+			for (int j = 1; j < length; ++j) {
+				Cell c2 = m.cell((favPath->m_path[i-1] + (j * cellGradNorm)).toPoint());
+				c2.setGradient(cellGradNorm);
+			}
+			c.setGradient(cellGradNorm);
+		}
+	}
+	
+	QPointF grad = favPath->m_path[1] - m.worldToIndex(robotPos);
+	grad = grad / sqrt(grad.x()*grad.x() + grad.y()*grad.y());
+	return grad;
+}
+
+double MaxAreaStrategy::explorationPotential(GridMap& m, QPoint position, int radius)
+{
+	double result = 0.0;
+	
+	if (m.isValidField(position))
+	{
+		return 0.0;
+	}
+	
+	int xStart = position.x() - radius;
+	int xEnd = position.x() + radius;
+	int yStart = position.y() - radius;
+	int yEnd = position.y() + radius;
+	
+	for ( int a = xStart; a <= xEnd; ++a) {
+		for (int b = yStart; b <= yEnd; ++b) {
+			if (m.isValidField(a, b)) {
+				
+			}
+			else {
+				
+			}
+		}
+	}
+	return result;
+}
+
+double MaxAreaStrategy::computeDistance(QPointF arg1, QPointF arg2)
+{
+	QPointF vect = arg2 - arg1;
+	return sqrt (vect.x() * vect.x() + vect.y() * vect.y());
+}
+
@@ -0,0 +1,33 @@
+#ifndef MAXAREASTRATEGY_H
+#define MAXAREASTRATEGY_H
+
+
+#include "strategy.h"
+#include "gridmap.h"
+
+#include <QtCore/QPoint>
+
+
+
+class MaxAreaStrategy : public Strategy
+{
+public:
+    MaxAreaStrategy(SimulationContext* context);
+
+    virtual void tick();
+    virtual void postProcess();
+    virtual QPointF gradient(Robot* robot, bool interpolate);
+	
+	virtual QPointF gradient(Robot* robot, const QPointF& robotPos);
+	
+	virtual void updateVectorField();
+	
+	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
+	
+    virtual QString name() const;
+	
+private:
+    double computeDistance(QPointF arg1, QPointF arg2);
+};
+
+#endif // MAXAREASTRATEGY_H
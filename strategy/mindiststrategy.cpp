@@ -0,0 +1,280 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "mindiststrategy.h"
+#include "simulationcontext.h"
+#include "robot.h"
+#include "robotmanager.h"
+#include "config.h"
+#include "bullostrategy.h"
+#include "incrementalplanner.h"
+#include "robottask.h"
+#include "gradientcache.h"
+
+#include <QtCore/QDebug>
+
+#include <math.h>
+
+//BEGIN MinDistStrategy
+MinDistStrategy::MinDistStrategy(SimulationContext* context, DisCoverageBulloStrategy* centroidalSearch)
+    : Strategy(context)
+    , m_centroidalSearch(centroidalSearch)
+{
+}
+
+MinDistStrategy::~MinDistStrategy()
+{
+    qDeleteAll(m_frontierPlanners);
+    qDeleteAll(m_gradientCaches);
+}
+
+QString MinDistStrategy::name() const
+{
+    return QString("MinDist");
+}
+
+void MinDistStrategy::reset()
+{
+    qDeleteAll(m_frontierPlanners);
+    m_frontierPlanners.clear();
+    qDeleteAll(m_gradientCaches);
+    m_gradientCaches.clear();
+}
+
+void MinDistStrategy::tick()
+{
+}
+
+void MinDistStrategy::postProcess()
+{
+    // compute geodesic Voronoi partition
+    context()->computeVoronoiPartition();
+
+    // update the frontier cache
+    context()->map().updateRobotFrontierCache();
+
+    // forget the planners and gradients of removed robots
+    foreach (Robot* robot, m_frontierPlanners.keys()) {
+        if (robot && context()->robotManager().indexOf(robot) < 0) {
+            delete m_frontierPlanners.take(robot);
+        }
+    }
+    foreach (Robot* robot, m_gradientCaches.keys()) {
+        if (robot && context()->robotManager().indexOf(robot) < 0) {
+            delete m_gradientCaches.take(robot);
+        }
+    }
+
+    // show density if wanted, needs distance transform
+    if (context()->config().showDensity()) {
+        context()->map().computeDistanceTransforms();
+        context()->map().updateDensity();
+    }
+
+    // compute vector field in each cell if needed
+    if (context()->config().showVectorField()) {
+        updateVectorField();
+    }
+}
+
+void MinDistStrategy::updateVectorField()
+{
+    const int count = context()->robotManager().count();
+    
+    if (count >= 1) {
+        // creating a planner registers it with the map, so do it before the
+        // robots run in parallel, same for the caches. Each robot only writes
+        // its Voronoi cell.
+        for (int r = 0; r < count; ++r) {
+            Robot* robot = context()->robotManager().robot(r);
+            if (context()->map().hasFrontiers(robot)) {
+                frontierPlanner(robot);
+                gradientCache(robot);
+            }
+        }
+
+        // robots without frontiers fall back to the centroidal search
+        m_centroidalSearch->prepareCaches();
+
+        RobotMethodTask<MinDistStrategy> task(this, &MinDistStrategy::updateVectorField);
+        task.run(context()->map().robots());
+    } else {
+        gradientCache(0);
+        updateVectorField(0);
+    }
+}
+
+void MinDistStrategy::updateVectorField(Robot* robot)
+{
+    // fallback to centroidal search if no frontiers exist
+    if (robot && !context()->map().hasFrontiers(robot)) {
+        m_centroidalSearch->updateVectorField(robot);
+        return;
+    }
+
+    // the gradient of each cell points to the first corner of the
+    // beautified shortest path to the nearest frontier
+    GridMap& m = context()->map();
+    IncrementalPlanner& planner = frontierPlanner(robot);
+    const int dx = m.size().width();
+    const int dy = m.size().height();
+    for (int b = 0; b < dy; ++b) {
+        for (int a = 0; a < dx; ++a) {
+            Cell c = m.cell(a, b);
+            if (robot && robot != c.robot())
+                continue;
+
+            if (c.state() != (Cell::Explored | Cell::Free))
+                continue;
+
+            c.setGradient(cellGradient(robot, planner, QPoint(a, b)));
+        }
+    }
+}
+
+GradientCache& MinDistStrategy::gradientCache(Robot* robot)
+{
+    GradientCache* cache = m_gradientCaches.value(robot);
+    if (!cache) {
+        cache = new GradientCache();
+        m_gradientCaches[robot] = cache;
+    }
+
+    cache->validate(context()->map());
+    return *cache;
+}
+
+QPointF MinDistStrategy::cellGradient(Robot* robot, IncrementalPlanner& planner, const QPoint& cellIndex)
+{
+    GridMap& m = context()->map();
+    GradientCache& cache = *m_gradientCaches.value(robot);
+    const int index = m.linearIndex(cellIndex.x(), cellIndex.y());
+
+    QPointF grad;
+    if (!cache.lookup(index, grad)) {
+        grad = gradient(m.cell(cellIndex).center(), planner);
+        cache.store(index, grad);
+    }
+    return grad;
+}
+
+IncrementalPlanner& MinDistStrategy::frontierPlanner(Robot* robot)
+{
+    GridMap& m = context()->map();
+
+    // the planner of a deleted map is useless
+    IncrementalPlanner* planner = m_frontierPlanners.value(robot);
+    if (planner && planner->map() != &m) {
+        delete planner;
+        planner = 0;
+    }
+
+    if (!planner) {
+        planner = new IncrementalPlanner(&m, IncrementalPlanner::ToSources);
+        m_frontierPlanners[robot] = planner;
+    }
+
+    // only repairs what changed since the last call
+    planner->setSources(m.frontiers(robot));
+    planner->update();
+
+    return *planner;
+}
+
+QPointF MinDistStrategy::gradient(Robot* robot, bool interpolate)
+{
+    // no frontiers: fallback to centroidal search-based DisCoverage
+    if (!context()->map().hasFrontiers(robot)) {
+        return m_centroidalSearch->gradient(robot, interpolate);
+    }
+
+    if (interpolate) {
+        return interpolatedGradient(robot->position(), robot);
+    } else {
+        return gradient(robot->position(), frontierPlanner(robot));
+    }
+}
+
+QPointF MinDistStrategy::gradient(const QPointF& robotPos, IncrementalPlanner& planner)
+{
+    GridMap& m = context()->map();
+    const QPoint startIndex = m.worldToIndex(robotPos);
+    if (!m.isValidField(startIndex)) {
+        return QPointF(0, 0);
+    }
+
+    const QPoint waypoint = planner.waypoint(startIndex);
+    if (waypoint == startIndex) {
+        return QPointF(0, 0);
+    }
+
+    const QPointF cellCenter = m.cell(waypoint).rect().center();
+
+    // pos is continuous robot position
+    // cellCenter is center of 2nd path cell
+    const double dx = cellCenter.x() - robotPos.x();
+    const double dy = cellCenter.y() - robotPos.y();
+
+    QPointF grad(dx, dy);
+    if (!grad.isNull()) {
+        grad /= sqrt(grad.x()*grad.x() + grad.y()*grad.y());
+    }
+
+    return grad;
+}
+
+QPointF MinDistStrategy::interpolatedGradient(const QPointF& robotPos, Robot* robot)
+{
+    GridMap& m = context()->map();
+    QPoint cellIndex(m.worldToIndex(robotPos));
+
+    const double diffx = 1.0 - fabs(robotPos.x() - m.cell(cellIndex).center().x()) / context()->map().resolution();
+    const double diffy = 1.0 - fabs(robotPos.y() - m.cell(cellIndex).center().y()) / context()->map().resolution();
+
+    const int dx = (robotPos.x() < m.cell(cellIndex).center().x()) ? -1 : 1;
+    const int dy = (robotPos.y() < m.cell(cellIndex).center().y()) ? -1 : 1;
+
+    QPoint g00(cellIndex);
+    QPoint g01(g00);
+    QPoint g10(g00);
+    QPoint g11(g00);
+
+    if (m.isValidField(cellIndex + QPoint(dx, 0))) g01 = cellIndex + QPoint(dx, 0);
+    if (m.isValidField(cellIndex + QPoint(0, dy))) g10 = cellIndex + QPoint(0, dy);
+    if (m.isValidField(cellIndex + QPoint(dx,dy))) g11 = cellIndex + QPoint(dx, dy);
+
+    // the planner is up to date before the cache is validated
+    IncrementalPlanner& planner = frontierPlanner(robot);
+    gradientCache(robot);
+
+    QPointF grad00(cellGradient(robot, planner, g00));
+    QPointF grad01(cellGradient(robot, planner, g01));
+    QPointF grad10(cellGradient(robot, planner, g10));
+    QPointF grad11(cellGradient(robot, planner, g11));
+
+    QPointF gradX0(diffx * grad00 + (1 - diffx) * grad01);
+    QPointF gradX1(diffx * grad10 + (1 - diffx) * grad11);
+
+    QPointF grad(diffy * gradX0 + (1 - diffy) * gradX1);
+
+    return grad;
+}
+//END MinDistStrategy
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,79 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_MINDIST_STRATEGY_H
+#define DISCOVERAGE_MINDIST_STRATEGY_H
+
+#include <QtCore/QPoint>
+#include <QtCore/QHash>
+#include "cell.h"
+#include "gridmap.h"
+#include "strategy.h"
+
+class SimulationContext;
+class DisCoverageBulloStrategy;
+class IncrementalPlanner;
+class GradientCache;
+
+/**
+ * Each robot follows the shortest path to its nearest frontier. Robots
+ * without frontiers fall back to the centroidal search.
+ */
+class MinDistStrategy : public Strategy
+{
+    public:
+        MinDistStrategy(SimulationContext* context, DisCoverageBulloStrategy* centroidalSearch);
+        virtual ~MinDistStrategy();
+
+    public:
+        virtual void reset();
+        virtual void tick();
+
+        virtual void postProcess();
+
+        virtual QPointF gradient(Robot* robot, bool interpolate);
+        virtual QString name() const;
+
+    protected:
+        void updateVectorField();
+        void updateVectorField(Robot* robot);
+
+        IncrementalPlanner& frontierPlanner(Robot* robot);
+        QPointF gradient(const QPointF& robotPos, IncrementalPlanner& planner);
+        QPointF interpolatedGradient(const QPointF& robotPos, Robot* robot);
+
+        // gradient at the center of a cell, computed on demand. The cache
+        // must be validated with gradientCache() before.
+        QPointF cellGradient(Robot* robot, IncrementalPlanner& planner, const QPoint& cellIndex);
+        GradientCache& gradientCache(Robot* robot);
+
+    private:
+        DisCoverageBulloStrategy* m_centroidalSearch;
+
+        // shortest paths to the frontiers of each robot, kept across ticks
+        QHash<Robot*, IncrementalPlanner*> m_frontierPlanners;
+
+        // cell gradients of each robot, valid as long as the map and the
+        // partition do not change (see GradientCache::validate())
+        QHash<Robot*, GradientCache*> m_gradientCaches;
+};
+
+#endif // DISCOVERAGE_MINDIST_STRATEGY_H
+
+// kate: replace-tabs on; indent-width 4;
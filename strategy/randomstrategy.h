@@ -0,0 +1,25 @@
+#ifndef RANDOMSTRATEGY_H
+#define RANDOMSTRATEGY_H
+
+#include "strategy.h"
+#include "gridmap.h"
+
+#include <QtCore/QPoint>
+
+
+class RandomStrategy : public Strategy
+{
+public:
+    RandomStrategy(SimulationContext* context);
+
+    virtual void tick();
+    virtual void postProcess();
+    virtual QPointF gradient(Robot* robot, bool interpolate);
+
+private:
+	QPointF grad;
+	
+	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
+};
+
+#endif // RANDOMSTRATEGY_H
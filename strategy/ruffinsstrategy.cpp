@@ -0,0 +1,93 @@
+#include "ruffinsstrategy.h"
+
+#include "robot.h"
+#include "simulationcontext.h"
+
+#include <iostream>
+#include <cmath>
+
+#include <QtCore/QList>
+
+RuffinsStrategy::RuffinsStrategy(SimulationContext* context): Strategy(context), grad(1, 0)
+{
+	qsrand(42);
+}
+
+void RuffinsStrategy::tick()
+{
+    Strategy::tick();
+}
+
+void RuffinsStrategy::postProcess()
+{
+    Strategy::postProcess();
+	
+    // update the frontier cache
+    context()->map().updateRobotFrontierCache();
+}
+
+QPointF RuffinsStrategy::gradient(Robot* robot, bool interpolate)
+{
+    GridMap& m = *robot->map();
+	
+	if (qrand() % 10) {
+		QPoint pos = m.worldToIndex(robot->position()) + grad.toPoint();
+		if (! m.cell(pos).isObstacle()) {
+			return this->grad;
+		}
+		else{
+			std::cout << "oww I've crashed into an obstacle!" << std::endl;
+		}
+	}
+	
+    while (1) {
+
+		double x = qrand() - RAND_MAX / 2;
+		double y = qrand() - RAND_MAX / 2;
+		std::cout << x << " : " << y << std::endl;
+		double scale = sqrt(x * x + y * y);
+		QPointF newGrad(x / scale , y / scale);
+//		robot->position();
+
+        //m = *robot->map();
+		QPoint pos = m.worldToIndex(robot->position()) + newGrad.toPoint();
+
+		if (! m.cell(pos).isObstacle()) {
+			grad = newGrad;
+			return newGrad;
+		}
+		else{
+			QPointF newGrad(-grad.x(), -grad.y());
+//			grad = newGrad;
+			return newGrad;
+		}
+	}
+    return QPointF();
+}
+
+double RuffinsStrategy::explorationPotential(GridMap& m, QPoint position, int radius)
+{
+	double result = 0.0;
+	
+	if (m.isValidField(position))
+	{
+		return 0.0;
+	}
+	
+	int xStart = position.x() - radius;
+	int xEnd = position.x() + radius;
+	int yStart = position.y() - radius;
+	int yEnd = position.y() + radius;
+	
+	for ( int a = xStart; a <= xEnd; ++a) {
+		for (int b = yStart; b <= yEnd; ++b) {
+			if (m.isValidField(a, b)) {
+				
+			}
+			else {
+				
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,25 @@
+#ifndef RUFFINSSTRATEGY_H
+#define RUFFINSSTRATEGY_H
+
+#include "strategy.h"
+#include "gridmap.h"
+
+#include <QtCore/QPoint>
+
+
+class RuffinsStrategy : public Strategy
+{
+public:
+    RuffinsStrategy(SimulationContext* context);
+
+    virtual void tick();
+    virtual void postProcess();
+    virtual QPointF gradient(Robot* robot, bool interpolate);
+
+private:
+	QPointF grad;
+	
+	virtual double explorationPotential(GridMap& m, QPoint position, int radius);
+};
+
+#endif // RUFFINSSTRATEGY_H
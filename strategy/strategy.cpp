@@ -0,0 +1,75 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "strategy.h"
+
+#include <QtCore/QSettings>
+#include <QtCore/QTextStream>
+
+//BEGIN Strategy
+Strategy::Strategy(SimulationContext* context)
+    : m_context(context)
+{
+}
+
+Strategy::~Strategy()
+{
+}
+
+SimulationContext* Strategy::context() const
+{
+    return m_context;
+}
+
+void Strategy::reset()
+{
+}
+
+void Strategy::tick()
+{
+}
+
+void Strategy::postProcess()
+{
+}
+
+QPointF Strategy::gradient(Robot* /*robot*/, bool /*interpolate*/)
+{
+    return QPointF();
+}
+
+QString Strategy::name() const
+{
+    return QString();
+}
+
+void Strategy::save(QSettings& config)
+{
+}
+
+void Strategy::load(QSettings& config)
+{
+}
+
+void Strategy::exportObjectiveFunction(QTextStream& ts)
+{
+}
+//END Strategy
+
+// kate: replace-tabs on; indent-width 4;
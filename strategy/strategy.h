@@ -0,0 +1,107 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_STRATEGY_H
+#define DISCOVERAGE_STRATEGY_H
+
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+
+class SimulationContext;
+class Robot;
+class QSettings;
+class QTextStream;
+
+/**
+ * Base class for exploration strategies: the objective and gradient
+ * computation that moves the robots of a SimulationContext.
+ *
+ * Strategies only depend on QtCore and run without GUI, e.g. in the
+ * discoverage-batch tool. In the application, a ToolHandler wraps each
+ * strategy and adds the dock widgets and the drawing.
+ */
+class Strategy
+{
+    public:
+        Strategy(SimulationContext* context);
+        virtual ~Strategy();
+
+        SimulationContext* context() const;
+
+        /**
+         * This function is called when the "Reset" action is triggered.
+         * Usually, cleanup routines are called here, such as cleaning trajectories.
+         *
+         * The default implementation does nothing.
+         */
+        virtual void reset();
+
+        /**
+         * This function is called each iteration and is basically one step
+         * of a discrete-time implementation of the algorithm.
+         *
+         * To move the robots, use the Robot::setPosition() and Robot::position().
+         *
+         * The default implementation does nothing.
+         *
+         * @see RobotManager, Robot::position(), Robot::setPosition()
+         */
+        virtual void tick();
+
+        /**
+         * This function is called after tick().
+         * The idea is to prepare everything for the next iteration.
+         * Examples include the computation of the Voronoi partition, distance
+         * transforms or information needed when painting the environment.
+         *
+         * The default implementation does nothing.
+         */
+        virtual void postProcess();
+
+        /**
+         * Return the gradient for @p robot at robot->position().
+         * Usually, @p interpolate is true. This means that the returned gradient
+         * should be interpolated between the 4 adjacent grid map cells of the
+         * current robot position.
+         */
+        virtual QPointF gradient(Robot* robot, bool interpolate);
+
+        /**
+         * Return a GUI readable name of the strategy.
+         * Examples: "MinDist", "MaxArea", "DisCoverage", ...
+         */
+        virtual QString name() const;
+
+    //
+    // load & save, and export
+    //
+    public:
+        // the parameters of the strategy, the default does nothing
+        virtual void save(QSettings& config);
+        virtual void load(QSettings& config);
+
+        virtual void exportObjectiveFunction(QTextStream& ts);
+
+    private:
+        SimulationContext* m_context;
+};
+
+#endif // DISCOVERAGE_STRATEGY_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,233 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "fastmathtest.h"
+#include "fastmath.h"
+
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <math.h>
+#include <stdlib.h>
+
+// not a multiple of the vector width, so the batch functions also run
+// their scalar tail
+static const int s_count = (1 << 18) + 3;
+
+// error bounds documented in fastmath.h
+static const double s_expMaxRelativeError = 3e-7;
+static const double s_logMaxError = 2e-7;
+static const double s_atan2MaxAbsoluteError = 3e-7;
+
+static QVector<float> expArguments()
+{
+    // the range that neither under- nor overflows
+    QVector<float> x(s_count);
+    for (int i = 0; i < s_count; ++i) {
+        x[i] = -87.3f + 176.0f * i / s_count;
+        x[i] = qMin(x[i], 88.7f);
+    }
+    return x;
+}
+
+static QVector<float> logArguments()
+{
+    // normal floats, evenly spread over the exponents
+    QVector<float> x(s_count);
+    for (int i = 0; i < s_count; ++i) {
+        x[i] = ::exp(-87.0 + 175.0 * i / s_count);
+    }
+    return x;
+}
+
+static void atan2Arguments(QVector<float>& y, QVector<float>& x)
+{
+    // directions in all quadrants, including the axes
+    srand(1);
+    y.resize(s_count);
+    x.resize(s_count);
+    for (int i = 0; i < s_count; ++i) {
+        y[i] = 100.0f * rand() / RAND_MAX - 50.0f;
+        x[i] = 100.0f * rand() / RAND_MAX - 50.0f;
+    }
+    for (int i = 0; i < 8; ++i) {
+        y[i] = (i & 1) ? 0.0f : ((i & 2) ? 1.0f : -1.0f);
+        x[i] = (i & 1) ? ((i & 2) ? 1.0f : -1.0f) : 0.0f;
+    }
+}
+
+//BEGIN FastMathTest
+void FastMathTest::instructionSet()
+{
+    // ENABLE_AVX2 builds must actually use the AVX2 path
+#if defined(DISCOVERAGE_AVX2)
+    QCOMPARE(QString(FastMath::instructionSet()), QString("AVX2"));
+#elif defined(__SSE2__) || defined(_M_X64)
+    QCOMPARE(QString(FastMath::instructionSet()), QString("SSE2"));
+#else
+    QCOMPARE(QString(FastMath::instructionSet()), QString("scalar"));
+#endif
+}
+
+void FastMathTest::expAccuracy()
+{
+    const QVector<float> x = expArguments();
+    QVector<float> batch(s_count);
+    FastMath::exp(x.constData(), batch.data(), s_count);
+
+    double batchError = 0.0;
+    double scalarError = 0.0;
+    for (int i = 0; i < s_count; ++i) {
+        const double exact = ::exp(static_cast<double>(x[i]));
+        batchError = qMax(batchError, qAbs(batch[i] - exact) / exact);
+        scalarError = qMax(scalarError, qAbs(FastMath::exp(x[i]) - exact) / exact);
+    }
+
+    QVERIFY2(batchError < s_expMaxRelativeError,
+             qPrintable(QString("batch exp: max relative error %1").arg(batchError)));
+    QVERIFY2(scalarError < s_expMaxRelativeError,
+             qPrintable(QString("scalar exp: max relative error %1").arg(scalarError)));
+}
+
+void FastMathTest::logAccuracy()
+{
+    const QVector<float> x = logArguments();
+    QVector<float> batch(s_count);
+    FastMath::log(x.constData(), batch.data(), s_count);
+
+    // error relative to max(1, |log(x)|)
+    double batchError = 0.0;
+    double scalarError = 0.0;
+    for (int i = 0; i < s_count; ++i) {
+        const double exact = ::log(static_cast<double>(x[i]));
+        const double scale = qMax(1.0, qAbs(exact));
+        batchError = qMax(batchError, qAbs(batch[i] - exact) / scale);
+        scalarError = qMax(scalarError, qAbs(FastMath::log(x[i]) - exact) / scale);
+    }
+
+    QVERIFY2(batchError < s_logMaxError,
+             qPrintable(QString("batch log: max error %1").arg(batchError)));
+    QVERIFY2(scalarError < s_logMaxError,
+             qPrintable(QString("scalar log: max error %1").arg(scalarError)));
+}
+
+void FastMathTest::atan2Accuracy()
+{
+    QVector<float> y;
+    QVector<float> x;
+    atan2Arguments(y, x);
+    QVector<float> batch(s_count);
+    FastMath::atan2(y.constData(), x.constData(), batch.data(), s_count);
+
+    double batchError = 0.0;
+    double scalarError = 0.0;
+    for (int i = 0; i < s_count; ++i) {
+        const double exact = ::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]));
+        batchError = qMax(batchError, qAbs(batch[i] - exact));
+        scalarError = qMax(scalarError, qAbs(FastMath::atan2(y[i], x[i]) - exact));
+    }
+
+    QVERIFY2(batchError < s_atan2MaxAbsoluteError,
+             qPrintable(QString("batch atan2: max absolute error %1").arg(batchError)));
+    QVERIFY2(scalarError < s_atan2MaxAbsoluteError,
+             qPrintable(QString("scalar atan2: max absolute error %1").arg(scalarError)));
+}
+
+void FastMathTest::specialValues()
+{
+    // 16 equal values, so the batch functions use full vectors
+    QVector<float> x(16);
+    QVector<float> y(16);
+    QVector<float> result(16);
+
+    x.fill(-100.0f);
+    FastMath::exp(x.constData(), result.data(), x.size());
+    QCOMPARE(result[0], 0.0f);
+    QCOMPARE(FastMath::exp(-100.0f), 0.0f);
+
+    x.fill(100.0f);
+    FastMath::exp(x.constData(), result.data(), x.size());
+    QVERIFY(qIsInf(result[0]) && result[0] > 0.0f);
+    QVERIFY(qIsInf(FastMath::exp(100.0f)));
+
+    x.fill(0.0f);
+    FastMath::log(x.constData(), result.data(), x.size());
+    QVERIFY(qIsInf(result[0]) && result[0] < 0.0f);
+    QVERIFY(qIsInf(FastMath::log(0.0f)) && FastMath::log(0.0f) < 0.0f);
+
+    x.fill(-1.0f);
+    FastMath::log(x.constData(), result.data(), x.size());
+    QVERIFY(qIsNaN(result[0]));
+    QVERIFY(qIsNaN(FastMath::log(-1.0f)));
+
+    x.fill(0.0f);
+    y.fill(0.0f);
+    FastMath::atan2(y.constData(), x.constData(), result.data(), x.size());
+    QCOMPARE(result[0], 0.0f);
+    QCOMPARE(FastMath::atan2(0.0f, 0.0f), 0.0f);
+}
+
+void FastMathTest::batchMatchesScalar()
+{
+    // all paths evaluate the same polynomials, only the rounding of fused
+    // multiply-adds may differ
+    const QVector<float> expX = expArguments();
+    const QVector<float> logX = logArguments();
+    QVector<float> y;
+    QVector<float> x;
+    atan2Arguments(y, x);
+
+    QVector<float> expResult(s_count);
+    QVector<float> logResult(s_count);
+    QVector<float> atan2Result(s_count);
+    FastMath::exp(expX.constData(), expResult.data(), s_count);
+    FastMath::log(logX.constData(), logResult.data(), s_count);
+    FastMath::atan2(y.constData(), x.constData(), atan2Result.data(), s_count);
+
+    int mismatches = 0;
+    for (int i = 0; i < s_count; ++i) {
+        const float e = FastMath::exp(expX[i]);
+        const float l = FastMath::log(logX[i]);
+        const float a = FastMath::atan2(y[i], x[i]);
+        if (qAbs(expResult[i] - e) > 1e-6f * e
+            || qAbs(logResult[i] - l) > 1e-6f * qMax(1.0f, qAbs(l))
+            || qAbs(atan2Result[i] - a) > 1e-6f)
+        {
+            ++mismatches;
+        }
+    }
+    QCOMPARE(mismatches, 0);
+}
+
+void FastMathTest::batchInPlace()
+{
+    const QVector<float> x = expArguments();
+    QVector<float> expected(s_count);
+    FastMath::exp(x.constData(), expected.data(), s_count);
+
+    QVector<float> inPlace = x;
+    float* data = inPlace.data();
+    FastMath::exp(data, data, s_count);
+    QVERIFY(inPlace == expected);
+}
+//END FastMathTest
+
+QTEST_APPLESS_MAIN(FastMathTest)
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,49 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_FAST_MATH_TEST_H
+#define DISCOVERAGE_FAST_MATH_TEST_H
+
+#include <QtCore/QObject>
+
+/**
+ * Compares the FastMath approximations to libm and fails if the error bounds
+ * documented in fastmath.h are exceeded. The batch functions run the SIMD
+ * path of the build (SSE2, or AVX2 with ENABLE_AVX2) for all full vectors
+ * and the scalar functions for the rest, so both paths are checked.
+ */
+class FastMathTest : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void instructionSet();
+
+        void expAccuracy();
+        void logAccuracy();
+        void atan2Accuracy();
+
+        void specialValues();
+        void batchMatchesScalar();
+        void batchInPlace();
+};
+
+#endif // DISCOVERAGE_FAST_MATH_TEST_H
+
+// kate: replace-tabs on; indent-width 4;
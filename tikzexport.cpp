@@ -31,11 +31,6 @@
 #include <QtCore/QPointF>
 #include <QtCore/QRectF>
 
-#include <QtGui/QPainterPath>
-#include <QtGui/QColor>
-
-#include <QDebug>
-
 QTikzPicture::QTikzPicture()
     : ts(0)
 {
@@ -51,45 +46,6 @@ void QTikzPicture::setStream(QTextStream* textStream, int precision)
     }
 }
 
-QString QTikzPicture::registerColor(const QColor& color)
-{
-    // some predefined colors
-    if (color == Qt::red) return "red";
-    if (color == Qt::green) return "green";
-    if (color == Qt::blue) return "blue";
-    if (color == Qt::black) return "black";
-    if (color == Qt::white) return "white";
-    if (color == Qt::cyan) return "cyan";
-    if (color == Qt::magenta) return "magenta";
-    if (color == Qt::yellow) return "yellow";
-
-    QString name = color.name();
-    if (name.startsWith('#')) name.remove(0, 1);
-
-    name.replace("0", "q", Qt::CaseInsensitive);
-    name.replace("1", "r", Qt::CaseInsensitive);
-    name.replace("2", "s", Qt::CaseInsensitive);
-    name.replace("3", "t", Qt::CaseInsensitive);
-    name.replace("4", "u", Qt::CaseInsensitive);
-    name.replace("5", "v", Qt::CaseInsensitive);
-    name.replace("6", "w", Qt::CaseInsensitive);
-    name.replace("7", "x", Qt::CaseInsensitive);
-    name.replace("8", "y", Qt::CaseInsensitive);
-    name.replace("9", "z", Qt::CaseInsensitive);
-
-    name = 'c' + name;
-
-    if (!m_colors.contains(name)) {
-        if (ts) {
-            (*ts) << "\\definecolor{" << name << "}{rgb}{"
-                  << color.redF() << ", " << color.greenF() << ", " << color.blueF() << "}\n";
-        }
-        m_colors[name] = true;
-    }
-
-    return name;
-}
-
 void QTikzPicture::begin(const QString& options)
 {
     if (!ts) return;
@@ -142,28 +98,6 @@ void QTikzPicture::comment(const QString& text)
     (*ts) << "% " << text << "\n";
 }
 
-void QTikzPicture::path(const QPainterPath& path, const QString& options)
-{
-    if (!ts || path.isEmpty()) return;
-
-    int i = 0;
-    for (i = 0; i < path.elementCount(); ++i) {
-        const QPainterPath::Element& element = path.elementAt(i);
-
-        if (element.type == QPainterPath::MoveToElement) {
-            if (i > 0) {
-                (*ts) << " -- cycle;\n";
-            }
-            (*ts) << "\\draw[" << options << "] (" << element.x << ", " << element.y << ")";
-        } else if (element.type == QPainterPath::LineToElement) {
-            (*ts) << " -- (" << element.x << ", " << element.y << ")";
-        }
-    }
-    if (i > 0) {
-        (*ts) << " -- cycle;\n";
-    }
-}
-
 void QTikzPicture::path(const QRectF& rect, const QString& options)
 {
     if (!ts || rect.isEmpty()) return;
@@ -176,31 +110,6 @@ void QTikzPicture::path(const QRectF& rect, const QString& options)
           << ") rectangle (" << rect.right() << ", " << rect.bottom() << ");\n";
 }
 
-void QTikzPicture::clip(const QPainterPath& path)
-{
-    if (!ts || path.isEmpty()) return;
-
-    (*ts) << "\\clip ";
-
-    for (int i = 0; i < path.elementCount(); ++i) {
-        const QPainterPath::Element& element = path.elementAt(i);
-
-        if (element.type == QPainterPath::MoveToElement) {
-            if (i > 0) {
-                (*ts) << " -- cycle";
-                (*ts) << "\n      ";
-            }
-        } else if (element.type == QPainterPath::LineToElement) {
-            (*ts) << " -- ";
-        } else {
-            qWarning() << "QTikzPicture::clip: uknown QPainterPath segment type";
-        }
-        (*ts) << "(" << element.x << ", " << element.y << ")";
-    }
-
-    (*ts) << " -- cycle;\n";
-}
-
 void QTikzPicture::clip(const QRectF& rect)
 {
     if (!ts || rect.isEmpty()) return;
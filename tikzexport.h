@@ -38,6 +38,8 @@ class QPointF;
 class QRectF;
 class QPainterPath;
 
+// The QColor and QPainterPath overloads are implemented in tikzexportgui.cpp,
+// which is built with the GUI only.
 class QTikzPicture
 {
     public:
@@ -0,0 +1,148 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "tiletask.h"
+#include "robottask.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+
+//BEGIN TileRunnable
+class TileRunnable : public QRunnable
+{
+    public:
+        TileRunnable(TileTask* task, QSemaphore* done)
+            : m_task(task)
+            , m_done(done)
+        {
+        }
+
+        virtual void run()
+        {
+            m_task->processTiles();
+            m_done->release();
+        }
+
+    private:
+        TileTask* m_task;
+        QSemaphore* m_done;
+};
+//END TileRunnable
+
+//BEGIN TileTask
+TileTask::TileTask(int tileSize)
+    : m_tileSize(qMax(1, tileSize))
+    , m_wallTime(0.0)
+{
+}
+
+TileTask::~TileTask()
+{
+}
+
+void TileTask::run(const QRect& area)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_tiles.clear();
+    for (int y = area.top(); y <= area.bottom(); y += m_tileSize) {
+        for (int x = area.left(); x <= area.right(); x += m_tileSize) {
+            m_tiles.append(QRect(x, y, m_tileSize, m_tileSize).intersected(area));
+        }
+    }
+    m_tileTime.fill(0.0, m_tiles.size());
+    m_nextTile = 0;
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int workers = RobotTask::isParallel()
+                      ? qMin(pool->maxThreadCount(), m_tiles.size()) : 1;
+
+    QSemaphore done;
+    for (int i = 1; i < workers; ++i) {
+        pool->start(new TileRunnable(this, &done));
+    }
+
+    // the calling thread works on tiles as well
+    processTiles();
+
+    // The caller may be a pool thread itself (within a RobotTask). Let the
+    // pool start another thread while waiting, so that the queued runnables
+    // cannot starve. Other callers do not count as active pool threads.
+    if (workers > 1) {
+        const bool poolThread = RobotTask::isWorkerThread();
+        if (poolThread) {
+            pool->releaseThread();
+        }
+        done.acquire(workers - 1);
+        if (poolThread) {
+            pool->reserveThread();
+        }
+    }
+
+    m_wallTime = timer.nsecsElapsed() / 1000000.0;
+}
+
+void TileTask::processTiles()
+{
+    QElapsedTimer timer;
+    for (int i = m_nextTile.fetchAndAddOrdered(1); i < m_tiles.size(); i = m_nextTile.fetchAndAddOrdered(1)) {
+        timer.start();
+        process(m_tiles[i]);
+        m_tileTime[i] = timer.nsecsElapsed() / 1000000.0;
+    }
+}
+
+double TileTask::cpuTime() const
+{
+    double sum = 0.0;
+    foreach (double time, m_tileTime) {
+        sum += time;
+    }
+    return sum;
+}
+
+QString TileTask::timingSummary() const
+{
+    if (m_tiles.isEmpty()) {
+        return QString("no tiles");
+    }
+
+    int slowest = 0;
+    for (int i = 1; i < m_tiles.size(); ++i) {
+        if (m_tileTime[i] > m_tileTime[slowest])
+            slowest = i;
+    }
+
+    const QRect& tile = m_tiles[slowest];
+    return QString("%1 tiles: wall %2 ms, cpu %3 ms, mean tile %4 ms, slowest tile (%5, %6) %7 ms")
+        .arg(m_tiles.size())
+        .arg(m_wallTime, 0, 'f', 1)
+        .arg(cpuTime(), 0, 'f', 1)
+        .arg(cpuTime() / m_tiles.size(), 0, 'f', 2)
+        .arg(tile.x()).arg(tile.y())
+        .arg(m_tileTime[slowest], 0, 'f', 2);
+}
+//END TileTask
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,87 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef DISCOVERAGE_TILE_TASK_H
+#define DISCOVERAGE_TILE_TASK_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRect>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * Work that is done for each cell of a map area separately, e.g. the vector
+ * field of the DisCoverage-centroid handler.
+ *
+ * run() splits the area into square tiles and calls process() for each tile.
+ * The tiles are handed out to the threads of the global QThreadPool one by
+ * one, so that expensive tiles do not stall the others. process() must only
+ * write data of the cells in its tile and keep its scratch data local.
+ *
+ * Parallel execution follows RobotTask::isParallel().
+ *
+ * The time spent in each tile is recorded, see tileTime().
+ */
+class TileTask
+{
+    public:
+        explicit TileTask(int tileSize = 32);
+        virtual ~TileTask();
+
+        // process all tiles of area, returns when all tiles are done
+        void run(const QRect& area);
+
+        // tiles of the last run(), in row-major order
+        inline const QVector<QRect>& tiles() const
+        { return m_tiles; }
+
+        // time spent in process() for tile i in milliseconds
+        inline double tileTime(int i) const
+        { return m_tileTime[i]; }
+
+        // sum of all tile times, and the wall time of the last run()
+        double cpuTime() const;
+        inline double wallTime() const
+        { return m_wallTime; }
+
+        // one line summary of the timing of the last run()
+        QString timingSummary() const;
+
+    protected:
+        // called concurrently for different tiles
+        virtual void process(const QRect& tile) = 0;
+
+    private:
+        friend class TileRunnable;
+        void processTiles();
+
+    private:
+        int m_tileSize;
+        QVector<QRect> m_tiles;
+        QVector<double> m_tileTime;
+        double m_wallTime;
+
+        // index of the next unprocessed tile, shared by all threads
+        QAtomicInt m_nextTile;
+};
+
+#endif // DISCOVERAGE_TILE_TASK_H
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,526 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include "gridmapview.h"
+#include "gridmap.h"
+#include "config.h"
+#include "robot.h"
+#include "robotview.h"
+#include "tikzexport.h"
+#include "fastmath.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QBrush>
+
+// width of the explored obstacle frame around each GridMap
+static const int border = 2;
+
+GridMapView::GridMapView(QObject* parent)
+    : QObject(parent)
+    , m_map(0)
+{
+}
+
+GridMapView::~GridMapView()
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+}
+
+void GridMapView::setMap(GridMap* map)
+{
+    if (m_map) {
+        m_map->removeObserver(this);
+    }
+
+    m_map = map;
+    m_pixmapCache = QPixmap();
+    m_partitionMap.clear();
+    m_changedCells.clear();
+
+    if (m_map) {
+        m_map->addObserver(this);
+    }
+}
+
+GridMap* GridMapView::map() const
+{
+    return m_map;
+}
+
+//BEGIN view properties
+QSize GridMapView::displaySize() const
+{
+    return m_pixmapCache.size();
+}
+
+qreal GridMapView::scaleFactor() const
+{
+    return Config::self()->zoom() / m_map->resolution();
+}
+
+void GridMapView::incScaleFactor()
+{
+    Config::self()->zoomIn();
+}
+
+void GridMapView::decScaleFactor()
+{
+    Config::self()->zoomOut();
+}
+
+int GridMapView::screenToIndex(qreal screenPos) const
+{
+    return screenPos / (scaleFactor() * m_map->resolution());
+}
+
+QPoint GridMapView::screenToIndex(const QPointF& screenPos) const
+{
+    QPointF pt(screenPos / (scaleFactor() * m_map->resolution()));
+    return QPoint(pt.x(), pt.y());
+}
+
+qreal GridMapView::screenToWorld(qreal screenPos) const
+{
+    return screenPos / scaleFactor();
+}
+
+QPointF GridMapView::screenToWorld(const QPointF& screenPos) const
+{
+    return screenPos / scaleFactor();
+}
+
+qreal GridMapView::worldToScreen(qreal mapPos) const
+{
+    return mapPos * scaleFactor();
+}
+
+QPointF GridMapView::worldToScreen(const QPointF& mapPos) const
+{
+    return mapPos * scaleFactor();
+}
+//END
+
+//BEGIN drawing
+void GridMapView::updateCache()
+{
+    if (!m_map || !Config::self()->renderingEnabled()) {
+        return;
+    }
+
+    const int sizex = m_map->size().width();
+    const int sizey = m_map->size().height();
+
+    if (sizex == 0 || sizey == 0) {
+        m_pixmapCache = QPixmap();
+        return;
+    }
+
+    const qreal w = m_map->resolution();
+    const qreal scale = scaleFactor();
+
+    // create QPixmap spanning the entire space Q
+    if (m_pixmapCache.width() != scale * sizex * w + 1 ||
+        m_pixmapCache.height() != scale * sizey * w + 1)
+    {
+        m_pixmapCache = QPixmap(scale * sizex * w + 1, scale * sizey * w + 1);
+    }
+    m_pixmapCache.fill();
+    m_changedCells.clear();
+
+    // finally draw to pixmap cache
+    QPainter p(&m_pixmapCache);
+    p.scale(scaleFactor(), scaleFactor());
+    const int cellCount = sizex * sizey;
+    for (int i = 0; i < cellCount; ++i) {
+        drawCell(p, Cell(m_map, i), Config::self()->showDensity(), Config::self()->showVectorField());
+    }
+
+    m_partitionMap.clear();
+    if (Config::self()->showPartition() && m_map->robots().size() > 1) {
+        // create a QPainterPath for each robot
+        for (int i = 0; i < cellCount; ++i) {
+            const Cell cell(m_map, i);
+            Robot* robot = cell.robot();
+            if (robot)
+                m_partitionMap[robot].addRect(cell.rect());
+        }
+
+        // simplify each painter path
+        QMapIterator<Robot*, QPainterPath> it(m_partitionMap);
+        while (it.hasNext()) {
+            it.next();
+            m_partitionMap[it.key()] = it.value().simplified();
+        }
+    }
+}
+
+void GridMapView::draw(QPainter& p)
+{
+    updateChangedCells();
+    p.drawPixmap(0, 0, m_pixmapCache);
+
+    p.save();
+    p.scale(scaleFactor(), scaleFactor());
+
+    QMapIterator<Robot*, QPainterPath> it(m_partitionMap);
+    while (it.hasNext()) {
+        it.next();
+        QColor col(RobotView::color(it.key()));
+        p.setPen(QPen(col, m_map->resolution() * 0.3));
+        col.setAlpha(96);
+        p.setBrush(col);
+        p.drawPath(it.value());
+    }
+
+    p.restore();
+}
+
+void GridMapView::updateChangedCells()
+{
+    if (m_changedCells.isEmpty()) {
+        return;
+    }
+
+    QPainter p(&m_pixmapCache);
+    p.scale(scaleFactor(), scaleFactor());
+    foreach (int index, m_changedCells) {
+        drawCell(p, Cell(m_map, index), Config::self()->showDensity(), Config::self()->showVectorField());
+    }
+    m_changedCells.clear();
+}
+
+QColor GridMapView::densityToColor(float density)
+{
+    const float sat = density == 0 ? 0.0 : 0.5;
+    const float val = 1.0;
+    float tmp = sqrt(-FastMath::log(density)) / 10;
+    const float hue = tmp;
+
+    return QColor::fromHsvF(hue, sat, val);
+}
+
+void GridMapView::drawCell(QPainter& p, const Cell& cell, bool showDensity, bool showGradient)
+{
+    static QBrush sBrushFrontier = QBrush(QColor(255, 127, 0, 255));
+    static QBrush sBrushExplored = QBrush(QColor(255, 255, 255, 0));
+
+    static QBrush sBrushExploredObstacle = QBrush(QColor(127, 127, 127));
+    static QBrush sBrushUnexploredObstacle = QBrush(QColor(Qt::gray));
+    static QBrush sBrushFree = QBrush(QColor(255, 255, 255));
+
+    const Cell::State s = cell.state();
+    const QRectF r = cell.rect();
+
+    p.setPen(Qt::NoPen);
+    p.setBrush(Qt::NoBrush);
+    if (s & Cell::Free) {
+        p.fillRect(r, sBrushFree);
+    } else {
+        p.fillRect(r, (s & Cell::Explored) ? sBrushExploredObstacle : sBrushUnexploredObstacle);
+    }
+
+    if (s & Cell::Unknown) {
+        p.setPen(Qt::gray);
+        p.drawRect(r);
+    } else if (s & Cell::Frontier) {
+        p.setBrush(sBrushFrontier);
+        p.setPen(Qt::gray);
+        p.drawRect(r);
+    } else if (!(s & Cell::Obstacle)) { // s & Explored
+        if (showDensity) {
+            p.fillRect(r, densityToColor(cell.density()));
+        } else {
+            p.setPen(Qt::white);
+            p.setBrush(sBrushFree);
+            p.drawRect(r);
+        }
+
+        const QPointF g = cell.gradient();
+        if (showGradient && !g.isNull()) {
+            // Draw the arrows
+            double angle = ::acos(g.x() / sqrt(g.x()*g.x() + g.y()*g.y()));
+            if (g.y() >= 0)
+                angle = 2 * M_PI - angle;
+
+            qreal arrowSize = r.width() / 2.0;
+
+            QPointF src = cell.center() - g * r.width() / 4.0;
+            QPointF dst = cell.center() + g * r.width() / 4.0;
+
+            QPointF destArrowP1 = dst + QPointF(sin(angle - M_PI / 3) * arrowSize/2,
+                                                     cos(angle - M_PI / 3) * arrowSize/2);
+            QPointF destArrowP2 = dst + QPointF(sin(angle - M_PI + M_PI / 3) * arrowSize/2,
+                                                     cos(angle - M_PI + M_PI / 3) * arrowSize/2);
+
+            p.setRenderHints(QPainter::Antialiasing, true);
+            p.setPen(Qt::black);
+            p.drawLine(src, dst);
+            p.drawPolyline(QPolygonF() << destArrowP1 << dst << destArrowP2);
+            p.setRenderHints(QPainter::Antialiasing, false);
+        }
+    }
+}
+//END
+
+//BEGIN GridMapObserver
+void GridMapView::cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState)
+{
+    Q_UNUSED(oldState)
+    Q_UNUSED(newState)
+
+    // nothing to update without pixmap cache, e.g. if rendering is disabled
+    if (!m_pixmapCache.isNull()) {
+        m_changedCells.append(cell.linearIndex());
+    }
+}
+
+void GridMapView::mapReset()
+{
+    // the cell indices are invalid now, updateCache() redraws all cells
+    m_changedCells.clear();
+}
+
+void GridMapView::mapDestroyed()
+{
+    m_map = 0;
+    m_pixmapCache = QPixmap();
+    m_partitionMap.clear();
+    m_changedCells.clear();
+}
+//END
+
+//BEGIN export
+void GridMapView::exportCell(QTikzPicture& tp, const Cell& cell, bool fillDensity, bool exportGradient)
+{
+    const Cell::State s = cell.state();
+    const QRectF r = cell.rect();
+    const QPointF g = cell.gradient();
+
+    if (s & Cell::Frontier) { // frontiers
+        tp.path(r, "fill=colFrontier, draw=colBorder");
+    } else if (s & Cell::Obstacle) {
+        if (s & Cell::Explored) {
+            tp.path(r, "fill=colExploredObstacle, draw=colBorder");
+        } else {
+            tp.path(r, "fill=colUnexploredObstacle, draw=colBorder");
+        }
+    } else {
+        if (s & Cell::Unknown) {
+            tp.path(r, "draw=colBorder");
+        } else {
+            if (fillDensity) {
+                QColor color = densityToColor(cell.density());
+                QString strColor = tp.registerColor(color);
+                tp.path(r, "fill=" + strColor + ", draw=" + strColor);
+            }
+        }
+    }
+
+    if (exportGradient && !g.isNull()) {
+        QPointF src = cell.center() - g * r.width() / 3.5;
+        QPointF dst = cell.center() + g * r.width() / 3.5;
+        tp.line(src, dst, "->");
+    }
+}
+
+void GridMapView::exportToTikz(QTikzPicture& tp)
+{
+    const bool showVectorField = Config::self()->showVectorField();
+    const bool showDensity = Config::self()->showDensity();
+
+    const qreal res = m_map->resolution();
+    const int width = m_map->size().width();
+    const int height = m_map->size().height();
+
+    QSizeF mapSize(m_map->size());
+    mapSize *= res;
+    QRectF clipRect(QPointF(border*res, border*res), mapSize - QSizeF(2*border*res, 2*border*res));
+    tp.clip(clipRect);
+
+    // 1st round: export all explored free cells
+    tp.newline();
+    tp.comment("explored cells");
+    if (!showDensity && showVectorField) tp.beginScope("gray");
+    for (int a = 0; a < width; ++a) {
+        for (int b = 0; b < height; ++b) {
+            const Cell c = m_map->cell(a, b);
+            if (c.state() == (Cell::Explored | Cell::Free))
+                exportCell(tp, c, showDensity, showVectorField);
+        }
+    }
+    if (!showDensity && showVectorField) tp.endScope();
+
+#if 0
+    // 2nd round: all unexplored cells (not frontiers)
+    tp.newline();
+    tp.comment("all unexplored cells and obstacles except frontiers");
+    for (int a = 0; a < width; ++a) {
+        for (int b = 0; b < height; ++b) {
+            const Cell c = m_map->cell(a, b);
+            if (c.state() & Cell::Unknown)
+                exportCell(tp, c, showDensity, showVectorField);
+        }
+    }
+
+    // 3nd round: all frontiers
+    tp.newline();
+    tp.comment("all frontiers");
+    for (int a = 0; a < width; ++a) {
+        for (int b = 0; b < height; ++b) {
+            const Cell c = m_map->cell(a, b);
+            if (c.state() & Cell::Frontier)
+                exportCell(tp, c, showDensity, showVectorField);
+        }
+    }
+#else
+    exportToTikzOpt(tp);
+#endif
+
+    // export partition
+    tp.comment("Voronoi partition");
+    const QVector<Robot*>& robots = m_map->robots();
+    if (Config::self()->showPartition() && robots.size() > 1) {
+        foreach (Robot* robot, robots) {
+            if (!m_partitionMap.contains(robot))
+                continue;
+
+            const QPainterPath& path = m_partitionMap[robot];
+            tp.beginScope();
+            tp.clip(path);
+            QString col = tp.registerColor(RobotView::color(robot));
+            tp.path(path, "ultra thick, draw=" + col);
+            tp.endScope();
+        }
+    }
+}
+
+void GridMapView::exportToTikzOpt(QTikzPicture& tp)
+{
+    const qreal res = m_map->resolution();
+    const int width = m_map->size().width();
+    const int height = m_map->size().height();
+
+    // collect connecting regions
+    QPainterPath unexploredRegion;
+    QPainterPath exploredObstacles;
+    QPainterPath unexploredObstacles;
+    QPainterPath frontiers;
+    for (int a = 0; a < width; ++a) {
+        for (int b = 0; b < height; ++b) {
+            const Cell c = m_map->cell(a, b);
+            if (c.state() & (Cell::Frontier | Cell::Unknown))
+                unexploredRegion.addRect(c.rect());
+
+            if (c.state() == (Cell::Obstacle | Cell::Explored))
+                exploredObstacles.addRect(c.rect());
+
+            if (c.state() == (Cell::Obstacle | Cell::Unknown))
+                unexploredObstacles.addRect(c.rect());
+
+            if (c.state() & Cell::Frontier)
+                frontiers.addRect(c.rect());
+        }
+    }
+
+    // simplify paths to reduce tikz size
+    unexploredRegion = unexploredRegion.simplified();
+    exploredObstacles = exploredObstacles.simplified();
+    unexploredObstacles = unexploredObstacles.simplified();
+    frontiers = frontiers.simplified();
+
+    const QRectF sceneRect(0, 0, res * width, res * height);
+
+    // draw frontiers
+    if (!frontiers.isEmpty()) {
+        tp.beginScope();
+            tp.clip(frontiers);
+            tp.path(sceneRect, "fill=colFrontier");
+        tp.endScope();
+    }
+
+    // draw unexplored obstacles
+    if (!unexploredObstacles.isEmpty()) {
+        tp.beginScope();
+            tp.clip(unexploredObstacles);
+            tp.path(sceneRect, "fill=colUnexploredObstacle");
+        tp.endScope();
+    }
+
+    // draw explored obstacles
+    if (!exploredObstacles.isEmpty()) {
+        tp.beginScope();
+            tp.clip(exploredObstacles);
+            tp.path(sceneRect, "fill=colExploredObstacle");
+        tp.endScope();
+    }
+
+    // draw grid for unexplored cells
+    if (!unexploredRegion.isEmpty()) {
+        tp.beginScope();
+            tp.path(unexploredRegion, "draw=colBorder");
+            tp.clip(unexploredRegion);
+            tp << "\\draw[draw=colBorder] (0, 0) grid [step=" << res << "] ("
+            << res * width << ", "
+            << res * height << ");\n";
+        tp.endScope();
+    }
+}
+
+void GridMapView::exportLegend(QTikzPicture& tp)
+{
+    const int width = m_map->size().width();
+    const int height = m_map->size().height();
+
+    // find maximum distance
+    double maxDist = 0;
+    for (int a = 0; a < width; ++a) {
+        for (int b = 0; b < height; ++b) {
+            const Cell c = m_map->cell(a, b);
+            if (c.state() == (Cell::Free | Cell::Explored)) {
+                if (maxDist < c.frontierDist())
+                    maxDist = c.frontierDist();
+            }
+        }
+    }
+
+    const double h = m_map->resolution() * (height - 4);
+    tp.begin("yscale=-1");
+    const int imax = 100;
+    for (int i = 0; i < imax; i++) {
+        double dist = (i * maxDist) / imax;
+        QString c = tp.registerColor(densityToColor(exp(-0.5/(2*2)*dist*dist)));
+        double y = h * i / imax;
+        QRectF rect(0.0, y, 0.8, h / imax);
+        tp.path(rect, "fill=" + c + ", draw=" + c);
+    }
+    tp.newline();
+    tp.path(QRectF(0.0, 0.0, 0.8, h), "draw=black");
+    tp.newline();
+    tp << "\\node[below] at (0.4, 0) {$\\phi_\\text{max}$};\n";
+    tp << "\\node[above] at (0.4, " << h << ") {$\\phi_\\text{min}$};\n";
+    tp.end();
+}
+//END
+
+// kate: replace-tabs on; indent-width 4;
@@ -0,0 +1,122 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_GRIDMAP_VIEW_H
+#define DISCOVERAGE_GRIDMAP_VIEW_H
+
+#include <QtCore/QObject>
+#include <QtCore/QMap>
+#include <QtCore/QPoint>
+#include <QtCore/QVector>
+#include <QtGui/QColor>
+#include <QtGui/QPainterPath>
+#include <QtGui/QPixmap>
+
+#include "gridmapobserver.h"
+
+class QPainter;
+class QTikzPicture;
+class GridMap;
+class Robot;
+
+/**
+ * Rendering of a GridMap: the pixmap cache of all cells, the outlines of
+ * the Voronoi partition, the conversion between screen and world
+ * coordinates, and the TikZ export.
+ *
+ * The GridMap itself does not depend on QtGui, so that the simulation runs
+ * without a view (batch runs, benchmarks). Cells whose state changes are
+ * redrawn with the next draw(). Densities, gradients and the partition are
+ * only redrawn by updateCache().
+ */
+class GridMapView : public QObject, public GridMapObserver
+{
+    Q_OBJECT
+
+    public:
+        GridMapView(QObject* parent = 0);
+        virtual ~GridMapView();
+
+        // the view does not own the map
+        void setMap(GridMap* map);
+        GridMap* map() const;
+
+    //
+    // export
+    //
+    public:
+        void exportToTikz(QTikzPicture& tp);
+        void exportToTikzOpt(QTikzPicture& tp);
+
+        void exportLegend(QTikzPicture& tp);
+
+    //
+    // drawing
+    //
+    public slots:
+        void updateCache();
+        void draw(QPainter& p);
+
+    public:
+        static QColor densityToColor(float density);
+
+        static void drawCell(QPainter& p, const Cell& cell, bool showDensity, bool showGradient);
+        static void exportCell(QTikzPicture& tp, const Cell& cell, bool fillDensity, bool exportGradient);
+
+    //
+    // view properties
+    //
+    public:
+        QSize displaySize() const;      // returns desired widget size in pixel, equals pixmap-cache size
+        qreal scaleFactor() const;      // zoom factor for visualization
+        void incScaleFactor();          // increase zoom factor
+        void decScaleFactor();          // decrease zoom factor
+
+        int screenToIndex(qreal screenPos) const;
+        QPoint screenToIndex(const QPointF& screenPos) const;
+
+        qreal screenToWorld(qreal screenPos) const;
+        QPointF screenToWorld(const QPointF& screenPos) const;
+
+        qreal worldToScreen(qreal mapPos) const;
+        QPointF worldToScreen(const QPointF& mapPos) const;
+
+    //
+    // GridMapObserver
+    //
+    public:
+        virtual void cellStateChanged(const Cell& cell, Cell::State oldState, Cell::State newState);
+        virtual void mapReset();
+        virtual void mapDestroyed();
+
+    private:
+        // draw the cells changed since the last draw() into the pixmap cache
+        void updateChangedCells();
+
+    private:
+        GridMap* m_map;
+
+        QPixmap m_pixmapCache;
+        QMap<Robot*, QPainterPath> m_partitionMap;
+        QVector<int> m_changedCells;        // linear indices
+};
+
+#endif // DISCOVERAGE_GRIDMAP_VIEW_H
+
+// kate: replace-tabs on; indent-width 4;
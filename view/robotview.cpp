@@ -0,0 +1,260 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include "robotview.h"
+#include "robot.h"
+#include "unicycle.h"
+#include "integratordynamics.h"
+#include "integratordynamicsconfigwidget.h"
+#include "unicycleconfigwidget.h"
+#include "robotmanager.h"
+#include "simulationcontext.h"
+#include "gridmap.h"
+#include "config.h"
+#include "tikzexport.h"
+
+#include <QtGui/QPainter>
+
+//BEGIN RobotView
+QColor RobotView::color(Robot* robot)
+{
+    const int index = robot->context()->robotManager().indexOf(robot);
+    static QColor orange(255, 128, 0);
+    static QColor lila(191, 127, 255);
+
+    switch (index) {
+        case 0: return Qt::blue;
+        case 1: return Qt::green;
+        case 2: return Qt::red;
+        case 3: return Qt::yellow;
+        case 4: return Qt::magenta;
+        case 5: return Qt::cyan;
+        case 6: return Qt::gray;
+        case 7: return orange;
+        case 8: return lila;
+        default: return Qt::white;
+    }
+}
+
+static QPainterPath circularPath(const QPointF& center, qreal radius)
+{
+    int segmentCount = static_cast<int>((radius + 1.0) * 20);
+
+    QPainterPath path;
+    path.moveTo(center + QPointF(radius, 0));
+
+    for (int i = 1; i < segmentCount; ++i) {
+        QPointF p(radius * cos(i * 2.0 * M_PI / segmentCount), radius * sin(i * 2.0 * M_PI / segmentCount));
+        path.lineTo(center + p);
+    }
+
+    path.closeSubpath();
+    return path;
+}
+
+QPainterPath RobotView::visibleArea(Robot* robot, double radius, bool limitToVoronoiCell)
+{
+    GridMap* m = robot->map();
+    QVector<Cell> visibleCells = m->visibleCells(robot->position(), radius);
+    QPainterPath visiblePath;
+    foreach (const Cell& cell, visibleCells) {
+        if (!limitToVoronoiCell || cell.robot() == robot)
+            visiblePath.addRect(cell.rect());
+    }
+    visiblePath = visiblePath.simplified();
+
+    // potentially limit with visibility radius
+    if (radius < m->convexDiameter()) {
+        visiblePath = visiblePath.intersected(circularPath(robot->position(), radius));
+    }
+
+    return visiblePath;
+}
+
+void RobotView::draw(QPainter& p, Robot* robot)
+{
+    p.setRenderHints(QPainter::Antialiasing, true);
+    p.setPen(QPen(color(robot), robot->map()->resolution() * 0.3, Qt::SolidLine));
+    drawTrajectory(p, robot);
+    if (robot->type() == Robot::Unicycle) {
+        drawUnicycle(p, robot);
+    } else {
+        drawIntegratorDynamics(p, robot);
+    }
+    drawSensedArea(p, robot);
+    p.setRenderHints(QPainter::Antialiasing, false);
+}
+
+void RobotView::drawTrajectory(QPainter& p, Robot* robot)
+{
+    const QVector<QPointF>& trajectory = robot->trajectory();
+    if (trajectory.size()) {
+        p.save();
+        p.setRenderHints(QPainter::Antialiasing, true);
+        p.setPen(QPen(color(robot), robot->map()->resolution() * 0.3, Qt::SolidLine));
+        p.drawPolyline(&trajectory[0], trajectory.size());
+        p.restore();
+    }
+}
+
+void RobotView::drawSensedArea(QPainter& p, Robot* robot)
+{
+    QColor col(color(robot));
+    QPen pen(col, robot->map()->resolution() * 0.3);
+    p.setPen(pen);
+    if (robot->fillSensingRange()) {
+        col.setAlpha(50);
+        p.setBrush(col);
+    } else {
+        p.setBrush(Qt::NoBrush);
+    }
+
+    QPainterPath visiblePath = visibleArea(robot, robot->sensingRange());
+    p.drawPath(visiblePath);
+}
+
+void RobotView::drawPreviewTrajectory(QPainter& p, Robot* robot)
+{
+    QVector<QPointF> previewPath = robot->previewTrajectory();
+    if (previewPath.size()) {
+        p.save();
+        p.setRenderHints(QPainter::Antialiasing, true);
+        p.setPen(QPen(color(robot), 0.05, Qt::DashLine));
+        p.drawPolyline(&previewPath[0], previewPath.size());
+        p.restore();
+    }
+}
+
+void RobotView::drawIntegratorDynamics(QPainter& p, Robot* robot)
+{
+    static QPen blackPen(Qt::black);
+    blackPen.setWidthF(robot->map()->resolution() * 0.1);
+
+    p.setOpacity(1.0);
+    p.setPen(blackPen);
+    p.setBrush(color(robot));
+    p.drawEllipse(robot->position(), 0.05, 0.05);
+}
+
+void RobotView::drawUnicycle(QPainter& p, Robot* robot)
+{
+    static QPen blackPen(Qt::black);
+    blackPen.setWidthF(robot->map()->resolution() * 0.1);
+
+    p.save();
+    p.translate(robot->position());
+    p.rotate(robot->orientation() * 180 / M_PI);
+
+    p.setOpacity(1.0);
+    p.setPen(blackPen);
+    p.setBrush(color(robot));
+
+    // draw wheels
+    QRectF wheel(-0.1, -0.15, 0.2, 0.1);
+    p.drawRect(wheel);
+    wheel.moveTo(-0.1,  0.05);
+    p.drawRect(wheel);
+
+    // draw triangle
+    QPainterPath triangle;
+    triangle.moveTo(0.15, 0);
+    triangle.lineTo(-0, -0.15);
+    triangle.lineTo(-0, 0.15);
+    triangle.closeSubpath();
+    p.drawPath(triangle);
+
+    p.restore();
+}
+
+void RobotView::exportToTikz(QTikzPicture& tp, Robot* robot)
+{
+    if (robot->type() == Robot::Unicycle) {
+        exportUnicycle(tp, robot);
+    } else {
+        exportIntegratorDynamics(tp, robot);
+    }
+}
+
+void RobotView::exportIntegratorDynamics(QTikzPicture& tp, Robot* robot)
+{
+    const QString c = tp.registerColor(color(robot));
+    tp.comment("robot trajectory (integrator dynamics)");
+    tp.line(robot->trajectory(), "very thick, draw=" + c);
+
+    if (robot->isActive() && robot->context()->config().showPreviewTrajectory()) {
+        QVector<QPointF> t = robot->previewTrajectory();
+        tp.comment("robot preview trajectory (integrator dynamics)");
+        tp.line(t, "very thick, draw=" + c);
+    }
+
+    // construct path of visibility region
+    tp.comment("robot sensed area");
+    QPainterPath visiblePath = visibleArea(robot, robot->sensingRange());
+    tp.path(visiblePath, "very thick, draw=" + c); // + ", fill=black, fill opacity=0.2");
+
+    tp.circle(robot->position(), 0.05, "draw=black, fill=white");
+}
+
+void RobotView::exportUnicycle(QTikzPicture& tp, Robot* robot)
+{
+    const QString c = tp.registerColor(color(robot));
+    tp.comment("robot trajectory (unicycle dynamics)");
+    tp.line(robot->trajectory(), "very thick, draw=" + c);
+
+    // construct path of visibility region
+    tp.comment("robot sensed area");
+    QPainterPath visiblePath = visibleArea(robot, robot->sensingRange());
+    tp.path(visiblePath, "very thick, draw=" + c/* + ", fill=black, fill opacity=0.2"*/);
+
+    // draw unicycle
+    tp.beginScope(QString("xshift=%1cm").arg(robot->position().x())
+                + QString(", yshift=%1cm").arg(robot->position().y())
+                + QString(", rotate=%1").arg(robot->orientation() * 180 / M_PI));
+
+    // draw wheels
+    QRectF wheel(-0.1, -0.15, 0.2, 0.1);
+    tp.path(wheel, "draw=black, fill=lightgray");
+    wheel.moveTo(-0.1,  0.05);
+    tp.path(wheel, "draw=black, fill=lightgray");
+
+    // draw triangle
+    QPainterPath triangle;
+    triangle.moveTo(0.15, 0);
+    triangle.lineTo(-0, -0.12);
+    triangle.lineTo(-0, 0.12);
+    triangle.closeSubpath();
+    tp.path(triangle, "draw=black, fill=" + c);
+
+    tp.endScope();
+}
+
+RobotConfigWidget* RobotView::createConfigWidget(Robot* robot)
+{
+    if (robot->type() == Robot::Unicycle) {
+        return new UnicycleConfigWidget(static_cast<Unicycle*>(robot));
+    } else {
+        return new IntegratorDynamicsConfigWidget(static_cast<IntegratorDynamics*>(robot));
+    }
+}
+//END RobotView
+
+// kate: replace-tabs on; indent-width 4;
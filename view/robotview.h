@@ -0,0 +1,66 @@
+/* This file is part of the DisCoverage project.
+
+   Copyright (C) Dominik Haumann <dhaumann at rtr.tu-darmstadt.de>
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef DISCOVERAGE_ROBOT_VIEW_H
+#define DISCOVERAGE_ROBOT_VIEW_H
+
+#include <QtGui/QColor>
+#include <QtGui/QPainterPath>
+
+class QPainter;
+class QTikzPicture;
+class Robot;
+class RobotConfigWidget;
+
+/**
+ * Rendering of a Robot: its color, the trajectory, the robot itself and
+ * its sensed area, and the TikZ export. The robots only depend on QtCore,
+ * so the drawing dispatches on Robot::type().
+ */
+class RobotView
+{
+    public:
+        // color of robot, depends on its index in the RobotManager
+        static QColor color(Robot* robot);
+
+        // cells visible from the robot within radius, as outline
+        static QPainterPath visibleArea(Robot* robot, double radius, bool limitToVoronoiCell = false);
+
+        // trajectory, robot and sensed area
+        static void draw(QPainter& p, Robot* robot);
+        static void drawPreviewTrajectory(QPainter& p, Robot* robot);
+
+        static void exportToTikz(QTikzPicture& tp, Robot* robot);
+
+        // new config widget for robot, owned by the caller
+        static RobotConfigWidget* createConfigWidget(Robot* robot);
+
+    private:
+        static void drawTrajectory(QPainter& p, Robot* robot);
+        static void drawSensedArea(QPainter& p, Robot* robot);
+        static void drawIntegratorDynamics(QPainter& p, Robot* robot);
+        static void drawUnicycle(QPainter& p, Robot* robot);
+
+        static void exportIntegratorDynamics(QTikzPicture& tp, Robot* robot);
+        static void exportUnicycle(QTikzPicture& tp, Robot* robot);
+};
+
+#endif // DISCOVERAGE_ROBOT_VIEW_H
+
+// kate: replace-tabs on; indent-width 4;